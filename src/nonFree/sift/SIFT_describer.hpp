@@ -7,9 +7,14 @@
 #ifndef OPENMVG_PATENTED_SIFT_SIFT_DESCRIBER_H
 #define OPENMVG_PATENTED_SIFT_SIFT_DESCRIBER_H
 
+#include "openMVG/features/sift_scale_space.hpp"
 #include <cereal/cereal.hpp>
+#include <algorithm>
+#include <chrono>
 #include <iostream>
+#include <limits>
 #include <numeric>
+#include <sstream>
 
 extern "C" {
 #include "nonFree/sift/vl/sift.h"
@@ -22,6 +27,17 @@ namespace features {
 // [1] R. Arandjelović, A. Zisserman.
 // Three things everyone should know to improve object retrieval. CVPR2012.
 
+/// Initialize VLFeat once for the process
+/// (the SIFT regions of several images can be computed concurrently)
+inline void vl_init_once()
+{
+  static struct VLFeat_State
+  {
+    VLFeat_State() { vl_constructor(); }
+    ~VLFeat_State() { vl_destructor(); }
+  } vlfeat_state;
+}
+
 inline void siftDescToUChar(
   vl_sift_pix descr[128],
   Descriptor<unsigned char,128> & descriptor,
@@ -38,6 +54,27 @@ inline void siftDescToUChar(
     descriptor[k] = static_cast<unsigned char>(512.f*descr[k]);
 }
 
+/// Time spent in the stages of the SIFT computation
+/// (seconds, summed over the Describe calls and the threads)
+struct SIFT_Timings
+{
+  SIFT_Timings(): scale_space(0.0), detection(0.0), orientation(0.0), description(0.0) {}
+
+  double scale_space; // Gaussian pyramid
+  double detection;   // DoG, extrema localization (and feature budget selection)
+  double orientation; // Gradients and keypoint orientations
+  double description; // Keypoint descriptors
+};
+
+inline std::ostream & operator<<(std::ostream & os, const SIFT_Timings & timings)
+{
+  return os
+    << "scale space: " << timings.scale_space << " s, "
+    << "detection: " << timings.detection << " s, "
+    << "orientation: " << timings.orientation << " s, "
+    << "description: " << timings.description << " s";
+}
+
 struct SiftParams
 {
   SiftParams(
@@ -80,7 +117,7 @@ class SIFT_Image_describer : public Image_describer
 {
 public:
   SIFT_Image_describer(const SiftParams & params = SiftParams(), bool bOrientation = true)
-    :Image_describer(), _params(params), _bOrientation(bOrientation) {}
+    :Image_describer(), _params(params), _bOrientation(bOrientation), _bNativeScaleSpace(false) {}
 
   ~SIFT_Image_describer() {}
 
@@ -104,6 +141,21 @@ public:
     return true;
   }
 
+  /**
+  @brief Build the Gaussian scale space with SIFT_Scale_Space (row parallel and
+  vectorized) instead of the scalar VLFeat code.
+  The keypoints and descriptors are the VLFeat ones (existing regions stay valid).
+  This runtime setting is not serialized.
+  */
+  void Set_native_scale_space(bool bNativeScaleSpace)
+  {
+    _bNativeScaleSpace = bNativeScaleSpace;
+  }
+
+  /// Time spent in each stage since the creation of the describer (or the last reset)
+  SIFT_Timings Get_timings() const { return _timings; }
+  void Reset_timings() { _timings = SIFT_Timings(); }
+
   /**
   @brief Detect regions on the image and compute their attributes (description)
   @param image Image.
@@ -120,7 +172,7 @@ public:
     const image::Image<float> If(image.GetMat().cast<float>());
 
     // Configure VLFeat
-    vl_constructor();
+    vl_init_once();
 
     VlSiftFilt *filt = vl_sift_new(w, h,
       _params._num_octaves, _params._num_scales, _params._first_octave);
@@ -129,71 +181,117 @@ public:
     if (_params._peak_threshold >= 0)
       vl_sift_set_peak_thresh(filt, 255*_params._peak_threshold/_params._num_scales);
 
-    Descriptor<vl_sift_pix, 128> descr;
-    Descriptor<unsigned char, 128> descriptor;
+    // Native scale space (the VLFeat filter keeps the detection and the description).
+    // It is also used with a pyramid cache (it can start from a cached base level).
+    std::unique_ptr<SIFT_Scale_Space> scale_space;
+    if (_bNativeScaleSpace || _pyramid_cache)
+      scale_space.reset(new SIFT_Scale_Space(w, h, filt->O, filt->S, filt->o_min));
+
+    // Base level of the scale space from the pyramid cache (computed and stored if missing)
+    image::Image<float> base;
+    const float * base_level = NULL;
+    if (_pyramid_cache)
+    {
+      Stage_Timer timer;
+      std::ostringstream os;
+      os << Image_Pyramid_Cache::Hash_Image(image) << "_sift_" << filt->o_min << "_" << filt->S;
+      if (!_pyramid_cache->Get(os.str(), base))
+      {
+        base.resize(scale_space->Base_Width(), scale_space->Base_Height());
+        scale_space->Compute_Base_Level(If.data(), base.data());
+        _pyramid_cache->Put(os.str(), base);
+      }
+      base_level = base.data();
+      timer.Add_To(_timings.scale_space);
+    }
 
     // Process SIFT computation
-    vl_sift_process_first_octave(filt, If.data());
+    Process_First_Octave(filt, If.data(), scale_space.get(), base_level);
 
     Allocate(regions);
 
     // Build alias to cached data
     SIFT_Regions * regionsCasted = dynamic_cast<SIFT_Regions*>(regions.get());
     // reserve some memory for faster keypoint saving
-    regionsCasted->Features().reserve(2000);
-    regionsCasted->Descriptors().reserve(2000);
-
-    while (true) {
-      vl_sift_detect(filt);
+    const size_t reserve_size = _max_features > 0 ? _max_features : 2000;
+    regionsCasted->Features().reserve(reserve_size);
+    regionsCasted->Descriptors().reserve(reserve_size);
 
-      VlSiftKeypoint const *keys  = vl_sift_get_keypoints(filt);
-      const int nkeys = vl_sift_get_nkeypoints(filt);
+    if (_max_features == 0)
+    {
+      while (true) {
+        Stage_Timer timer;
+        vl_sift_detect(filt);
+        timer.Add_To(_timings.detection);
 
-      // Update gradient before launching parallel extraction
-      vl_sift_update_gradient(filt);
+        Describe_Octave(filt, vl_sift_get_keypoints(filt), vl_sift_get_nkeypoints(filt),
+          mask, std::numeric_limits<size_t>::max(), regionsCasted);
 
-      #ifdef OPENMVG_USE_OPENMP
-      #pragma omp parallel for private(descr, descriptor)
-      #endif
-      for (int i = 0; i < nkeys; ++i) {
-
-        // Feature masking
-        if (mask)
-        {
-          const image::Image<unsigned char> & maskIma = *mask;
-          if (maskIma(keys[i].y, keys[i].x) > 0)
+        if (Process_Next_Octave(filt, scale_space.get()))
+          break; // Last octave
+      }
+    }
+    else
+    {
+      // 1. Detect the keypoints of all the octaves (response: |DoG| at the extremum)
+      std::vector<std::vector<VlSiftKeypoint> > octave_keys;
+      std::vector<PointFeature> vec_points;
+      std::vector<float> vec_responses;
+      while (true) {
+        Stage_Timer timer;
+        vl_sift_detect(filt);
+
+        VlSiftKeypoint const *keys  = vl_sift_get_keypoints(filt);
+        const int nkeys = vl_sift_get_nkeypoints(filt);
+        const int ow = vl_sift_get_octave_width(filt);
+        const int oh = vl_sift_get_octave_height(filt);
+
+        octave_keys.push_back(std::vector<VlSiftKeypoint>());
+        for (int i = 0; i < nkeys; ++i) {
+          // Feature masking
+          if (mask && (*mask)(keys[i].y, keys[i].x) > 0)
             continue;
+          octave_keys.back().push_back(keys[i]);
+          vec_points.push_back(PointFeature(keys[i].x, keys[i].y));
+          vec_responses.push_back(std::abs(
+            filt->dog[keys[i].ix + keys[i].iy * ow + (keys[i].is - filt->s_min) * ow * oh]));
         }
+        timer.Add_To(_timings.detection);
+        if (Process_Next_Octave(filt, scale_space.get()))
+          break; // Last octave
+      }
 
-        double angles [4] = {0.0, 0.0, 0.0, 0.0};
-        int nangles = 1; // by default (1 upright feature)
-        if (_bOrientation)
-        { // compute from 1 to 4 orientations
-          nangles = vl_sift_calc_keypoint_orientations(filt, angles, keys+i);
-        }
-
-        for (int q=0 ; q < nangles ; ++q) {
-          vl_sift_calc_keypoint_descriptor(filt, &descr[0], keys+i, angles[q]);
-          const SIOPointFeature fp(keys[i].x, keys[i].y,
-            keys[i].sigma, static_cast<float>(angles[q]));
-
-          siftDescToUChar(&descr[0], descriptor, _params._root_sift);
-          #ifdef OPENMVG_USE_OPENMP
-          #pragma omp critical
-          #endif
-          {
-            regionsCasted->Descriptors().push_back(descriptor);
-            regionsCasted->Features().push_back(fp);
-          }
+      // 2. Keep the budget of keypoints
+      Stage_Timer timer;
+      const std::vector<size_t> selected =
+        SelectFeatures(vec_points, vec_responses, w, h, _max_features, _feature_selection);
+      std::vector<char> vec_selected(vec_points.size(), 0);
+      for (size_t i = 0; i < selected.size(); ++i)
+        vec_selected[selected[i]] = 1;
+      timer.Add_To(_timings.detection);
+
+      // 3. Describe only the kept keypoints (the scale space is computed again octave per octave).
+      // The secondary orientations use the remaining budget.
+      size_t spare_angles = _max_features - selected.size();
+      size_t index = 0;
+      Process_First_Octave(filt, If.data(), scale_space.get(), base_level);
+      for (size_t o = 0; o < octave_keys.size(); ++o)
+      {
+        std::vector<VlSiftKeypoint> keys;
+        for (size_t i = 0; i < octave_keys[o].size(); ++i, ++index)
+          if (vec_selected[index])
+            keys.push_back(octave_keys[o][i]);
+        if (!keys.empty())
+        {
+          spare_angles = Describe_Octave(filt, &keys[0], static_cast<int>(keys.size()),
+            NULL, spare_angles, regionsCasted);
         }
+        if (o + 1 < octave_keys.size())
+          Process_Next_Octave(filt, scale_space.get());
       }
-      if (vl_sift_process_next_octave(filt))
-        break; // Last octave
     }
     vl_sift_delete(filt);
 
-    vl_destructor();
-
     return true;
   };
 
@@ -212,8 +310,164 @@ public:
   }
 
 private:
+
+  /// Measure the time of a stage and add it to a thread shared counter
+  class Stage_Timer
+  {
+  public:
+    Stage_Timer() : _start(std::chrono::steady_clock::now()) {}
+
+    void Add_To(double & counter)
+    {
+      const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+      const double seconds = std::chrono::duration<double>(now - _start).count();
+      _start = now;
+      #ifdef OPENMVG_USE_OPENMP
+      #pragma omp atomic
+      #endif
+      counter += seconds;
+    }
+
+  private:
+    std::chrono::steady_clock::time_point _start;
+  };
+
+  /// Copy the state of the native scale space to the VLFeat filter
+  static void Sync_Filter(VlSiftFilt *filt, const SIFT_Scale_Space & scale_space)
+  {
+    filt->o_cur = scale_space.Octave();
+    filt->octave_width = scale_space.Octave_Width();
+    filt->octave_height = scale_space.Octave_Height();
+    filt->nkeys = 0;
+    filt->grad_o = filt->o_min - 1; // the gradients must be computed again
+  }
+
+  /// Compute the first octave of the scale space (VLFeat or native, from the base level if any)
+  int Process_First_Octave(
+    VlSiftFilt *filt,
+    const vl_sift_pix * image,
+    SIFT_Scale_Space * scale_space,
+    const float * base_level = NULL) const
+  {
+    Stage_Timer timer;
+    int status = VL_ERR_OK;
+    if (!scale_space)
+      status = vl_sift_process_first_octave(filt, image);
+    else
+    {
+      const bool bOctave = base_level ?
+        scale_space->Process_First_Octave_From_Base(base_level, filt->octave) :
+        scale_space->Process_First_Octave(image, filt->octave);
+      if (!bOctave)
+        status = VL_ERR_EOF;
+      Sync_Filter(filt, *scale_space);
+    }
+    timer.Add_To(_timings.scale_space);
+    return status;
+  }
+
+  /// Compute the next octave of the scale space (VLFeat or native), VL_ERR_EOF after the last one
+  int Process_Next_Octave(VlSiftFilt *filt, SIFT_Scale_Space * scale_space) const
+  {
+    Stage_Timer timer;
+    int status = VL_ERR_OK;
+    if (!scale_space)
+      status = vl_sift_process_next_octave(filt);
+    else
+    {
+      if (!scale_space->Process_Next_Octave(filt->octave))
+        status = VL_ERR_EOF;
+      else
+        Sync_Filter(filt, *scale_space);
+    }
+    timer.Add_To(_timings.scale_space);
+    return status;
+  }
+
+  /**
+  @brief Describe the keypoints of the current octave (the gradient is updated)
+  and append them to the regions in keypoint order.
+  @param spare_angles Maximal number of secondary orientations
+  @return The remaining number of secondary orientations
+  */
+  size_t Describe_Octave(
+    VlSiftFilt *filt,
+    VlSiftKeypoint const *keys,
+    const int nkeys,
+    const image::Image<unsigned char> * mask,
+    size_t spare_angles,
+    SIFT_Regions * regionsCasted) const
+  {
+    // Per keypoint output slots (up to 4 orientations per keypoint):
+    // the threads write to distinct slots (no critical section) and the slots
+    // are appended in keypoint order (deterministic output)
+    const int max_angles = _bOrientation ? 4 : 1;
+    std::vector<int> vec_nangles(nkeys, 0);
+    std::vector<double> vec_angles(nkeys * max_angles, 0.0);
+
+    // Update gradient before launching parallel extraction
+    Stage_Timer timer;
+    vl_sift_update_gradient(filt);
+
+    #ifdef OPENMVG_USE_OPENMP
+    #pragma omp parallel for schedule(dynamic, 16)
+    #endif
+    for (int i = 0; i < nkeys; ++i) {
+
+      // Feature masking
+      if (mask)
+      {
+        const image::Image<unsigned char> & maskIma = *mask;
+        if (maskIma(keys[i].y, keys[i].x) > 0)
+          continue;
+      }
+
+      int nangles = 1; // by default (1 upright feature)
+      if (_bOrientation)
+      { // compute from 1 to 4 orientations
+        nangles = vl_sift_calc_keypoint_orientations(filt, &vec_angles[i * max_angles], keys+i);
+      }
+      vec_nangles[i] = nangles;
+    }
+
+    timer.Add_To(_timings.orientation);
+
+    // Limit the secondary orientations (in keypoint order)
+    for (int i = 0; i < nkeys; ++i) {
+      if (vec_nangles[i] > 1) {
+        const size_t extra = std::min(spare_angles, size_t(vec_nangles[i] - 1));
+        vec_nangles[i] = 1 + static_cast<int>(extra);
+        spare_angles -= extra;
+      }
+    }
+
+    std::vector<size_t> vec_offsets(nkeys + 1, regionsCasted->Features().size());
+    for (int i = 0; i < nkeys; ++i)
+      vec_offsets[i+1] = vec_offsets[i] + vec_nangles[i];
+    regionsCasted->Features().resize(vec_offsets[nkeys]);
+    regionsCasted->Descriptors().resize(vec_offsets[nkeys]);
+
+    #ifdef OPENMVG_USE_OPENMP
+    #pragma omp parallel for schedule(dynamic, 16)
+    #endif
+    for (int i = 0; i < nkeys; ++i) {
+      Descriptor<vl_sift_pix, 128> descr;
+      for (int q = 0; q < vec_nangles[i]; ++q) {
+        const double angle = vec_angles[i * max_angles + q];
+        vl_sift_calc_keypoint_descriptor(filt, &descr[0], keys+i, angle);
+        regionsCasted->Features()[vec_offsets[i] + q] = SIOPointFeature(keys[i].x, keys[i].y,
+          keys[i].sigma, static_cast<float>(angle));
+        siftDescToUChar(&descr[0], regionsCasted->Descriptors()[vec_offsets[i] + q], _params._root_sift);
+      }
+    }
+    timer.Add_To(_timings.description);
+    return spare_angles;
+  }
+
   SiftParams _params;
   bool _bOrientation;
+  bool _bNativeScaleSpace;
+  mutable SIFT_Timings _timings;
 };
 
 } // namespace features
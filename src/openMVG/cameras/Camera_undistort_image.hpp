@@ -9,6 +9,10 @@
 #define OPENMVG_CAMERA_UNDISTORT_IMAGE_HPP
 
 #include "openMVG/image/image.hpp"
+#include "openMVG/types.hpp"
+
+#include <cmath>
+#include <vector>
 
 namespace openMVG {
 namespace cameras {
@@ -45,8 +49,262 @@ void UndistortImage(
   }
 }
 
+/**
+* @brief Precomputed undistortion lookup table.
+*
+* For every pixel of the undistorted image, store the top-left source pixel of
+* the bilinear footprint in the distorted image and its sub-pixel position
+* quantized on 1/INTER_TAB_SIZE steps (fixed-point remapping).
+* The map depends only on the intrinsic parameters and on the image size,
+* so it can be computed once and shared by all the views of an intrinsic.
+*/
+struct UndistortionMap
+{
+  // Number of bits used to quantize the sub-pixel position
+  static const int INTER_BITS = 5;
+  static const int INTER_TAB_SIZE = 1 << INTER_BITS;
+  // Fixed point precision of the bilinear weights (they sum to 1 << COEF_BITS)
+  static const int COEF_BITS = 15;
+
+  UndistortionMap(): _width(0), _height(0) {}
+
+  int Width() const { return _width; }
+  int Height() const { return _height; }
+  bool empty() const { return _src_index.empty(); }
+
+  /// Compute the lookup table of the given camera for a (w x h) image.
+  /// Return false if the camera has no distortion or the size is too small.
+  bool Build(const IntrinsicBase * cam, int w, int h)
+  {
+    _width = _height = 0;
+    _src_index.clear();
+    _src_frac.clear();
+    if (!cam || !cam->have_disto() || w < 2 || h < 2)
+      return false;
+
+    _width = w;
+    _height = h;
+    _src_index.resize(static_cast<size_t>(w) * h);
+    _src_frac.resize(static_cast<size_t>(w) * h);
+#ifdef OPENMVG_USE_OPENMP
+    #pragma omp parallel for schedule(dynamic)
+#endif
+    for (int j = 0; j < h; ++j)
+    {
+      int * index = &_src_index[static_cast<size_t>(j) * w];
+      unsigned short * frac = &_src_frac[static_cast<size_t>(j) * w];
+      for (int i = 0; i < w; ++i)
+      {
+        // compute coordinates with distortion
+        const Vec2 disto_pix = cam->get_d_pixel(Vec2(i,j));
+        const double x = disto_pix(0), y = disto_pix(1);
+        // same domain test as the one used by UndistortImage (Image::Contains)
+        if (!(x > -1.0 && y > -1.0 && x < w && y < h))
+        {
+          index[i] = -1;
+          frac[i] = 0;
+          continue;
+        }
+        int x0, y0, fx, fy;
+        Quantize(x, w, x0, fx);
+        Quantize(y, h, y0, fy);
+        index[i] = y0 * w + x0;
+        frac[i] = static_cast<unsigned short>(fy * (INTER_TAB_SIZE + 1) + fx);
+      }
+    }
+    return true;
+  }
+
+  /// Linear index of the top-left source pixel of the undistorted pixel (x,y)
+  /// (-1 if the pixel is outside the distorted image domain)
+  const int * index_row(int y) const { return &_src_index[static_cast<size_t>(y) * _width]; }
+  /// Quantized sub-pixel position of the undistorted pixel (x,y)
+  const unsigned short * frac_row(int y) const { return &_src_frac[static_cast<size_t>(y) * _width]; }
+
+  /// Bilinear weights (top-left, top-right, bottom-left, bottom-right)
+  ///  for each quantized sub-pixel position (fixed point version)
+  static const int * IntegerWeights()
+  {
+    static const std::vector<int> table = BuildIntegerWeights();
+    return &table[0];
+  }
+
+  /// Bilinear weights (top-left, top-right, bottom-left, bottom-right)
+  ///  for each quantized sub-pixel position (floating point version)
+  static const float * FloatWeights()
+  {
+    static const std::vector<float> table = BuildFloatWeights();
+    return &table[0];
+  }
+
+private:
+
+  // Split a coordinate in an integer part and a quantized fractional part.
+  // The footprint is shifted at the border in order to always read valid pixels:
+  //  (x0, x0+1) are both in [0, size-1].
+  static void Quantize(double v, int size, int & v0, int & fv)
+  {
+    v0 = static_cast<int>(std::floor(v));
+    fv = static_cast<int>(std::floor((v - v0) * INTER_TAB_SIZE + 0.5));
+    if (fv == INTER_TAB_SIZE) { ++v0; fv = 0; }
+    if (v0 < 0) { v0 = 0; fv = 0; }
+    if (v0 >= size - 1) { v0 = size - 2; fv = INTER_TAB_SIZE; }
+  }
+
+  static std::vector<int> BuildIntegerWeights()
+  {
+    const int n = INTER_TAB_SIZE + 1;
+    std::vector<int> table(n * n * 4);
+    const int scale = 1 << (COEF_BITS - 2 * INTER_BITS);
+    for (int fy = 0; fy < n; ++fy)
+    for (int fx = 0; fx < n; ++fx)
+    {
+      int * w = &table[(fy * n + fx) * 4];
+      w[0] = (INTER_TAB_SIZE - fx) * (INTER_TAB_SIZE - fy) * scale;
+      w[1] = fx * (INTER_TAB_SIZE - fy) * scale;
+      w[2] = (INTER_TAB_SIZE - fx) * fy * scale;
+      w[3] = fx * fy * scale;
+    }
+    return table;
+  }
+
+  static std::vector<float> BuildFloatWeights()
+  {
+    const int n = INTER_TAB_SIZE + 1;
+    std::vector<float> table(n * n * 4);
+    const std::vector<int> integer_table = BuildIntegerWeights();
+    for (size_t i = 0; i < table.size(); ++i)
+      table[i] = integer_table[i] / static_cast<float>(1 << COEF_BITS);
+    return table;
+  }
+
+  int _width, _height;
+  std::vector<int> _src_index;
+  std::vector<unsigned short> _src_frac;
+};
+
+/// Precomputed undistortion maps indexed by intrinsic id
+typedef Hash_Map<IndexT, UndistortionMap> UndistortionMaps;
+
+namespace detail {
+
+/// Describe a pixel type as a fixed number of contiguous channels
+template <typename T>
+struct RemapPixelTraits
+{
+  typedef T channel_type;
+  static const int channels = 1;
+};
+
+template <typename T>
+struct RemapPixelTraits< image::Rgb<T> >
+{
+  typedef T channel_type;
+  static const int channels = 3;
+};
+
+template <typename T>
+struct RemapPixelTraits< image::Rgba<T> >
+{
+  typedef T channel_type;
+  static const int channels = 4;
+};
+
+/// Bilinear interpolation of the channels of one pixel (generic version)
+template <typename T, int C>
+struct BilinearRemapKernel
+{
+  typedef float weight_type;
+  static const weight_type * weights() { return UndistortionMap::FloatWeights(); }
+
+  static inline void apply(
+    const T * top, const T * bottom, const weight_type * w, T * dst)
+  {
+    for (int c = 0; c < C; ++c)
+    {
+      dst[c] = static_cast<T>(
+        w[0] * top[c] + w[1] * top[c + C] + w[2] * bottom[c] + w[3] * bottom[c + C]);
+    }
+  }
+};
+
+/// Bilinear interpolation of the channels of one pixel (8 bits fixed point version)
+template <int C>
+struct BilinearRemapKernel<unsigned char, C>
+{
+  typedef int weight_type;
+  static const weight_type * weights() { return UndistortionMap::IntegerWeights(); }
+
+  static inline void apply(
+    const unsigned char * top, const unsigned char * bottom,
+    const weight_type * w, unsigned char * dst)
+  {
+    const int w0 = w[0], w1 = w[1], w2 = w[2], w3 = w[3];
+    const int round = 1 << (UndistortionMap::COEF_BITS - 1);
+    for (int c = 0; c < C; ++c)
+    {
+      dst[c] = static_cast<unsigned char>(
+        (w0 * top[c] + w1 * top[c + C] + w2 * bottom[c] + w3 * bottom[c + C] + round)
+          >> UndistortionMap::COEF_BITS);
+    }
+  }
+};
+
+} // namespace detail
+
+/**
+* @brief Undistort an image by using a precomputed undistortion map.
+* @param imageIn Input (distorted) image
+* @param map Undistortion map computed for the size of imageIn
+* @param[out] image_ud Undistorted image
+* @param fillcolor Color of the pixels that fall outside the input image domain
+* @return false if the map does not correspond to the image size
+*/
+template <typename Image>
+bool UndistortImage(
+  const Image& imageIn,
+  const UndistortionMap & map,
+  Image & image_ud,
+  typename Image::Tpixel fillcolor = typename Image::Tpixel(0))
+{
+  if (map.empty() ||
+      map.Width() != imageIn.Width() || map.Height() != imageIn.Height())
+    return false;
+
+  typedef typename Image::Tpixel Tpixel;
+  typedef detail::RemapPixelTraits<Tpixel> Traits;
+  typedef typename Traits::channel_type Tchannel;
+  const int C = Traits::channels;
+  typedef detail::BilinearRemapKernel<Tchannel, C> Kernel;
+  const typename Kernel::weight_type * weights = Kernel::weights();
+
+  image_ud.resize(imageIn.Width(), imageIn.Height(), false);
+  const Tchannel * src = reinterpret_cast<const Tchannel*>(imageIn.data());
+  const int src_stride = imageIn.Width() * C;
+#ifdef OPENMVG_USE_OPENMP
+  #pragma omp parallel for
+#endif
+  for (int j = 0; j < imageIn.Height(); ++j)
+  {
+    const int * index = map.index_row(j);
+    const unsigned short * frac = map.frac_row(j);
+    Tpixel * dst_row = &image_ud(j, 0);
+    for (int i = 0; i < imageIn.Width(); ++i)
+    {
+      if (index[i] < 0)
+      {
+        dst_row[i] = fillcolor;
+        continue;
+      }
+      const Tchannel * top = src + static_cast<size_t>(index[i]) * C;
+      Kernel::apply(top, top + src_stride, weights + 4 * frac[i],
+        reinterpret_cast<Tchannel*>(&dst_row[i]));
+    }
+  }
+  return true;
+}
+
 } // namespace cameras
 } // namespace openMVG
 
 #endif // #ifndef OPENMVG_CAMERA_UNDISTORT_IMAGE_HPP
-
@@ -0,0 +1,76 @@
+
+// Copyright (c) 2015 Pierre MOULON.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "openMVG/cameras/cameras.hpp"
+using namespace openMVG;
+using namespace openMVG::cameras;
+using namespace openMVG::image;
+
+#include "testing/testing.h"
+
+//-----------------
+// Test summary:
+//-----------------
+// - Create a Pinhole_Intrinsic_Radial_K3 camera
+// - Undistort a smooth synthetic image with the per pixel sampling method
+//    and with the precomputed undistortion map
+// - Assert that both undistorted images are similar
+//-----------------
+TEST(Cameras_Undistortion, map_vs_sampling) {
+
+  const int w = 200, h = 150;
+  const Pinhole_Intrinsic_Radial_K3 cam(w, h, 180, w/2., h/2.,
+    // K1, K2, K3
+    -0.245539, 0.255195, 0.163773);
+
+  Image<RGBColor> image(w, h);
+  for (int j = 0; j < h; ++j)
+    for (int i = 0; i < w; ++i)
+      image(j, i) = RGBColor(i, j, (i + j) / 2);
+
+  Image<RGBColor> image_sampled, image_remapped;
+  UndistortImage(image, &cam, image_sampled, BLACK);
+
+  UndistortionMap map;
+  EXPECT_TRUE(map.Build(&cam, w, h));
+  EXPECT_TRUE(UndistortImage(image, map, image_remapped, BLACK));
+  EXPECT_EQ(w, image_remapped.Width());
+  EXPECT_EQ(h, image_remapped.Height());
+
+  // Compare the image interior (border pixels use a different interpolation footprint)
+  int max_difference = 0;
+  for (int j = 1; j < h - 1; ++j)
+    for (int i = 1; i < w - 1; ++i)
+      for (int c = 0; c < 3; ++c)
+        max_difference = std::max(max_difference,
+          std::abs(int(image_sampled(j, i)(c)) - int(image_remapped(j, i)(c))));
+  EXPECT_TRUE(max_difference <= 1);
+}
+
+//-----------------
+// Test summary:
+//-----------------
+// - Check that a map can only be used for images of the size it has been built for
+// - Check that no map is built for a camera without distortion
+//-----------------
+TEST(Cameras_Undistortion, map_validity) {
+
+  const Pinhole_Intrinsic_Radial_K1 cam(100, 100, 100, 50, 50, 0.1);
+  UndistortionMap map;
+  EXPECT_TRUE(map.Build(&cam, 100, 100));
+
+  Image<float> image(50, 50, true, 1.f), image_ud;
+  EXPECT_FALSE(UndistortImage(image, map, image_ud));
+
+  const Pinhole_Intrinsic cam_no_disto(100, 100, 100, 50, 50);
+  EXPECT_FALSE(map.Build(&cam_no_disto, 100, 100));
+  EXPECT_TRUE(map.empty());
+}
+
+/* ************************************************************************* */
+int main() { TestResult tr; return TestRegistry::runAllTests(tr);}
+/* ************************************************************************* */
@@ -27,6 +27,18 @@ class Exif_IO
 
     virtual std::string getLensModel() const = 0;
 
+    /** Get the GPS latitude (decimal degrees), return false if not available */
+    virtual bool GPSLatitude(double * latitude) const = 0;
+
+    /** Get the GPS longitude (decimal degrees), return false if not available */
+    virtual bool GPSLongitude(double * longitude) const = 0;
+
+    /** Get the GPS altitude (meters), return false if not available */
+    virtual bool GPSAltitude(double * altitude) const = 0;
+
+    /** Get the GPS image direction (degrees), return false if not available */
+    virtual bool GPSImgDirection(double * direction) const = 0;
+
     /** Open the file for checking and parsing */
     virtual bool open( const std::string & sFileName ) = 0;
 
@@ -103,6 +103,38 @@ class Exif_IO_EasyExif : public Exif_IO
       return "";
     }
 
+    bool GPSLatitude(double * latitude) const
+    {
+      if (exifInfo_.GeoLocation.LatComponents.direction == 0)
+        return false;
+      *latitude = exifInfo_.GeoLocation.Latitude;
+      return true;
+    }
+
+    bool GPSLongitude(double * longitude) const
+    {
+      if (exifInfo_.GeoLocation.LonComponents.direction == 0)
+        return false;
+      *longitude = exifInfo_.GeoLocation.Longitude;
+      return true;
+    }
+
+    bool GPSAltitude(double * altitude) const
+    {
+      if (exifInfo_.GeoLocation.LatComponents.direction == 0)
+        return false;
+      *altitude = exifInfo_.GeoLocation.Altitude;
+      return true;
+    }
+
+    bool GPSImgDirection(double * direction) const
+    {
+      if (exifInfo_.GeoLocation.ImgDirection < 0.0)
+        return false;
+      *direction = exifInfo_.GeoLocation.ImgDirection;
+      return true;
+    }
+
     /**Verify if the file has metadata*/
     bool doesHaveExifInfo() const
     {
@@ -148,7 +180,8 @@ class Exif_IO_EasyExif : public Exif_IO
         <<  exifInfo_.GeoLocation.LonComponents.minutes << ", "
         <<  exifInfo_.GeoLocation.LonComponents.seconds << ", "
         <<  exifInfo_.GeoLocation.LonComponents.direction << ")" << "\n"
-        << "GPS Altitude      : m" << exifInfo_.GeoLocation.Altitude << "\n";
+        << "GPS Altitude      : m" << exifInfo_.GeoLocation.Altitude << "\n"
+        << "GPS Img direction : deg" << exifInfo_.GeoLocation.ImgDirection << "\n";
       return os.str();
     }
 
@@ -106,7 +106,9 @@ void AKAZE::ComputeAKAZESlice( const Image<float> & src , const int p , const in
                         Image<float> & Li , // Diffusion image
                         Image<float> & Lx , // X derivatives
                         Image<float> & Ly , // Y derivatives
-                        Image<float> & Lhess ) // Det(Hessian)
+                        Image<float> & Lhess , // Det(Hessian)
+                        const bool bFusedKernels ,
+                        const bool bSmoothedSrc )
 {
   const float sigma_cur = Sigma( sigma0 , p , q , nbSlice );
   const float ratio = 1 << p; //pow(2,p);
@@ -116,7 +118,10 @@ void AKAZE::ComputeAKAZESlice( const Image<float> & src , const int p , const in
   if( p == 0 && q == 0 )
   {
     // Compute new image
-    ImageGaussianFilter( src , sigma0 , Li, 0, 0) ;
+    if ( bSmoothedSrc )
+      Li = src ;
+    else
+      ImageGaussianFilter( src , sigma0 , Li, 0, 0) ;
   }
   else
   {
@@ -139,17 +144,30 @@ void AKAZE::ComputeAKAZESlice( const Image<float> & src , const int p , const in
     // Compute first derivatives (Scharr scale 1, non normalized) for diffusion coef
     ImageGaussianFilter( in , 1.f , smoothed, 0, 0 ) ;
 
-    ImageScharrXDerivative( smoothed , Lx , false ) ;
-    ImageScharrYDerivative( smoothed , Ly , false ) ;
-
-    // Compute diffusion coefficient
-    Image<float> & diff = smoothed; // diffusivity image (reuse existing memory)
-    ImagePeronaMalikG2DiffusionCoef( Lx , Ly , contrast_factor , diff ) ;
-
-    // Compute FED cycles
+    // Compute FED cycle timings
     std::vector< float > tau ;
     FEDCycleTimings( total_cycle_time , 0.25f , tau ) ;
-    ImageFEDCycle( in , diff , tau ) ;
+
+    if ( bFusedKernels )
+    {
+      // Derivatives + diffusion coefficient in a single pass (Lx is used as storage)
+      Image<float> & diff = Lx;
+      ImagePeronaMalikG2DiffusionCoefScharr( smoothed , contrast_factor , diff ) ;
+      // In place FED steps
+      ImageFEDCycleFused( in , diff , tau ) ;
+    }
+    else
+    {
+      ImageScharrXDerivative( smoothed , Lx , false ) ;
+      ImageScharrYDerivative( smoothed , Ly , false ) ;
+
+      // Compute diffusion coefficient
+      Image<float> & diff = smoothed; // diffusivity image (reuse existing memory)
+      ImagePeronaMalikG2DiffusionCoef( Lx , Ly , contrast_factor , diff ) ;
+
+      // Compute FED cycles
+      ImageFEDCycle( in , diff , tau ) ;
+    }
     Li = in ; // evolution image
   }
 
@@ -164,6 +182,18 @@ void AKAZE::ComputeAKAZESlice( const Image<float> & src , const int p , const in
     ImageGaussianFilter( Li , 1.f , smoothed, 0, 0 );
   }
 
+  if ( bFusedKernels )
+  {
+    // First derivatives, then second derivatives + Det(Hessian) in single passes
+    ImageScaledScharrXYDerivatives( smoothed , Lx , Ly , sigma_scale ) ;
+    ImageScaledScharrHessianDeterminant( Lx , Ly , sigma_scale ,
+      static_cast<float>( sigma_scale * sigma_scale ) , Lhess ) ;
+
+    Lx *= static_cast<float>( sigma_scale ) ;
+    Ly *= static_cast<float>( sigma_scale ) ;
+    return;
+  }
+
   // Compute true first derivatives
   ImageScaledScharrXDerivative( smoothed , Lx , sigma_scale ) ;
   ImageScaledScharrYDerivative( smoothed , Ly , sigma_scale ) ;
@@ -196,7 +226,7 @@ void convert_scale(Image &src)
 
 /// Constructor with input arguments
 AKAZE::AKAZE(const Image<unsigned char> & in, const AKAZEConfig & options):
-    options_(options)
+    options_(options), base_contrast_factor_(0.f)
 {
   in_ = in.GetMat().cast<float>() / 255.f;
   options_.fDesc_factor = std::max(6.f*sqrtf(2.f), options_.fDesc_factor);
@@ -205,11 +235,24 @@ AKAZE::AKAZE(const Image<unsigned char> & in, const AKAZEConfig & options):
   options_.iNbOctave = std::min(options_.iNbOctave, nbOctaveMax);
 }
 
+void AKAZE::Compute_Base_Level(Image<float> & base, float & contrast_factor) const
+{
+  contrast_factor = ComputeAutomaticContrastFactor( in_, 0.7f ) ;
+  ImageGaussianFilter( in_ , options_.fSigma0 , base, 0, 0) ;
+}
+
+void AKAZE::Set_Base_Level(const Image<float> & base, const float contrast_factor)
+{
+  base_ = base;
+  base_contrast_factor_ = contrast_factor;
+}
+
 /// Compute the AKAZE non linear diffusion scale space per slice
 void AKAZE::Compute_AKAZEScaleSpace(void)
 {
-  float contrast_factor = ComputeAutomaticContrastFactor( in_, 0.7f ) ;
-  Image<float> input = in_;
+  const bool bBase = base_.Width() > 0;
+  float contrast_factor = bBase ? base_contrast_factor_ : ComputeAutomaticContrastFactor( in_, 0.7f ) ;
+  Image<float> input = bBase ? base_ : in_;
 
   // Octave computation
   for( int p = 0 ; p < options_.iNbOctave ; ++p )
@@ -222,7 +265,7 @@ void AKAZE::Compute_AKAZEScaleSpace(void)
       TEvolution & evo = evolution_.back();
       // Compute Slice at (p,q) index
       ComputeAKAZESlice( input , p , q , options_.iNbSlicePerOctave , options_.fSigma0 , contrast_factor,
-        evo.cur , evo.Lx , evo.Ly , evo.Lhess );
+        evo.cur , evo.Lx , evo.Ly , evo.Lhess , options_.bFusedKernels , bBase );
 
       // Prepare inputs for next slice
       input = evo.cur;
@@ -265,6 +308,50 @@ void detectDuplicates(
   }
 }
 
+/// Detect the local maxima of the Determinant of Hessian of the (p,q) slice
+static void Detect_Slice_Extrema(
+  const AKAZEConfig & options,
+  const int p, // octave index
+  const int q, // slice index
+  const Image<float> & LDetHess,
+  std::vector< std::pair<AKAZEKeypoint, bool> > & vec_kpts)
+{
+  const float ratio = (float) (1 << p);
+  const float sigma_cur = Sigma( options.fSigma0 , p , q , options.iNbSlicePerOctave ) ;
+
+  // Check that the point is under the image limits for the descriptor computation
+  const float borderLimit =
+    MathTrait<float>::round(options.fDesc_factor*sigma_cur*fderivative_factor/ratio)+1;
+
+  for (int jx = borderLimit; jx < LDetHess.Height()-borderLimit; ++jx)
+  for (int ix = borderLimit; ix < LDetHess.Width()-borderLimit; ++ix) {
+
+    const float value = LDetHess(jx, ix);
+
+    // Filter the points with the detector threshold
+    if (value > options.fThreshold &&
+      value > LDetHess(jx-1, ix) &&
+      value > LDetHess(jx-1, ix+1) &&
+      value > LDetHess(jx-1, ix-1) &&
+      value > LDetHess(jx  , ix-1) &&
+      value > LDetHess(jx  , ix+1) &&
+      value > LDetHess(jx+1, ix-1) &&
+      value > LDetHess(jx+1, ix) &&
+      value > LDetHess(jx+1, ix+1))
+    {
+      AKAZEKeypoint point;
+      point.size = sigma_cur * fderivative_factor ;
+      point.octave = p;
+      point.response = fabs(value);
+      point.x = ix * ratio;
+      point.y = jx * ratio;
+      point.angle = 0.0f;
+      point.class_id = p * options.iNbSlicePerOctave + q;
+      vec_kpts.push_back( std::make_pair(point,false) );
+    }
+  }
+}
+
 void AKAZE::Feature_Detection(std::vector<AKAZEKeypoint>& kpts) const
 {
 #define OPENMVG_REMOVE_DUPLICATES 1
@@ -276,44 +363,10 @@ void AKAZE::Feature_Detection(std::vector<AKAZEKeypoint>& kpts) const
 #endif
   for( int p = 0 ; p < options_.iNbOctave ; ++p )
   {
-    const float ratio = (float) (1 << p);
-
     for( int q = 0 ; q < options_.iNbSlicePerOctave ; ++q )
     {
-      const float sigma_cur = Sigma( options_.fSigma0 , p , q , options_.iNbSlicePerOctave ) ;
-      const Image<float> & LDetHess = evolution_[options_.iNbOctave * p + q].Lhess;
-
-      // Check that the point is under the image limits for the descriptor computation
-      const float borderLimit =
-        MathTrait<float>::round(options_.fDesc_factor*sigma_cur*fderivative_factor/ratio)+1;
-
-      for (int jx = borderLimit; jx < LDetHess.Height()-borderLimit; ++jx)
-      for (int ix = borderLimit; ix < LDetHess.Width()-borderLimit; ++ix) {
-
-        const float value = LDetHess(jx, ix);
-
-        // Filter the points with the detector threshold
-        if (value > options_.fThreshold &&
-          value > LDetHess(jx-1, ix) &&
-          value > LDetHess(jx-1, ix+1) &&
-          value > LDetHess(jx-1, ix-1) &&
-          value > LDetHess(jx  , ix-1) &&
-          value > LDetHess(jx  , ix+1) &&
-          value > LDetHess(jx+1, ix-1) &&
-          value > LDetHess(jx+1, ix) &&
-          value > LDetHess(jx+1, ix+1))
-        {
-          AKAZEKeypoint point;
-          point.size = sigma_cur * fderivative_factor ;
-          point.octave = p;
-          point.response = fabs(value);
-          point.x = ix * ratio;
-          point.y = jx * ratio;
-          point.angle = 0.0f;
-          point.class_id = p * options_.iNbSlicePerOctave + q;
-          vec_kpts_perSlice[options_.iNbOctave * p + q].push_back( std::make_pair(point,false) );
-        }
-      }
+      const int slice_id = options_.iNbSlicePerOctave * p + q;
+      Detect_Slice_Extrema(options_, p, q, evolution_[slice_id].Lhess, vec_kpts_perSlice[slice_id]);
     }
   }
 
@@ -346,7 +399,7 @@ void AKAZE::Feature_Detection(std::vector<AKAZEKeypoint>& kpts) const
     for( int q = 0 ; q < options_.iNbSlicePerOctave ; ++q )
     {
       const float sigma_cur = Sigma( options_.fSigma0 , p , q , options_.iNbSlicePerOctave ) ;
-      const Image<float> & LDetHess = evolution_[options_.iNbOctave * p + q].Lhess;
+      const Image<float> & LDetHess = evolution_[options_.iNbSlicePerOctave * p + q].Lhess;
 
       // Check that the point is under the image limits for the descriptor computation
       const float borderLimit =
@@ -452,6 +505,92 @@ void AKAZE::Feature_Detection(std::vector<AKAZEKeypoint>& kpts) const
 #endif
 }
 
+/// Release the memory of a slice
+static void Clear_Slice(TEvolution & slice)
+{
+  slice.cur.resize(0, 0);
+  slice.Lx.resize(0, 0);
+  slice.Ly.resize(0, 0);
+  slice.Lhess.resize(0, 0);
+}
+
+void AKAZE::Feature_Detection_Streaming(const Slice_Callback & slice_callback) const
+{
+  const bool bBase = base_.Width() > 0;
+  float contrast_factor = bBase ? base_contrast_factor_ : ComputeAutomaticContrastFactor( in_, 0.7f ) ;
+
+  // Refine the keypoints of a slice that are not duplicated and send them to the callback
+  const auto emit_slice = [&](
+    const TEvolution & slice,
+    const std::vector< std::pair<AKAZEKeypoint, bool> > & vec_kp)
+  {
+    std::vector<AKAZEKeypoint> kpts;
+    kpts.reserve(vec_kp.size());
+    for (size_t i = 0; i < vec_kp.size(); ++i)
+      if (!vec_kp[i].second)
+        kpts.push_back(vec_kp[i].first);
+
+    std::vector<char> vec_refined(kpts.size());
+#ifdef OPENMVG_USE_OPENMP
+  #pragma omp parallel for schedule(dynamic)
+#endif
+    for (int i = 0; i < static_cast<int>(kpts.size()); ++i)
+      vec_refined[i] = Do_Subpixel_Refinement(kpts[i], slice.Lhess);
+
+    size_t refined_count = 0;
+    for (size_t i = 0; i < kpts.size(); ++i)
+      if (vec_refined[i])
+        kpts[refined_count++] = kpts[i];
+    kpts.resize(refined_count);
+
+    slice_callback(slice, kpts);
+  };
+
+  // Only the previous and the current slices are in memory
+  TEvolution previous, current;
+  std::vector< std::pair<AKAZEKeypoint, bool> > previous_kpts, current_kpts;
+  bool has_previous = false;
+
+  for( int p = 0 ; p < options_.iNbOctave ; ++p )
+  {
+    contrast_factor *= (p == 0) ? 1.f : 0.75f;
+
+    for( int q = 0 ; q < options_.iNbSlicePerOctave ; ++q )
+    {
+      // Compute Slice at (p,q) index (from the previous slice)
+      ComputeAKAZESlice( has_previous ? previous.cur : (bBase ? base_ : in_) , p , q ,
+        options_.iNbSlicePerOctave , options_.fSigma0 , contrast_factor,
+        current.cur , current.Lx , current.Ly , current.Lhess , options_.bFusedKernels , bBase );
+
+      current_kpts.clear();
+      Detect_Slice_Extrema(options_, p, q, current.Lhess, current_kpts);
+
+      //-- Filter duplicates (same order as Feature_Detection)
+      detectDuplicates(current_kpts, current_kpts);
+      if (has_previous)
+      {
+        detectDuplicates(previous_kpts, current_kpts);
+        // The previous slice keypoints are now final
+        emit_slice(previous, previous_kpts);
+      }
+
+      // The current slice becomes the previous one (swap to reuse the memory)
+      previous.cur.swap(current.cur);
+      previous.Lx.swap(current.Lx);
+      previous.Ly.swap(current.Ly);
+      previous.Lhess.swap(current.Lhess);
+      previous_kpts.swap(current_kpts);
+      has_previous = true;
+
+      // The next octave slices are smaller: release the buffers
+      if (q == options_.iNbSlicePerOctave - 1)
+        Clear_Slice(current);
+    }
+  }
+  if (has_previous)
+    emit_slice(previous, previous_kpts);
+}
+
 /// This method performs sub pixel refinement of a keypoint
 bool AKAZE::Do_Subpixel_Refinement( AKAZEKeypoint & kpt, const Image<float> & Ldet) const
 {
@@ -41,6 +41,8 @@
 
 #include <cereal/cereal.hpp>
 
+#include <functional>
+
 namespace openMVG {
 namespace features {
 
@@ -51,7 +53,8 @@ struct AKAZEConfig
     iNbSlicePerOctave(4),
     fSigma0(1.6f),
     fThreshold(0.0008f),
-    fDesc_factor(1.f)
+    fDesc_factor(1.f),
+    bFusedKernels(true)
   {
   }
 
@@ -71,6 +74,7 @@ struct AKAZEConfig
   float fSigma0; ///< Initial sigma offset (used to suppress low level noise)
   float fThreshold;  ///< Hessian determinant threshold
   float fDesc_factor;   ///< Magnifier used to describe an interest point
+  bool bFusedKernels; ///< Use the fused single pass image kernels (runtime only: not serialized)
 };
 
 struct AKAZEKeypoint{
@@ -109,18 +113,41 @@ private:
   AKAZEConfig options_;               ///< Configuration options for AKAZE
   std::vector<TEvolution> evolution_;	///< Vector of nonlinear diffusion evolution (Scale Space)
   image::Image<float> in_;            ///< Input image
+  image::Image<float> base_;          ///< Precomputed base level (optional)
+  float base_contrast_factor_;        ///< Contrast factor of the precomputed base level
 
 public:
 
   /// Constructor
   AKAZE(const image::Image<unsigned char> & in, const AKAZEConfig & options);
 
+  /// Compute the base level of the scale space (the input image smoothed at fSigma0,
+  ///  i.e. the diffusion image of the first slice) and the first octave contrast factor
+  void Compute_Base_Level(image::Image<float> & base, float & contrast_factor) const;
+
+  /// Use a precomputed base level and contrast factor (see Compute_Base_Level), e.g. cached
+  ///  ones: the initial smoothing and the contrast factor computation are skipped
+  void Set_Base_Level(const image::Image<float> & base, const float contrast_factor);
+
   /// Compute the AKAZE non linear diffusion scale space per slice
   void Compute_AKAZEScaleSpace(void);
 
   /// Detect AKAZE feature in the AKAZE scale space
   void Feature_Detection(std::vector<AKAZEKeypoint>& kpts) const;
 
+  /// Callback receiving a slice and its detected (and refined) keypoints
+  typedef std::function<void(const TEvolution &, const std::vector<AKAZEKeypoint> &)> Slice_Callback;
+
+  /// Low memory scale space computation and feature detection (streaming mode)
+  /// The slices are computed one after the other and only two of them (the previous
+  ///  and the current ones) are kept in memory instead of the whole scale space.
+  /// When the keypoints of a slice can no longer be marked as duplicates (i.e. once
+  ///  the next slice is detected), they are refined and given with their slice to
+  ///  the callback (to compute their orientations and descriptors), then the slice is released.
+  /// The detected keypoints are the same as the ones of
+  ///  Compute_AKAZEScaleSpace + Feature_Detection + Do_Subpixel_Refinement.
+  void Feature_Detection_Streaming(const Slice_Callback & slice_callback) const;
+
   /// Sub pixel refinement of the detected keypoints
   void Do_Subpixel_Refinement(std::vector<AKAZEKeypoint>& kpts) const;
 
@@ -153,7 +180,9 @@ public:
     image::Image<float> & Li, // Diffusion image
     image::Image<float> & Lx, // X derivatives
     image::Image<float> & Ly, // Y derivatives
-    image::Image<float> & Lhess // Det(Hessian)
+    image::Image<float> & Lhess, // Det(Hessian)
+    const bool bFusedKernels = true, // Use the fused single pass image kernels
+    const bool bSmoothedSrc = false // The first slice src is already smoothed at sigma0
     );
 
   /// Compute Contrast Factor
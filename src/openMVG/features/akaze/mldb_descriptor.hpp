@@ -12,6 +12,9 @@
 #include "openMVG/image/image.hpp"
 #include "openMVG/numeric/math_trait.hpp"
 
+#include <algorithm>
+#include <cstdint>
+
 namespace openMVG {
 namespace features {
 
@@ -131,38 +134,38 @@ namespace features {
   }
 
   /**
-    ** @brief Compute final keypoint (ie interest point + description) for a given interest point
+    ** @brief Sample the (2 pattern_size + 1)^2 oriented pattern of an interest point
     ** @param Li Input Octave slice
     ** @param Lx Input X-derivative
     ** @param Ly Input Y-derivative
     ** @param id_octave Id of current octave
     ** @param ipt Input interest point
-    ** @param desc output descriptor (binary descriptor)
+    ** @param pattern_size Half size of the pattern
+    ** @param samples_Li output samples of Li
+    ** @param samples_Lx output samples of Lx
+    ** @param samples_Ly output samples of Ly
     **/
-  template< typename Real>
-  void ComputeMLDBDescriptor(
+  template< typename Real , typename SampleMatrix >
+  static inline void SampleMLDBPattern(
     const image::Image<Real> & Li,
     const image::Image<Real> &Lx,
     const image::Image<Real> &Ly,
     const int id_octave ,
     const SIOPointFeature & ipt ,
-    Descriptor<bool, 486> & desc )
+    const int pattern_size ,
+    SampleMatrix & samples_Li ,
+    SampleMatrix & samples_Lx ,
+    SampleMatrix & samples_Ly )
   {
-    // // Note : in KAZE description we compute descriptor of previous slice and never the current one
-
-    // See if it's necessary to change this value (pass it into a param ?)
-    const int pattern_size = 10 ;
-
     // Sampling size according to the scale value
     const Real inv_octave_scale = static_cast<Real>( 1 ) / static_cast<Real>( 1 << id_octave ) ;
     const Real sigma_scale = MathTrait<Real>::round( ipt.scale() * inv_octave_scale ) ;
 
     // Get every samples inside 2pattern x 2pattern square region
     // Memory efficient (get samples then work in aligned)
-    Eigen::Matrix<Real, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
-      samples_Li( 2 * pattern_size + 1 , 2 * pattern_size + 1 ),
-      samples_Lx( 2 * pattern_size + 1 , 2 * pattern_size + 1 ),
-      samples_Ly( 2 * pattern_size + 1 , 2 * pattern_size + 1 );
+    samples_Li.resize( 2 * pattern_size + 1 , 2 * pattern_size + 1 ) ;
+    samples_Lx.resize( 2 * pattern_size + 1 , 2 * pattern_size + 1 ) ;
+    samples_Ly.resize( 2 * pattern_size + 1 , 2 * pattern_size + 1 ) ;
 
     // Compute cos and sin values for this point orientation
     const Real c = MathTrait<Real>::cos( ipt.orientation() ) ;
@@ -188,14 +191,46 @@ namespace features {
         const Real dy = cur_y + sigma_scale * delta_y ;
 
         // Compute new discrete position
-        const int y = MathTrait<Real>::round( dy ) ;
-        const int x = MathTrait<Real>::round( dx ) ;
+        // (same as MathTrait<Real>::round for the positions inside the image, without libm calls)
+        const int y = static_cast<int>( dy + static_cast<Real>( 0.5 ) ) ;
+        const int x = static_cast<int>( dx + static_cast<Real>( 0.5 ) ) ;
 
         samples_Li( i + pattern_size , j + pattern_size ) = Li( y , x ) ;
         samples_Lx( i + pattern_size , j + pattern_size ) = Lx( y , x ) ;
         samples_Ly( i + pattern_size , j + pattern_size ) = Ly( y , x ) ;
       }
     }
+  }
+
+  /**
+    ** @brief Compute final keypoint (ie interest point + description) for a given interest point
+    ** @param Li Input Octave slice
+    ** @param Lx Input X-derivative
+    ** @param Ly Input Y-derivative
+    ** @param id_octave Id of current octave
+    ** @param ipt Input interest point
+    ** @param desc output descriptor (binary descriptor)
+    **/
+  template< typename Real>
+  void ComputeMLDBDescriptor(
+    const image::Image<Real> & Li,
+    const image::Image<Real> &Lx,
+    const image::Image<Real> &Ly,
+    const int id_octave ,
+    const SIOPointFeature & ipt ,
+    Descriptor<bool, 486> & desc )
+  {
+    // // Note : in KAZE description we compute descriptor of previous slice and never the current one
+
+    // See if it's necessary to change this value (pass it into a param ?)
+    const int pattern_size = 10 ;
+
+    Eigen::Matrix<Real, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> samples_Li, samples_Lx, samples_Ly ;
+    SampleMLDBPattern( Li , Lx , Ly , id_octave , ipt , pattern_size , samples_Li , samples_Lx , samples_Ly ) ;
+
+    // Compute cos and sin values for this point orientation
+    const Real c = MathTrait<Real>::cos( ipt.orientation() ) ;
+    const Real s = MathTrait<Real>::sin( ipt.orientation() ) ;
 
     size_t outIndex = 0 ; // Index to store next binary value
 
@@ -218,6 +253,117 @@ namespace features {
     assert( outIndex == 486 ) ; // Just to be sure (and we are sure ! completly sure !)
   }
 
+  /**
+    ** @brief Compute the MLDB descriptor of an interest point directly as 64-bit words
+    **  (bit k of the descriptor is the bit k % 64 of the word k / 64, the 26 last bits are 0).
+    ** The derivatives are rotated once per sample, the means of the three grids
+    **  (2x2, 3x3, 4x4) are read from a single integral image of the samples and the
+    **  comparison bits are written straight into the words.
+    ** Same bits as the Descriptor<bool, 486> version, except that the subdivision sums are
+    **  accumulated in double precision (a comparison of two equal means may differ).
+    ** @param Li Input Octave slice
+    ** @param Lx Input X-derivative
+    ** @param Ly Input Y-derivative
+    ** @param id_octave Id of current octave
+    ** @param ipt Input interest point
+    ** @param desc output descriptor (486 bits packed in 64-bit words)
+    **/
+  template< typename Real>
+  void ComputeMLDBDescriptor(
+    const image::Image<Real> & Li,
+    const image::Image<Real> &Lx,
+    const image::Image<Real> &Ly,
+    const int id_octave ,
+    const SIOPointFeature & ipt ,
+    Descriptor<uint64_t, 8> & desc )
+  {
+    const int pattern_size = 10 ;
+    const int sample_count = 2 * pattern_size + 1 ;
+
+    Eigen::Matrix<Real, sample_count, sample_count, Eigen::RowMajor> samples_Li, samples_Lx, samples_Ly ;
+    SampleMLDBPattern( Li , Lx , Ly , id_octave , ipt , pattern_size , samples_Li , samples_Lx , samples_Ly ) ;
+
+    const Real c = MathTrait<Real>::cos( ipt.orientation() ) ;
+    const Real s = MathTrait<Real>::sin( ipt.orientation() ) ;
+
+    // Integral images of Li and of the rotated derivatives (see ComputeMeanValuesInSubdivisions)
+    Eigen::Matrix<double, sample_count + 1, sample_count + 1, Eigen::RowMajor> integral_Li, integral_Lx, integral_Ly ;
+    integral_Li.row( 0 ).setZero() ; integral_Lx.row( 0 ).setZero() ; integral_Ly.row( 0 ).setZero() ;
+    for( int i = 0 ; i < sample_count ; ++i )
+    {
+      double row_Li = 0.0 , row_Lx = 0.0 , row_Ly = 0.0 ;
+      integral_Li( i + 1 , 0 ) = integral_Lx( i + 1 , 0 ) = integral_Ly( i + 1 , 0 ) = 0.0 ;
+      for( int j = 0 ; j < sample_count ; ++j )
+      {
+        const Real dx = samples_Lx( i , j ) ;
+        const Real dy = samples_Ly( i , j ) ;
+        row_Li += samples_Li( i , j ) ;
+        row_Ly += static_cast<Real>( dx * c + dy * s ) ;
+        row_Lx += static_cast<Real>( dy * c - dx * s ) ;
+        integral_Li( i + 1 , j + 1 ) = integral_Li( i , j + 1 ) + row_Li ;
+        integral_Lx( i + 1 , j + 1 ) = integral_Lx( i , j + 1 ) + row_Lx ;
+        integral_Ly( i + 1 , j + 1 ) = integral_Ly( i , j + 1 ) + row_Ly ;
+      }
+    }
+
+    // The bits are accumulated in a word that is stored once complete
+    int outIndex = 0 ; // Index of the next binary value
+    uint64_t word = 0 ;
+    const auto push_bit = [&]( const bool bit )
+    {
+      word |= uint64_t( bit ) << ( outIndex & 63 ) ;
+      if( ( ++outIndex & 63 ) == 0 )
+      {
+        desc[ ( outIndex >> 6 ) - 1 ] = word ;
+        word = 0 ;
+      }
+    } ;
+
+    // Grids of 2x2, 3x3 and 4x4 subdivisions
+    const int nb_subdivs[ 3 ] = { 2 , 3 , 4 } ;
+    const int subdiv_sizes[ 3 ] =
+    { pattern_size , ( 2 * pattern_size + 2 ) / 3 , pattern_size / 2 } ;
+    double mean_Li[ 16 ] , mean_Lx[ 16 ] , mean_Ly[ 16 ] ;
+    for( int grid = 0 ; grid < 3 ; ++grid )
+    {
+      const int nb_subdiv = nb_subdivs[ grid ] ;
+      const int subdiv_size = subdiv_sizes[ grid ] ;
+      for( int i = 0 ; i < nb_subdiv ; ++i )
+      {
+        for( int j = 0 ; j < nb_subdiv ; ++j )
+        {
+          const int min_x = j * subdiv_size ;
+          const int min_y = i * subdiv_size ;
+          const int max_x = std::min( ( j + 1 ) * subdiv_size , sample_count ) ;
+          const int max_y = std::min( ( i + 1 ) * subdiv_size , sample_count ) ;
+          const double inv_nb_elt = 1.0 / ( ( max_x - min_x ) * ( max_y - min_y ) ) ;
+          const int cell = i * nb_subdiv + j ;
+          mean_Li[ cell ] = ( integral_Li( max_y , max_x ) - integral_Li( min_y , max_x )
+            - integral_Li( max_y , min_x ) + integral_Li( min_y , min_x ) ) * inv_nb_elt ;
+          mean_Lx[ cell ] = ( integral_Lx( max_y , max_x ) - integral_Lx( min_y , max_x )
+            - integral_Lx( max_y , min_x ) + integral_Lx( min_y , min_x ) ) * inv_nb_elt ;
+          mean_Ly[ cell ] = ( integral_Ly( max_y , max_x ) - integral_Ly( min_y , max_x )
+            - integral_Ly( max_y , min_x ) + integral_Ly( min_y , min_x ) ) * inv_nb_elt ;
+        }
+      }
+
+      // Binary comparisons (same order as ComputeBinaryValues)
+      const int nb_cells = nb_subdiv * nb_subdiv ;
+      for( int src = 0 ; src < nb_cells ; ++src )
+      {
+        for( int dst = src + 1 ; dst < nb_cells ; ++dst )
+        {
+          push_bit( mean_Li[ src ] > mean_Li[ dst ] ) ;
+          push_bit( mean_Lx[ src ] > mean_Lx[ dst ] ) ;
+          push_bit( mean_Ly[ src ] > mean_Ly[ dst ] ) ;
+        }
+      }
+    }
+
+    assert( outIndex == 486 ) ;
+    desc[ 7 ] = word ; // the last 26 bits are 0
+  }
+
 } // namespace features
 } // namespace openMVG
 
@@ -0,0 +1,227 @@
+
+// Copyright (c) 2015 Pierre MOULON.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "openMVG/features/akaze/AKAZE.hpp"
+#include "openMVG/features/image_describer_akaze.hpp"
+#include "testing/testing.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace openMVG;
+using namespace openMVG::image;
+using namespace openMVG::features;
+
+// Synthetic image made of gaussian blobs of various sizes
+static Image<unsigned char> BlobImage(const int width, const int height)
+{
+  Image<float> ima(width, height, true, 0.f);
+  for (int k = 0; k < 60; ++k)
+  {
+    const float cx = (k * 7919) % width;
+    const float cy = (k * 104729) % height;
+    const float sigma = 1.5f + (k % 7) * 1.5f;
+    for (int y = 0; y < height; ++y)
+    for (int x = 0; x < width; ++x)
+    {
+      const float d2 = (x - cx) * (x - cx) + (y - cy) * (y - cy);
+      ima(y, x) += ((k % 2) ? 1.f : 0.6f) * exp(-d2 / (2.f * sigma * sigma));
+    }
+  }
+  Image<unsigned char> out(width, height);
+  for (int y = 0; y < height; ++y)
+  for (int x = 0; x < width; ++x)
+    out(y, x) = static_cast<unsigned char>(std::min(1.f, ima(y, x)) * 255.f);
+  return out;
+}
+
+static bool KeypointLess(const AKAZEKeypoint & a, const AKAZEKeypoint & b)
+{
+  if (a.class_id != b.class_id) return a.class_id < b.class_id;
+  if (a.y != b.y) return a.y < b.y;
+  return a.x < b.x;
+}
+
+TEST(AKAZE, StreamingSameAsFullScaleSpace)
+{
+  const Image<unsigned char> image = BlobImage(320, 240);
+  AKAZEConfig options;
+  options.fThreshold /= 10.f;
+  options.iNbOctave = 3; // != iNbSlicePerOctave
+
+  // Reference: the whole scale space is computed then the features are detected
+  AKAZE akaze(image, options);
+  akaze.Compute_AKAZEScaleSpace();
+  std::vector<AKAZEKeypoint> kpts;
+  akaze.Feature_Detection(kpts);
+  akaze.Do_Subpixel_Refinement(kpts);
+  EXPECT_TRUE(kpts.size() > 20);
+
+  // Streaming: the slices are computed and released one after the other
+  AKAZE akaze_streaming(image, options);
+  std::vector<AKAZEKeypoint> streamed_kpts;
+  size_t slice_count = 0;
+  akaze_streaming.Feature_Detection_Streaming(
+    [&](const TEvolution & slice, const std::vector<AKAZEKeypoint> & slice_kpts)
+    {
+      // The given slice is the one of the keypoints
+      for (size_t i = 0; i < slice_kpts.size(); ++i)
+      {
+        EXPECT_EQ(slice_count, slice_kpts[i].class_id);
+        EXPECT_EQ(akaze.getSlices()[slice_count].Lx.Width(), slice.Lx.Width());
+      }
+      streamed_kpts.insert(streamed_kpts.end(), slice_kpts.begin(), slice_kpts.end());
+      ++slice_count;
+    });
+  EXPECT_TRUE(akaze_streaming.getSlices().empty());
+  EXPECT_EQ(akaze.getSlices().size(), slice_count);
+
+  std::sort(kpts.begin(), kpts.end(), KeypointLess);
+  std::sort(streamed_kpts.begin(), streamed_kpts.end(), KeypointLess);
+  EXPECT_EQ(kpts.size(), streamed_kpts.size());
+  for (size_t i = 0; i < std::min(kpts.size(), streamed_kpts.size()); ++i)
+  {
+    EXPECT_EQ(kpts[i].x, streamed_kpts[i].x);
+    EXPECT_EQ(kpts[i].y, streamed_kpts[i].y);
+    EXPECT_EQ(kpts[i].size, streamed_kpts[i].size);
+    EXPECT_EQ(kpts[i].response, streamed_kpts[i].response);
+  }
+}
+
+TEST(AKAZE, FusedKernelsSameAsSeparableFilters)
+{
+  const Image<unsigned char> image = BlobImage(320, 240);
+  AKAZEConfig options;
+  options.fThreshold /= 10.f;
+
+  std::vector<AKAZEKeypoint> kpts[2];
+  for (int i = 0; i < 2; ++i)
+  {
+    options.bFusedKernels = (i == 1);
+    AKAZE akaze(image, options);
+    akaze.Compute_AKAZEScaleSpace();
+    akaze.Feature_Detection(kpts[i]);
+    akaze.Do_Subpixel_Refinement(kpts[i]);
+    std::sort(kpts[i].begin(), kpts[i].end(), KeypointLess);
+  }
+  EXPECT_TRUE(kpts[0].size() > 20);
+  EXPECT_EQ(kpts[0].size(), kpts[1].size());
+  for (size_t i = 0; i < std::min(kpts[0].size(), kpts[1].size()); ++i)
+  {
+    EXPECT_EQ(kpts[0][i].class_id, kpts[1][i].class_id);
+    EXPECT_NEAR(kpts[0][i].x, kpts[1][i].x, 1e-3);
+    EXPECT_NEAR(kpts[0][i].y, kpts[1][i].y, 1e-3);
+    EXPECT_NEAR(kpts[0][i].response, kpts[1][i].response, 1e-3 * kpts[0][i].response);
+  }
+}
+
+TEST(AKAZE, FeatureBudget)
+{
+  const Image<unsigned char> image = BlobImage(320, 240);
+  AKAZEConfig options;
+  options.fThreshold /= 10.f;
+  AKAZE_Image_describer describer(AKAZEParams(options, AKAZE_MSURF));
+
+  std::unique_ptr<Regions> all_regions;
+  describer.Describe(image, all_regions);
+  const AKAZE_Float_Regions * all =
+    dynamic_cast<AKAZE_Float_Regions*>(all_regions.get());
+  EXPECT_TRUE(all->RegionCount() > 40);
+
+  // The kept regions are described as without budget
+  const size_t budget = all->RegionCount() / 2;
+  const EFEATURE_SELECTION selections[3] =
+    {FEATURE_SELECTION_RESPONSE, FEATURE_SELECTION_GRID, FEATURE_SELECTION_ANMS};
+  for (int s = 0; s < 3; ++s)
+  {
+    describer.Set_feature_budget(budget, selections[s]);
+    std::unique_ptr<Regions> regions;
+    describer.Describe(image, regions);
+    const AKAZE_Float_Regions * kept = dynamic_cast<AKAZE_Float_Regions*>(regions.get());
+    EXPECT_EQ(budget, kept->RegionCount());
+    for (size_t i = 0; i < kept->RegionCount(); ++i)
+    {
+      bool bFound = false;
+      for (size_t j = 0; j < all->RegionCount() && !bFound; ++j)
+        bFound = kept->Features()[i] == all->Features()[j] &&
+          std::equal(kept->Descriptors()[i].getData(), kept->Descriptors()[i].getData() + 64,
+            all->Descriptors()[j].getData());
+      EXPECT_TRUE(bFound);
+    }
+  }
+}
+
+TEST(AKAZE, PyramidCacheSameRegions)
+{
+  const Image<unsigned char> image = BlobImage(320, 240);
+  AKAZEConfig options;
+  options.fThreshold /= 10.f;
+  AKAZE_Image_describer describer(AKAZEParams(options, AKAZE_MSURF));
+
+  std::unique_ptr<Regions> ref_regions;
+  describer.Describe(image, ref_regions);
+  const AKAZE_Float_Regions * ref = dynamic_cast<AKAZE_Float_Regions*>(ref_regions.get());
+
+  // First run: the base level is computed and cached, second run: it is read from the cache.
+  // Same regions with the whole scale space (feature budget) or in streaming mode.
+  std::shared_ptr<Image_Pyramid_Cache> cache = std::make_shared<Image_Pyramid_Cache>(size_t(1) << 24);
+  describer.Set_pyramid_cache(cache);
+  for (int run = 0; run < 4; ++run)
+  {
+    describer.Set_feature_budget(run < 2 ? 0 : ref->RegionCount());
+    std::unique_ptr<Regions> regions;
+    describer.Describe(image, regions);
+    const AKAZE_Float_Regions * cached = dynamic_cast<AKAZE_Float_Regions*>(regions.get());
+    EXPECT_EQ(ref->RegionCount(), cached->RegionCount());
+    if (run < 2)
+    {
+      for (size_t i = 0; i < std::min(ref->RegionCount(), cached->RegionCount()); ++i)
+      {
+        EXPECT_TRUE(ref->Features()[i] == cached->Features()[i]);
+        EXPECT_TRUE(std::equal(ref->Descriptors()[i].getData(), ref->Descriptors()[i].getData() + 64,
+          cached->Descriptors()[i].getData()));
+      }
+    }
+  }
+  EXPECT_EQ(size_t(2 * 3), cache->Get_statistics().memory_hits); // base level and contrast factor
+  EXPECT_EQ(size_t(1), cache->Get_statistics().misses);
+}
+
+TEST(AKAZE, MLDBPackedSameAsBoolDescriptor)
+{
+  Image<float> Li(80, 60), Lx(80, 60), Ly(80, 60);
+  for (int y = 0; y < Li.Height(); ++y)
+  for (int x = 0; x < Li.Width(); ++x)
+  {
+    Li(y, x) = rand() / float(RAND_MAX);
+    Lx(y, x) = rand() / float(RAND_MAX) - 0.5f;
+    Ly(y, x) = rand() / float(RAND_MAX) - 0.5f;
+  }
+
+  size_t different_bits = 0;
+  for (int k = 0; k < 50; ++k)
+  {
+    // Octave 1 points (the pattern is sampled at half resolution)
+    const SIOPointFeature pt(2.f * (25 + k % 30), 2.f * (20 + (k * 7) % 20),
+      2.f * (1.f + (k % 2) * 0.4f), k * 0.37f);
+
+    Descriptor<bool, 486> desc_bool;
+    ComputeMLDBDescriptor(Li, Lx, Ly, 1, pt, desc_bool);
+    Descriptor<uint64_t, 8> desc_words;
+    ComputeMLDBDescriptor(Li, Lx, Ly, 1, pt, desc_words);
+
+    for (int i = 0; i < 486; ++i)
+      different_bits += desc_bool[i] != (((desc_words[i / 64] >> (i % 64)) & 1) != 0);
+    EXPECT_EQ(uint64_t(0), desc_words[7] >> (486 - 448)); // unused bits
+  }
+  // Only a comparison of two (nearly) equal means can differ (rounding)
+  EXPECT_TRUE(different_bits <= 2);
+}
+
+/* ************************************************************************* */
+int main() { TestResult tr; return TestRegistry::runAllTests(tr);}
+/* ************************************************************************* */
@@ -188,6 +188,18 @@ static bool loadDescsFromBinFile(
   return bOk;
 }
 
+/// Read the number of descriptors of a binary file (without loading them)
+/// Return false if the file cannot be read
+inline bool countDescsInBinFile(
+  const std::string & sfileNameDescs,
+  std::size_t & cardDesc)
+{
+  std::ifstream fileIn(sfileNameDescs.c_str(), std::ios::in | std::ios::binary);
+  cardDesc = 0;
+  fileIn.read((char*) &cardDesc,  sizeof(std::size_t));
+  return fileIn.good();
+}
+
 /// Write descriptors to file (in binary mode)
 template<typename DescriptorsT >
 static bool saveDescsToBinFile(
@@ -0,0 +1,213 @@
+
+// Copyright (c) 2015 Pierre MOULON.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef OPENMVG_FEATURES_FEATURE_SELECTION_HPP
+#define OPENMVG_FEATURES_FEATURE_SELECTION_HPP
+
+#include "openMVG/features/feature.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace openMVG {
+namespace features {
+
+// Bibliography:
+// [1] M. Brown, R. Szeliski, S. Winder.
+// Multi-image matching using multi-scale oriented patches. CVPR2005.
+
+/// How the features are chosen when their count is limited
+enum EFEATURE_SELECTION
+{
+  FEATURE_SELECTION_RESPONSE, // Strongest responses
+  FEATURE_SELECTION_GRID,     // Strongest responses per cell of a regular grid
+  FEATURE_SELECTION_ANMS      // Adaptive non-maximal suppression [1]
+};
+
+/// Index of the features sorted by decreasing response (ties: increasing index)
+inline std::vector<size_t> SortByResponse(const std::vector<float> & responses)
+{
+  std::vector<size_t> order(responses.size());
+  for (size_t i = 0; i < order.size(); ++i)
+    order[i] = i;
+  std::sort(order.begin(), order.end(),
+    [&](const size_t a, const size_t b)
+    { return responses[a] > responses[b] || (responses[a] == responses[b] && a < b); });
+  return order;
+}
+
+/// Grid bucketing: the features are ranked by their response inside their cell,
+///  then all the best features of the cells are kept first, then the second ones...
+inline std::vector<size_t> SelectFeatures_Grid
+(
+  const std::vector<PointFeature> & points,
+  const std::vector<float> & responses,
+  const int width,
+  const int height,
+  const size_t max_count
+)
+{
+  // About 4 features per cell if they were uniformly distributed
+  const double cell_count = std::max(1.0, max_count / 4.0);
+  const double cell_size = std::max(1.0, std::sqrt(double(width) * height / cell_count));
+  const int grid_width = std::max(1, static_cast<int>(std::ceil(width / cell_size)));
+  const int grid_height = std::max(1, static_cast<int>(std::ceil(height / cell_size)));
+
+  const std::vector<size_t> order = SortByResponse(responses);
+  std::vector<size_t> cell_fill(grid_width * grid_height, 0);
+  std::vector<std::pair<size_t, size_t> > rank_index(order.size()); // (rank in the cell, order)
+  for (size_t i = 0; i < order.size(); ++i)
+  {
+    const PointFeature & pt = points[order[i]];
+    const int cx = std::min(grid_width - 1, std::max(0, static_cast<int>(pt.x() / cell_size)));
+    const int cy = std::min(grid_height - 1, std::max(0, static_cast<int>(pt.y() / cell_size)));
+    rank_index[i] = std::make_pair(cell_fill[cy * grid_width + cx]++, i);
+  }
+  std::sort(rank_index.begin(), rank_index.end());
+
+  std::vector<size_t> kept;
+  kept.reserve(max_count);
+  for (size_t i = 0; i < rank_index.size() && kept.size() < max_count; ++i)
+    kept.push_back(order[rank_index[i].second]);
+  return kept;
+}
+
+/// Adaptive non-maximal suppression [1]:
+///  the suppression radius of a feature is its distance to the nearest feature with a
+///  significantly stronger response (response * robust_coef > own response),
+///  the features with the largest radii are kept.
+/// The stronger features are indexed in a regular grid as soon as they are significant
+///  for the current feature (decreasing response order): the nearest one is searched
+///  in rings of cells around the feature.
+inline std::vector<size_t> SelectFeatures_ANMS
+(
+  const std::vector<PointFeature> & points,
+  const std::vector<float> & responses,
+  const int width,
+  const int height,
+  const size_t max_count,
+  const float robust_coef = 0.9f
+)
+{
+  const std::vector<size_t> order = SortByResponse(responses);
+
+  // About one feature per cell
+  const double cell_size = std::max(1.0, std::sqrt(double(width) * height / std::max(size_t(1), order.size())));
+  const int grid_width = std::max(1, static_cast<int>(std::ceil(width / cell_size)));
+  const int grid_height = std::max(1, static_cast<int>(std::ceil(height / cell_size)));
+  std::vector<std::vector<size_t> > grid(grid_width * grid_height);
+  const auto cell_x = [&](const float x)
+    { return std::min(grid_width - 1, std::max(0, static_cast<int>(x / cell_size))); };
+  const auto cell_y = [&](const float y)
+    { return std::min(grid_height - 1, std::max(0, static_cast<int>(y / cell_size))); };
+
+  std::vector<std::pair<double, size_t> > radius_order(order.size()); // (-squared radius, order)
+  size_t inserted = 0;
+  for (size_t i = 0; i < order.size(); ++i)
+  {
+    const PointFeature & pt = points[order[i]];
+    // Index the features that are significantly stronger than the current one
+    while (inserted < i && responses[order[inserted]] * robust_coef > responses[order[i]])
+    {
+      const PointFeature & pt_inserted = points[order[inserted]];
+      grid[cell_y(pt_inserted.y()) * grid_width + cell_x(pt_inserted.x())].push_back(order[inserted]);
+      ++inserted;
+    }
+
+    double best_d2 = std::numeric_limits<double>::infinity();
+    if (inserted > 0)
+    {
+      const int cx = cell_x(pt.x()), cy = cell_y(pt.y());
+      const int max_ring = std::max(grid_width, grid_height);
+      for (int ring = 0; ring <= max_ring; ++ring)
+      {
+        // The features of the next rings are at least at ring * cell_size
+        const double ring_distance = ring > 0 ? (ring - 1) * cell_size : 0.0;
+        if (best_d2 <= ring_distance * ring_distance)
+          break;
+        for (int y = cy - ring; y <= cy + ring; ++y)
+        {
+          if (y < 0 || y >= grid_height)
+            continue;
+          const int step = (y == cy - ring || y == cy + ring) ? 1 : 2 * ring;
+          for (int x = cx - ring; x <= cx + ring; x += std::max(step, 1))
+          {
+            if (x < 0 || x >= grid_width)
+              continue;
+            const std::vector<size_t> & cell = grid[y * grid_width + x];
+            for (size_t k = 0; k < cell.size(); ++k)
+            {
+              const double d2 = (points[cell[k]].coords() - pt.coords()).cast<double>().squaredNorm();
+              best_d2 = std::min(best_d2, d2);
+            }
+          }
+        }
+      }
+    }
+    radius_order[i] = std::make_pair(-best_d2, i);
+  }
+  std::sort(radius_order.begin(), radius_order.end());
+
+  std::vector<size_t> kept;
+  kept.reserve(std::min(max_count, order.size()));
+  for (size_t i = 0; i < radius_order.size() && kept.size() < max_count; ++i)
+    kept.push_back(order[radius_order[i].second]);
+  return kept;
+}
+
+/**
+ * @brief Select at most max_count features
+ * @param points Feature positions
+ * @param responses Feature detector responses (the higher the better)
+ * @param width Image width
+ * @param height Image height
+ * @param max_count Maximal number of kept features (0: no limit)
+ * @param selection Selection method
+ * @return The indexes of the kept features (in increasing order)
+ */
+inline std::vector<size_t> SelectFeatures
+(
+  const std::vector<PointFeature> & points,
+  const std::vector<float> & responses,
+  const int width,
+  const int height,
+  const size_t max_count,
+  const EFEATURE_SELECTION selection = FEATURE_SELECTION_RESPONSE
+)
+{
+  std::vector<size_t> kept;
+  if (max_count == 0 || points.size() <= max_count)
+  {
+    kept.resize(points.size());
+    for (size_t i = 0; i < kept.size(); ++i)
+      kept[i] = i;
+    return kept;
+  }
+
+  switch (selection)
+  {
+    case FEATURE_SELECTION_GRID:
+      kept = SelectFeatures_Grid(points, responses, width, height, max_count);
+    break;
+    case FEATURE_SELECTION_ANMS:
+      kept = SelectFeatures_ANMS(points, responses, width, height, max_count);
+    break;
+    default:
+      kept = SortByResponse(responses);
+      kept.resize(max_count);
+    break;
+  }
+  std::sort(kept.begin(), kept.end());
+  return kept;
+}
+
+} // namespace features
+} // namespace openMVG
+
+#endif // OPENMVG_FEATURES_FEATURE_SELECTION_HPP
@@ -0,0 +1,101 @@
+
+// Copyright (c) 2015 Pierre MOULON.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "openMVG/features/feature_selection.hpp"
+#include "testing/testing.h"
+
+#include <algorithm>
+#include <set>
+#include <vector>
+
+using namespace openMVG;
+using namespace openMVG::features;
+
+// Strong features packed in the top left corner, weak features everywhere
+static void SyntheticFeatures
+(
+  std::vector<PointFeature> & points,
+  std::vector<float> & responses
+)
+{
+  for (int k = 0; k < 200; ++k)
+  {
+    points.push_back(PointFeature((k * 7) % 50, (k * 13) % 50));
+    responses.push_back(100.f + k);
+  }
+  for (int k = 0; k < 800; ++k)
+  {
+    points.push_back(PointFeature((k * 7919) % 1000, (k * 104729) % 1000));
+    responses.push_back(1.f + (k % 50));
+  }
+}
+
+// Number of the 10x10 cells (100x100 pixels each) that contain a kept feature
+static size_t CoveredCells
+(
+  const std::vector<PointFeature> & points,
+  const std::vector<size_t> & kept
+)
+{
+  std::set<int> cells;
+  for (size_t i = 0; i < kept.size(); ++i)
+    cells.insert(static_cast<int>(points[kept[i]].y() / 100) * 10 +
+      static_cast<int>(points[kept[i]].x() / 100));
+  return cells.size();
+}
+
+TEST(feature_selection, NoLimit)
+{
+  std::vector<PointFeature> points;
+  std::vector<float> responses;
+  SyntheticFeatures(points, responses);
+  EXPECT_EQ(points.size(), SelectFeatures(points, responses, 1000, 1000, 0).size());
+  EXPECT_EQ(points.size(), SelectFeatures(points, responses, 1000, 1000, 5000,
+    FEATURE_SELECTION_ANMS).size());
+}
+
+TEST(feature_selection, Response)
+{
+  std::vector<PointFeature> points;
+  std::vector<float> responses;
+  SyntheticFeatures(points, responses);
+  const std::vector<size_t> kept = SelectFeatures(points, responses, 1000, 1000, 100);
+  EXPECT_EQ(100, kept.size());
+  // The strongest features (the last ones of the corner) in increasing index order
+  for (size_t i = 0; i < kept.size(); ++i)
+    EXPECT_EQ(100 + i, kept[i]);
+}
+
+TEST(feature_selection, UniformCoverage)
+{
+  std::vector<PointFeature> points;
+  std::vector<float> responses;
+  SyntheticFeatures(points, responses);
+
+  const std::vector<size_t> kept_response =
+    SelectFeatures(points, responses, 1000, 1000, 100, FEATURE_SELECTION_RESPONSE);
+  EXPECT_EQ(1, CoveredCells(points, kept_response));
+
+  const EFEATURE_SELECTION selections[2] = {FEATURE_SELECTION_GRID, FEATURE_SELECTION_ANMS};
+  for (int s = 0; s < 2; ++s)
+  {
+    const std::vector<size_t> kept =
+      SelectFeatures(points, responses, 1000, 1000, 100, selections[s]);
+    EXPECT_EQ(100, kept.size());
+    // Increasing and unique indexes
+    for (size_t i = 1; i < kept.size(); ++i)
+      EXPECT_TRUE(kept[i-1] < kept[i]);
+    // The kept features are spread over the image
+    EXPECT_TRUE(CoveredCells(points, kept) > 50);
+    // The strongest feature is always kept
+    EXPECT_TRUE(std::find(kept.begin(), kept.end(), 199) != kept.end());
+  }
+}
+
+/* ************************************************************************* */
+int main() { TestResult tr; return TestRegistry::runAllTests(tr);}
+/* ************************************************************************* */
@@ -15,8 +15,12 @@
 #include "openMVG/features/keypointSet.hpp"
 #include "openMVG/features/regions.hpp"
 #include "openMVG/features/regions_factory.hpp"
+#include "openMVG/features/regions_compression.hpp"
 #include "openMVG/features/image_describer.hpp"
 #include "openMVG/features/image_describer_akaze.hpp"
+#include "openMVG/features/image_describer_tiled.hpp"
+#include "openMVG/features/image_pyramid_cache.hpp"
+#include "openMVG/features/sift_scale_space.hpp"
 #include "openMVG/features/io_regions_type.hpp"
 
 #endif // OPENMVG_FEATURES_HPP
@@ -95,6 +95,10 @@ TEST(descriptorIO, BINARY) {
   loadDescsFromBinFile("tempDescsBin.desc", vec_descs_read);
   EXPECT_EQ(CARD, vec_descs_read.size());
 
+  size_t cardDesc = 0;
+  EXPECT_TRUE(countDescsInBinFile("tempDescsBin.desc", cardDesc));
+  EXPECT_EQ(CARD, cardDesc);
+
   for(int i = 0; i < CARD; ++i) {
     for (int j = 0; j < DESC_LENGTH; ++j)
       EXPECT_EQ(vec_descs[i][j], vec_descs_read[i][j]);
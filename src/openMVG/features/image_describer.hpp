@@ -10,6 +10,8 @@
 
 #include "openMVG/numeric/numeric.h"
 #include "openMVG/features/regions.hpp"
+#include "openMVG/features/feature_selection.hpp"
+#include "openMVG/features/image_pyramid_cache.hpp"
 #include "openMVG/image/image_container.hpp"
 #include <memory>
 #include <cereal/cereal.hpp> // Serialization
@@ -27,9 +29,40 @@ enum EDESCRIBER_PRESET
 class Image_describer
 {
 public:
-  Image_describer() {}
+  Image_describer()
+    :_max_features(0), _feature_selection(FEATURE_SELECTION_RESPONSE) {}
   virtual ~Image_describer() {}
 
+  /**
+  @brief Limit the number of described regions
+  The keypoints are selected before the descriptor computation
+   (the dropped keypoints are never described).
+  This setting is not serialized: it must be set for each run.
+  @param max_features Maximal number of regions (0: no limit)
+  @param selection How the kept keypoints are chosen:
+    strongest responses, strongest responses per grid cell or
+    adaptive non-maximal suppression (uniform coverage).
+  */
+  void Set_feature_budget(
+    const size_t max_features,
+    const EFEATURE_SELECTION selection = FEATURE_SELECTION_RESPONSE)
+  {
+    _max_features = max_features;
+    _feature_selection = selection;
+  }
+
+  /**
+  @brief Share a cache of scale space base levels (keyed by image hash)
+  The describers that support it read the base level of their scale space from
+   the cache (the initial smoothing is skipped) or compute and store it.
+  This setting is not serialized: it must be set for each run.
+  @param cache The cache (NULL: no cache)
+  */
+  void Set_pyramid_cache(const std::shared_ptr<Image_Pyramid_Cache> & cache)
+  {
+    _pyramid_cache = cache;
+  }
+
   /**
   @brief Use a preset to control the number of detected regions
   @param preset The preset configuration
@@ -74,6 +107,11 @@ public:
   {
     return regions->LoadFeatures(sfileNameFeats);
   }
+
+protected:
+  size_t _max_features; // Maximal number of regions (0: no limit)
+  EFEATURE_SELECTION _feature_selection; // Selection of the kept keypoints
+  std::shared_ptr<Image_Pyramid_Cache> _pyramid_cache; // Cache of the base levels (optional)
 };
 
 } // namespace features
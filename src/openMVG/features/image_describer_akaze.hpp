@@ -9,6 +9,7 @@
 
 #include <iostream>
 #include <numeric>
+#include <sstream>
 
 #include "openMVG/features/image_describer.hpp"
 #include "openMVG/features/regions_factory.hpp"
@@ -87,189 +88,237 @@ public:
     std::unique_ptr<Regions> &regions,
     const image::Image<unsigned char> * mask = NULL)
   {
-    _params._options.fDesc_factor =
+    // Local copy of the options: several images can be described concurrently
+    AKAZEConfig options = _params._options;
+    options.fDesc_factor =
       (_params._eAkazeDescriptor == AKAZE_MSURF ||
       _params._eAkazeDescriptor == AKAZE_LIOP) ? 10.f*sqrtf(2.f)
       : 11.f*sqrtf(2.f); // MLDB
 
-    AKAZE akaze(image, _params._options);
+    AKAZE akaze(image, options);
+    Allocate(regions);
+
+    // Base level of the scale space from the pyramid cache (computed and stored if missing)
+    if (_pyramid_cache)
+    {
+      std::ostringstream os;
+      os << Image_Pyramid_Cache::Hash_Image(image) << "_akaze_" << options.fSigma0;
+      const std::string key = os.str();
+      image::Image<float> base, contrast_factor; // contrast factor stored as a 1x1 level
+      if (!_pyramid_cache->Get(key, base) ||
+          !_pyramid_cache->Get(key + "_contrast", contrast_factor))
+      {
+        float factor;
+        akaze.Compute_Base_Level(base, factor);
+        contrast_factor = image::Image<float>(1, 1, true, factor);
+        _pyramid_cache->Put(key, base);
+        _pyramid_cache->Put(key + "_contrast", contrast_factor);
+      }
+      akaze.Set_Base_Level(base, contrast_factor(0, 0));
+    }
+
+    if (_max_features == 0)
+    {
+      // Low memory mode: the scale space slices are computed, described and
+      //  released one after the other (the whole scale space is never in memory)
+      akaze.Feature_Detection_Streaming(
+        [&](const TEvolution & slice, const std::vector<AKAZEKeypoint> & kpts)
+        {
+          Describe_Slice(akaze, slice, kpts, image, mask, regions.get());
+        });
+      return true;
+    }
+
+    // Feature budget: all the keypoints must be known before the selection,
+    //  so the whole scale space is kept in memory
     akaze.Compute_AKAZEScaleSpace();
     std::vector<AKAZEKeypoint> kpts;
     kpts.reserve(5000);
     akaze.Feature_Detection(kpts);
     akaze.Do_Subpixel_Refinement(kpts);
 
-    Allocate(regions);
+    std::vector<AKAZEKeypoint> unmasked_kpts;
+    unmasked_kpts.reserve(kpts.size());
+    std::vector<PointFeature> vec_points;
+    std::vector<float> vec_responses;
+    for (size_t i = 0; i < kpts.size(); ++i)
+    {
+      // Feature masking
+      if (mask && (*mask)(kpts[i].y, kpts[i].x) > 0)
+        continue;
+      unmasked_kpts.push_back(kpts[i]);
+      vec_points.push_back(PointFeature(kpts[i].x, kpts[i].y));
+      vec_responses.push_back(kpts[i].response);
+    }
+    const std::vector<size_t> selected = SelectFeatures(vec_points, vec_responses,
+      image.Width(), image.Height(), _max_features, _feature_selection);
+
+    // Describe the kept keypoints slice per slice
+    const std::vector<TEvolution> & slices = akaze.getSlices();
+    std::vector<std::vector<AKAZEKeypoint> > slice_kpts(slices.size());
+    for (size_t i = 0; i < selected.size(); ++i)
+    {
+      const AKAZEKeypoint & ptAkaze = unmasked_kpts[selected[i]];
+      slice_kpts[ptAkaze.class_id].push_back(ptAkaze);
+    }
+    for (size_t i = 0; i < slices.size(); ++i)
+    {
+      if (!slice_kpts[i].empty())
+        Describe_Slice(akaze, slices[i], slice_kpts[i], image, NULL, regions.get());
+    }
+    return true;
+  };
+
+  /// Allocate Regions type depending of the Image_describer
+  void Allocate(std::unique_ptr<Regions> &regions) const
+  {
+    switch(_params._eAkazeDescriptor)
+    {
+      case AKAZE_MSURF:
+        return regions.reset(new AKAZE_Float_Regions);
+      break;
+      case AKAZE_LIOP:
+        return regions.reset(new AKAZE_Liop_Regions);
+      case AKAZE_MLDB:
+       return regions.reset(new AKAZE_Binary_Regions);
+      break;
+    }
+  }
+
+  template<class Archive>
+  void serialize(Archive & ar)
+  {
+    ar(
+     cereal::make_nvp("params", _params),
+     cereal::make_nvp("bOrientation", _bOrientation));
+  }
+
+
+private:
+
+  /// Compute the orientation and the description of the keypoints of a slice
+  /// (the described regions are appended to the regions container)
+  void Describe_Slice(
+    const AKAZE & akaze,
+    const TEvolution & cur_slice,
+    const std::vector<AKAZEKeypoint> & slice_kpts,
+    const image::Image<unsigned char>& image,
+    const image::Image<unsigned char> * mask,
+    Regions * regions) const
+  {
+    // Feature masking
+    std::vector<AKAZEKeypoint> kpts;
+    kpts.reserve(slice_kpts.size());
+    for (size_t i = 0; i < slice_kpts.size(); ++i)
+    {
+      const AKAZEKeypoint & ptAkaze = slice_kpts[i];
+      if (mask)
+      {
+        const image::Image<unsigned char> & maskIma = *mask;
+        if (maskIma(ptAkaze.y, ptAkaze.x) > 0)
+          continue;
+      }
+      kpts.push_back(ptAkaze);
+    }
+
+  #ifdef OPENMVG_USE_OPENMP
+    #pragma omp parallel for
+  #endif
+    for (int i = 0; i < static_cast<int>(kpts.size()); ++i)
+    {
+      if (_bOrientation)
+        akaze.Compute_Main_Orientation(kpts[i], cur_slice.Lx, cur_slice.Ly);
+      else
+        kpts[i].angle = 0.0f;
+    }
 
     switch(_params._eAkazeDescriptor)
     {
       case AKAZE_MSURF:
       {
         // Build alias to cached data
-        AKAZE_Float_Regions * regionsCasted = dynamic_cast<AKAZE_Float_Regions*>(regions.get());
-        regionsCasted->Features().resize(kpts.size());
-        regionsCasted->Descriptors().resize(kpts.size());
+        AKAZE_Float_Regions * regionsCasted = dynamic_cast<AKAZE_Float_Regions*>(regions);
+        const size_t offset = regionsCasted->Features().size();
+        regionsCasted->Features().resize(offset + kpts.size());
+        regionsCasted->Descriptors().resize(offset + kpts.size());
 
       #ifdef OPENMVG_USE_OPENMP
         #pragma omp parallel for
       #endif
         for (int i = 0; i < static_cast<int>(kpts.size()); ++i)
         {
-          AKAZEKeypoint ptAkaze = kpts[i];
-
-          // Feature masking
-          if (mask)
-          {
-            const image::Image<unsigned char> & maskIma = *mask;
-            if (maskIma(ptAkaze.y, ptAkaze.x) > 0)
-              continue;
-          }
-
-          const TEvolution & cur_slice = akaze.getSlices()[ptAkaze.class_id];
-
-          if (_bOrientation)
-            akaze.Compute_Main_Orientation(ptAkaze, cur_slice.Lx, cur_slice.Ly);
-          else
-            ptAkaze.angle = 0.0f;
-
-          regionsCasted->Features()[i] =
+          const AKAZEKeypoint & ptAkaze = kpts[i];
+          regionsCasted->Features()[offset + i] =
             SIOPointFeature(ptAkaze.x, ptAkaze.y, ptAkaze.size, ptAkaze.angle);
 
           ComputeMSURFDescriptor(cur_slice.Lx, cur_slice.Ly, ptAkaze.octave,
-            regionsCasted->Features()[i],
-            regionsCasted->Descriptors()[i]);
+            regionsCasted->Features()[offset + i],
+            regionsCasted->Descriptors()[offset + i]);
         }
       }
       break;
       case AKAZE_LIOP:
       {
         // Build alias to cached data
-        AKAZE_Liop_Regions * regionsCasted = dynamic_cast<AKAZE_Liop_Regions*>(regions.get());
-        regionsCasted->Features().resize(kpts.size());
-        regionsCasted->Descriptors().resize(kpts.size());
-
-        // Init LIOP extractor
-        LIOP::Liop_Descriptor_Extractor liop_extractor;
-
-      #ifdef OPENMVG_USE_OPENMP
-        #pragma omp parallel for
-      #endif
-        for (int i = 0; i < static_cast<int>(kpts.size()); ++i)
+        AKAZE_Liop_Regions * regionsCasted = dynamic_cast<AKAZE_Liop_Regions*>(regions);
+        const size_t offset = regionsCasted->Features().size();
+        regionsCasted->Features().resize(offset + kpts.size());
+        regionsCasted->Descriptors().resize(offset + kpts.size());
+
+        // Compute LIOP descriptor (do not need rotation computation, since
+        //  LIOP descriptor is rotation invariant).
+        // Rescale for LIOP patch extraction
+        std::vector<SIOPointFeature> fps(kpts.size());
+        for (size_t i = 0; i < kpts.size(); ++i)
         {
-          AKAZEKeypoint ptAkaze = kpts[i];
-
-          // Feature masking
-          if (mask)
-          {
-            const image::Image<unsigned char> & maskIma = *mask;
-            if (maskIma(ptAkaze.y, ptAkaze.x) > 0)
-              continue;
-          }
-
-          const TEvolution & cur_slice = akaze.getSlices()[ptAkaze.class_id];
-
-          if (_bOrientation)
-            akaze.Compute_Main_Orientation(ptAkaze, cur_slice.Lx, cur_slice.Ly);
-          else
-            ptAkaze.angle = 0.0f;
-
-          regionsCasted->Features()[i] =
+          const AKAZEKeypoint & ptAkaze = kpts[i];
+          regionsCasted->Features()[offset + i] =
             SIOPointFeature(ptAkaze.x, ptAkaze.y, ptAkaze.size, ptAkaze.angle);
+          fps[i] = SIOPointFeature(ptAkaze.x, ptAkaze.y,
+            ptAkaze.size/2.0, ptAkaze.angle);
+        }
 
-          // Compute LIOP descriptor (do not need rotation computation, since
-          //  LIOP descriptor is rotation invariant).
-          // Rescale for LIOP patch extraction
-          const SIOPointFeature fp =
-              SIOPointFeature(ptAkaze.x, ptAkaze.y,
-              ptAkaze.size/2.0, ptAkaze.angle);
-
-          float desc[144];
-          liop_extractor.extract(image, fp, desc);
+        // Batched LIOP extraction (parallel over the keypoints)
+        LIOP::Liop_Descriptor_Extractor liop_extractor;
+        std::vector<float> descs;
+        liop_extractor.extract(image, fps, descs);
+        for (size_t i = 0; i < kpts.size(); ++i)
           for(int j=0; j < 144; ++j)
-            regionsCasted->Descriptors()[i][j] =
-              static_cast<unsigned char>(desc[j] * 255.f +.5f);
-        }
+            regionsCasted->Descriptors()[offset + i][j] =
+              static_cast<unsigned char>(descs[i * 144 + j] * 255.f +.5f);
       }
       break;
       case AKAZE_MLDB:
       {
         // Build alias to cached data
-        AKAZE_Binary_Regions * regionsCasted = dynamic_cast<AKAZE_Binary_Regions*>(regions.get());
-        regionsCasted->Features().resize(kpts.size());
-        regionsCasted->Descriptors().resize(kpts.size());
+        AKAZE_Binary_Regions * regionsCasted = dynamic_cast<AKAZE_Binary_Regions*>(regions);
+        const size_t offset = regionsCasted->Features().size();
+        regionsCasted->Features().resize(offset + kpts.size());
+        regionsCasted->Descriptors().resize(offset + kpts.size());
 
       #ifdef OPENMVG_USE_OPENMP
         #pragma omp parallel for
       #endif
         for (int i = 0; i < static_cast<int>(kpts.size()); ++i)
         {
-          AKAZEKeypoint ptAkaze = kpts[i];
-
-          // Feature masking
-          if (mask)
-          {
-            const image::Image<unsigned char> & maskIma = *mask;
-            if (maskIma(ptAkaze.y, ptAkaze.x) > 0)
-              continue;
-          }
-
-          const TEvolution & cur_slice = akaze.getSlices()[ptAkaze.class_id];
-
-          if (_bOrientation)
-            akaze.Compute_Main_Orientation(ptAkaze, cur_slice.Lx, cur_slice.Ly);
-          else
-            ptAkaze.angle = 0.0f;
-
-          regionsCasted->Features()[i] =
+          const AKAZEKeypoint & ptAkaze = kpts[i];
+          regionsCasted->Features()[offset + i] =
             SIOPointFeature(ptAkaze.x, ptAkaze.y, ptAkaze.size, ptAkaze.angle);
 
-          // Compute MLDB descriptor
-		      Descriptor<bool,486> desc;
-      		ComputeMLDBDescriptor(cur_slice.cur, cur_slice.Lx, cur_slice.Ly,
-            ptAkaze.octave, regionsCasted->Features()[i], desc);
-          // convert the bool vector to the binary unsigned char array
-          unsigned char * ptr = reinterpret_cast<unsigned char*>(&regionsCasted->Descriptors()[i]);
-          memset(ptr, 0, regionsCasted->DescriptorLength()*sizeof(unsigned char));
-          // For each byte
-          for (int j = 0; j < std::ceil(486./8.); ++j, ++ptr) {
-            // set the corresponding 8bits to the good values
-            for (int iBit = 0; iBit < 8 && j*8+iBit < 486; ++iBit)  {
-              *ptr |= desc[j*8+iBit] << iBit;
-            }
-          }
+          // Compute MLDB descriptor (486 bits packed in 64-bit words)
+          Descriptor<uint64_t, 8> desc;
+          ComputeMLDBDescriptor(cur_slice.cur, cur_slice.Lx, cur_slice.Ly,
+            ptAkaze.octave, regionsCasted->Features()[offset + i], desc);
+          // store the words as bytes (bit k of the descriptor in the byte k / 8)
+          unsigned char * ptr = reinterpret_cast<unsigned char*>(&regionsCasted->Descriptors()[offset + i]);
+          for (int j = 0; j < 64; ++j)
+            ptr[j] = static_cast<unsigned char>(desc[j / 8] >> (8 * (j % 8)));
         }
       }
       break;
     }
-    return true;
-  };
-
-  /// Allocate Regions type depending of the Image_describer
-  void Allocate(std::unique_ptr<Regions> &regions) const
-  {
-    switch(_params._eAkazeDescriptor)
-    {
-      case AKAZE_MSURF:
-        return regions.reset(new AKAZE_Float_Regions);
-      break;
-      case AKAZE_LIOP:
-        return regions.reset(new AKAZE_Liop_Regions);
-      case AKAZE_MLDB:
-       return regions.reset(new AKAZE_Binary_Regions);
-      break;
-    }
   }
 
-  template<class Archive>
-  void serialize(Archive & ar)
-  {
-    ar(
-     cereal::make_nvp("params", _params),
-     cereal::make_nvp("bOrientation", _bOrientation));
-  }
-
-
-private:
   AKAZEParams _params;
   bool _bOrientation;
 };
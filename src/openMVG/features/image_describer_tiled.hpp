@@ -0,0 +1,182 @@
+
+// Copyright (c) 2015 Pierre MOULON.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef OPENMVG_FEATURES_IMAGE_DESCRIBER_TILED_HPP
+#define OPENMVG_FEATURES_IMAGE_DESCRIBER_TILED_HPP
+
+#include "openMVG/features/image_describer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <map>
+#include <vector>
+
+namespace openMVG {
+namespace features {
+
+/// Provide the rows [y, y + rows) of an image as a grayscale band
+/// (the bands are requested by increasing y)
+typedef std::function<bool(int y, int rows, image::Image<unsigned char> & band)> Band_Reader;
+
+/**
+@brief Tiled regions computation for very large images.
+The image is split into tiles of tile_size x tile_size pixels. Each tile is
+ described with its neighborhood (overlap pixels on each side), so only a
+ band of tile rows is in memory and the describer pyramids are bounded by the
+ tile size. The tiles of a band are described in parallel.
+A region is kept by the tile whose core (the tile without the overlap) contains
+ it, then the regions detected by two tiles across a tile border
+ (distance < dedup_radius) are kept only once.
+The regions are returned in the image frame, in tile order (deterministic).
+Note: the feature budget of the describer applies per tile.
+@param describer The describer (Describe must be reentrant)
+@param width Image width
+@param height Image height
+@param read_band Provide the grayscale image rows
+@param regions The detected regions and attributes
+@param mask 8-bit gray image (full size) for keypoint filtering (optional).
+@param tile_size Size of the tiles (without the overlap)
+@param overlap Size of the tile neighborhood (should cover the descriptor support)
+@param dedup_radius Distance under which two regions of neighboring tiles are the same
+*/
+inline bool Describe_Tiled
+(
+  Image_describer & describer,
+  const int width,
+  const int height,
+  const Band_Reader & read_band,
+  std::unique_ptr<Regions> & regions,
+  const image::Image<unsigned char> * mask,
+  const int tile_size,
+  const int overlap,
+  const float dedup_radius = 1.f
+)
+{
+  describer.Allocate(regions);
+  if (tile_size <= 0 || overlap < 0 || width <= 0 || height <= 0)
+    return false;
+
+  const int tile_count_x = (width + tile_size - 1) / tile_size;
+  const int tile_count_y = (height + tile_size - 1) / tile_size;
+  std::vector<std::unique_ptr<Regions> > tile_regions(tile_count_x * tile_count_y);
+
+  for (int ty = 0; ty < tile_count_y; ++ty)
+  {
+    const int y0 = ty * tile_size, y1 = std::min(height, y0 + tile_size);
+    const int band_y0 = std::max(0, y0 - overlap), band_y1 = std::min(height, y1 + overlap);
+    image::Image<unsigned char> band;
+    if (!read_band(band_y0, band_y1 - band_y0, band) ||
+        band.Width() != width || band.Height() != band_y1 - band_y0)
+      return false;
+
+#ifdef OPENMVG_USE_OPENMP
+    #pragma omp parallel for schedule(dynamic) if(tile_count_x > 1)
+#endif
+    for (int tx = 0; tx < tile_count_x; ++tx)
+    {
+      const int x0 = tx * tile_size, x1 = std::min(width, x0 + tile_size);
+      const int tile_x0 = std::max(0, x0 - overlap), tile_x1 = std::min(width, x1 + overlap);
+      const image::Image<unsigned char> tile(
+        band.block(0, tile_x0, band.Height(), tile_x1 - tile_x0));
+      std::unique_ptr<image::Image<unsigned char> > tile_mask;
+      if (mask)
+        tile_mask.reset(new image::Image<unsigned char>(
+          mask->block(band_y0, tile_x0, band.Height(), tile_x1 - tile_x0)));
+
+      std::unique_ptr<Regions> cur_regions;
+      describer.Describe(tile, cur_regions, tile_mask.get());
+      cur_regions->TranslateRegions(Vec2f(static_cast<float>(tile_x0), static_cast<float>(band_y0)));
+
+      // Keep the regions of the tile core
+      std::unique_ptr<Regions> & core_regions = tile_regions[ty * tile_count_x + tx];
+      core_regions.reset(cur_regions->EmptyClone());
+      for (size_t i = 0; i < cur_regions->RegionCount(); ++i)
+      {
+        const Vec2 pos = cur_regions->GetRegionPosition(i);
+        if (pos(0) >= x0 && pos(0) < x1 && pos(1) >= y0 && pos(1) < y1)
+          cur_regions->CopyRegion(i, core_regions.get());
+      }
+    }
+  }
+
+  // Gather the regions in tile order and deduplicate the regions found on both
+  //  sides of a tile border: the regions close to an inner tile border are indexed
+  //  in a grid of dedup_radius cells and compared to the regions of the previous tiles.
+  std::map<std::pair<int, int>, std::vector<Vec2> > border_grid;
+  const float radius = std::max(dedup_radius, 1e-3f);
+  const auto is_near_border = [&](const Vec2 & pos)
+  {
+    const double dx = std::fmod(pos(0), static_cast<double>(tile_size));
+    const double dy = std::fmod(pos(1), static_cast<double>(tile_size));
+    return
+      (pos(0) >= radius && dx < radius) || (pos(0) < width - radius && dx > tile_size - radius) ||
+      (pos(1) >= radius && dy < radius) || (pos(1) < height - radius && dy > tile_size - radius);
+  };
+
+  for (size_t t = 0; t < tile_regions.size(); ++t)
+  {
+    const Regions * cur_regions = tile_regions[t].get();
+    std::vector<std::pair<std::pair<int, int>, Vec2> > to_index;
+    for (size_t i = 0; i < cur_regions->RegionCount(); ++i)
+    {
+      const Vec2 pos = cur_regions->GetRegionPosition(i);
+      if (is_near_border(pos))
+      {
+        const int cx = static_cast<int>(std::floor(pos(0) / radius));
+        const int cy = static_cast<int>(std::floor(pos(1) / radius));
+        bool bDuplicate = false;
+        for (int y = cy - 1; y <= cy + 1 && !bDuplicate; ++y)
+        for (int x = cx - 1; x <= cx + 1 && !bDuplicate; ++x)
+        {
+          const auto iter = border_grid.find(std::make_pair(x, y));
+          if (iter == border_grid.end())
+            continue;
+          for (size_t j = 0; j < iter->second.size() && !bDuplicate; ++j)
+            bDuplicate = (iter->second[j] - pos).norm() < radius;
+        }
+        // The duplicates are indexed too (a region found by the 4 tiles of a corner)
+        to_index.push_back(std::make_pair(std::make_pair(cx, cy), pos));
+        if (bDuplicate)
+          continue;
+      }
+      cur_regions->CopyRegion(i, regions.get());
+    }
+    // The regions of a tile are indexed after its own processing
+    // (the regions of a same tile are never duplicates, i.e. several orientations)
+    for (size_t k = 0; k < to_index.size(); ++k)
+      border_grid[to_index[k].first].push_back(to_index[k].second);
+    tile_regions[t].reset();
+  }
+  return true;
+}
+
+/// Tiled regions computation of an image in memory (see the Band_Reader version)
+inline bool Describe_Tiled
+(
+  Image_describer & describer,
+  const image::Image<unsigned char> & image,
+  std::unique_ptr<Regions> & regions,
+  const image::Image<unsigned char> * mask,
+  const int tile_size,
+  const int overlap,
+  const float dedup_radius = 1.f
+)
+{
+  return Describe_Tiled(describer, image.Width(), image.Height(),
+    [&](int y, int rows, image::Image<unsigned char> & band)
+    {
+      band = image.block(y, 0, rows, image.Width());
+      return true;
+    },
+    regions, mask, tile_size, overlap, dedup_radius);
+}
+
+} // namespace features
+} // namespace openMVG
+
+#endif // OPENMVG_FEATURES_IMAGE_DESCRIBER_TILED_HPP
@@ -0,0 +1,159 @@
+
+// Copyright (c) 2015 Pierre MOULON.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "openMVG/features/image_describer_tiled.hpp"
+#include "openMVG/features/regions_factory.hpp"
+#include "testing/testing.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace openMVG;
+using namespace openMVG::image;
+using namespace openMVG::features;
+
+// Describe the bright pixels of an image.
+// The positions are moved by 0.4 pixel toward the image center, so a pixel on a
+//  tile border is found by the two neighboring tiles, in the core of each tile.
+class Bright_Pixel_Image_describer : public Image_describer
+{
+public:
+  bool Set_configuration_preset(EDESCRIBER_PRESET preset) { return true; }
+
+  bool Describe(const Image<unsigned char>& image,
+    std::unique_ptr<Regions> &regions,
+    const Image<unsigned char> * mask = NULL)
+  {
+    Allocate(regions);
+    AKAZE_Float_Regions * regionsCasted = dynamic_cast<AKAZE_Float_Regions*>(regions.get());
+    for (int y = 0; y < image.Height(); ++y)
+    for (int x = 0; x < image.Width(); ++x)
+    {
+      if (image(y, x) < 128 || (mask && (*mask)(y, x) > 0))
+        continue;
+      const float px = x + (2 * x < image.Width() ? 0.4f : -0.4f);
+      const float py = y + (2 * y < image.Height() ? 0.4f : -0.4f);
+      regionsCasted->Features().push_back(SIOPointFeature(px, py, 1.f, 0.f));
+      AKAZE_Float_Regions::DescriptorT desc;
+      for (int k = 0; k < 64; ++k)
+        desc[k] = image(y, x);
+      regionsCasted->Descriptors().push_back(desc);
+    }
+    return true;
+  }
+
+  void Allocate(std::unique_ptr<Regions> &regions) const
+  {
+    regions.reset(new AKAZE_Float_Regions);
+  }
+};
+
+static Image<unsigned char> BrightPixelImage
+(
+  const int width,
+  const int height,
+  const std::vector<Vec2> & pixels
+)
+{
+  Image<unsigned char> image(width, height, true, 0);
+  for (size_t i = 0; i < pixels.size(); ++i)
+    image(pixels[i](1), pixels[i](0)) = 128 + i % 128;
+  return image;
+}
+
+// Rounded positions of the regions (sorted)
+static std::vector<std::pair<int, int> > RoundedPositions(const Regions & regions)
+{
+  std::vector<std::pair<int, int> > positions;
+  for (size_t i = 0; i < regions.RegionCount(); ++i)
+  {
+    const Vec2 pos = regions.GetRegionPosition(i);
+    positions.push_back(std::make_pair(
+      static_cast<int>(std::floor(pos(1) + 0.5)), static_cast<int>(std::floor(pos(0) + 0.5))));
+  }
+  std::sort(positions.begin(), positions.end());
+  return positions;
+}
+
+static const std::vector<SIOPointFeature> & Features(const Regions & regions)
+{
+  return dynamic_cast<const AKAZE_Float_Regions &>(regions).Features();
+}
+
+TEST(Describe_Tiled, SameAsWholeImage)
+{
+  // Bright pixels away from the tile borders
+  std::vector<Vec2> pixels;
+  for (int k = 0; k < 200; ++k)
+  {
+    const int x = (k * 7919) % 230, y = (k * 104729) % 170;
+    if (x % 50 != 0 && y % 50 != 0)
+      pixels.push_back(Vec2(x, y));
+  }
+  const Image<unsigned char> image = BrightPixelImage(230, 170, pixels);
+
+  Bright_Pixel_Image_describer describer;
+  std::unique_ptr<Regions> regions, tiled_regions;
+  describer.Describe(image, regions);
+  EXPECT_TRUE(Describe_Tiled(describer, image, tiled_regions, NULL, 50, 8));
+
+  EXPECT_EQ(regions->RegionCount(), tiled_regions->RegionCount());
+  EXPECT_TRUE(RoundedPositions(*regions) == RoundedPositions(*tiled_regions));
+
+  // Deterministic output
+  std::unique_ptr<Regions> tiled_regions_bis;
+  Describe_Tiled(describer, image, tiled_regions_bis, NULL, 50, 8);
+  EXPECT_TRUE(Features(*tiled_regions) == Features(*tiled_regions_bis));
+
+  // A single tile is the whole image
+  std::unique_ptr<Regions> single_tile_regions;
+  Describe_Tiled(describer, image, single_tile_regions, NULL, 1000, 8);
+  EXPECT_TRUE(Features(*regions) == Features(*single_tile_regions));
+}
+
+TEST(Describe_Tiled, BorderDeduplication)
+{
+  // Bright pixels on the tile borders (and on a tile corner)
+  std::vector<Vec2> pixels;
+  pixels.push_back(Vec2(50, 20));
+  pixels.push_back(Vec2(100, 75));
+  pixels.push_back(Vec2(30, 100));
+  pixels.push_back(Vec2(150, 50));
+  pixels.push_back(Vec2(120, 120));
+  const Image<unsigned char> image = BrightPixelImage(230, 170, pixels);
+
+  Bright_Pixel_Image_describer describer;
+  std::unique_ptr<Regions> tiled_regions;
+  EXPECT_TRUE(Describe_Tiled(describer, image, tiled_regions, NULL, 50, 8));
+  EXPECT_EQ(pixels.size(), tiled_regions->RegionCount());
+  EXPECT_EQ(pixels.size(), RoundedPositions(*tiled_regions).size());
+
+  // Without deduplication, the border pixels are found by several tiles
+  std::unique_ptr<Regions> duplicated_regions;
+  EXPECT_TRUE(Describe_Tiled(describer, image, duplicated_regions, NULL, 50, 8, 0.f));
+  EXPECT_TRUE(duplicated_regions->RegionCount() > pixels.size());
+}
+
+TEST(Describe_Tiled, Mask)
+{
+  std::vector<Vec2> pixels;
+  pixels.push_back(Vec2(10, 10));
+  pixels.push_back(Vec2(120, 120));
+  const Image<unsigned char> image = BrightPixelImage(230, 170, pixels);
+  Image<unsigned char> mask(230, 170, true, 0);
+  mask(120, 120) = 255;
+
+  Bright_Pixel_Image_describer describer;
+  std::unique_ptr<Regions> tiled_regions;
+  EXPECT_TRUE(Describe_Tiled(describer, image, tiled_regions, &mask, 50, 8));
+  EXPECT_EQ(1, tiled_regions->RegionCount());
+}
+
+/* ************************************************************************* */
+int main() { TestResult tr; return TestRegistry::runAllTests(tr);}
+/* ************************************************************************* */
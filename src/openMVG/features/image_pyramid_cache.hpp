@@ -0,0 +1,333 @@
+
+// Copyright (c) 2015 Pierre MOULON.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef OPENMVG_FEATURES_IMAGE_PYRAMID_CACHE_HPP
+#define OPENMVG_FEATURES_IMAGE_PYRAMID_CACHE_HPP
+
+#include "openMVG/image/image_container.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <list>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace openMVG {
+namespace features {
+
+/**
+@brief Cache of the decoded grayscale images and of the base levels of the
+ describer scale spaces (the first smoothed level), keyed by image hash.
+The same images can then be described by several describers, or with several
+ presets, without being decoded and smoothed again.
+Two tiers:
+ - in-process: the least recently used entries are evicted beyond a memory budget,
+ - on-disk (optional): a directory shared by the runs, the least recently used
+   files are evicted beyond a disk budget (the usage order is kept in an index file).
+The cache is thread safe, but a directory must be used by one process at a time.
+*/
+class Image_Pyramid_Cache
+{
+public:
+
+  struct Statistics
+  {
+    Statistics() : memory_hits(0), disk_hits(0), misses(0), evictions(0) {}
+    size_t memory_hits, disk_hits, misses, evictions;
+  };
+
+  /**
+  @param memory_budget Maximal size of the in-process entries (bytes)
+  @param directory Directory of the on-disk entries (must exist, empty: no on-disk tier)
+  @param disk_budget Maximal size of the on-disk entries (bytes)
+  */
+  Image_Pyramid_Cache(
+    const size_t memory_budget,
+    const std::string & directory = "",
+    const size_t disk_budget = 0)
+    :_memory_budget(memory_budget), _memory_size(0),
+     _directory(directory), _disk_budget(disk_budget), _disk_size(0)
+  {
+    Load_Index();
+  }
+
+  /// 64-bit FNV-1a hash of the image size and pixels (hexadecimal)
+  template <typename T>
+  static std::string Hash_Image(const image::Image<T> & image)
+  {
+    const int size[2] = {image.Width(), image.Height()};
+    uint64_t hash = Hash_Bytes(Fnv_Offset(), size, sizeof(size));
+    hash = Hash_Bytes(hash, image.data(), size_t(size[0]) * size[1] * sizeof(T));
+    return To_Hex(hash);
+  }
+
+  /// 64-bit FNV-1a hash of a file content (hexadecimal, empty if the file cannot be read).
+  /// It keys the decoded image of a file without decoding it.
+  static std::string Hash_File(const std::string & filename)
+  {
+    std::ifstream stream(filename.c_str(), std::ios::binary);
+    if (!stream.is_open())
+      return std::string();
+    uint64_t hash = Fnv_Offset();
+    std::vector<char> buffer(1 << 20);
+    while (stream)
+    {
+      stream.read(&buffer[0], buffer.size());
+      hash = Hash_Bytes(hash, &buffer[0], static_cast<size_t>(stream.gcount()));
+    }
+    return To_Hex(hash);
+  }
+
+  /// Get an image or a level (false if the key is unknown)
+  template <typename T>
+  bool Get(const std::string & key, image::Image<T> & image)
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    Entry entry;
+    Memory_Map::iterator it = _memory.find(key);
+    if (it != _memory.end() && it->second.first.pixel_size == sizeof(T))
+    {
+      _memory_lru.splice(_memory_lru.begin(), _memory_lru, it->second.second);
+      ++_statistics.memory_hits;
+      To_Image(it->second.first, image);
+      return true;
+    }
+    if (Read_Disk(key, sizeof(T), entry))
+    {
+      ++_statistics.disk_hits;
+      To_Image(entry, image);
+      Put_Memory(key, entry);
+      return true;
+    }
+    ++_statistics.misses;
+    return false;
+  }
+
+  /// Store an image or a level (in memory and on disk)
+  template <typename T>
+  void Put(const std::string & key, const image::Image<T> & image)
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    Entry entry;
+    entry.width = image.Width();
+    entry.height = image.Height();
+    entry.pixel_size = sizeof(T);
+    entry.data.resize(entry.Size());
+    if (!entry.data.empty())
+      std::memcpy(&entry.data[0], image.data(), entry.data.size());
+    Write_Disk(key, entry);
+    Put_Memory(key, entry);
+  }
+
+  Statistics Get_statistics() const
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _statistics;
+  }
+
+private:
+
+  struct Entry
+  {
+    int width, height, pixel_size;
+    std::vector<unsigned char> data;
+    size_t Size() const { return size_t(width) * height * pixel_size; }
+  };
+
+  typedef std::list<std::string> Lru_List; // most recently used first
+  typedef std::map<std::string, std::pair<Entry, Lru_List::iterator> > Memory_Map;
+  typedef std::map<std::string, std::pair<size_t, Lru_List::iterator> > Disk_Map;
+
+  static uint64_t Fnv_Offset() { return 14695981039346656037ULL; }
+
+  static uint64_t Hash_Bytes(uint64_t hash, const void * data, const size_t size)
+  {
+    const unsigned char * bytes = static_cast<const unsigned char *>(data);
+    for (size_t i = 0; i < size; ++i)
+    {
+      hash ^= bytes[i];
+      hash *= 1099511628211ULL;
+    }
+    return hash;
+  }
+
+  static std::string To_Hex(const uint64_t hash)
+  {
+    std::ostringstream os;
+    os << std::hex << std::setw(16) << std::setfill('0') << hash;
+    return os.str();
+  }
+
+  template <typename T>
+  static void To_Image(const Entry & entry, image::Image<T> & image)
+  {
+    image.resize(entry.width, entry.height);
+    if (!entry.data.empty())
+      std::memcpy(image.data(), &entry.data[0], entry.data.size());
+  }
+
+  //--
+  // In-process tier
+  //--
+
+  void Put_Memory(const std::string & key, const Entry & entry)
+  {
+    Erase_Memory(key);
+    if (entry.Size() > _memory_budget)
+      return;
+    _memory_lru.push_front(key);
+    _memory[key] = std::make_pair(entry, _memory_lru.begin());
+    _memory_size += entry.Size();
+    while (_memory_size > _memory_budget)
+    {
+      Erase_Memory(_memory_lru.back());
+      ++_statistics.evictions;
+    }
+  }
+
+  void Erase_Memory(const std::string & key)
+  {
+    Memory_Map::iterator it = _memory.find(key);
+    if (it == _memory.end())
+      return;
+    _memory_size -= it->second.first.Size();
+    _memory_lru.erase(it->second.second);
+    _memory.erase(it);
+  }
+
+  //--
+  // On-disk tier: one file per entry (width, height, pixel size, pixels) and an
+  //  index file listing the entries and their sizes (least recently used first)
+  //--
+
+  std::string Entry_Path(const std::string & key) const
+  {
+    return _directory + "/" + key + ".bin";
+  }
+
+  std::string Index_Path() const
+  {
+    return _directory + "/pyramid_cache_index.txt";
+  }
+
+  void Load_Index()
+  {
+    if (_directory.empty())
+      return;
+    std::ifstream stream(Index_Path().c_str());
+    std::string key;
+    size_t size;
+    while (stream >> key >> size)
+      Touch_Disk(key, size);
+  }
+
+  void Save_Index() const
+  {
+    std::ofstream stream(Index_Path().c_str());
+    for (Lru_List::const_reverse_iterator it = _disk_lru.rbegin(); it != _disk_lru.rend(); ++it)
+      stream << *it << ' ' << _disk.find(*it)->second.first << '\n';
+  }
+
+  /// Set an entry as the most recently used one
+  void Touch_Disk(const std::string & key, const size_t size)
+  {
+    Erase_Disk_Index(key);
+    _disk_lru.push_front(key);
+    _disk[key] = std::make_pair(size, _disk_lru.begin());
+    _disk_size += size;
+  }
+
+  void Erase_Disk_Index(const std::string & key)
+  {
+    Disk_Map::iterator it = _disk.find(key);
+    if (it == _disk.end())
+      return;
+    _disk_size -= it->second.first;
+    _disk_lru.erase(it->second.second);
+    _disk.erase(it);
+  }
+
+  bool Read_Disk(const std::string & key, const int pixel_size, Entry & entry)
+  {
+    if (_directory.empty() || _disk.find(key) == _disk.end())
+      return false;
+    std::ifstream stream(Entry_Path(key).c_str(), std::ios::binary);
+    int header[3];
+    bool ok = static_cast<bool>(stream.read(reinterpret_cast<char*>(header), sizeof(header)));
+    if (ok)
+    {
+      if (header[2] != pixel_size)
+        return false;
+      entry.width = header[0];
+      entry.height = header[1];
+      entry.pixel_size = header[2];
+      entry.data.resize(entry.Size());
+      ok = entry.data.empty() ||
+        stream.read(reinterpret_cast<char*>(&entry.data[0]), entry.data.size());
+    }
+    if (!ok)
+    {
+      // Missing or truncated file: forget the entry
+      Erase_Disk_Index(key);
+      std::remove(Entry_Path(key).c_str());
+      Save_Index();
+      return false;
+    }
+    Touch_Disk(key, sizeof(header) + entry.Size());
+    Save_Index();
+    return true;
+  }
+
+  void Write_Disk(const std::string & key, const Entry & entry)
+  {
+    if (_directory.empty())
+      return;
+    const size_t size = sizeof(int) * 3 + entry.Size();
+    if (size > _disk_budget)
+      return;
+    std::ofstream stream(Entry_Path(key).c_str(), std::ios::binary);
+    const int header[3] = {entry.width, entry.height, entry.pixel_size};
+    stream.write(reinterpret_cast<const char*>(header), sizeof(header));
+    if (!entry.data.empty())
+      stream.write(reinterpret_cast<const char*>(&entry.data[0]), entry.data.size());
+    if (!stream)
+      return;
+    stream.close();
+    Touch_Disk(key, size);
+    while (_disk_size > _disk_budget)
+    {
+      const std::string evicted = _disk_lru.back();
+      Erase_Disk_Index(evicted);
+      std::remove(Entry_Path(evicted).c_str());
+      ++_statistics.evictions;
+    }
+    Save_Index();
+  }
+
+  size_t _memory_budget, _memory_size;
+  Lru_List _memory_lru;
+  Memory_Map _memory;
+
+  std::string _directory;
+  size_t _disk_budget, _disk_size;
+  Lru_List _disk_lru;
+  Disk_Map _disk;
+
+  Statistics _statistics;
+  mutable std::mutex _mutex;
+};
+
+} // namespace features
+} // namespace openMVG
+
+#endif // OPENMVG_FEATURES_IMAGE_PYRAMID_CACHE_HPP
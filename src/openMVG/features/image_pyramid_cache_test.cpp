@@ -0,0 +1,109 @@
+
+// Copyright (c) 2015 Pierre MOULON.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "openMVG/features/image_pyramid_cache.hpp"
+#include "testing/testing.h"
+
+#include <cstdio>
+
+using namespace openMVG;
+using namespace openMVG::image;
+using namespace openMVG::features;
+
+static Image<float> Level(const int width, const int height, const float value)
+{
+  Image<float> level(width, height);
+  for (int y = 0; y < height; ++y)
+    for (int x = 0; x < width; ++x)
+      level(y, x) = value + x - y;
+  return level;
+}
+
+TEST(Image_Pyramid_Cache, Hash)
+{
+  Image<unsigned char> image(10, 8, true, 12);
+  const std::string hash = Image_Pyramid_Cache::Hash_Image(image);
+  EXPECT_EQ(size_t(16), hash.size());
+  EXPECT_EQ(hash, Image_Pyramid_Cache::Hash_Image(Image<unsigned char>(10, 8, true, 12)));
+  // Same pixels, other size
+  EXPECT_FALSE((hash == Image_Pyramid_Cache::Hash_Image(Image<unsigned char>(8, 10, true, 12))));
+  image(3, 4) = 13;
+  EXPECT_FALSE((hash == Image_Pyramid_Cache::Hash_Image(image)));
+  EXPECT_TRUE(Image_Pyramid_Cache::Hash_File("not_a_file.jpg").empty());
+}
+
+TEST(Image_Pyramid_Cache, MemoryLRU)
+{
+  // Room for two 10x10 float levels
+  Image_Pyramid_Cache cache(2 * 10 * 10 * sizeof(float));
+  Image<float> level;
+  EXPECT_FALSE(cache.Get("a", level));
+
+  cache.Put("a", Level(10, 10, 1.f));
+  cache.Put("b", Level(10, 10, 2.f));
+  EXPECT_TRUE(cache.Get("a", level)); // "a" is now the most recently used
+  EXPECT_EQ(0.f, (level.GetMat() - Level(10, 10, 1.f).GetMat()).array().abs().maxCoeff());
+
+  cache.Put("c", Level(10, 10, 3.f)); // evicts "b"
+  EXPECT_FALSE(cache.Get("b", level));
+  EXPECT_TRUE(cache.Get("a", level));
+  EXPECT_TRUE(cache.Get("c", level));
+  EXPECT_EQ(3.f, level(0, 0));
+
+  // An entry is returned with its own pixel type only
+  Image<unsigned char> gray;
+  EXPECT_FALSE(cache.Get("c", gray));
+
+  const Image_Pyramid_Cache::Statistics stats = cache.Get_statistics();
+  EXPECT_EQ(size_t(3), stats.memory_hits);
+  EXPECT_EQ(size_t(3), stats.misses);
+  EXPECT_EQ(size_t(1), stats.evictions);
+
+  // Too large entries are not kept
+  cache.Put("d", Level(20, 20, 4.f));
+  EXPECT_FALSE(cache.Get("d", level));
+  EXPECT_TRUE(cache.Get("c", level));
+}
+
+TEST(Image_Pyramid_Cache, DiskLRU)
+{
+  const size_t level_size = 3 * sizeof(int) + 10 * 10 * sizeof(float);
+  {
+    // No memory tier, room for two levels on disk
+    Image_Pyramid_Cache cache(0, ".", 2 * level_size);
+    cache.Put("temp_pyr_a", Level(10, 10, 1.f));
+    cache.Put("temp_pyr_b", Level(10, 10, 2.f));
+    Image<float> level;
+    EXPECT_TRUE(cache.Get("temp_pyr_a", level));
+  }
+  {
+    // The entries and their usage order are kept by the next runs
+    Image_Pyramid_Cache cache(0, ".", 2 * level_size);
+    Image<float> level;
+    EXPECT_TRUE(cache.Get("temp_pyr_b", level));
+    EXPECT_EQ(2.f, level(0, 0));
+    EXPECT_TRUE(cache.Get("temp_pyr_a", level));
+    EXPECT_EQ(0.f, (level.GetMat() - Level(10, 10, 1.f).GetMat()).array().abs().maxCoeff());
+    EXPECT_EQ(size_t(2), cache.Get_statistics().disk_hits);
+
+    Image<unsigned char> gray(10, 10, true, 7);
+    cache.Put("temp_pyr_gray", gray); // evicts "temp_pyr_b" (least recently used)
+    EXPECT_FALSE(cache.Get("temp_pyr_b", level));
+    EXPECT_TRUE(cache.Get("temp_pyr_a", level));
+    gray.fill(0);
+    EXPECT_TRUE(cache.Get("temp_pyr_gray", gray));
+    EXPECT_EQ(7, gray(9, 9));
+  }
+  std::remove("temp_pyr_a.bin");
+  std::remove("temp_pyr_b.bin");
+  std::remove("temp_pyr_gray.bin");
+  std::remove("pyramid_cache_index.txt");
+}
+
+/* ************************************************************************* */
+int main() { TestResult tr; return TestRegistry::runAllTests(tr);}
+/* ************************************************************************* */
@@ -29,11 +29,10 @@ const int MAX_PIXEL_NUM  = 1681;
 const int MAX_SAMPLE_NUM = 10;
 const int LIOP_NUM = 4;
 const int REGION_NUM = 6;
-
-Liop_Descriptor_Extractor::Liop_Descriptor_Extractor()
-{
-  GeneratePatternMap( m_LiopPatternMap, m_LiopPosWeight, LIOP_NUM);
-}
+const int SCALE_PATCH_WIDTH = 31;
+const int OUT_PATCH_WIDTH = SCALE_PATCH_WIDTH+6;
+const int LS_RADIUS = 6;
+const int GRAY_BIN_NUM = 256;
 
 struct Pixel{
   float x, y; // position
@@ -92,7 +91,7 @@ bool BilinearInterpolation_BorderCheck(
 }
 
 //non descend
-void SortGray(float* dst, int* idx, float* src, int len)
+inline void SortGray(float* dst, int* idx, float* src, int len)
 {
   int i, j;
 
@@ -171,6 +170,117 @@ void ThreshNorm(float* des, int dim, float illuThresh)
   }
 }
 
+Liop_Descriptor_Extractor::Liop_Descriptor_Extractor()
+{
+  GeneratePatternMap( m_LiopPatternMap, m_LiopPosWeight, LIOP_NUM);
+
+  //-- Pattern of each ordering of the neighbours, indexed by the neighbour
+  //    indexes sorted by intensity (2 bits per index)
+  m_LiopPatternLUT.assign(1 << (2*LIOP_NUM), 0);
+  for (int code = 0; code < static_cast<int>(m_LiopPatternLUT.size()); ++code)
+  {
+    int key = 0;
+    for (int k=0; k<LIOP_NUM; ++k)
+    {
+      const int idx = (code >> (2*(LIOP_NUM-k-1))) & 3;
+      key += (idx+1)* m_LiopPosWeight[LIOP_NUM-k-1];
+    }
+    std::map<int, unsigned char>::const_iterator iter = m_LiopPatternMap.find(key);
+    if (iter != m_LiopPatternMap.end())
+      m_LiopPatternLUT[code] = iter->second;
+  }
+
+  //-- Neighbour sampling of the pixels of the LIOP region (same positions and
+  //    weights as CreateLIOP_GOrder). The pixels that have a neighbour out of
+  //    the patch are never described and so are not listed.
+  const int outRadius = OUT_PATCH_WIDTH / 2;
+  const int inRadius = SCALE_PATCH_WIDTH / 2;
+  const float inRadius2 = float(inRadius*inRadius);
+  const float theta = 2.0f*M_PI/(float)LIOP_NUM;
+
+  for (int y=-inRadius; y<=inRadius; ++y)
+  {
+    for (int x=-inRadius; x<=inRadius; ++x)
+    {
+      float dis2 = (float)(x*x + y*y);
+      if(dis2 > inRadius2)
+        continue;
+
+      const float nDirX = static_cast<float>(x);
+      const float nDirY = static_cast<float>(y);
+      float nOri = atan2(nDirY, nDirX);
+      if (fabs(nOri - M_PI) < FLT_EPSILON)	//[-M_PI, M_PI)
+      {
+        nOri = static_cast<float>(-M_PI);
+      }
+
+      Region_Pixel pixel;
+      pixel.index = (y+outRadius)*OUT_PATCH_WIDTH+x+outRadius;
+      bool isInBound = true;
+      for (int k=0; k<LIOP_NUM; k++)
+      {
+        const float deltaX = LS_RADIUS * cos(nOri+k*theta);
+        const float deltaY = LS_RADIUS * sin(nOri+k*theta);
+
+        const float sampleX = x+deltaX+outRadius;
+        const float sampleY = y+deltaY+outRadius;
+        if(!(sampleX >= 0 && sampleY >= 0 &&
+             sampleX <= OUT_PATCH_WIDTH-1 && sampleY <= OUT_PATCH_WIDTH-1))
+        {
+          isInBound = false;
+          break;
+        }
+
+        const int x1 = (int)sampleX;
+        const int y1 = (int)sampleY;
+        const int x2 = (x1 == OUT_PATCH_WIDTH-1) ? x1 : x1+1;
+        const int y2 = (y1 == OUT_PATCH_WIDTH-1) ? y1 : y1+1;
+
+        Neighbour_Sample & sample = pixel.sample[k];
+        sample.index[0] = y1*OUT_PATCH_WIDTH+x1;
+        sample.index[1] = y1*OUT_PATCH_WIDTH+x2;
+        sample.index[2] = y2*OUT_PATCH_WIDTH+x1;
+        sample.index[3] = y2*OUT_PATCH_WIDTH+x2;
+        sample.weight[0] = (x2 - sampleX) * (y2 - sampleY);
+        sample.weight[1] = (sampleX - x1) * (y2 - sampleY);
+        sample.weight[2] = (x2 - sampleX) * (sampleY - y1);
+        sample.weight[3] = (sampleX - x1) * (sampleY - y1);
+      }
+      if (!isInBound)
+        continue;
+
+      // Are all the samples in the patch disk (flagged if the patch is in the image)?
+      pixel.inPatchDisk = true;
+      for (int k=0; k<LIOP_NUM; k++)
+      {
+        for (int j=0; j<4; ++j)
+        {
+          const int dx = pixel.sample[k].index[j] % OUT_PATCH_WIDTH - outRadius;
+          const int dy = pixel.sample[k].index[j] / OUT_PATCH_WIDTH - outRadius;
+          if (dx*dx + dy*dy > outRadius*outRadius)
+            pixel.inPatchDisk = false;
+        }
+      }
+      m_RegionPixels.push_back(pixel);
+    }
+  }
+
+  //-- Gaussian kernel of the patch smoothing (as image::ImageGaussianFilter(patch, 1.2))
+  const double sigma = 1.2;
+  const int k_size = (int) 2 * 3 * sigma + 1;
+  const int half_k_size = k_size / 2;
+  const double exp_scale = 1.0 / ( 2.0 * sigma * sigma );
+  Vec kernel( k_size );
+  double sum = 0;
+  for( int i = 0; i < k_size; ++i )
+  {
+    const double dx = (i - half_k_size);
+    kernel( i ) = exp( - dx * dx * exp_scale );
+    sum += kernel( i );
+  }
+  m_GaussianKernel = (kernel * (1.0 / sum)).cast<float>().transpose();
+}
+
 void Liop_Descriptor_Extractor::CreateLIOP_GOrder(
   const image::Image<float> & outPatch,
   const image::Image<unsigned char> & flagPatch,
@@ -353,6 +463,250 @@ void Liop_Descriptor_Extractor::extract(
   CreateLIOP_GOrder(outPatch, flagPatch, inRadius, desc);
 }
 
+/// Per thread buffers of the batched extraction
+struct Liop_Descriptor_Extractor::Patch_Buffers
+{
+  image::RowMatrixXf patch, smoothed_patch;
+  std::vector<unsigned char> flags;
+  std::vector<float> grays, sorted_grays;
+  std::vector<unsigned char> patterns;
+  std::vector<int> bin_start, bin_cursor;
+};
+
+/// Linear sampling position and coefficients along an axis
+///  (as computed by image::Sampler2d<image::SamplerLinear>)
+struct Linear_Sample
+{
+  Linear_Sample() {}
+  explicit Linear_Sample(const float pos)
+  {
+    const double d = static_cast<double>(pos) - floor(pos);
+    coef[0] = 1.0 - d;
+    coef[1] = d;
+    grid = static_cast<int>(floor(pos));
+  }
+  double coef[2];
+  int grid;
+};
+
+/// image::Sampler2d<image::SamplerLinear> sampling of a pixel whose four
+///  neighbours are in the image (same arithmetic)
+inline unsigned char SampleLinear(
+  const image::Image<unsigned char> & I,
+  const Linear_Sample & sy,
+  const Linear_Sample & sx)
+{
+  double res = 0.0;
+  double total_weight = 0.0;
+  for (int i = 0; i < 2; ++i)
+  {
+    const unsigned char * row = I.data() + (sy.grid+i) * I.Width() + sx.grid;
+    for (int j = 0; j < 2; ++j)
+    {
+      const double w = sx.coef[j] * sy.coef[i];
+      res += static_cast<double>(row[j]) * w;
+      total_weight += w;
+    }
+  }
+  if (total_weight != 1.0)
+    res /= total_weight;
+  return (res < 0.0) ? 0 : (res > 255.0 ? 255 : static_cast<unsigned char>(res + 0.5));
+}
+
+inline int GrayBin(const float gray)
+{
+  return std::min(std::max(static_cast<int>(gray), 0), GRAY_BIN_NUM-1);
+}
+
+void Liop_Descriptor_Extractor::extract_fast(
+  const image::Image<unsigned char> & I,
+  const SIOPointFeature & feat,
+  float desc[144],
+  Patch_Buffers & buffers) const
+{
+  std::fill(desc, desc+144, 0.f);
+
+  //a. extract the local patch
+  const int outRadius = OUT_PATCH_WIDTH/2;
+  const int outRadius2 = outRadius*outRadius;
+  const float scale = feat.scale();
+
+  buffers.patch.setZero(OUT_PATCH_WIDTH, OUT_PATCH_WIDTH);
+  buffers.flags.assign(OUT_PATCH_WIDTH*OUT_PATCH_WIDTH, 0);
+
+  const image::Sampler2d<image::SamplerLinear> sampler;
+
+  float * outPatch_data = buffers.patch.data();
+  unsigned char * flagPatch_data = &buffers.flags[0];
+
+  // Linear sampling coefficients of the patch columns (shared by the rows)
+  Linear_Sample sample_x[OUT_PATCH_WIDTH];
+  for(int x=-outRadius; x<=outRadius; ++x)
+    sample_x[x+outRadius] = Linear_Sample(x*scale+feat.x());
+
+  for(int y=-outRadius; y<=outRadius; ++y)
+  {
+    const float ys = y*scale+feat.y();
+    if(ys<0 || ys>I.Height()-1)
+      continue;
+    const Linear_Sample sample_y(ys);
+
+    for(int x=-outRadius; x<=outRadius; ++x)
+    {
+      const float dis2 = (float)(x*x + y*y);
+      if(dis2 > outRadius2)
+        continue;
+
+      const float xs = x*scale+feat.x();
+      if(xs<0 || xs>I.Width()-1)
+        continue;
+
+      const Linear_Sample & sx = sample_x[x+outRadius];
+      outPatch_data[(y+outRadius)*OUT_PATCH_WIDTH+x+outRadius] =
+        (sx.grid+1 < I.Width() && sample_y.grid+1 < I.Height()) ?
+        SampleLinear(I, sample_y, sx) : sampler(I, ys, xs);
+      flagPatch_data[(y+outRadius)*OUT_PATCH_WIDTH+x+outRadius] = 1;
+    }
+  }
+  buffers.smoothed_patch.resize(OUT_PATCH_WIDTH, OUT_PATCH_WIDTH);
+  image::SeparableConvolution2d(buffers.patch, m_GaussianKernel, m_GaussianKernel,
+    &buffers.smoothed_patch);
+
+  //b. LIOP pattern of the region pixels (precomputed neighbour sampling)
+  // If the patch is in the image, the flagged pixels are the ones of the patch disk
+  const bool isPatchInImage =
+    -outRadius*scale+feat.y() >= 0 && outRadius*scale+feat.y() <= I.Height()-1 &&
+    -outRadius*scale+feat.x() >= 0 && outRadius*scale+feat.x() <= I.Width()-1;
+  const float * data = buffers.smoothed_patch.data();
+  buffers.grays.resize(m_RegionPixels.size());
+  buffers.patterns.resize(m_RegionPixels.size());
+  int pixelCount = 0;
+  for (size_t i = 0; i < m_RegionPixels.size(); ++i)
+  {
+    const Region_Pixel & pixel = m_RegionPixels[i];
+    if (isPatchInImage)
+    {
+      if (!pixel.inPatchDisk)
+        continue;
+    }
+    else if (flagPatch_data[pixel.index] == 0)
+      continue;
+
+    float src[LIOP_NUM];
+    bool isInBound = true;
+    for (int k=0; k<LIOP_NUM; ++k)
+    {
+      const Neighbour_Sample & sample = pixel.sample[k];
+      if (!isPatchInImage &&
+          (flagPatch_data[sample.index[0]] == 0 ||
+           flagPatch_data[sample.index[1]] == 0 ||
+           flagPatch_data[sample.index[2]] == 0 ||
+           flagPatch_data[sample.index[3]] == 0))
+      {
+        isInBound = false;
+        break;
+      }
+      src[k] =
+        sample.weight[0] * data[sample.index[0]] +
+        sample.weight[1] * data[sample.index[1]] +
+        sample.weight[2] * data[sample.index[2]] +
+        sample.weight[3] * data[sample.index[3]];
+    }
+    if (!isInBound)
+      continue;
+
+    int idx[LIOP_NUM];
+    float dst[LIOP_NUM];
+    SortGray(dst, idx, src, LIOP_NUM);
+    int code = 0;
+    for (int k=0; k<LIOP_NUM; ++k)
+      code = (code << 2) | idx[k];
+
+    buffers.grays[pixelCount] = data[pixel.index];
+    buffers.patterns[pixelCount] = m_LiopPatternLUT[code];
+    ++pixelCount;
+  }
+
+  if (pixelCount < REGION_NUM)
+    return;
+
+  //c. intensity order binning: counting sort of the pixels on their quantized
+  //    intensity, the exact fence intensities are selected in their bin only
+  std::vector<int> & bin_start = buffers.bin_start;
+  std::vector<int> & bin_cursor = buffers.bin_cursor;
+  bin_start.assign(GRAY_BIN_NUM+1, 0);
+  for (int i = 0; i < pixelCount; ++i)
+    ++bin_start[GrayBin(buffers.grays[i])+1];
+  for (int b = 0; b < GRAY_BIN_NUM; ++b)
+    bin_start[b+1] += bin_start[b];
+  bin_cursor.assign(bin_start.begin(), bin_start.end()-1);
+  buffers.sorted_grays.resize(pixelCount);
+  for (int i = 0; i < pixelCount; ++i)
+    buffers.sorted_grays[bin_cursor[GrayBin(buffers.grays[i])]++] = buffers.grays[i];
+
+  float fenceGray[REGION_NUM];
+  for (int i=0; i<REGION_NUM; ++i)
+  {
+    const int fenceId = pixelCount*(i+1)/REGION_NUM-1;
+    const int bin = static_cast<int>(
+      std::upper_bound(bin_start.begin(), bin_start.end(), fenceId) - bin_start.begin()) - 1;
+    float * first = &buffers.sorted_grays[0] + bin_start[bin];
+    float * last = &buffers.sorted_grays[0] + bin_start[bin+1];
+    std::nth_element(first, &buffers.sorted_grays[fenceId], last);
+    fenceGray[i] = buffers.sorted_grays[fenceId];
+  }
+
+  // As in CreateLIOP_GOrder, a region starts at the first pixel of the fence
+  //  intensity of the previous region: these pixels are counted in both regions
+  float fenceLowGray[REGION_NUM];
+  for (int r = 0; r < REGION_NUM; ++r)
+  {
+    fenceLowGray[r] = fenceGray[r];
+    const int first = bin_start[GrayBin(fenceGray[r]-FLT_EPSILON)];
+    const int last = bin_start[GrayBin(fenceGray[r]+FLT_EPSILON)+1];
+    for (int i = first; i < last; ++i)
+      if (fabs(buffers.sorted_grays[i]-fenceGray[r]) < FLT_EPSILON)
+        fenceLowGray[r] = std::min(fenceLowGray[r], buffers.sorted_grays[i]);
+  }
+
+  const int l_patternWidth = LIOP_NUM == 3 ? 6 : 24;
+  for (int i = 0; i < pixelCount; ++i)
+  {
+    const float gray = buffers.grays[i];
+    int regionId = 0;
+    while (gray > fenceGray[regionId])
+      ++regionId;
+    while (true)
+    {
+      desc[regionId*l_patternWidth+buffers.patterns[i]] += 1.f;
+      if (regionId == REGION_NUM-1 || gray < fenceLowGray[regionId])
+        break;
+      ++regionId;
+    }
+  }
+
+  ThreshNorm(desc,l_patternWidth*REGION_NUM,1.f);
+}
+
+void Liop_Descriptor_Extractor::extract(
+  const image::Image<unsigned char> & I,
+  const std::vector<SIOPointFeature> & feats,
+  std::vector<float> & descs) const
+{
+  descs.resize(feats.size() * 144);
+#ifdef OPENMVG_USE_OPENMP
+  #pragma omp parallel
+#endif
+  {
+    Patch_Buffers buffers;
+#ifdef OPENMVG_USE_OPENMP
+    #pragma omp for schedule(dynamic, 16)
+#endif
+    for (int i = 0; i < static_cast<int>(feats.size()); ++i)
+      extract_fast(I, feats[i], &descs[i * 144], buffers);
+  }
+}
+
 template<typename T>
 bool NextPermutation(std::vector<T> & p, int n)
 {
@@ -32,15 +32,58 @@ class Liop_Descriptor_Extractor
 private:
   std::map<int, unsigned char> m_LiopPatternMap;
   std::vector<int> m_LiopPosWeight;
+
+  /// Bilinear sampling of a neighbour in the patch (pixel indexes and weights)
+  struct Neighbour_Sample
+  {
+    int index[4];
+    float weight[4];
+  };
+  /// Pixel of the LIOP region with its precomputed LIOP_NUM neighbour samples
+  struct Region_Pixel
+  {
+    int index;
+    Neighbour_Sample sample[4];
+    bool inPatchDisk; // all the samples are in the patch disk
+  };
+  /// Precomputed sampling of the LIOP region (depends only on the patch radius)
+  std::vector<Region_Pixel> m_RegionPixels;
+  /// LIOP pattern of each neighbour ordering (2 bits per neighbour index)
+  std::vector<unsigned char> m_LiopPatternLUT;
+  /// Gaussian kernel used to smooth the patch
+  Eigen::Matrix<float, 1, Eigen::Dynamic> m_GaussianKernel;
+
+  struct Patch_Buffers;
+  void extract_fast(
+    const image::Image<unsigned char> & I,
+    const SIOPointFeature & feat,
+    float desc[144],
+    Patch_Buffers & buffers) const;
+
 public:
 
   Liop_Descriptor_Extractor();
 
+  /// Reference implementation (one keypoint)
   void extract(
     const image::Image<unsigned char> & I,
     const SIOPointFeature & feat,
     float desc[144]);
 
+  /**
+  * @brief Describe a batch of keypoints (same output as the reference extract).
+  * The neighbour sampling positions and weights are precomputed once, the pixels
+  *  are binned with a counting sort on their quantized intensity (instead of a
+  *  std::sort of the patch) and the buffers are reused by the keypoints of a thread.
+  * @param I The image
+  * @param feats The keypoints
+  * @param descs The descriptors (144 floats per keypoint)
+  */
+  void extract(
+    const image::Image<unsigned char> & I,
+    const std::vector<SIOPointFeature> & feats,
+    std::vector<float> & descs) const;
+
   void CreateLIOP_GOrder(
     const image::Image<float> & outPatch,
     const image::Image<unsigned char> & flagPatch,
@@ -0,0 +1,109 @@
+
+// Copyright (c) 2015 Pierre MOULON.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "openMVG/features/liop/liop_descriptor.hpp"
+#include "testing/testing.h"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+using namespace openMVG;
+using namespace openMVG::image;
+using namespace openMVG::features;
+
+// Smoothed random texture (no large flat area)
+static Image<unsigned char> TextureImage(const int width, const int height)
+{
+  Image<float> noise(width, height);
+  srand(7);
+  for (int y = 0; y < height; ++y)
+  for (int x = 0; x < width; ++x)
+    noise(y, x) = static_cast<float>(rand() % 256);
+  Image<float> smoothed;
+  ImageGaussianFilter(noise, 2.0, smoothed);
+  const float minV = smoothed.GetMat().minCoeff(), maxV = smoothed.GetMat().maxCoeff();
+  Image<unsigned char> out(width, height);
+  for (int y = 0; y < height; ++y)
+  for (int x = 0; x < width; ++x)
+    out(y, x) = static_cast<unsigned char>((smoothed(y, x) - minV) / (maxV - minV) * 255.f);
+  return out;
+}
+
+// Keypoints of various scales, some of them close to the image border
+static std::vector<SIOPointFeature> Keypoints(const int width, const int height, const int count)
+{
+  std::vector<SIOPointFeature> feats;
+  for (int k = 0; k < count; ++k)
+  {
+    const float x = (k * 7919) % (width * 10) / 10.f;
+    const float y = (k * 104729) % (height * 10) / 10.f;
+    const float scale = 0.5f + (k % 9) * 0.5f;
+    feats.push_back(SIOPointFeature(x, y, scale, 0.f));
+  }
+  return feats;
+}
+
+TEST(LIOP, BatchedSameAsReference)
+{
+  const Image<unsigned char> image = TextureImage(320, 240);
+  const std::vector<SIOPointFeature> feats = Keypoints(image.Width(), image.Height(), 500);
+
+  LIOP::Liop_Descriptor_Extractor liop_extractor;
+  std::vector<float> descs;
+  liop_extractor.extract(image, feats, descs);
+  EXPECT_EQ(feats.size() * 144, descs.size());
+
+  int same_count = 0;
+  float max_diff = 0.f;
+  for (size_t i = 0; i < feats.size(); ++i)
+  {
+    float desc[144];
+    liop_extractor.extract(image, feats[i], desc);
+    float diff = 0.f;
+    for (int j = 0; j < 144; ++j)
+      diff = std::max(diff, std::abs(desc[j] - descs[i * 144 + j]));
+    if (diff == 0.f)
+      ++same_count;
+    max_diff = std::max(max_diff, diff);
+  }
+  // A floating point contraction may flip the ordinal pattern of a pixel whose
+  //  neighbours have the same intensity: the descriptors are almost always identical.
+  EXPECT_TRUE(same_count >= static_cast<int>(feats.size()) * 99 / 100);
+  EXPECT_TRUE(max_diff < 0.1f);
+}
+
+TEST(LIOP, Throughput)
+{
+  const Image<unsigned char> image = TextureImage(640, 480);
+  const std::vector<SIOPointFeature> feats = Keypoints(image.Width(), image.Height(), 4000);
+  LIOP::Liop_Descriptor_Extractor liop_extractor;
+
+  typedef std::chrono::steady_clock Clock;
+  const Clock::time_point t0 = Clock::now();
+  std::vector<float> ref_descs(feats.size() * 144);
+#ifdef OPENMVG_USE_OPENMP
+  #pragma omp parallel for
+#endif
+  for (int i = 0; i < static_cast<int>(feats.size()); ++i)
+    liop_extractor.extract(image, feats[i], &ref_descs[i * 144]);
+  const Clock::time_point t1 = Clock::now();
+  std::vector<float> descs;
+  liop_extractor.extract(image, feats, descs);
+  const Clock::time_point t2 = Clock::now();
+
+  const double ref_s = std::chrono::duration<double>(t1 - t0).count();
+  const double batch_s = std::chrono::duration<double>(t2 - t1).count();
+  std::cout << "LIOP throughput (keypoints/s): reference " << feats.size() / ref_s
+    << ", batched " << feats.size() / batch_s << std::endl;
+  EXPECT_EQ(ref_descs.size(), descs.size());
+}
+
+/* ************************************************************************* */
+int main() { TestResult tr; return TestRegistry::runAllTests(tr);}
+/* ************************************************************************* */
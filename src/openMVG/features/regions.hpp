@@ -9,6 +9,8 @@
 #define OPENMVG_FEATURES_REGIONS_HPP
 
 #include "openMVG/numeric/numeric.h"
+#include "openMVG/numeric/float16.hpp"
+#include "openMVG/types.hpp"
 #include "openMVG/features/feature.hpp"
 #include "openMVG/features/descriptor.hpp"
 #include "openMVG/matching/metric.hpp"
@@ -70,9 +72,19 @@ public:
   // - Binary: Hamming
   virtual double SquaredDescriptorDistance(size_t i, const Regions *, size_t j) const = 0;
 
+  /// Return the squared distances between the Inth descriptor and a list of
+  ///  descriptors of another Region container (same metric as SquaredDescriptorDistance)
+  // Batched version, the container type is checked only once
+  virtual void SquaredDescriptorDistances(
+    size_t i, const Regions *,
+    const IndexT * j, size_t count, double * distances) const = 0;
+
   /// Add the Inth region to another Region container
   virtual void CopyRegion(size_t i, Regions *) const = 0;
 
+  /// Translate the positions of all the regions (i.e. from a sub-image frame to the image frame)
+  virtual void TranslateRegions(const Vec2f & offset) = 0;
+
   virtual Regions * EmptyClone() const = 0;
 
 };
@@ -174,6 +186,24 @@ public:
     return metric(_vec_descs[i].getData(), regionsT->_vec_descs[j].getData(), DescriptorT::static_size);
   }
 
+  // Return the L2 distances between a descriptor and a list of descriptors
+  void SquaredDescriptorDistances(
+    size_t i, const Regions * regions,
+    const IndexT * j, size_t count, double * distances) const
+  {
+    assert(i < _vec_descs.size());
+    assert(regions);
+
+    const Scalar_Regions<FeatT, T, L> * regionsT = dynamic_cast<const Scalar_Regions<FeatT, T, L> *>(regions);
+    const matching::L2_Vectorized<T> metric;
+    const T * query = _vec_descs[i].getData();
+    for (size_t k = 0; k < count; ++k)
+    {
+      assert(j[k] < regions->RegionCount());
+      distances[k] = metric(query, regionsT->_vec_descs[j[k]].getData(), DescriptorT::static_size);
+    }
+  }
+
   /// Add the Inth region to another Region container
   void CopyRegion(size_t i, Regions * region_container) const
   {
@@ -182,6 +212,12 @@ public:
     static_cast<Scalar_Regions<FeatT, T, L> *>(region_container)->_vec_descs.push_back(_vec_descs[i]);
   }
 
+  void TranslateRegions(const Vec2f & offset)
+  {
+    for (size_t i = 0; i < _vec_feats.size(); ++i)
+      _vec_feats[i].coords() += offset;
+  }
+
 private:
   //--
   //-- internal data
@@ -290,6 +326,26 @@ public:
     return descDist * descDist;
   }
 
+  // Return the squared Hamming distances between a descriptor and a list of descriptors
+  void SquaredDescriptorDistances(
+    size_t i, const Regions * regions,
+    const IndexT * j, size_t count, double * distances) const
+  {
+    assert(i < _vec_descs.size());
+    assert(regions);
+
+    const Binary_Regions<FeatT, L> * regionsT = dynamic_cast<const Binary_Regions<FeatT, L> *>(regions);
+    const matching::Hamming<unsigned char> metric;
+    const unsigned char * query = _vec_descs[i].getData();
+    for (size_t k = 0; k < count; ++k)
+    {
+      assert(j[k] < regions->RegionCount());
+      const typename matching::Hamming<unsigned char>::ResultType descDist =
+        metric(query, regionsT->_vec_descs[j[k]].getData(), DescriptorT::static_size);
+      distances[k] = descDist * descDist;
+    }
+  }
+
   /// Add the Inth region to another Region container
   void CopyRegion(size_t i, Regions * region_container) const
   {
@@ -298,6 +354,12 @@ public:
     static_cast<Binary_Regions<FeatT, L> *>(region_container)->_vec_descs.push_back(_vec_descs[i]);
   }
 
+  void TranslateRegions(const Vec2f & offset)
+  {
+    for (size_t i = 0; i < _vec_feats.size(); ++i)
+      _vec_feats[i].coords() += offset;
+  }
+
 private:
   //--
   //-- internal data
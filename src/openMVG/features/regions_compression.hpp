@@ -0,0 +1,280 @@
+
+// Copyright (c) 2015 Pierre MOULON.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef OPENMVG_FEATURES_REGIONS_COMPRESSION_HPP
+#define OPENMVG_FEATURES_REGIONS_COMPRESSION_HPP
+
+#include "openMVG/features/regions_factory.hpp"
+#include "openMVG/numeric/float16.hpp"
+
+#include <Eigen/Eigenvalues>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <typeinfo>
+
+namespace openMVG {
+namespace features {
+
+/// Storage of the region descriptors (in memory and in the .desc files)
+enum EDESCRIPTOR_STORAGE
+{
+  DESCRIPTOR_STORAGE_FULL,    // descriptors as computed by the image describer
+  DESCRIPTOR_STORAGE_FLOAT16, // half precision floats (float descriptors only)
+  DESCRIPTOR_STORAGE_PCA64    // 64 PCA components quantized on 8 bits
+};
+
+/**
+ * Learned PCA projection of scalar descriptors to 64 components quantized on 8 bits.
+ * The same quantization step is used for all the components:
+ *  the squared L2 distance of two compressed descriptors approximates the one of the
+ *  original descriptors up to a constant factor (the distance ratio test is unchanged).
+ */
+class Descriptor_PCA
+{
+public:
+
+  static const int Dimension = 64;
+
+  Descriptor_PCA() : _scale(0.f) {}
+
+  /// Learn the projection from some descriptors (one descriptor per row).
+  /// Return false if there is not enough descriptors or if they are too short.
+  bool Learn(const Eigen::MatrixXf & descriptors)
+  {
+    if (descriptors.rows() < 2 || descriptors.cols() < Dimension)
+      return false;
+
+    const Eigen::MatrixXd samples = descriptors.cast<double>();
+    const Eigen::RowVectorXd mean = samples.colwise().mean();
+    const Eigen::MatrixXd centered = samples.rowwise() - mean;
+    const Eigen::MatrixXd covariance =
+      (centered.transpose() * centered) / static_cast<double>(samples.rows() - 1);
+
+    // The eigenvalues are sorted in increasing order: keep the last ones
+    const Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> solver(covariance);
+    if (solver.info() != Eigen::Success)
+      return false;
+    const Eigen::MatrixXd::Index n = covariance.cols();
+    _mean = mean.transpose().cast<float>();
+    _projection.resize(Dimension, n);
+    for (int i = 0; i < Dimension; ++i)
+      _projection.row(i) = solver.eigenvectors().col(n - 1 - i).transpose().cast<float>();
+
+    // Map +/- 3 standard deviations of the first component to the 8 bit range
+    const double max_variance = std::max(solver.eigenvalues()(n - 1), 1e-12);
+    _scale = static_cast<float>(127.5 / (3.0 * std::sqrt(max_variance)));
+    return true;
+  }
+
+  bool Is_learned() const { return _projection.rows() == Dimension; }
+
+  /// Length of the descriptors that can be compressed
+  size_t Input_dimension() const { return static_cast<size_t>(_projection.cols()); }
+
+  /// Project a descriptor and quantize its components
+  template <typename T>
+  void Project(const T * descriptor, unsigned char * out) const
+  {
+    const Eigen::VectorXf centered =
+      Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1> >(descriptor, _projection.cols())
+      .template cast<float>() - _mean;
+    const Eigen::VectorXf projected = (_projection * centered) * _scale;
+    for (int i = 0; i < Dimension; ++i)
+      out[i] = static_cast<unsigned char>(
+        std::min(255.f, std::max(0.f, std::floor(projected(i) + 128.f + 0.5f))));
+  }
+
+  /// Compress some regions (same features, projected descriptors)
+  template <typename FeatT, typename T, size_t L>
+  void Compress(
+    const Scalar_Regions<FeatT, T, L> & regions,
+    Scalar_Regions<FeatT, unsigned char, Dimension> & compressed) const
+  {
+    assert(Input_dimension() == L);
+    compressed.Features() = regions.Features();
+    compressed.Descriptors().resize(regions.RegionCount());
+#ifdef OPENMVG_USE_OPENMP
+    #pragma omp parallel for
+#endif
+    for (int i = 0; i < static_cast<int>(regions.RegionCount()); ++i)
+      Project(regions.Descriptors()[i].getData(), compressed.Descriptors()[i].getData());
+  }
+
+  /// Export the projection (binary file)
+  bool Save(const std::string & sFileName) const
+  {
+    std::ofstream file(sFileName.c_str(), std::ios::out | std::ios::binary);
+    const int cols = static_cast<int>(_projection.cols());
+    file.write((const char*) &cols, sizeof(int));
+    file.write((const char*) &_scale, sizeof(float));
+    file.write((const char*) _mean.data(), cols * sizeof(float));
+    file.write((const char*) _projection.data(), Dimension * cols * sizeof(float));
+    const bool bOk = file.good();
+    file.close();
+    return bOk;
+  }
+
+  /// Import a projection exported by Save
+  bool Load(const std::string & sFileName)
+  {
+    std::ifstream fileIn(sFileName.c_str(), std::ios::in | std::ios::binary);
+    int cols = 0;
+    fileIn.read((char*) &cols, sizeof(int));
+    if (!fileIn.good() || cols < Dimension)
+      return false;
+    fileIn.read((char*) &_scale, sizeof(float));
+    _mean.resize(cols);
+    _projection.resize(Dimension, cols);
+    fileIn.read((char*) _mean.data(), cols * sizeof(float));
+    fileIn.read((char*) _projection.data(), Dimension * cols * sizeof(float));
+    if (!fileIn.good())
+    {
+      _projection.resize(0, 0);
+      return false;
+    }
+    return true;
+  }
+
+private:
+  Eigen::VectorXf _mean;
+  Eigen::MatrixXf _projection; // one row per component
+  float _scale; // quantization: value = round(component * scale) + 128
+};
+
+/// Convert the float descriptors of some regions to half precision
+template <typename FeatT, size_t L>
+void Compress_Float16
+(
+  const Scalar_Regions<FeatT, float, L> & regions,
+  Scalar_Regions<FeatT, Float16, L> & compressed
+)
+{
+  compressed.Features() = regions.Features();
+  compressed.Descriptors().resize(regions.RegionCount());
+  for (size_t i = 0; i < regions.RegionCount(); ++i)
+  {
+    const float * desc = regions.Descriptors()[i].getData();
+    std::copy(desc, desc + L, compressed.Descriptors()[i].getData());
+  }
+}
+
+/// Copy the descriptors of scalar regions (unsigned char or float) to a matrix
+///  (one descriptor per row). Return false for the other region types.
+static bool Descriptors_To_Matrix
+(
+  const Regions & regions,
+  Eigen::MatrixXf & descriptors
+)
+{
+  typedef Eigen::Matrix<unsigned char, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> UcharMat;
+  typedef Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> FloatMat;
+  const Eigen::MatrixXf::Index rows = regions.RegionCount(), cols = regions.DescriptorLength();
+  if (!regions.IsScalar())
+    return false;
+  if (regions.Type_id() == typeid(unsigned char).name())
+    descriptors = rows == 0 ? Eigen::MatrixXf(0, cols) : Eigen::MatrixXf(Eigen::Map<const UcharMat>(
+      static_cast<const unsigned char *>(regions.DescriptorRawData()), rows, cols).cast<float>());
+  else if (regions.Type_id() == typeid(float).name())
+    descriptors = rows == 0 ? Eigen::MatrixXf(0, cols) : Eigen::MatrixXf(Eigen::Map<const FloatMat>(
+      static_cast<const float *>(regions.DescriptorRawData()), rows, cols));
+  else
+    return false;
+  return true;
+}
+
+/// Return the regions type used to store some regions type with the given storage
+///  (NULL if the storage does not apply to this region type)
+static std::unique_ptr<Regions> Compressed_Regions_Type
+(
+  const Regions & regions_type,
+  const EDESCRIPTOR_STORAGE eStorage
+)
+{
+  std::unique_ptr<Regions> compressed;
+  switch (eStorage)
+  {
+    case DESCRIPTOR_STORAGE_FULL:
+      compressed.reset(regions_type.EmptyClone());
+    break;
+    case DESCRIPTOR_STORAGE_FLOAT16:
+      if (dynamic_cast<const AKAZE_Float_Regions *>(&regions_type))
+        compressed.reset(new AKAZE_Float16_Regions);
+    break;
+    case DESCRIPTOR_STORAGE_PCA64:
+      if (dynamic_cast<const SIFT_Regions *>(&regions_type) ||
+          dynamic_cast<const AKAZE_Float_Regions *>(&regions_type) ||
+          dynamic_cast<const AKAZE_Liop_Regions *>(&regions_type))
+        compressed.reset(new PCA64_Regions);
+    break;
+  }
+  return compressed;
+}
+
+/**
+ * Return the regions with their descriptors stored in another way
+ *  (NULL if the storage does not apply to this region type):
+ * - DESCRIPTOR_STORAGE_FULL: a copy of the regions,
+ * - DESCRIPTOR_STORAGE_FLOAT16: AKAZE_Float_Regions to AKAZE_Float16_Regions,
+ * - DESCRIPTOR_STORAGE_PCA64: SIFT_Regions, AKAZE_Float_Regions and AKAZE_Liop_Regions
+ *   to PCA64_Regions (a PCA learned on the same descriptor type is required).
+ */
+static std::unique_ptr<Regions> Compress_Regions
+(
+  const Regions & regions,
+  const EDESCRIPTOR_STORAGE eStorage,
+  const Descriptor_PCA * pca = NULL
+)
+{
+  std::unique_ptr<Regions> compressed;
+  switch (eStorage)
+  {
+    case DESCRIPTOR_STORAGE_FULL:
+    {
+      compressed.reset(regions.EmptyClone());
+      for (size_t i = 0; i < regions.RegionCount(); ++i)
+        regions.CopyRegion(i, compressed.get());
+    }
+    break;
+    case DESCRIPTOR_STORAGE_FLOAT16:
+    {
+      const AKAZE_Float_Regions * akaze_float = dynamic_cast<const AKAZE_Float_Regions *>(&regions);
+      if (akaze_float)
+      {
+        AKAZE_Float16_Regions * half_regions = new AKAZE_Float16_Regions;
+        compressed.reset(half_regions);
+        Compress_Float16(*akaze_float, *half_regions);
+      }
+    }
+    break;
+    case DESCRIPTOR_STORAGE_PCA64:
+    {
+      if (pca == NULL || !pca->Is_learned() || pca->Input_dimension() != regions.DescriptorLength())
+        break;
+      PCA64_Regions * pca_regions = new PCA64_Regions;
+      compressed.reset(pca_regions);
+      if (const SIFT_Regions * sift = dynamic_cast<const SIFT_Regions *>(&regions))
+        pca->Compress(*sift, *pca_regions);
+      else if (const AKAZE_Float_Regions * akaze_float = dynamic_cast<const AKAZE_Float_Regions *>(&regions))
+        pca->Compress(*akaze_float, *pca_regions);
+      else if (const AKAZE_Liop_Regions * akaze_liop = dynamic_cast<const AKAZE_Liop_Regions *>(&regions))
+        pca->Compress(*akaze_liop, *pca_regions);
+      else
+        compressed.reset();
+    }
+    break;
+  }
+  return compressed;
+}
+
+} // namespace features
+} // namespace openMVG
+
+#endif // OPENMVG_FEATURES_REGIONS_COMPRESSION_HPP
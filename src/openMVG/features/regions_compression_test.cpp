@@ -0,0 +1,241 @@
+
+// Copyright (c) 2015 Pierre MOULON.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "openMVG/features/regions_compression.hpp"
+#include "openMVG/matching/matcher_brute_force.hpp"
+#include "testing/testing.h"
+
+#include <cmath>
+#include <cstdio>
+#include <limits>
+
+using namespace openMVG;
+using namespace openMVG::features;
+
+// Random database descriptors with a low rank structure (as real descriptors, most
+//  of the variance is in a few directions) followed by query descriptors:
+//  the query k is a noisy copy of the database descriptor Source(k).
+static size_t Source(const size_t k, const size_t database_count)
+{
+  return (k * 7) % database_count;
+}
+
+template <typename RegionsT>
+static void RandomRegions(
+  const int database_count, const int query_count, const float range, RegionsT & regions)
+{
+  typedef typename RegionsT::DescriptorT::bin_type T;
+  const size_t L = RegionsT::DescriptorT::static_size;
+  srand(11);
+  Eigen::MatrixXf basis(L, 16);
+  for (size_t i = 0; i < L; ++i)
+    for (int j = 0; j < 16; ++j)
+      basis(i, j) = rand() / float(RAND_MAX) / 8.f;
+  std::vector<Eigen::VectorXf> latents;
+  for (int k = 0; k < database_count + query_count; ++k)
+  {
+    Eigen::VectorXf latent(16);
+    for (int j = 0; j < 16; ++j)
+      latent(j) = (k < database_count) ?
+        rand() / float(RAND_MAX) :
+        latents[Source(k, database_count)](j) + (rand() / float(RAND_MAX) - 0.5f) * 0.05f;
+    latents.push_back(latent);
+    const Eigen::VectorXf desc = basis * latent * range / 2.f;
+    typename RegionsT::DescriptorT d;
+    for (size_t i = 0; i < L; ++i)
+      d[i] = static_cast<T>(std::min(range, std::max(0.f, desc(i) + rand() / float(RAND_MAX) * range / 50.f)));
+    regions.Descriptors().push_back(d);
+    regions.Features().push_back(SIOPointFeature(k, 2 * k, 1.f + k % 3, 0.f));
+  }
+}
+
+TEST(Float16, Conversions)
+{
+  EXPECT_EQ(0.f, float(Float16(0.f)));
+  EXPECT_EQ(1.f, float(Float16(1.f)));
+  EXPECT_EQ(-2.5f, float(Float16(-2.5f)));
+  EXPECT_EQ(65504.f, float(Float16(65504.f))); // largest finite value
+  EXPECT_EQ(std::ldexp(1.f, -24), float(Float16(std::ldexp(1.f, -24)))); // smallest subnormal
+  EXPECT_EQ(1.f, float(Float16(1.f + std::ldexp(1.f, -11)))); // tie: rounded to even
+  EXPECT_EQ(1.f + std::ldexp(1.f, -9), float(Float16(1.f + 3 * std::ldexp(1.f, -11))));
+  EXPECT_TRUE(std::isinf(float(Float16(1e6f))));
+  EXPECT_TRUE(std::isnan(float(Float16(std::numeric_limits<float>::quiet_NaN()))));
+
+  // All the non NaN values are converted back to themselves
+  size_t mismatch_count = 0;
+  for (int h = 0; h < 65536; ++h)
+  {
+    if ((h & 0x7c00) == 0x7c00 && (h & 0x3ff) != 0)
+      continue;
+    mismatch_count += Float16::From_float(Float16::To_float(uint16_t(h))) != h;
+  }
+  EXPECT_EQ(size_t(0), mismatch_count);
+
+  // Relative rounding error of the normal values
+  float max_error = 0.f;
+  for (int k = 1; k < 10000; ++k)
+  {
+    const float value = (k * 7919 % 10007) / 37.f;
+    max_error = std::max(max_error, std::abs(float(Float16(value)) - value) / value);
+  }
+  EXPECT_TRUE(max_error <= std::ldexp(1.f, -11));
+}
+
+TEST(Regions_Compression, Float16Regions)
+{
+  AKAZE_Float_Regions regions;
+  RandomRegions(200, 0, 1.f, regions);
+
+  std::unique_ptr<Regions> compressed = Compress_Regions(regions, DESCRIPTOR_STORAGE_FLOAT16);
+  AKAZE_Float16_Regions * half_regions = dynamic_cast<AKAZE_Float16_Regions *>(compressed.get());
+  EXPECT_TRUE(half_regions != NULL);
+  EXPECT_EQ(regions.RegionCount(), half_regions->RegionCount());
+  EXPECT_EQ(sizeof(Float16) * 64, sizeof(AKAZE_Float16_Regions::DescriptorT));
+
+  // Same features, nearly the same distances
+  double max_error = 0.0;
+  for (size_t i = 0; i < regions.RegionCount(); ++i)
+  {
+    EXPECT_TRUE(regions.Features()[i] == half_regions->Features()[i]);
+    const size_t j = (i * 37) % regions.RegionCount();
+    const double dist = regions.SquaredDescriptorDistance(i, &regions, j);
+    max_error = std::max(max_error,
+      std::abs(half_regions->SquaredDescriptorDistance(i, half_regions, j) - dist) / (dist + 1e-3));
+  }
+  EXPECT_TRUE(max_error < 1e-2);
+
+  // The .desc file is twice smaller and read back unchanged
+  EXPECT_TRUE(half_regions->Save("temp_half.feat", "temp_half.desc"));
+  EXPECT_TRUE(regions.Save("temp_full.feat", "temp_full.desc"));
+  std::ifstream half_file("temp_half.desc", std::ios::binary | std::ios::ate);
+  std::ifstream full_file("temp_full.desc", std::ios::binary | std::ios::ate);
+  EXPECT_EQ(sizeof(size_t) + 200 * 64 * 2, size_t(half_file.tellg()));
+  EXPECT_EQ(sizeof(size_t) + 200 * 64 * 4, size_t(full_file.tellg()));
+  half_file.close();
+  full_file.close();
+  AKAZE_Float16_Regions loaded;
+  EXPECT_TRUE(loaded.Load("temp_half.feat", "temp_half.desc"));
+  EXPECT_EQ(half_regions->RegionCount(), loaded.RegionCount());
+  size_t different_count = 0;
+  for (size_t i = 0; i < loaded.RegionCount(); ++i)
+    for (int k = 0; k < 64; ++k)
+      different_count += loaded.Descriptors()[i][k].bits != half_regions->Descriptors()[i][k].bits;
+  EXPECT_EQ(size_t(0), different_count);
+  std::remove("temp_half.feat");
+  std::remove("temp_half.desc");
+  std::remove("temp_full.feat");
+  std::remove("temp_full.desc");
+
+  // Only float descriptors can be stored as half precision floats
+  EXPECT_TRUE(Compress_Regions(SIFT_Regions(), DESCRIPTOR_STORAGE_FLOAT16) == NULL);
+  EXPECT_TRUE(Compressed_Regions_Type(SIFT_Regions(), DESCRIPTOR_STORAGE_FLOAT16) == NULL);
+  EXPECT_TRUE(dynamic_cast<AKAZE_Float16_Regions *>(
+    Compressed_Regions_Type(AKAZE_Float_Regions(), DESCRIPTOR_STORAGE_FLOAT16).get()) != NULL);
+}
+
+TEST(Regions_Compression, Float16Matching)
+{
+  AKAZE_Float_Regions regions;
+  RandomRegions(200, 100, 1.f, regions);
+  AKAZE_Float16_Regions half_regions;
+  Compress_Float16(regions, half_regions);
+
+  // The nearest neighbours are found from the half precision descriptors
+  typedef matching::ArrayMatcherBruteForce<float, matching::L2_Vectorized<float> > FloatMatcherT;
+  typedef matching::ArrayMatcherBruteForce<Float16, matching::L2_Vectorized<Float16> > HalfMatcherT;
+  FloatMatcherT float_matcher;
+  HalfMatcherT half_matcher;
+  const int database_count = 200, query_count = 100;
+  float_matcher.Build(regions.Descriptors()[0].getData(), database_count, 64);
+  half_matcher.Build(half_regions.Descriptors()[0].getData(), database_count, 64);
+  matching::IndMatches float_matches, half_matches;
+  std::vector<float> float_distances, half_distances;
+  EXPECT_TRUE(float_matcher.SearchNeighbours(regions.Descriptors()[database_count].getData(),
+    query_count, &float_matches, &float_distances, 1));
+  EXPECT_TRUE(half_matcher.SearchNeighbours(half_regions.Descriptors()[database_count].getData(),
+    query_count, &half_matches, &half_distances, 1));
+  EXPECT_EQ(float_matches.size(), half_matches.size());
+  int same_count = 0, found_count = 0;
+  for (size_t i = 0; i < std::min(float_matches.size(), half_matches.size()); ++i)
+  {
+    same_count += float_matches[i]._j == half_matches[i]._j;
+    found_count += half_matches[i]._j == Source(database_count + i, database_count);
+  }
+  EXPECT_TRUE(same_count >= query_count * 95 / 100);
+  EXPECT_TRUE(found_count >= query_count * 95 / 100);
+}
+
+TEST(Regions_Compression, PCA64Regions)
+{
+  SIFT_Regions regions;
+  RandomRegions(300, 100, 255.f, regions);
+
+  // No projection: no compression
+  Descriptor_PCA pca;
+  EXPECT_FALSE(pca.Is_learned());
+  EXPECT_TRUE(Compress_Regions(regions, DESCRIPTOR_STORAGE_PCA64, &pca) == NULL);
+
+  Eigen::MatrixXf descriptors;
+  EXPECT_TRUE(Descriptors_To_Matrix(regions, descriptors));
+  EXPECT_EQ(400, descriptors.rows());
+  EXPECT_EQ(128, descriptors.cols());
+  EXPECT_TRUE(pca.Learn(descriptors.topRows(300)));
+  EXPECT_EQ(size_t(128), pca.Input_dimension());
+
+  std::unique_ptr<Regions> compressed = Compress_Regions(regions, DESCRIPTOR_STORAGE_PCA64, &pca);
+  const PCA64_Regions * pca_regions = dynamic_cast<const PCA64_Regions *>(compressed.get());
+  EXPECT_TRUE(pca_regions != NULL);
+  EXPECT_EQ(regions.RegionCount(), pca_regions->RegionCount());
+  EXPECT_EQ(size_t(64), pca_regions->DescriptorLength());
+
+  // The nearest neighbours are kept (the descriptors are four times smaller)
+  int same_count = 0, found_count = 0, query_count = 0;
+  for (size_t i = 300; i < regions.RegionCount(); ++i, ++query_count)
+  {
+    size_t best[2] = {0, 0};
+    double best_dist[2] = {std::numeric_limits<double>::max(), std::numeric_limits<double>::max()};
+    for (size_t j = 0; j < 300; ++j)
+    {
+      const double dist[2] = {
+        regions.SquaredDescriptorDistance(i, &regions, j),
+        pca_regions->SquaredDescriptorDistance(i, pca_regions, j)};
+      for (int k = 0; k < 2; ++k)
+        if (dist[k] < best_dist[k])
+        {
+          best_dist[k] = dist[k];
+          best[k] = j;
+        }
+    }
+    same_count += best[0] == best[1];
+    found_count += best[1] == Source(i, 300);
+  }
+  EXPECT_TRUE(same_count >= query_count * 9 / 10);
+  EXPECT_TRUE(found_count >= query_count * 9 / 10);
+
+  // The projection is read back unchanged
+  EXPECT_TRUE(pca.Save("temp_pca.bin"));
+  Descriptor_PCA loaded;
+  EXPECT_TRUE(loaded.Load("temp_pca.bin"));
+  std::remove("temp_pca.bin");
+  PCA64_Regions reloaded;
+  loaded.Compress(regions, reloaded);
+  EXPECT_TRUE(std::equal(
+    reloaded.Descriptors()[0].getData(), reloaded.Descriptors()[0].getData() + 64 * regions.RegionCount(),
+    pca_regions->Descriptors()[0].getData()));
+
+  EXPECT_TRUE(dynamic_cast<PCA64_Regions *>(
+    Compressed_Regions_Type(SIFT_Regions(), DESCRIPTOR_STORAGE_PCA64).get()) != NULL);
+  EXPECT_TRUE(Compressed_Regions_Type(AKAZE_Binary_Regions(), DESCRIPTOR_STORAGE_PCA64) == NULL);
+
+  // The projection is specific to a descriptor length
+  EXPECT_TRUE(Compress_Regions(AKAZE_Float_Regions(), DESCRIPTOR_STORAGE_PCA64, &pca) == NULL);
+  EXPECT_FALSE(loaded.Load("not_a_file.bin"));
+}
+
+/* ************************************************************************* */
+int main() { TestResult tr; return TestRegistry::runAllTests(tr);}
+/* ************************************************************************* */
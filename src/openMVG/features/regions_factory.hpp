@@ -18,10 +18,14 @@ typedef Scalar_Regions<SIOPointFeature,unsigned char,128> SIFT_Regions;
 
 /// Define the AKAZE Keypoint (with a float descriptor)
 typedef Scalar_Regions<SIOPointFeature,float,64> AKAZE_Float_Regions;
+/// Define the AKAZE Keypoint (with a half precision float descriptor)
+typedef Scalar_Regions<SIOPointFeature,Float16,64> AKAZE_Float16_Regions;
 /// Define the AKAZE Keypoint (with a LIOP descriptor)
 typedef Scalar_Regions<SIOPointFeature,unsigned char,144> AKAZE_Liop_Regions;
 /// Define the AKAZE Keypoint (with a binary descriptor saved in an uchar array)
 typedef Binary_Regions<SIOPointFeature,64> AKAZE_Binary_Regions;
+/// Define a Keypoint with a PCA projected descriptor (64 quantized components)
+typedef Scalar_Regions<SIOPointFeature,unsigned char,64> PCA64_Regions;
 
 } // namespace features
 } // namespace openMVG
@@ -34,7 +38,9 @@ typedef Binary_Regions<SIOPointFeature,64> AKAZE_Binary_Regions;
 #include <cereal/archives/json.hpp>
 CEREAL_REGISTER_TYPE_WITH_NAME(openMVG::features::SIFT_Regions, "SIFT_Regions");
 CEREAL_REGISTER_TYPE_WITH_NAME(openMVG::features::AKAZE_Float_Regions, "AKAZE_Float_Regions");
+CEREAL_REGISTER_TYPE_WITH_NAME(openMVG::features::AKAZE_Float16_Regions, "AKAZE_Float16_Regions");
 CEREAL_REGISTER_TYPE_WITH_NAME(openMVG::features::AKAZE_Liop_Regions, "AKAZE_Liop_Regions");
 CEREAL_REGISTER_TYPE_WITH_NAME(openMVG::features::AKAZE_Binary_Regions, "AKAZE_Binary_Regions");
+CEREAL_REGISTER_TYPE_WITH_NAME(openMVG::features::PCA64_Regions, "PCA64_Regions");
 
 #endif // OPENMVG_FEATURES_REGIONS_FACTORY_HPP
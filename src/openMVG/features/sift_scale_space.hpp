@@ -0,0 +1,245 @@
+
+// Copyright (c) 2015 Pierre MOULON.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef OPENMVG_FEATURES_SIFT_SCALE_SPACE_HPP
+#define OPENMVG_FEATURES_SIFT_SCALE_SPACE_HPP
+
+#include "openMVG/image/image.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace openMVG {
+namespace features {
+
+// Bibliography:
+// [1] D. G. Lowe. Distinctive image features from scale-invariant keypoints. IJCV 2004.
+// [2] A. Vedaldi, B. Fulkerson. VLFeat: An open and portable library of computer vision algorithms. 2008.
+
+/**
+@brief Gaussian scale space of the SIFT detector [1].
+Native implementation of the VLFeat scale space [2]: same octave geometry, same
+ smoothing schedule, same Gaussian filters and same summation order, so its levels
+ can replace the VLFeat ones (the keypoints and descriptors are unchanged).
+The smoothing uses the row parallel and vectorized separable convolution
+ (image::SeparableConvolution2d_BorderCopy).
+The octave o has Level_Count() = num_scales + 3 levels (scales -1 to num_scales + 1)
+ of Octave_Width() x Octave_Height() pixels, stored contiguously in the caller buffer.
+*/
+class SIFT_Scale_Space
+{
+public:
+  /**
+  @param width Image width
+  @param height Image height
+  @param num_octaves Octaves count (< 0: as many as the image size allows)
+  @param num_scales Scales per octave
+  @param first_octave Index of the first octave (-1: upscaled image)
+  */
+  SIFT_Scale_Space(int width, int height, int num_octaves, int num_scales, int first_octave)
+    :_width(width), _height(height), _num_scales(num_scales),
+     _first_octave(first_octave), _octave(first_octave)
+  {
+    _num_octaves = num_octaves >= 0 ? num_octaves :
+      std::max(static_cast<int>(std::floor(std::log2(std::min(width, height)))) - first_octave - 3, 1);
+    _sigman = 0.5;
+    _sigmak = std::pow(2.0, 1.0 / num_scales);
+    _sigma0 = 1.6 * _sigmak;
+    _dsigma0 = _sigma0 * std::sqrt(1.0 - 1.0 / (_sigmak * _sigmak));
+  }
+
+  int Octave_Count() const { return _num_octaves; }
+  int Level_Count() const { return _num_scales + 3; }
+  /// Index of the current octave
+  int Octave() const { return _octave; }
+  int Octave_Width() const { return Octave_Size(_width, _octave); }
+  int Octave_Height() const { return Octave_Size(_height, _octave); }
+  /// Size of the base level (the level -1 of the first octave)
+  int Base_Width() const { return Octave_Size(_width, _first_octave); }
+  int Base_Height() const { return Octave_Size(_height, _first_octave); }
+
+  /// Size of the level buffer of the first octave (the largest one)
+  size_t Buffer_Size() const
+  {
+    return size_t(Level_Count()) * Base_Width() * Base_Height();
+  }
+
+  /**
+  @brief Compute the base level of the scale space: the image resampled to the
+   first octave and smoothed to the scale of its level -1
+  @param image The image (width x height pixels, row major)
+  @param base The base level (Base_Width() x Base_Height() floats)
+  */
+  void Compute_Base_Level(const float * image, float * base) const
+  {
+    const int w = Base_Width(), h = Base_Height();
+    LevelMap base_level(base, h, w);
+    if (_first_octave < 0)
+    {
+      image::RowMatrixXf upsampled = ConstLevelMap(image, _height, _width);
+      for (int o = 0; o > _first_octave; --o)
+        upsampled = Upsample(upsampled);
+      base_level = upsampled;
+    }
+    else
+    {
+      const int step = 1 << _first_octave;
+      for (int y = 0; y < h; ++y)
+        for (int x = 0; x < w; ++x)
+          base_level(y, x) = image[y * step * _width + x * step];
+    }
+
+    // Adjust the smoothing of the first level (the image has a nominal smoothing of sigman)
+    const double sa = _sigma0 * std::pow(_sigmak, -1.0);
+    const double sb = _sigman * std::pow(2.0, -_first_octave);
+    if (sa > sb)
+      Smooth(base_level, base_level, std::sqrt(sa * sa - sb * sb));
+  }
+
+  /**
+  @brief Compute the levels of the first octave
+  @param image The image (width x height pixels, row major)
+  @param levels The levels of the octave (at least Buffer_Size() floats)
+  @return false if there is no octave
+  */
+  bool Process_First_Octave(const float * image, float * levels)
+  {
+    _octave = _first_octave;
+    if (_num_octaves == 0)
+      return false;
+
+    Compute_Base_Level(image, levels);
+    Fill_Octave(levels);
+    return true;
+  }
+
+  /**
+  @brief Compute the levels of the first octave from a precomputed base level
+   (see Compute_Base_Level), e.g. a cached one: the initial resampling and
+   smoothing are skipped
+  @param base The base level (Base_Width() x Base_Height() floats)
+  @param levels The levels of the octave (at least Buffer_Size() floats)
+  @return false if there is no octave
+  */
+  bool Process_First_Octave_From_Base(const float * base, float * levels)
+  {
+    _octave = _first_octave;
+    if (_num_octaves == 0)
+      return false;
+
+    std::copy(base, base + size_t(Base_Width()) * Base_Height(), levels);
+    Fill_Octave(levels);
+    return true;
+  }
+
+  /**
+  @brief Compute the levels of the next octave from the levels of the current one (in place)
+  @return false if the current octave is the last one
+  */
+  bool Process_Next_Octave(float * levels)
+  {
+    if (_octave == _first_octave + _num_octaves - 1)
+      return false;
+
+    // The base of the next octave is the level num_scales - 1 (twice the smoothing of
+    //  the level -1) downsampled by 2: it has exactly the smoothing of the level -1
+    //  of the next octave (no extra smoothing)
+    const int s_best = _num_scales - 1;
+    const int w = Octave_Width(), h = Octave_Height();
+    const int nw = Octave_Size(_width, _octave + 1), nh = Octave_Size(_height, _octave + 1);
+    const ConstLevelMap best(levels + size_t(w) * h * (s_best + 1), h, w);
+    LevelMap base(levels, nh, nw);
+    for (int y = 0; y < nh; ++y)
+      for (int x = 0; x < nw; ++x)
+        base(y, x) = best(2 * y, 2 * x);
+    ++_octave;
+
+    Fill_Octave(levels);
+    return true;
+  }
+
+  /// Normalized Gaussian kernel of VLFeat (half width max(ceil(4 sigma), 1))
+  static Eigen::Matrix<float, 1, Eigen::Dynamic> Gaussian_Kernel(const double sigma)
+  {
+    const int half_width = std::max(static_cast<int>(std::ceil(4.0 * sigma)), 1);
+    Eigen::Matrix<float, 1, Eigen::Dynamic> kernel(2 * half_width + 1);
+    float sum = 0.f;
+    for (int i = 0; i < kernel.cols(); ++i)
+    {
+      const float d = static_cast<float>(i - half_width) / static_cast<float>(sigma);
+      kernel(i) = static_cast<float>(std::exp(-0.5 * (d * d)));
+      sum += kernel(i);
+    }
+    for (int i = 0; i < kernel.cols(); ++i)
+      kernel(i) /= sum;
+    return kernel;
+  }
+
+  /// Double the size of an image by linear interpolation (rows first, then columns)
+  static image::RowMatrixXf Upsample(const image::RowMatrixXf & in)
+  {
+    const int w = static_cast<int>(in.cols()), h = static_cast<int>(in.rows());
+    image::RowMatrixXf rows_upsampled(h, 2 * w), out(2 * h, 2 * w);
+    for (int y = 0; y < h; ++y)
+    {
+      for (int x = 0; x < w - 1; ++x)
+      {
+        rows_upsampled(y, 2 * x) = in(y, x);
+        rows_upsampled(y, 2 * x + 1) = static_cast<float>(0.5 * (in(y, x) + in(y, x + 1)));
+      }
+      rows_upsampled(y, 2 * w - 2) = rows_upsampled(y, 2 * w - 1) = in(y, w - 1);
+    }
+    for (int y = 0; y < h - 1; ++y)
+    {
+      out.row(2 * y) = rows_upsampled.row(y);
+      for (int x = 0; x < 2 * w; ++x)
+        out(2 * y + 1, x) = static_cast<float>(0.5 * (rows_upsampled(y, x) + rows_upsampled(y + 1, x)));
+    }
+    out.row(2 * h - 2) = rows_upsampled.row(h - 1);
+    out.row(2 * h - 1) = rows_upsampled.row(h - 1);
+    return out;
+  }
+
+private:
+
+  typedef Eigen::Map<image::RowMatrixXf> LevelMap;
+  typedef Eigen::Map<const image::RowMatrixXf> ConstLevelMap;
+
+  static int Octave_Size(const int size, const int octave)
+  {
+    return octave >= 0 ? size >> octave : size << -octave;
+  }
+
+  template <typename ImageIn, typename ImageOut>
+  static void Smooth(const ImageIn & in, ImageOut & out, const double sigma)
+  {
+    const Eigen::Matrix<float, 1, Eigen::Dynamic> kernel = Gaussian_Kernel(sigma);
+    image::SeparableConvolution2d_BorderCopy(in, kernel, kernel, &out);
+  }
+
+  /// Compute the levels 0 to num_scales + 1 from the level -1 of the current octave
+  void Fill_Octave(float * levels) const
+  {
+    const int w = Octave_Width(), h = Octave_Height();
+    for (int s = 0; s <= _num_scales + 1; ++s)
+    {
+      const ConstLevelMap previous(levels + size_t(w) * h * s, h, w);
+      LevelMap level(levels + size_t(w) * h * (s + 1), h, w);
+      Smooth(previous, level, _dsigma0 * std::pow(_sigmak, s));
+    }
+  }
+
+  int _width, _height;
+  int _num_octaves, _num_scales, _first_octave;
+  int _octave; // current octave
+  double _sigman, _sigmak, _sigma0, _dsigma0;
+};
+
+} // namespace features
+} // namespace openMVG
+
+#endif // OPENMVG_FEATURES_SIFT_SCALE_SPACE_HPP
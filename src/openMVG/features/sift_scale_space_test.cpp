@@ -0,0 +1,118 @@
+
+// Copyright (c) 2015 Pierre MOULON.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "openMVG/features/sift_scale_space.hpp"
+#include "testing/testing.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace openMVG;
+using namespace openMVG::image;
+using namespace openMVG::features;
+
+TEST(SIFT_Scale_Space, Geometry)
+{
+  SIFT_Scale_Space scale_space(101, 70, 3, 3, -1);
+  EXPECT_EQ(3, scale_space.Octave_Count());
+  EXPECT_EQ(6, scale_space.Level_Count());
+  EXPECT_EQ(size_t(6 * 202 * 140), scale_space.Buffer_Size());
+
+  const std::vector<float> image(101 * 70, 128.f);
+  std::vector<float> levels(scale_space.Buffer_Size());
+  EXPECT_TRUE(scale_space.Process_First_Octave(&image[0], &levels[0]));
+  EXPECT_EQ(-1, scale_space.Octave());
+  EXPECT_EQ(202, scale_space.Octave_Width());
+  EXPECT_EQ(140, scale_space.Octave_Height());
+  EXPECT_TRUE(scale_space.Process_Next_Octave(&levels[0]));
+  EXPECT_EQ(101, scale_space.Octave_Width());
+  EXPECT_EQ(70, scale_space.Octave_Height());
+  EXPECT_TRUE(scale_space.Process_Next_Octave(&levels[0]));
+  EXPECT_EQ(1, scale_space.Octave());
+  EXPECT_EQ(50, scale_space.Octave_Width());
+  EXPECT_EQ(35, scale_space.Octave_Height());
+  EXPECT_FALSE(scale_space.Process_Next_Octave(&levels[0]));
+
+  // A constant image has constant levels
+  for (size_t i = 0; i < size_t(6 * 50 * 35); ++i)
+    EXPECT_NEAR(128.f, levels[i], 1e-3);
+
+  // As many octaves as the image size allows
+  EXPECT_EQ(3, SIFT_Scale_Space(101, 70, -1, 3, 0).Octave_Count());
+}
+
+TEST(SIFT_Scale_Space, GaussianKernel)
+{
+  const Eigen::Matrix<float, 1, Eigen::Dynamic> kernel = SIFT_Scale_Space::Gaussian_Kernel(1.3);
+  EXPECT_EQ(2 * 6 + 1, kernel.cols());
+  EXPECT_NEAR(1.f, kernel.sum(), 1e-6);
+  EXPECT_EQ(0.f, (kernel - kernel.reverse()).array().abs().maxCoeff());
+  EXPECT_EQ(3, SIFT_Scale_Space::Gaussian_Kernel(0.1).cols());
+}
+
+TEST(SIFT_Scale_Space, Levels)
+{
+  const int w = 64, h = 48, num_scales = 3;
+  std::vector<float> image(w * h);
+  for (int y = 0; y < h; ++y)
+    for (int x = 0; x < w; ++x)
+      image[y * w + x] = rand() % 256;
+
+  SIFT_Scale_Space scale_space(w, h, 2, num_scales, 0);
+  std::vector<float> levels(scale_space.Buffer_Size());
+  EXPECT_TRUE(scale_space.Process_First_Octave(&image[0], &levels[0]));
+
+  // Each level is the previous one smoothed by the incremental Gaussian (VLFeat schedule)
+  const double sigmak = std::pow(2.0, 1.0 / num_scales);
+  const double dsigma0 = 1.6 * sigmak * std::sqrt(1.0 - 1.0 / (sigmak * sigmak));
+  for (int s = 0; s <= num_scales + 1; ++s)
+  {
+    const Eigen::Matrix<float, 1, Eigen::Dynamic> kernel =
+      SIFT_Scale_Space::Gaussian_Kernel(dsigma0 * std::pow(sigmak, s));
+    const Image<float> previous(Eigen::Map<RowMatrixXf>(&levels[w * h * s], h, w));
+    Image<float> ref;
+    ImageConvolution(previous, (kernel.transpose() * kernel).cast<double>().eval(), ref);
+    const Eigen::Map<RowMatrixXf> level(&levels[w * h * (s + 1)], h, w);
+    EXPECT_NEAR(0.f, (ref.GetMat() - level).array().abs().maxCoeff(), 1e-3);
+  }
+
+  // The next octave starts from the level num_scales - 1 downsampled by 2
+  const RowMatrixXf best = Eigen::Map<RowMatrixXf>(&levels[w * h * num_scales], h, w);
+  EXPECT_TRUE(scale_space.Process_Next_Octave(&levels[0]));
+  const Eigen::Map<RowMatrixXf> base(&levels[0], h / 2, w / 2);
+  for (int y = 0; y < h / 2; ++y)
+    for (int x = 0; x < w / 2; ++x)
+      EXPECT_EQ(best(2 * y, 2 * x), base(y, x));
+}
+
+TEST(SIFT_Scale_Space, FirstOctaveFromBase)
+{
+  const int w = 64, h = 48;
+  std::vector<float> image(w * h);
+  for (int y = 0; y < h; ++y)
+    for (int x = 0; x < w; ++x)
+      image[y * w + x] = rand() % 256;
+
+  for (int first_octave = -1; first_octave <= 1; ++first_octave)
+  {
+    SIFT_Scale_Space scale_space(w, h, 2, 3, first_octave);
+    std::vector<float> levels(scale_space.Buffer_Size());
+    EXPECT_TRUE(scale_space.Process_First_Octave(&image[0], &levels[0]));
+
+    // A cached base level gives the same octave
+    std::vector<float> base(scale_space.Base_Width() * scale_space.Base_Height());
+    scale_space.Compute_Base_Level(&image[0], &base[0]);
+    EXPECT_TRUE(std::equal(base.begin(), base.end(), levels.begin()));
+    std::vector<float> levels_from_base(scale_space.Buffer_Size());
+    EXPECT_TRUE(scale_space.Process_First_Octave_From_Base(&base[0], &levels_from_base[0]));
+    EXPECT_TRUE(levels == levels_from_base);
+  }
+}
+
+/* ************************************************************************* */
+int main() { TestResult tr; return TestRegistry::runAllTests(tr);}
+/* ************************************************************************* */
@@ -9,6 +9,9 @@
 
 #include "openMVG/geometry/half_space_intersection.hpp"
 
+#include <algorithm>
+#include <limits>
+
 namespace openMVG {
 namespace geometry {
 
@@ -85,6 +88,18 @@ struct Frustum
 
   /// Test if two frustums intersect or not
   bool intersect(const Frustum & f) const
+  {
+    // Truncated frustums are bounded convex polyhedra:
+    //  their intersection can be tested analytically.
+    if (isBoundedPolyhedron() && f.isBoundedPolyhedron())
+      return intersect_separating_axis(f);
+
+    // Infinite or degenerate frustums: solve the half space intersection problem
+    return intersect_half_spaces(f);
+  }
+
+  /// Test if two frustums intersect or not by using a Linear Program
+  bool intersect_half_spaces(const Frustum & f) const
   {
     // Concatenate the Half Planes and see if an intersection exists
     std::vector<Half_plane> vec_planes(planes.size() + f.planes.size());
@@ -94,6 +109,79 @@ struct Frustum
     return halfPlane::isNotEmpty(vec_planes);
   }
 
+  /// Test if two truncated frustums intersect or not by using the separating axis theorem:
+  ///  two convex polyhedra do not intersect if and only if their projections on one of
+  ///  the face normals or on one of the cross products of their edges do not overlap.
+  /// Note: both frustums must be bounded polyhedra (see isBoundedPolyhedron).
+  bool intersect_separating_axis(const Frustum & f) const
+  {
+    // Face normals
+    for (size_t i = 0; i < planes.size(); ++i)
+      if (isSeparatingAxis(planes[i].normal(), f))
+        return false;
+    for (size_t i = 0; i < f.planes.size(); ++i)
+      if (isSeparatingAxis(f.planes[i].normal(), f))
+        return false;
+
+    // Cross products of the edge directions
+    Vec3 edges[4], f_edges[4];
+    edge_directions(edges);
+    f.edge_directions(f_edges);
+    for (int i = 0; i < 4; ++i)
+    {
+      // lateral edges
+      for (int j = 0; j < 4; ++j)
+      {
+        if (isSeparatingAxis(edges[i].cross(f_edges[j]), f))
+          return false;
+      }
+    }
+    for (int i = 0; i < 2; ++i)
+    {
+      // near/far rectangle edges against the other frustum edges
+      const Vec3 rect_edge = points[i+1] - points[i];
+      const Vec3 f_rect_edge = f.points[i+1] - f.points[i];
+      for (int j = 0; j < 4; ++j)
+      {
+        if (isSeparatingAxis(rect_edge.cross(f_edges[j]), f)
+          || isSeparatingAxis(edges[j].cross(f_rect_edge), f))
+          return false;
+      }
+      for (int j = 0; j < 2; ++j)
+      {
+        const Vec3 f_rect_edge_j = f.points[j+1] - f.points[j];
+        if (isSeparatingAxis(rect_edge.cross(f_rect_edge_j), f))
+          return false;
+      }
+    }
+    return true;
+  }
+
+  /// Return true if the Frustum is a closed convex polyhedron defined by its 8 points
+  ///  (truncated frustum with valid near & far planes)
+  bool isBoundedPolyhedron() const
+  {
+    return isTruncated() && points.size() == 8 && z_near > 0. && z_far > z_near;
+  }
+
+  /// Return the axis aligned bounding box of the frustum
+  ///  (unbounded for infinite and degenerate frustums)
+  Eigen::AlignedBox<double, 3> bounds() const
+  {
+    Eigen::AlignedBox<double, 3> box;
+    if (isBoundedPolyhedron())
+    {
+      for (size_t i = 0; i < points.size(); ++i)
+        box.extend(points[i]);
+    }
+    else
+    {
+      box.min().setConstant(-std::numeric_limits<double>::infinity());
+      box.max().setConstant(std::numeric_limits<double>::infinity());
+    }
+    return box;
+  }
+
   /// Return true if the Frustum is an infinite one
   bool isInfinite() const
   {
@@ -112,6 +200,39 @@ struct Frustum
     return points;
   }
 
+private:
+
+  // Directions of the 4 lateral edges of a truncated frustum
+  void edge_directions(Vec3 edges[4]) const
+  {
+    for (int i = 0; i < 4; ++i)
+      edges[i] = points[i+4] - points[i];
+  }
+
+  // Project the points of the two frustums on the axis and test if the intervals are disjoint
+  bool isSeparatingAxis(const Vec3 & axis, const Frustum & f) const
+  {
+    // Parallel edges lead to a null axis that is not a valid candidate
+    if (axis.squaredNorm() < std::numeric_limits<double>::epsilon())
+      return false;
+
+    double min_a = std::numeric_limits<double>::max(), max_a = -min_a;
+    double min_b = min_a, max_b = max_a;
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+      const double proj = axis.dot(points[i]);
+      min_a = std::min(min_a, proj);
+      max_a = std::max(max_a, proj);
+    }
+    for (size_t i = 0; i < f.points.size(); ++i)
+    {
+      const double proj = axis.dot(f.points[i]);
+      min_b = std::min(min_b, proj);
+      max_b = std::max(max_b, proj);
+    }
+    return max_a < min_b || max_b < min_a;
+  }
+
 }; // struct Frustum
 
 } // namespace geometry
@@ -167,6 +167,54 @@ TEST(frustum, empty_intersection)
   }
 }
 
+//--
+// Check that the analytic intersection test of truncated frustums (separating axis)
+//  gives the same results as the half space intersection (Linear Program)
+//--
+TEST(frustum, separating_axis_vs_half_spaces)
+{
+  const Mat3 K = (Mat3() << 500, 0, 250, 0, 500, 200, 0, 0, 1).finished();
+  std::srand(0);
+  int nb_intersection = 0;
+  for (int i = 0; i < 500; ++i)
+  {
+    std::vector<Frustum> vec_frustum;
+    for (int j = 0; j < 2; ++j)
+    {
+      const Vec3 axis = Vec3::Random();
+      const Mat3 R = Eigen::AngleAxisd(axis.norm() * M_PI, axis.normalized()).toRotationMatrix();
+      const Vec3 C = Vec3::Random();
+      const double z_near = 0.1 + std::abs(Vec2::Random()(0));
+      const double z_far = z_near + 0.1 + 2.0 * std::abs(Vec2::Random()(0));
+      vec_frustum.push_back(Frustum(500, 400, K, R, C, z_near, z_far));
+      EXPECT_TRUE(vec_frustum[j].isBoundedPolyhedron());
+    }
+    const bool bIntersect = vec_frustum[0].intersect_half_spaces(vec_frustum[1]);
+    EXPECT_EQ(bIntersect, vec_frustum[0].intersect_separating_axis(vec_frustum[1]));
+    EXPECT_EQ(bIntersect, vec_frustum[1].intersect_separating_axis(vec_frustum[0]));
+    nb_intersection += bIntersect;
+  }
+  // Ensure that the test cover both cases
+  EXPECT_TRUE(nb_intersection > 0 && nb_intersection < 500);
+}
+
+//--
+// Check the frustum bounding boxes
+//--
+TEST(frustum, bounds)
+{
+  const Mat3 K = (Mat3() << 500, 0, 250, 0, 500, 200, 0, 0, 1).finished();
+  const Frustum infinite_frustum(500, 400, K, Mat3::Identity(), Vec3::Zero());
+  EXPECT_FALSE(infinite_frustum.bounds().max().allFinite());
+
+  const Frustum truncated_frustum(500, 400, K, Mat3::Identity(), Vec3::Zero(), 1.0, 2.0);
+  const Eigen::AlignedBox<double, 3> box = truncated_frustum.bounds();
+  for (size_t i = 0; i < truncated_frustum.frustum_points().size(); ++i)
+    EXPECT_TRUE(box.contains(truncated_frustum.frustum_points()[i]));
+  EXPECT_NEAR(1.0, box.min()(2), 1e-8);
+  EXPECT_NEAR(2.0, box.max()(2), 1e-8);
+}
+
 /* ************************************************************************* */
 int main() { TestResult tr; return TestRegistry::runAllTests(tr);}
 /* ************************************************************************* */
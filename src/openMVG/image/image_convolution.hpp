@@ -9,6 +9,8 @@
 
 #include "openMVG/numeric/accumulator_trait.hpp"
 
+#include <algorithm>
+
 /**
  ** @file Standard 2D image convolution functions :
  ** - vertical
@@ -252,6 +254,60 @@ static void SeparableConvolution2d(const RowMatrixXf& image,
   }
 }
 
+/**
+ ** Separable 2D convolution of a float image with copied border pixels
+ ** (vertical kernel first, then horizontal kernel).
+ ** Each output row is a weighted sum of whole rows (vectorized by Eigen)
+ ** and the rows are processed in parallel.
+ ** The images can be RowMatrixXf or Eigen::Map<RowMatrixXf> (external buffers).
+ ** @param image source image
+ ** @param kernel_x horizontal kernel (odd size)
+ ** @param kernel_y vertical kernel (odd size)
+ ** @param out output image, same size as image (can be the source image)
+ **/
+template <typename ImageIn, typename ImageOut>
+static void SeparableConvolution2d_BorderCopy(const ImageIn& image,
+                            const Eigen::Matrix<float, 1, Eigen::Dynamic>& kernel_x,
+                            const Eigen::Matrix<float, 1, Eigen::Dynamic>& kernel_y,
+                            ImageOut* out) {
+  const int rows = static_cast<int>(image.rows());
+  const int cols = static_cast<int>(image.cols());
+  const int sigma_y = static_cast<int>(kernel_y.cols());
+  const int half_sigma_y = sigma_y / 2;
+
+  // Vertical pass: out(row) = sum_i kernel_y(i) * image(clamp(row - half + i))
+  RowMatrixXf temp(rows, cols);
+#if defined(OPENMVG_USE_OPENMP)
+#pragma omp parallel for schedule(dynamic)
+#endif
+  for (int row = 0; row < rows; row++) {
+    temp.row(row) = kernel_y(0) *
+      image.row(std::min(std::max(row - half_sigma_y, 0), rows - 1));
+    for (int i = 1; i < sigma_y; i++) {
+      temp.row(row) += kernel_y(i) *
+        image.row(std::min(std::max(row - half_sigma_y + i, 0), rows - 1));
+    }
+  }
+
+  // Horizontal pass: sliding window over the row padded with its border pixels
+  const int sigma_x = static_cast<int>(kernel_x.cols());
+  const int half_sigma_x = sigma_x / 2;
+  Eigen::RowVectorXf temp_row(cols + sigma_x - 1);
+#if defined(OPENMVG_USE_OPENMP)
+#pragma omp parallel for firstprivate(temp_row), schedule(dynamic)
+#endif
+  for (int row = 0; row < rows; row++) {
+    temp_row.head(half_sigma_x).setConstant(temp(row, 0));
+    temp_row.segment(half_sigma_x, cols) = temp.row(row);
+    temp_row.tail(half_sigma_x).setConstant(temp(row, cols - 1));
+
+    out->row(row) = kernel_x(0) * temp_row.head(cols);
+    for (int i = 1; i < sigma_x; i++) {
+      out->row(row) += kernel_x(i) * temp_row.segment(i, cols);
+    }
+  }
+}
+
 // Specialization for Image<float> in order to use SeparableConvolution2d
 template<typename Kernel>
 void ImageSeparableConvolution( const Image<float> & img ,
@@ -11,6 +11,9 @@
 #pragma warning(once:4244)
 #endif
 
+#include <algorithm>
+#include <vector>
+
 namespace openMVG {
 namespace image {
 
@@ -36,6 +39,58 @@ void ImagePeronaMalikG2DiffusionCoef( const Image & Lx , const Image & Ly , cons
   out.array() = ( static_cast<Real>(1.f) + (Lx.array().square()+Ly.array().square() )/(k*k) ).inverse();
 }
 
+/**
+ ** Compute Perona and Malik G2 diffusion coefficient of the (non normalized) 3x3
+ **  Scharr derivatives of an image in a single pass
+ ** Same result as ImageScharrXDerivative, ImageScharrYDerivative (non normalized)
+ **  and ImagePeronaMalikG2DiffusionCoef, without the derivative images.
+ ** @param src input image
+ ** @param k sensitivity factor
+ ** @param out output coefficient
+ **/
+template < typename Image >
+void ImagePeronaMalikG2DiffusionCoefScharr( const Image & src , const typename Image::Tpixel k , Image & out )
+{
+  typedef typename Image::Tpixel Real;
+  const int rows = src.rows() ;
+  const int cols = src.cols() ;
+  out.resize( cols , rows ) ;
+
+  const Real k2 = k * k ;
+
+#ifdef OPENMVG_USE_OPENMP
+  #pragma omp parallel
+#endif
+  {
+    std::vector<Real> U( cols + 2 ), M( cols + 2 ), D( cols + 2 ) ;
+#ifdef OPENMVG_USE_OPENMP
+    #pragma omp for schedule(static)
+#endif
+    for( int row = 0 ; row < rows ; ++row )
+    {
+      ImageMirroredPaddedRow( src , row - 1 , 1 , &U[0] ) ;
+      ImageMirroredPaddedRow( src , row , 1 , &M[0] ) ;
+      ImageMirroredPaddedRow( src , row + 1 , 1 , &D[0] ) ;
+      Real * u = &U[0] , * m = &M[0] , * d = &D[0] ;
+      // Vertical pass (in place): smoothing for X, derivative for Y
+      for( int col = 0 ; col < cols + 2 ; ++col )
+      {
+        const Real smooth = Real( 3 ) * u[ col ] + Real( 10 ) * m[ col ] + Real( 3 ) * d[ col ] ;
+        d[ col ] = d[ col ] - u[ col ] ;
+        m[ col ] = smooth ;
+      }
+      // Horizontal pass and diffusion coefficient
+      Real * coef = out.data() + row * cols ;
+      for( int col = 0 ; col < cols ; ++col )
+      {
+        const Real Lx = m[ col + 2 ] - m[ col ] ;
+        const Real Ly = Real( 3 ) * d[ col ] + Real( 10 ) * d[ col + 1 ] + Real( 3 ) * d[ col + 2 ] ;
+        coef[ col ] = static_cast<Real>( 1.f ) / ( static_cast<Real>( 1.f ) + ( Lx * Lx + Ly * Ly ) / k2 ) ;
+      }
+    }
+  }
+}
+
 /**
 ** Apply Fast Explicit Diffusion to an Image (on central part)
 ** @param src input image
@@ -177,6 +232,20 @@ void ImageFED( const Image & src , const Image & diff , const typename Image::Tp
     out( height - 1 , j ) = value ;
   }
 
+  // Compute FED step on the corners (no flux with the outside)
+  if( width > 1 && height > 1 )
+  {
+    const int w1 = width - 1 , h1 = height - 1 ;
+    out( 0 , 0 ) = half_t * ( ( diff( 0 , 0 ) + diff( 0 , 1 ) ) * ( src( 0 , 1 ) - src( 0 , 0 ) )
+      + ( diff( 0 , 0 ) + diff( 1 , 0 ) ) * ( src( 1 , 0 ) - src( 0 , 0 ) ) ) ;
+    out( 0 , w1 ) = half_t * ( - ( diff( 0 , w1 ) + diff( 0 , w1 - 1 ) ) * ( src( 0 , w1 ) - src( 0 , w1 - 1 ) )
+      + ( diff( 0 , w1 ) + diff( 1 , w1 ) ) * ( src( 1 , w1 ) - src( 0 , w1 ) ) ) ;
+    out( h1 , 0 ) = half_t * ( ( diff( h1 , 0 ) + diff( h1 , 1 ) ) * ( src( h1 , 1 ) - src( h1 , 0 ) )
+      - ( diff( h1 , 0 ) + diff( h1 - 1 , 0 ) ) * ( src( h1 , 0 ) - src( h1 - 1 , 0 ) ) ) ;
+    out( h1 , w1 ) = half_t * ( - ( diff( h1 , w1 ) + diff( h1 , w1 - 1 ) ) * ( src( h1 , w1 ) - src( h1 , w1 - 1 ) )
+      - ( diff( h1 , w1 ) + diff( h1 - 1 , w1 ) ) * ( src( h1 , w1 ) - src( h1 - 1 , w1 ) ) ) ;
+  }
+
   // Compute FED step on first col
   for( int i = 1 ; i < height - 1 ; ++i )
   {
@@ -235,6 +304,88 @@ void ImageFEDCycle( Image & self , const Image & diff , const std::vector< typen
   }
 }
 
+/**
+ ** Compute Fast Explicit Diffusion cycle (in place, fused version)
+ ** Same result as ImageFEDCycle, but each FED step updates the image in place in a
+ **  single pass: the original values of the neighbor rows are kept in row buffers
+ **  instead of computing a step image and adding it to the image.
+ ** The rows are split in one band per thread (the band boundary rows are saved first).
+ ** @param self input/output image
+ ** @param diff diffusion coefficient
+ ** @param tau cycle timing vector
+ **/
+template< typename Image >
+void ImageFEDCycleFused( Image & self , const Image & diff , const std::vector< typename Image::Tpixel > & tau )
+{
+  typedef typename Image::Tpixel Real ;
+  const int rows = self.rows() ;
+  const int cols = self.cols() ;
+  if( rows == 0 || cols == 0 )
+    return ;
+
+#ifdef OPENMVG_USE_OPENMP
+  const int nb_thread = omp_get_max_threads();
+#else
+  const int nb_thread = 1 ;
+#endif
+
+  // Row bands
+  std::vector< int > range;
+  SplitRange( 0 , rows , nb_thread , range ) ;
+  const int nb_band = static_cast<int>( range.size() ) - 1 ;
+
+  // Original rows above and below each band (padded by 1 pixel)
+  std::vector< std::vector< Real > > band_above( nb_band , std::vector< Real >( cols + 2 ) ) ;
+  std::vector< std::vector< Real > > band_below( nb_band , std::vector< Real >( cols + 2 ) ) ;
+
+  for( size_t t = 0 ; t < tau.size() ; ++t )
+  {
+    const Real half_t = tau[ t ] * static_cast<Real>( 0.5 ) ;
+
+    for( int b = 0 ; b < nb_band ; ++b )
+    {
+      ImagePaddedRow( self , range[ b ] - 1 , 1 , &band_above[ b ][ 0 ] ) ;
+      ImagePaddedRow( self , range[ b + 1 ] , 1 , &band_below[ b ][ 0 ] ) ;
+    }
+
+#ifdef OPENMVG_USE_OPENMP
+    #pragma omp parallel for schedule(static)
+#endif
+    for( int b = 0 ; b < nb_band ; ++b )
+    {
+      // Original values of the previous and of the current rows
+      std::vector< Real > previous_row( band_above[ b ] ) , current_row( cols + 2 ) , diff_row( cols + 2 ) ;
+      for( int row = range[ b ] ; row < range[ b + 1 ] ; ++row )
+      {
+        ImagePaddedRow( self , row , 1 , &current_row[ 0 ] ) ;
+        ImagePaddedRow( diff , row , 1 , &diff_row[ 0 ] ) ;
+
+        const Real * up = &previous_row[ 1 ] ;
+        const Real * down = ( row + 1 == range[ b + 1 ] ) ?
+          &band_below[ b ][ 1 ] : self.data() + ( row + 1 ) * cols ;
+        const Real * diff_up = diff.data() + std::max( row - 1 , 0 ) * cols ;
+        const Real * diff_down = diff.data() + std::min( row + 1 , rows - 1 ) * cols ;
+        const Real * cur = &current_row[ 0 ] ;
+        const Real * cur_diff = &diff_row[ 0 ] ;
+        Real * out = self.data() + row * cols ;
+
+        // The out of image neighbors are the border pixels (no flux)
+        for( int col = 0 ; col < cols ; ++col )
+        {
+          const Real src = cur[ col + 1 ] ;
+          const Real d = cur_diff[ col + 1 ] ;
+          const Real a = ( d + cur_diff[ col + 2 ] ) * ( cur[ col + 2 ] - src ) ;
+          const Real b_ = ( d + diff_up[ col ] ) * ( src - up[ col ] ) ;
+          const Real c = ( d + cur_diff[ col ] ) * ( src - cur[ col ] ) ;
+          const Real d_ = ( d + diff_down[ col ] ) * ( down[ col ] - src ) ;
+          out[ col ] = src + half_t * ( a - c + d_ - b_ ) ;
+        }
+        previous_row.swap( current_row ) ;
+      }
+    }
+  }
+}
+
 // Compute if a number is prime of not
 static bool IsPrime( const int i )
 {
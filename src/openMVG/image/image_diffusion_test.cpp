@@ -0,0 +1,64 @@
+// Copyright (c) 2015 Pierre MOULON.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "openMVG/image/image.hpp"
+#include "testing/testing.h"
+
+using namespace openMVG;
+using namespace openMVG::image;
+
+static Image<float> RandomImage(const int width, const int height)
+{
+  Image<float> in(width, height);
+  for (int i = 0; i < in.Height(); ++i)
+    for (int j = 0; j < in.Width(); ++j)
+      in(i,j) = rand() % 256 / 255.f;
+  return in;
+}
+
+TEST(Image, PeronaMalikG2DiffusionCoef_Fused)
+{
+  const Image<float> in = RandomImage(47, 38);
+  const float k = 0.05f;
+
+  Image<float> Lx, Ly, diff;
+  ImageScharrXDerivative( in, Lx, false);
+  ImageScharrYDerivative( in, Ly, false);
+  ImagePeronaMalikG2DiffusionCoef( Lx, Ly, k, diff);
+
+  Image<float> diff_fused;
+  ImagePeronaMalikG2DiffusionCoefScharr( in, k, diff_fused);
+  EXPECT_EQ(diff.Width(), diff_fused.Width());
+  EXPECT_EQ(diff.Height(), diff_fused.Height());
+  EXPECT_NEAR(0.f, (diff - diff_fused).array().abs().maxCoeff(), 1e-6);
+}
+
+TEST(Image, FEDCycle_Fused)
+{
+  const Image<float> in = RandomImage(61, 45);
+  Image<float> diff;
+  ImagePeronaMalikG2DiffusionCoefScharr( in, 0.05f, diff);
+
+  std::vector<float> tau;
+  FEDCycleTimings( 2.f , 0.25f , tau ) ;
+  EXPECT_TRUE(tau.size() > 1);
+
+  // Step images added to the image
+  Image<float> ref = in;
+  ImageFEDCycle( ref, diff, tau);
+
+  // In place steps
+  Image<float> fused = in;
+  ImageFEDCycleFused( fused, diff, tau);
+
+  EXPECT_NEAR(0.f, (ref - fused).array().abs().maxCoeff(), 1e-5);
+  // The diffusion smooths the image
+  EXPECT_TRUE((fused - in).array().abs().maxCoeff() > 1e-2);
+}
+
+/* ************************************************************************* */
+int main() { TestResult tr; return TestRegistry::runAllTests(tr);}
+/* ************************************************************************* */
@@ -238,6 +238,184 @@ namespace image {
   }
 
 
+  /**
+   ** Copy an image row to a buffer padded by replicating the border pixels
+   ** @param img Input image
+   ** @param row Row index (clamped to the image range)
+   ** @param pad Number of pixels to add before and after the row
+   ** @param buffer Output buffer (size Width() + 2 * pad)
+   **/
+  template< typename Image >
+  inline void ImagePaddedRow( const Image & img , int row , const int pad , typename Image::Tpixel * buffer )
+  {
+    row = row < 0 ? 0 : ( row >= img.rows() ? img.rows() - 1 : row ) ;
+    const int cols = img.cols() ;
+    const typename Image::Tpixel * src = img.data() + row * cols ;
+    for( int k = 0 ; k < pad ; ++k )
+    {
+      buffer[ k ] = src[ 0 ] ;
+      buffer[ pad + cols + k ] = src[ cols - 1 ] ;
+    }
+    memcpy( buffer + pad , src , sizeof( typename Image::Tpixel ) * cols ) ;
+  }
+
+  /**
+   ** Copy an image row to a padded buffer with the borders of the float
+   **  ImageSeparableConvolution (SeparableConvolution2d):
+   **  the row index and the left border are mirrored (without repeating the border pixel),
+   **  the right border pixels are x[cols-3], x[cols-4], ...
+   ** @param img Input image
+   ** @param row Row index (mirrored if outside of the image)
+   ** @param pad Number of pixels to add before and after the row
+   ** @param buffer Output buffer (size Width() + 2 * pad)
+   **/
+  template< typename Image >
+  inline void ImageMirroredPaddedRow( const Image & img , int row , const int pad , typename Image::Tpixel * buffer )
+  {
+    const int rows = img.rows() ;
+    const int cols = img.cols() ;
+    row = row < 0 ? -row : ( row >= rows ? 2 * ( rows - 1 ) - row : row ) ;
+    row = std::min( std::max( row , 0 ) , rows - 1 ) ;
+    const typename Image::Tpixel * src = img.data() + row * cols ;
+    for( int k = 0 ; k < pad ; ++k )
+    {
+      buffer[ pad - 1 - k ] = src[ std::min( k + 1 , cols - 1 ) ] ;
+      buffer[ pad + cols + k ] = src[ std::max( cols - 3 - k , 0 ) ] ;
+    }
+    memcpy( buffer + pad , src , sizeof( typename Image::Tpixel ) * cols ) ;
+  }
+
+  /**
+   ** Compute X and Y derivatives using scaled Scharr filters in a single pass
+   ** Same results as ImageScaledScharrXDerivative and ImageScaledScharrYDerivative
+   **  (float images), but each output row is computed from 3 input rows (cache
+   **  resident) without any intermediate image.
+   ** @param img Input image
+   ** @param Lx Output X-derivative
+   ** @param Ly Output Y-derivative
+   ** @param scale scale of filter (1 -> 3x3 filter ; 2 -> 5x5, ...)
+   ** @param bNormalize true if kernel must be normalized
+   **/
+  template< typename Image >
+  void ImageScaledScharrXYDerivatives( const Image & img , Image & Lx , Image & Ly , const int scale ,
+    const bool bNormalize = true )
+  {
+    typedef typename Image::Tpixel Real ;
+    const int rows = img.rows() ;
+    const int cols = img.cols() ;
+    Lx.resize( cols , rows ) ;
+    Ly.resize( cols , rows ) ;
+
+    // Scharr parameter for derivative
+    const double w = 10.0 / 3.0 ;
+    const double norm = bNormalize ? 1.0 / ( 2.0 * scale * ( w + 2.0 ) ) : 1.0 ;
+    const Real k_side = static_cast<Real>( norm ) ;
+    const Real k_center = static_cast<Real>( w * norm ) ;
+    const int s = scale ;
+    const int padded_cols = cols + 2 * s ;
+
+#ifdef OPENMVG_USE_OPENMP
+    #pragma omp parallel
+#endif
+    {
+      std::vector<Real> U( padded_cols ), M( padded_cols ), D( padded_cols ) ;
+#ifdef OPENMVG_USE_OPENMP
+      #pragma omp for schedule(static)
+#endif
+      for( int row = 0 ; row < rows ; ++row )
+      {
+        ImageMirroredPaddedRow( img , row - s , s , &U[0] ) ;
+        ImageMirroredPaddedRow( img , row , s , &M[0] ) ;
+        ImageMirroredPaddedRow( img , row + s , s , &D[0] ) ;
+        Real * u = &U[0] , * m = &M[0] , * d = &D[0] ;
+        // Vertical pass (in place): smoothing for X, derivative for Y
+        for( int col = 0 ; col < padded_cols ; ++col )
+        {
+          const Real smooth = k_side * u[ col ] + k_center * m[ col ] + k_side * d[ col ] ;
+          d[ col ] = d[ col ] - u[ col ] ;
+          m[ col ] = smooth ;
+        }
+        // Horizontal pass: derivative for X, smoothing for Y
+        Real * lx = Lx.data() + row * cols ;
+        Real * ly = Ly.data() + row * cols ;
+        for( int col = 0 ; col < cols ; ++col )
+        {
+          lx[ col ] = m[ col + 2 * s ] - m[ col ] ;
+          ly[ col ] = k_side * d[ col ] + k_center * d[ col + s ] + k_side * d[ col + 2 * s ] ;
+        }
+      }
+    }
+  }
+
+  /**
+   ** Compute the determinant of the Hessian from the first derivatives in a single pass
+   ** Lxx, Lxy and Lyy are computed by using scaled Scharr filters on Lx and Ly
+   **  (as ImageScaledScharrXDerivative(Lx), ImageScaledScharrYDerivative(Lx) and
+   **  ImageScaledScharrYDerivative(Ly)) row per row, multiplied by factor, and only
+   **  Lxx * Lyy - Lxy^2 is stored.
+   ** @param Lx X-derivative
+   ** @param Ly Y-derivative
+   ** @param scale scale of filter (1 -> 3x3 filter ; 2 -> 5x5, ...)
+   ** @param factor scaling of the second order derivatives
+   ** @param Lhess Output determinant of the Hessian
+   **/
+  template< typename Image >
+  void ImageScaledScharrHessianDeterminant( const Image & Lx , const Image & Ly , const int scale ,
+    const typename Image::Tpixel factor , Image & Lhess )
+  {
+    typedef typename Image::Tpixel Real ;
+    const int rows = Lx.rows() ;
+    const int cols = Lx.cols() ;
+    Lhess.resize( cols , rows ) ;
+
+    // Scharr parameter for derivative
+    const double w = 10.0 / 3.0 ;
+    const double norm = 1.0 / ( 2.0 * scale * ( w + 2.0 ) ) ;
+    const Real k_side = static_cast<Real>( norm ) ;
+    const Real k_center = static_cast<Real>( w * norm ) ;
+    const int s = scale ;
+    const int padded_cols = cols + 2 * s ;
+
+#ifdef OPENMVG_USE_OPENMP
+    #pragma omp parallel
+#endif
+    {
+      std::vector<Real> XU( padded_cols ), XM( padded_cols ), XD( padded_cols ),
+        YU( padded_cols ), YD( padded_cols ) ;
+#ifdef OPENMVG_USE_OPENMP
+      #pragma omp for schedule(static)
+#endif
+      for( int row = 0 ; row < rows ; ++row )
+      {
+        ImageMirroredPaddedRow( Lx , row - s , s , &XU[0] ) ;
+        ImageMirroredPaddedRow( Lx , row , s , &XM[0] ) ;
+        ImageMirroredPaddedRow( Lx , row + s , s , &XD[0] ) ;
+        ImageMirroredPaddedRow( Ly , row - s , s , &YU[0] ) ;
+        ImageMirroredPaddedRow( Ly , row + s , s , &YD[0] ) ;
+        Real * xu = &XU[0] , * xm = &XM[0] , * xd = &XD[0] , * yu = &YU[0] , * yd = &YD[0] ;
+        // Vertical pass (in place): smoothing for Lxx, derivative for Lxy and Lyy
+        for( int col = 0 ; col < padded_cols ; ++col )
+        {
+          const Real smooth = k_side * xu[ col ] + k_center * xm[ col ] + k_side * xd[ col ] ;
+          xd[ col ] = xd[ col ] - xu[ col ] ;
+          xm[ col ] = smooth ;
+          yd[ col ] = yd[ col ] - yu[ col ] ;
+        }
+        // Horizontal pass and determinant
+        Real * det = Lhess.data() + row * cols ;
+        for( int col = 0 ; col < cols ; ++col )
+        {
+          const Real Lxx = factor * ( xm[ col + 2 * s ] - xm[ col ] ) ;
+          const Real Lxy = factor *
+            ( k_side * xd[ col ] + k_center * xd[ col + s ] + k_side * xd[ col + 2 * s ] ) ;
+          const Real Lyy = factor *
+            ( k_side * yd[ col ] + k_center * yd[ col + s ] + k_side * yd[ col + 2 * s ] ) ;
+          det[ col ] = Lxx * Lyy - Lxy * Lxy ;
+        }
+      }
+    }
+  }
+
   /**
    ** Compute (isotropic) gaussian filtering of an image using filter width of k * sigma
    ** @param img Input image
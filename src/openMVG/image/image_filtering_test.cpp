@@ -127,6 +127,69 @@ TEST(Image, Convolution_Sobel_X_Y)
   EXPECT_TRUE(WriteImage("out_SobelY.png", Image<unsigned char>(outFiltered.cast<unsigned char>())));
 }
 
+TEST(Image, Convolution_Scharr_X_Y_Fused)
+{
+  Image<float> in(53,41);
+  for (int i = 0; i < in.Height(); ++i)
+    for (int j = 0; j < in.Width(); ++j)
+      in(i,j) = rand() % 256 / 255.f;
+
+  for (int scale = 1; scale <= 3; ++scale)
+  {
+    // Reference: separable convolutions
+    Image<float> Lx, Ly, Lxx, Lxy, Lyy;
+    ImageScaledScharrXDerivative( in, Lx, scale);
+    ImageScaledScharrYDerivative( in, Ly, scale);
+    ImageScaledScharrXDerivative( Lx, Lxx, scale);
+    ImageScaledScharrYDerivative( Lx, Lxy, scale);
+    ImageScaledScharrYDerivative( Ly, Lyy, scale);
+    const float factor = scale * scale;
+    Image<float> Lhess(in.Width(), in.Height());
+    Lhess.array() = (factor * Lxx.array()) * (factor * Lyy.array()) - (factor * Lxy.array()).square();
+
+    // Single pass kernels
+    Image<float> Lx_fused, Ly_fused, Lhess_fused;
+    ImageScaledScharrXYDerivatives( in, Lx_fused, Ly_fused, scale);
+    ImageScaledScharrHessianDeterminant( Lx_fused, Ly_fused, scale, factor, Lhess_fused);
+
+    EXPECT_EQ(Lx.Width(), Lx_fused.Width());
+    EXPECT_EQ(Lx.Height(), Lx_fused.Height());
+    EXPECT_NEAR(0.f, (Lx - Lx_fused).array().abs().maxCoeff(), 1e-6);
+    EXPECT_NEAR(0.f, (Ly - Ly_fused).array().abs().maxCoeff(), 1e-6);
+    EXPECT_NEAR(0.f, (Lhess - Lhess_fused).array().abs().maxCoeff(),
+      1e-5 * Lhess.array().abs().maxCoeff());
+  }
+}
+
+TEST(Image, Convolution_Separable_BorderCopy)
+{
+  RowMatrixXf in(37,52);
+  for (int i = 0; i < in.rows(); ++i)
+    for (int j = 0; j < in.cols(); ++j)
+      in(i,j) = rand() % 256;
+
+  Eigen::Matrix<float, 1, Eigen::Dynamic> kernel_x(5), kernel_y(9);
+  kernel_x << 1.f, 4.f, 6.f, 4.f, 1.f;
+  kernel_y << 1.f, 2.f, 3.f, 4.f, 5.f, 4.f, 3.f, 2.f, 1.f;
+  kernel_x /= kernel_x.sum();
+  kernel_y /= kernel_y.sum();
+
+  // Reference: 2D convolution (border pixels are copied)
+  Image<float> ref;
+  const Mat kernel = (kernel_y.transpose() * kernel_x).cast<double>();
+  ImageConvolution(Image<float>(in), kernel, ref);
+
+  RowMatrixXf out(in.rows(), in.cols());
+  SeparableConvolution2d_BorderCopy(in, kernel_x, kernel_y, &out);
+  EXPECT_NEAR(0.f, (ref.GetMat() - out).array().abs().maxCoeff(), 1e-3);
+
+  // In place convolution of an external buffer
+  std::vector<float> buffer(in.data(), in.data() + in.size());
+  Eigen::Map<RowMatrixXf> map(&buffer[0], in.rows(), in.cols());
+  SeparableConvolution2d_BorderCopy(map, kernel_x, kernel_y, &map);
+  EXPECT_EQ(0.f, (map - out).array().abs().maxCoeff());
+}
+
 /* ************************************************************************* */
 int main() { TestResult tr; return TestRegistry::runAllTests(tr);}
 /* ************************************************************************* */
@@ -835,5 +835,213 @@ bool Read_TIFF_ImageHeader(const char * filename, ImageHeader * imgheader)
   return bStatus;
 }
 
+struct Row_Decoder
+{
+  virtual ~Row_Decoder() {}
+  /// Decode the next row as gray values
+  virtual bool ReadRow(unsigned char * gray_row) = 0;
+};
+
+/// Gray conversion of a row of 8-bit gray or RGB pixels (same conversion as ReadImage)
+static void RowToGray(const unsigned char * row, int width, int depth, unsigned char * gray_row)
+{
+  if (depth == 1)
+    memcpy(gray_row, row, width);
+  else
+    for (int x = 0; x < width; ++x)
+      Convert(RGBColor(row[3*x], row[3*x+1], row[3*x+2]), gray_row[x]);
+}
+
+struct Jpg_Row_Decoder : public Row_Decoder
+{
+  Jpg_Row_Decoder() : file(NULL), bCreated(false) {}
+  ~Jpg_Row_Decoder()
+  {
+    if (bCreated)
+      jpeg_destroy_decompress(&cinfo);
+    if (file)
+      fclose(file);
+  }
+
+  bool Open(const char * filename, int * w, int * h)
+  {
+    file = fopen(filename, "rb");
+    if (!file)
+      return false;
+    cinfo.err = jpeg_std_error(&jerr.pub);
+    jerr.pub.error_exit = &jpeg_error;
+    if (setjmp(jerr.setjmp_buffer))
+      return false;
+    jpeg_create_decompress(&cinfo);
+    bCreated = true;
+    jpeg_stdio_src(&cinfo, file);
+    jpeg_read_header(&cinfo, TRUE);
+    jpeg_start_decompress(&cinfo);
+    if (cinfo.output_components != 1 && cinfo.output_components != 3)
+      return false;
+    *w = cinfo.output_width;
+    *h = cinfo.output_height;
+    row.resize(cinfo.output_width * cinfo.output_components);
+    return true;
+  }
+
+  bool ReadRow(unsigned char * gray_row)
+  {
+    if (setjmp(jerr.setjmp_buffer)) {
+      cerr << "Error JPG: Failed to decompress.";
+      return false;
+    }
+    JSAMPROW scanline[1] = { &row[0] };
+    if (jpeg_read_scanlines(&cinfo, scanline, 1) != 1)
+      return false;
+    RowToGray(&row[0], cinfo.output_width, cinfo.output_components, gray_row);
+    return true;
+  }
+
+  FILE * file;
+  bool bCreated;
+  jpeg_decompress_struct cinfo;
+  my_error_mgr jerr;
+  vector<unsigned char> row;
+};
+
+struct Tiff_Row_Decoder : public Row_Decoder
+{
+  Tiff_Row_Decoder() : tiff(NULL), width(0), spp(0), next_row(0) {}
+  ~Tiff_Row_Decoder()
+  {
+    if (tiff)
+      TIFFClose(tiff);
+  }
+
+  bool Open(const char * filename, int * w, int * h)
+  {
+    tiff = TIFFOpen(filename, "r");
+    if (!tiff || TIFFIsTiled(tiff))
+      return false;
+    uint16 bps, planar;
+    TIFFGetField(tiff, TIFFTAG_IMAGEWIDTH, w);
+    TIFFGetField(tiff, TIFFTAG_IMAGELENGTH, h);
+    TIFFGetFieldDefaulted(tiff, TIFFTAG_BITSPERSAMPLE, &bps);
+    TIFFGetFieldDefaulted(tiff, TIFFTAG_SAMPLESPERPIXEL, &spp);
+    TIFFGetFieldDefaulted(tiff, TIFFTAG_PLANARCONFIG, &planar);
+    if (bps != 8 || (spp != 1 && spp != 3) || planar != PLANARCONFIG_CONTIG)
+      return false;
+    width = *w;
+    row.resize(TIFFScanlineSize(tiff));
+    return true;
+  }
+
+  bool ReadRow(unsigned char * gray_row)
+  {
+    if (TIFFReadScanline(tiff, &row[0], next_row++) < 0)
+      return false;
+    RowToGray(&row[0], width, spp, gray_row);
+    return true;
+  }
+
+  TIFF * tiff;
+  int width;
+  uint16 spp;
+  uint32 next_row;
+  vector<unsigned char> row;
+};
+
+/// Fallback: the image is fully decoded
+struct Memory_Row_Decoder : public Row_Decoder
+{
+  Memory_Row_Decoder() : next_row(0) {}
+
+  bool ReadRow(unsigned char * gray_row)
+  {
+    if (next_row >= image.Height())
+      return false;
+    memcpy(gray_row, &image(next_row++, 0), image.Width());
+    return true;
+  }
+
+  Image<unsigned char> image;
+  int next_row;
+};
+
+ImageBandReader::ImageBandReader()
+  :_width(0), _height(0), _next_row(0), _band_y(0)
+{}
+
+ImageBandReader::~ImageBandReader()
+{}
+
+bool ImageBandReader::Open(const char * filename)
+{
+  _decoder.reset();
+  _width = _height = _next_row = _band_y = 0;
+  _band = Image<unsigned char>();
+
+  switch (GetFormat(filename)) {
+    case Jpg:
+    {
+      std::unique_ptr<Jpg_Row_Decoder> decoder(new Jpg_Row_Decoder);
+      if (decoder->Open(filename, &_width, &_height))
+        _decoder.reset(decoder.release());
+    }
+    break;
+    case Tiff:
+    {
+      std::unique_ptr<Tiff_Row_Decoder> decoder(new Tiff_Row_Decoder);
+      if (decoder->Open(filename, &_width, &_height))
+        _decoder.reset(decoder.release());
+    }
+    break;
+    default:
+    break;
+  }
+  if (!_decoder)
+  {
+    // Unsupported row decoding: decode the whole image
+    std::unique_ptr<Memory_Row_Decoder> decoder(new Memory_Row_Decoder);
+    if (!ReadImage(filename, &decoder->image))
+      return false;
+    _width = decoder->image.Width();
+    _height = decoder->image.Height();
+    _decoder.reset(decoder.release());
+  }
+  return true;
+}
+
+bool ImageBandReader::ReadBand(int y, int rows, Image<unsigned char> * band)
+{
+  if (!_decoder || y < _band_y || rows < 0 || y + rows > _height)
+    return false;
+
+  Image<unsigned char> new_band(_width, rows, false);
+  vector<unsigned char> skipped_row;
+  for (int r = 0; r < rows; ++r)
+  {
+    const int row = y + r;
+    if (row < _next_row)
+    {
+      // Already decoded: the row must be in the previous band
+      if (row >= _band_y + _band.Height())
+        return false;
+      new_band.row(r) = _band.row(row - _band_y);
+    }
+    else
+    {
+      // Decode (and skip the rows before the band)
+      skipped_row.resize(_width);
+      for (; _next_row < row; ++_next_row)
+        if (!_decoder->ReadRow(&skipped_row[0]))
+          return false;
+      if (!_decoder->ReadRow(&new_band(r, 0)))
+        return false;
+      ++_next_row;
+    }
+  }
+  _band.swap(new_band);
+  _band_y = y;
+  *band = _band;
+  return true;
+}
+
 }  // namespace image
 }  // namespace openMVG
@@ -10,6 +10,8 @@
 #include "openMVG/image/image_container.hpp"
 #include "openMVG/image/pixel_types.hpp"
 
+#include <memory>
+
 namespace openMVG {
 namespace image {
 
@@ -84,6 +86,38 @@ bool Read_JPG_ImageHeader(const char *, ImageHeader *);
 bool Read_PNM_ImageHeader(const char *, ImageHeader *);
 bool Read_TIFF_ImageHeader(const char *, ImageHeader *);
 
+/// Row decoder used by ImageBandReader (implementation detail)
+struct Row_Decoder;
+
+/// Sequential reader of the rows of an image converted to grayscale (bounded memory).
+/// JPEG and TIFF (8-bit gray or RGB strips) images are decoded row by row, so only
+///  the requested band is in memory. The other images are fully decoded by Open.
+class ImageBandReader
+{
+public:
+  ImageBandReader();
+  ~ImageBandReader();
+
+  bool Open(const char * filename);
+
+  int Width() const { return _width; }
+  int Height() const { return _height; }
+
+  /// Read the rows [y, y + rows) of the image.
+  /// The bands must be requested by non decreasing y (consecutive bands can overlap).
+  bool ReadBand(int y, int rows, Image<unsigned char> * band);
+
+private:
+  ImageBandReader(const ImageBandReader &); // non copyable
+  ImageBandReader & operator=(const ImageBandReader &);
+
+  std::unique_ptr<Row_Decoder> _decoder;
+  int _width, _height;
+  int _next_row;              // Index of the next decoded row
+  Image<unsigned char> _band; // Last read band
+  int _band_y;                // First row of the last read band
+};
+
 template<>
 inline int ReadImage(const char * path, Image<unsigned char> * im)
 {
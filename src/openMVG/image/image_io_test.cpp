@@ -5,6 +5,7 @@
 // file, You can obtain one at http://mozilla.org/MPL/2.0/.
 
 
+#include <algorithm>
 #include <cstdio>
 #include <iostream>
 #include <string>
@@ -257,6 +258,56 @@ TEST(ImageHeader, AllFormats) {
   }
 }
 
+TEST(ImageBandReader, AllFormats) {
+
+  const std::vector<std::string> ext_Type = {"jpg", "png", "tif", "pgm", "ppm"};
+  Image<RGBColor> rgb_image(67, 45);
+  for (int y = 0; y < rgb_image.Height(); ++y)
+    for (int x = 0; x < rgb_image.Width(); ++x)
+      rgb_image(y, x) = RGBColor(x * 3, y * 5, (x * y) % 256);
+  Image<unsigned char> gray_image;
+  ConvertPixelType(rgb_image, &gray_image);
+
+  for (int i=0; i < ext_Type.size(); ++i)
+  {
+    for (int color = 0; color < 2; ++color)
+    {
+      if ((ext_Type[i] == "pgm" && color == 1) || (ext_Type[i] == "ppm" && color == 0))
+        continue;
+      const std::string filename = "img_band." + ext_Type[i];
+      if (color == 1) {
+        EXPECT_TRUE(WriteImage(filename.c_str(), rgb_image));
+      }
+      else {
+        EXPECT_TRUE(WriteImage(filename.c_str(), gray_image));
+      }
+
+      // Reference: the whole image
+      Image<unsigned char> image;
+      EXPECT_TRUE(ReadImage(filename.c_str(), &image));
+
+      // Overlapping bands
+      ImageBandReader reader;
+      EXPECT_TRUE(reader.Open(filename.c_str()));
+      EXPECT_EQ(image.Width(), reader.Width());
+      EXPECT_EQ(image.Height(), reader.Height());
+      for (int y = 0; y < reader.Height(); y += 10)
+      {
+        const int y0 = std::max(0, y - 4), y1 = std::min(reader.Height(), y + 14);
+        Image<unsigned char> band;
+        EXPECT_TRUE(reader.ReadBand(y0, y1 - y0, &band));
+        EXPECT_EQ(image.Width(), band.Width());
+        EXPECT_EQ(y1 - y0, band.Height());
+        EXPECT_TRUE(band == image.block(y0, 0, y1 - y0, image.Width()));
+      }
+      // Bands are read by non decreasing rows
+      Image<unsigned char> band;
+      EXPECT_FALSE(reader.ReadBand(0, 10, &band));
+      remove(filename.c_str());
+    }
+  }
+}
+
 /* ************************************************************************* */
 int main() { TestResult tr; return TestRegistry::runAllTests(tr);}
 /* ************************************************************************* */
@@ -18,6 +18,18 @@
 namespace openMVG {
 namespace matching {
 
+/// Export the IndMatch of a pair to a stream
+static bool PairIndMatchToStream(
+  const Pair & pair,
+  const std::vector<IndMatch> & vec_matches,
+  std::ostream & os)
+{
+  os << pair.first << " " << pair.second << '\n' << vec_matches.size() << '\n';
+  copy(vec_matches.begin(), vec_matches.end(),
+       std::ostream_iterator<IndMatch>(os, "\n"));
+  return os.good();
+}
+
 /// Export vector of IndMatch to a stream
 static bool PairedIndMatchToStream(
   const PairWiseMatches & map_indexedMatches,
@@ -27,12 +39,7 @@ static bool PairedIndMatchToStream(
     iter != map_indexedMatches.end();
     ++iter)
   {
-    const size_t I = iter->first.first;
-    const size_t J = iter->first.second;
-    const std::vector<IndMatch> & vec_matches = iter->second;
-    os << I << " " << J << '\n' << vec_matches.size() << '\n';
-    copy(vec_matches.begin(), vec_matches.end(),
-         std::ostream_iterator<IndMatch>(os, "\n"));
+    PairIndMatchToStream(iter->first, iter->second, os);
   }
   return os.good();
 }
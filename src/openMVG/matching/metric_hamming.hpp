@@ -39,6 +39,13 @@ namespace matching {
 #define PLATFORM_32_BIT
 #endif
 
+// If the build does not target the POPCNT instruction (no -mpopcnt, -msse4.2 or
+//  -march=native), the builtin popcount is a software routine: a popcnt version of
+//  the word loop is compiled anyway and selected at runtime on the CPUs that support it.
+#if (defined __GNUC__ || defined __clang__) && defined PLATFORM_64_BIT && !defined __POPCNT__
+#define OPENMVG_HAMMING_POPCNT_DISPATCH
+#endif
+
 /// Hamming distance:
 ///  Working for STL fixed size BITSET and boost DYNAMIC_BITSET
 template<typename TBitset>
@@ -103,6 +110,39 @@ struct Hamming
 #endif
   }
 
+#ifdef OPENMVG_HAMMING_POPCNT_DISPATCH
+  static inline bool cpu_has_popcnt()
+  {
+    static const bool has_popcnt = (__builtin_cpu_init(), __builtin_cpu_supports("popcnt") != 0);
+    return has_popcnt;
+  }
+
+  __attribute__((target("popcnt")))
+  static unsigned int distance64_popcnt(const uint64_t* pa, const uint64_t* pb, size_t count)
+  {
+    unsigned int result = 0;
+    for(size_t i = 0; i < count; ++i) {
+      result += __builtin_popcountll(pa[i] ^ pb[i]);
+    }
+    return result;
+  }
+#endif
+
+  /// Number of different bits between two arrays of 64-bit words
+  /// (e.g. the binary descriptors packed in 64-bit words: one popcount per word)
+  static inline unsigned int distance64(const uint64_t* pa, const uint64_t* pb, size_t count)
+  {
+#ifdef OPENMVG_HAMMING_POPCNT_DISPATCH
+    if (cpu_has_popcnt())
+      return distance64_popcnt(pa, pb, count);
+#endif
+    unsigned int result = 0;
+    for(size_t i = 0; i < count; ++i) {
+      result += popcnt64(pa[i] ^ pb[i]);
+    }
+    return result;
+  }
+
   // Size must be equal to number of ElementType
   template <typename Iterator1, typename Iterator2>
   inline ResultType operator()(Iterator1 a, Iterator2 b, size_t size) const
@@ -113,12 +153,8 @@ struct Hamming
 #ifdef PLATFORM_64_BIT
     if(size%sizeof(uint64_t) == 0)
     {
-      const uint64_t* pa = reinterpret_cast<const uint64_t*>(a);
-      const uint64_t* pb = reinterpret_cast<const uint64_t*>(b);
-      size /= (sizeof(uint64_t)/sizeof(unsigned char));
-      for(size_t i = 0; i < size; ++i, ++pa, ++pb ) {
-        result += popcnt64(*pa ^ *pb);
-      }
+      result = distance64(reinterpret_cast<const uint64_t*>(a),
+        reinterpret_cast<const uint64_t*>(b), size / sizeof(uint64_t));
     }
     else if(size%sizeof(uint32_t) == 0)
     {
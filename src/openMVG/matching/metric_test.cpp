@@ -7,6 +7,7 @@
 
 #include "testing/testing.h"
 #include "openMVG/matching/metric.hpp"
+#include "openMVG/numeric/float16.hpp"
 #include <iostream>
 #include <string>
 using namespace std;
@@ -39,6 +40,7 @@ TEST(Metric, L2_Vectorized)
   EXPECT_EQ(168, DistanceT<L2_Vectorized<int> >());
   EXPECT_EQ(168, DistanceT<L2_Vectorized<float> >());
   EXPECT_EQ(168, DistanceT<L2_Vectorized<double> >());
+  EXPECT_EQ(168, DistanceT<L2_Vectorized<Float16> >());
 }
 
 TEST(Metric, HAMMING_BITSET)
@@ -131,6 +133,28 @@ TEST(Metric, HAMMING_BITSET_RAW_MEMORY_32BITS)
   }
 }
 
+TEST(Metric, HAMMING_RAW_MEMORY_MLDB_SIZE)
+{
+  // 64 bytes descriptors (AKAZE MLDB): compared word by word
+  const int COUNT = 8;
+  std::bitset<512> tab[COUNT];
+  for (int k = 0; k < COUNT; ++k)
+    for (int i = 0; i < 512; ++i)
+      tab[k][i] = (rand() % (k + 2)) == 0;
+
+  Hamming< unsigned char > metricHamming;
+  for (int i = 0; i < COUNT; ++i)
+  {
+    for (int j = 0; j < COUNT; ++j)
+    {
+      const size_t gtDist = (tab[i] ^ tab[j]).count();
+      EXPECT_EQ(gtDist, metricHamming((unsigned char*)&tab[i], (unsigned char*)&tab[j], 64));
+      EXPECT_EQ(gtDist, Hamming< unsigned char >::distance64(
+        (uint64_t*)&tab[i], (uint64_t*)&tab[j], 8));
+    }
+  }
+}
+
 /* ************************************************************************* */
 int main() { TestResult tr; return TestRegistry::runAllTests(tr);}
 /* ************************************************************************* */
@@ -127,6 +127,34 @@ Matcher_Regions_Database::Matcher_Regions_Database
           std::cerr << "Using unknown matcher type" << std::endl;
       }
     }
+    else if (database_regions.Type_id() == typeid(Float16).name())
+    {
+      // Build on the fly half precision float based Matcher
+      switch (eMatcherType)
+      {
+        case BRUTE_FORCE_L2:
+        {
+          typedef L2_Vectorized<Float16> MetricT;
+          typedef ArrayMatcherBruteForce<Float16, MetricT> MatcherT;
+          _matching_interface.reset(new matching::RegionsMatcherT<MatcherT>(database_regions, true));
+        }
+        break;
+        case CASCADE_HASHING_L2:
+        {
+          typedef L2_Vectorized<Float16> MetricT;
+          typedef ArrayMatcherCascadeHashing<Float16, MetricT> MatcherT;
+          _matching_interface.reset(new matching::RegionsMatcherT<MatcherT>(database_regions, true));
+        }
+        break;
+        case ANN_L2:
+        {
+          std::cerr << "Not yet implemented" << std::endl;
+        }
+        break;
+        default:
+          std::cerr << "Using unknown matcher type" << std::endl;
+      }
+    }
     else if (database_regions.Type_id() == typeid(double).name())
     {
       // Build on the fly double based Matcher
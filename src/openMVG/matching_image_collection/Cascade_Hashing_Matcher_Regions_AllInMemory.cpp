@@ -36,7 +36,7 @@ void Match
   const sfm::Regions_Provider & regions_provider,
   const Pair_Set & pairs,
   float fDistRatio,
-  PairWiseMatches & map_PutativesMatches // the pairwise photometric corresponding points
+  PairWiseMatches_Consumer & consumer // the receiver of the pairwise photometric corresponding points
 )
 {
   C_Progress_display my_progress_bar( pairs.size() );
@@ -207,10 +207,10 @@ void Match
 #endif
       {
         ++my_progress_bar;
-        if (!vec_putative_matches.empty())
-        {
-          map_PutativesMatches.insert( make_pair( make_pair(I,J), std::move(vec_putative_matches) ));
-        }
+      }
+      if (!vec_putative_matches.empty())
+      {
+        consumer.Consume(Pair(I,J), std::move(vec_putative_matches));
       }
     }
   }
@@ -222,7 +222,7 @@ void Cascade_Hashing_Matcher_Regions_AllInMemory::Match
   const sfm::SfM_Data & sfm_data,
   const std::shared_ptr<sfm::Regions_Provider> & regions_provider,
   const Pair_Set & pairs,
-  PairWiseMatches & map_PutativesMatches // the pairwise photometric corresponding points
+  PairWiseMatches_Consumer & consumer // the receiver of the pairwise photometric corresponding points
 )const
 {
 #ifdef OPENMVG_USE_OPENMP
@@ -244,7 +244,7 @@ void Cascade_Hashing_Matcher_Regions_AllInMemory::Match
       *regions_provider.get(),
       pairs,
       f_dist_ratio_,
-      map_PutativesMatches);
+      consumer);
   }
   else
   if(regions.Type_id() == typeid(float).name())
@@ -254,7 +254,17 @@ void Cascade_Hashing_Matcher_Regions_AllInMemory::Match
       *regions_provider.get(),
       pairs,
       f_dist_ratio_,
-      map_PutativesMatches);
+      consumer);
+  }
+  else
+  if(regions.Type_id() == typeid(Float16).name())
+  {
+    impl::Match<Float16>(
+      sfm_data,
+      *regions_provider.get(),
+      pairs,
+      f_dist_ratio_,
+      consumer);
   }
   else
   {
@@ -27,13 +27,15 @@ class Cascade_Hashing_Matcher_Regions_AllInMemory : public Matcher
     float dist_ratio
   );
 
+  using Matcher::Match;
+
   /// Find corresponding points between some pair of view Ids
   void Match
   (
     const sfm::SfM_Data & sfm_data,
     const std::shared_ptr<sfm::Regions_Provider> & regions_provider,
     const Pair_Set & pairs,
-    matching::PairWiseMatches & map_PutativesMatches // the pairwise photometric corresponding points
+    PairWiseMatches_Consumer & consumer // the receiver of the pairwise photometric corresponding points
   )const;
 
   private:
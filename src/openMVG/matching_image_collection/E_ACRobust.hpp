@@ -154,10 +154,8 @@ struct GeometricFilter_EMatrix_AC
       Mat3 F;
       FundamentalFromEssential(m_E, ptrPinhole_I->K(), ptrPinhole_J->K(), &F);
 
-      geometry_aware::GuidedMatching
-        <Mat3,
-        openMVG::fundamental::kernel::EpipolarDistanceError>(
-        //openMVG::fundamental::kernel::SymmetricEpipolarDistanceError>(
+      geometry_aware::GuidedMatching_Fundamental_Grid
+        <openMVG::fundamental::kernel::EpipolarDistanceError>(
         F,
         cam_I, *regions_provider->regions_per_view.at(iIndex),
         cam_J, *regions_provider->regions_per_view.at(jIndex),
@@ -119,10 +119,8 @@ struct GeometricFilter_FMatrix_AC
           sfm_data->GetIntrinsics().at(view_J->id_intrinsic).get() : NULL;
 
       // Check the features correspondences that agree in the geometric and photometric domain
-      geometry_aware::GuidedMatching
-        <Mat3,
-        openMVG::fundamental::kernel::EpipolarDistanceError>(
-        //openMVG::fundamental::kernel::SymmetricEpipolarDistanceError>(
+      geometry_aware::GuidedMatching_Fundamental_Grid
+        <openMVG::fundamental::kernel::EpipolarDistanceError>(
         m_F,
         cam_I, *regions_provider->regions_per_view.at(iIndex),
         cam_J, *regions_provider->regions_per_view.at(jIndex),
@@ -43,6 +43,19 @@ struct ImageCollectionGeometricFilter
     const double d_distance_ratio = 0.6
   );
 
+  /// Perform robust model estimation (with optional guided_matching) for the putative matches of a single pair.
+  /// Return true (and the geometric inliers) if a model is found.
+  template<typename GeometryFunctor>
+  bool Robust_model_estimation
+  (
+    const GeometryFunctor & functor,
+    const Pair & pair,
+    const IndMatches & putative_matches,
+    IndMatches & geometric_inliers,
+    const bool b_guided_matching = false,
+    const double d_distance_ratio = 0.6
+  ) const;
+
   const PairWiseMatches & Get_geometric_matches() const {return _map_GeometricMatches;}
 
   // Data
@@ -76,17 +89,9 @@ void ImageCollectionGeometricFilter::Robust_model_estimation
     //-- Apply the geometric filter (robust model estimation)
     {
       IndMatches putative_inliers;
-      GeometryFunctor geometricFilter = functor; // use a copy since we are in a multi-thread context
-      if (geometricFilter.Robust_estimation(_sfm_data, _regions_provider, iter->first, vec_PutativeMatches, putative_inliers))
+      if (Robust_model_estimation(functor, current_pair, vec_PutativeMatches, putative_inliers,
+        b_guided_matching, d_distance_ratio))
       {
-        if (b_guided_matching)
-        {
-          IndMatches guided_geometric_inliers;
-          geometricFilter.Geometry_guided_matching(_sfm_data, _regions_provider, iter->first, d_distance_ratio, guided_geometric_inliers);
-          //std::cout << "#before/#after: " << putative_inliers.size() << "/" << guided_geometric_inliers.size() << std::endl;
-          std::swap(putative_inliers, guided_geometric_inliers);
-        }
-
 #ifdef OPENMVG_USE_OPENMP
 #pragma omp critical
 #endif
@@ -104,6 +109,31 @@ void ImageCollectionGeometricFilter::Robust_model_estimation
   }
 }
 
+template<typename GeometryFunctor>
+bool ImageCollectionGeometricFilter::Robust_model_estimation
+(
+  const GeometryFunctor & functor,
+  const Pair & pair,
+  const IndMatches & putative_matches,
+  IndMatches & geometric_inliers,
+  const bool b_guided_matching,
+  const double d_distance_ratio
+) const
+{
+  GeometryFunctor geometricFilter = functor; // use a copy since we are in a multi-thread context
+  if (!geometricFilter.Robust_estimation(_sfm_data, _regions_provider, pair, putative_matches, geometric_inliers))
+    return false;
+
+  if (b_guided_matching)
+  {
+    IndMatches guided_geometric_inliers;
+    geometricFilter.Geometry_guided_matching(_sfm_data, _regions_provider, pair, d_distance_ratio, guided_geometric_inliers);
+    //std::cout << "#before/#after: " << geometric_inliers.size() << "/" << guided_geometric_inliers.size() << std::endl;
+    std::swap(geometric_inliers, guided_geometric_inliers);
+  }
+  return true;
+}
+
 } // namespace openMVG
 } // namespace matching_image_collection
 
@@ -163,8 +163,8 @@ struct GeometricFilter_HMatrix_AC
       else
       {
         // Filtering based on region positions and regions descriptors
-        geometry_aware::GuidedMatching
-          <Mat3, openMVG::homography::kernel::AsymmetricError>(
+        geometry_aware::GuidedMatching_Homography_Grid
+          <openMVG::homography::kernel::AsymmetricError>(
           m_H,
           cam_I, *regions_provider->regions_per_view.at(iIndex),
           cam_J, *regions_provider->regions_per_view.at(jIndex),
@@ -13,12 +13,42 @@
 #include "openMVG/sfm/sfm_data.hpp"
 #include "openMVG/sfm/pipelines/sfm_regions_provider.hpp"
 
+#include <mutex>
 #include <string>
 #include <vector>
 
 namespace openMVG {
 namespace matching_image_collection {
 
+/// Receive the putative matches of the pairs as soon as they are computed
+/// (called concurrently by the matching threads: implementations must be thread safe)
+class PairWiseMatches_Consumer
+{
+  public:
+  virtual ~PairWiseMatches_Consumer() {};
+
+  /// Receive the (non empty) putative matches of a pair
+  virtual void Consume(const Pair & pair, matching::IndMatches && putative_matches) = 0;
+};
+
+/// Store the received putative matches in a PairWiseMatches container
+class PairWiseMatches_Collector : public PairWiseMatches_Consumer
+{
+  public:
+  PairWiseMatches_Collector(matching::PairWiseMatches & map_putatives_matches)
+    : _map_putatives_matches(map_putatives_matches) {}
+
+  void Consume(const Pair & pair, matching::IndMatches && putative_matches)
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _map_putatives_matches.insert(std::make_pair(pair, std::move(putative_matches)));
+  }
+
+  private:
+  matching::PairWiseMatches & _map_putatives_matches;
+  std::mutex _mutex;
+};
+
 /// Implementation of an Image Collection Matcher
 /// Compute putative matches between a collection of pictures
 class Matcher
@@ -29,12 +59,25 @@ class Matcher
   virtual ~Matcher() {};
 
   /// Find corresponding points between some pair of view Ids
+  /// The putative matches of each pair are sent to the consumer once computed
   virtual void Match(
     const sfm::SfM_Data & sfm_data,
     const std::shared_ptr<sfm::Regions_Provider> & regions_provider,
     const Pair_Set & pairs, // list of pair to consider for matching
-    matching::PairWiseMatches & map_putatives_matches // the output pairwise photometric corresponding points
+    PairWiseMatches_Consumer & consumer // the receiver of the pairwise photometric corresponding points
     )const = 0;
+
+  /// Find corresponding points between some pair of view Ids
+  void Match(
+    const sfm::SfM_Data & sfm_data,
+    const std::shared_ptr<sfm::Regions_Provider> & regions_provider,
+    const Pair_Set & pairs, // list of pair to consider for matching
+    matching::PairWiseMatches & map_putatives_matches // the output pairwise photometric corresponding points
+    )const
+  {
+    PairWiseMatches_Collector collector(map_putatives_matches);
+    Match(sfm_data, regions_provider, pairs, collector);
+  }
 };
 
 } // namespace openMVG
@@ -15,6 +15,18 @@
 #include "third_party/stlplus3/filesystemSimplified/file_system.hpp"
 #include "third_party/progress/progress.hpp"
 
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#ifdef OPENMVG_USE_OPENMP
+#include <omp.h>
+#endif
+
 namespace openMVG {
 namespace matching_image_collection {
 
@@ -22,81 +34,159 @@ using namespace openMVG::matching;
 using namespace openMVG::features;
 
 Matcher_Regions_AllInMemory::Matcher_Regions_AllInMemory(
-  float distRatio, EMatcherType eMatcherType)
-  :Matcher(), _f_dist_ratio(distRatio), _eMatcherType(eMatcherType)
+  float distRatio, EMatcherType eMatcherType, size_t database_cache_size)
+  :Matcher(), _f_dist_ratio(distRatio), _eMatcherType(eMatcherType),
+  _database_cache_size(database_cache_size)
 {
 }
 
+namespace {
+
+/// Bounded cache of the matching databases (built once per view, shared by the threads)
+/// The least recently used databases are released when the cache is full
+/// (a database still used by a thread is kept alive by its shared_ptr).
+class Matcher_Database_Cache
+{
+  public:
+  Matcher_Database_Cache
+  (
+    const sfm::Regions_Provider & regions_provider,
+    EMatcherType eMatcherType,
+    size_t capacity
+  ):_regions_provider(regions_provider), _eMatcherType(eMatcherType),
+    _capacity(std::max(capacity, size_t(1))), _time(0)
+  {}
+
+  std::shared_ptr<const Matcher_Regions_Database> Get(const IndexT I)
+  {
+    std::shared_ptr<Entry> entry;
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      std::map<IndexT, std::shared_ptr<Entry> >::iterator it = _entries.find(I);
+      if (it == _entries.end())
+      {
+        if (_entries.size() >= _capacity)
+        {
+          // Release the least recently used database
+          std::map<IndexT, std::shared_ptr<Entry> >::iterator it_lru = _entries.begin();
+          for (it = _entries.begin(); it != _entries.end(); ++it)
+            if (it->second->last_use < it_lru->second->last_use)
+              it_lru = it;
+          _entries.erase(it_lru);
+        }
+        it = _entries.insert(std::make_pair(I, std::make_shared<Entry>())).first;
+      }
+      it->second->last_use = ++_time;
+      entry = it->second;
+    }
+    // Build the database once (the other threads that need it wait)
+    std::call_once(entry->once, [&]{
+      entry->database = std::make_shared<Matcher_Regions_Database>(
+        _eMatcherType, *_regions_provider.regions_per_view.at(I).get());
+    });
+    return entry->database;
+  }
+
+  private:
+  struct Entry
+  {
+    std::once_flag once;
+    std::shared_ptr<const Matcher_Regions_Database> database;
+    size_t last_use;
+  };
+
+  const sfm::Regions_Provider & _regions_provider;
+  const EMatcherType _eMatcherType;
+  const size_t _capacity;
+  size_t _time;
+  std::map<IndexT, std::shared_ptr<Entry> > _entries;
+  std::mutex _mutex;
+};
+
+} // namespace
+
 void Matcher_Regions_AllInMemory::Match(
   const sfm::SfM_Data & sfm_data,
   const std::shared_ptr<sfm::Regions_Provider> & regions_provider,
   const Pair_Set & pairs,
-  PairWiseMatches & map_PutativesMatches)const // the pairwise photometric corresponding points
+  PairWiseMatches_Consumer & consumer)const // the receiver of the pairwise photometric corresponding points
 {
 #ifdef OPENMVG_USE_OPENMP
   std::cout << "Using the OPENMP thread interface" << std::endl;
+  const size_t thread_count = omp_get_max_threads();
+#else
+  const size_t thread_count = 1;
 #endif
-  const bool b_multithreaded_pair_search = (_eMatcherType == CASCADE_HASHING_L2);
-  // -> set to true for CASCADE_HASHING_L2, since OpenMP instructions are not used in this matcher
 
   C_Progress_display my_progress_bar( pairs.size() );
 
-  // Sort pairs according the first index to minimize the MatcherT build operations
-  typedef std::map<size_t, std::vector<size_t> > Map_vectorT;
+  // Schedule the pairs:
+  // - the pairs are grouped by database view (I) to reuse its matching database,
+  // - the estimated cost of a pair is the product of the regions counts,
+  // - the most expensive groups (and pairs in a group) are matched first,
+  //   so the threads stay busy until the end of the matching.
+  typedef std::map<IndexT, std::vector<std::pair<uint64_t, IndexT> > > Map_vectorT;
   Map_vectorT map_Pairs;
+  std::map<IndexT, uint64_t> map_GroupCost;
   for (Pair_Set::const_iterator iter = pairs.begin(); iter != pairs.end(); ++iter)
   {
-    map_Pairs[iter->first].push_back(iter->second);
+    const uint64_t cost =
+      uint64_t(regions_provider->regions_per_view.at(iter->first)->RegionCount()) *
+      regions_provider->regions_per_view.at(iter->second)->RegionCount();
+    map_Pairs[iter->first].push_back(std::make_pair(cost, iter->second));
+    map_GroupCost[iter->first] += cost;
   }
-
-  // Perform matching between all the pairs
-  for (Map_vectorT::const_iterator iter = map_Pairs.begin();
-    iter != map_Pairs.end(); ++iter)
+  std::vector<std::pair<uint64_t, IndexT> > vec_groups;
+  for (std::map<IndexT, uint64_t>::const_iterator iter = map_GroupCost.begin();
+    iter != map_GroupCost.end(); ++iter)
   {
-    const size_t I = iter->first;
-    const std::vector<size_t> & indexToCompare = iter->second;
-
-    const features::Regions & regionsI = *regions_provider->regions_per_view.at(I).get();
-    if (regionsI.RegionCount() == 0)
-    {
-      my_progress_bar += indexToCompare.size();
-      continue;
-    }
+    vec_groups.push_back(std::make_pair(iter->second, iter->first));
+  }
+  std::stable_sort(vec_groups.begin(), vec_groups.end(),
+    std::greater<std::pair<uint64_t, IndexT> >());
+  std::vector<Pair> vec_scheduled_pairs;
+  vec_scheduled_pairs.reserve(pairs.size());
+  for (size_t i = 0; i < vec_groups.size(); ++i)
+  {
+    const IndexT I = vec_groups[i].second;
+    std::vector<std::pair<uint64_t, IndexT> > & vec_J = map_Pairs[I];
+    std::stable_sort(vec_J.begin(), vec_J.end(), std::greater<std::pair<uint64_t, IndexT> >());
+    for (size_t j = 0; j < vec_J.size(); ++j)
+      vec_scheduled_pairs.push_back(Pair(I, vec_J[j].second));
+  }
 
-    // Initialize the matching interface
-    matching::Matcher_Regions_Database matcher(_eMatcherType, regionsI);
+  // Perform matching between all the pairs (in parallel, whatever the matcher type).
+  // The matching databases of the views are built on demand and kept in a bounded cache.
+  Matcher_Database_Cache database_cache(*regions_provider.get(), _eMatcherType,
+    _database_cache_size > 0 ? _database_cache_size : 2 * thread_count);
 
 #ifdef OPENMVG_USE_OPENMP
-    #pragma omp parallel for schedule(dynamic) if(b_multithreaded_pair_search)
+  #pragma omp parallel for schedule(dynamic)
 #endif
-    for (int j = 0; j < (int)indexToCompare.size(); ++j)
-    {
-      const size_t J = indexToCompare[j];
-
-      const features::Regions &regionsJ = *regions_provider->regions_per_view.at(J).get();
-      if (regionsJ.RegionCount() == 0
-          || regionsI.Type_id() != regionsJ.Type_id())
-      {
-#ifdef OPENMVG_USE_OPENMP
-  #pragma omp critical
-#endif
-        ++my_progress_bar;
-        continue;
-      }
+  for (int k = 0; k < (int)vec_scheduled_pairs.size(); ++k)
+  {
+    const IndexT I = vec_scheduled_pairs[k].first;
+    const IndexT J = vec_scheduled_pairs[k].second;
 
-      IndMatches vec_putatives_matches;
-      matcher.Match(_f_dist_ratio, regionsJ, vec_putatives_matches);
+    const features::Regions & regionsI = *regions_provider->regions_per_view.at(I).get();
+    const features::Regions & regionsJ = *regions_provider->regions_per_view.at(J).get();
+    IndMatches vec_putatives_matches;
+    if (regionsI.RegionCount() > 0 && regionsJ.RegionCount() > 0
+        && regionsI.Type_id() == regionsJ.Type_id())
+    {
+      const std::shared_ptr<const Matcher_Regions_Database> matcher = database_cache.Get(I);
+      matcher->Match(_f_dist_ratio, regionsJ, vec_putatives_matches);
+    }
 
 #ifdef OPENMVG_USE_OPENMP
   #pragma omp critical
 #endif
-      {
-        ++my_progress_bar;
-        if (!vec_putatives_matches.empty())
-        {
-          map_PutativesMatches.insert( make_pair( make_pair(I,J), std::move(vec_putatives_matches) ));
-        }
-      }
+    {
+      ++my_progress_bar;
+    }
+    if (!vec_putatives_matches.empty())
+    {
+      consumer.Consume(Pair(I,J), std::move(vec_putatives_matches));
     }
   }
 }
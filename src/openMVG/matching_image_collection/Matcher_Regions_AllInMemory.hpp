@@ -16,6 +16,9 @@ namespace matching_image_collection {
 /// Compute putative matches between a collection of pictures
 /// Spurious correspondences are discarded by using the
 ///  a threshold over the distance ratio of the 2 nearest neighbours.
+/// The pairs are matched in parallel (most expensive first, according the
+///  regions counts) and the matching database of a view is built once and
+///  kept in a bounded cache while its pairs are matched.
 ///
 class Matcher_Regions_AllInMemory : public Matcher
 {
@@ -23,16 +26,19 @@ class Matcher_Regions_AllInMemory : public Matcher
   Matcher_Regions_AllInMemory
   (
     float dist_ratio,
-    matching::EMatcherType eMatcherType
+    matching::EMatcherType eMatcherType,
+    size_t database_cache_size = 0 // max number of matching databases in memory (0: twice the thread count)
   );
 
+  using Matcher::Match;
+
   /// Find corresponding points between some pair of view Ids
   void Match
   (
     const sfm::SfM_Data & sfm_data,
     const std::shared_ptr<sfm::Regions_Provider> & regions_provider,
     const Pair_Set & pairs,
-    matching::PairWiseMatches & map_PutativesMatches // the pairwise photometric corresponding points
+    PairWiseMatches_Consumer & consumer // the receiver of the pairwise photometric corresponding points
   )const;
 
   private:
@@ -40,6 +46,8 @@ class Matcher_Regions_AllInMemory : public Matcher
   float _f_dist_ratio;
   // Matcher Type
   matching::EMatcherType _eMatcherType;
+  // Maximal number of matching databases kept in memory
+  size_t _database_cache_size;
 };
 
 } // namespace openMVG
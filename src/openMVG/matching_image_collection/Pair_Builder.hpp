@@ -9,10 +9,14 @@
 #include "openMVG/types.hpp"
 #include "openMVG/stl/split.hpp"
 
+#include <algorithm>
+#include <cstdint>
+#include <map>
 #include <set>
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <vector>
 
 namespace openMVG {
 
@@ -38,6 +42,92 @@ static Pair_Set contiguousWithOverlap(const size_t N, const size_t overlapSize)
   return pairs;
 }
 
+/// Keep the pairs that link at least one new view (incremental matching)
+/// A view is new if it does not appear in the already matched pairs:
+///  only the (new x already matched) and (new x new) pairs are returned.
+static Pair_Set incrementalPairs(const Pair_Set & pairs, const Pair_Set & matched_pairs)
+{
+  std::set<IndexT> matched_views;
+  for (Pair_Set::const_iterator iterP = matched_pairs.begin();
+    iterP != matched_pairs.end(); ++iterP)
+  {
+    matched_views.insert(iterP->first);
+    matched_views.insert(iterP->second);
+  }
+  Pair_Set new_pairs;
+  for (Pair_Set::const_iterator iterP = pairs.begin(); iterP != pairs.end(); ++iterP)
+  {
+    if (matched_pairs.count(*iterP) == 0 &&
+        (matched_views.count(iterP->first) == 0 || matched_views.count(iterP->second) == 0))
+      new_pairs.insert(*iterP);
+  }
+  return new_pairs;
+}
+
+/// Deterministic partition of the pairs into shard_count balanced shards
+/// The matching cost of a pair is estimated as the product of its view feature
+///  counts (a view missing in feature_counts counts for 1 feature).
+/// From the most to the least expensive, each pair is given to the shard that
+///  has the lowest total cost (ties are broken by the pair and shard indexes),
+///  so all the nodes compute the same partition from the same inputs.
+/// Return the pairs of the shard_index-th shard (0 <= shard_index < shard_count)
+static Pair_Set shardPairs
+(
+  const Pair_Set & pairs,
+  const std::map<IndexT, size_t> & feature_counts,
+  const size_t shard_index,
+  const size_t shard_count
+)
+{
+  Pair_Set shard_pairs;
+  if (shard_count == 0 || shard_index >= shard_count)
+    return shard_pairs;
+
+  std::vector<std::pair<uint64_t, Pair> > vec_cost_pairs;
+  vec_cost_pairs.reserve(pairs.size());
+  for (Pair_Set::const_iterator iterP = pairs.begin(); iterP != pairs.end(); ++iterP)
+  {
+    uint64_t cost = 1;
+    std::map<IndexT, size_t>::const_iterator iterCount = feature_counts.find(iterP->first);
+    if (iterCount != feature_counts.end())
+      cost *= std::max(iterCount->second, size_t(1));
+    iterCount = feature_counts.find(iterP->second);
+    if (iterCount != feature_counts.end())
+      cost *= std::max(iterCount->second, size_t(1));
+    vec_cost_pairs.push_back(std::make_pair(cost, *iterP));
+  }
+  // Decreasing cost, then increasing pair
+  std::sort(vec_cost_pairs.begin(), vec_cost_pairs.end(),
+    [](const std::pair<uint64_t, Pair> & a, const std::pair<uint64_t, Pair> & b)
+    { return a.first > b.first || (a.first == b.first && a.second < b.second); });
+
+  std::vector<uint64_t> shard_costs(shard_count, 0);
+  for (size_t i = 0; i < vec_cost_pairs.size(); ++i)
+  {
+    const size_t shard = std::min_element(shard_costs.begin(), shard_costs.end()) - shard_costs.begin();
+    shard_costs[shard] += vec_cost_pairs[i].first;
+    if (shard == shard_index)
+      shard_pairs.insert(vec_cost_pairs[i].second);
+  }
+  return shard_pairs;
+}
+
+/// Name of a shard file: ("matches.f.txt", 2, 4) -> "matches.f.shard_2_of_4.txt"
+static std::string shardFilename
+(
+  const std::string & filename,
+  const size_t shard_index,
+  const size_t shard_count
+)
+{
+  const std::string::size_type dot = filename.find_last_of('.');
+  std::ostringstream os;
+  os << filename.substr(0, dot) << ".shard_" << shard_index << "_of_" << shard_count;
+  if (dot != std::string::npos)
+    os << filename.substr(dot);
+  return os.str();
+}
+
 /// Load a set of Pair_Set from a file
 /// I J K L (pair that link I)
 static bool loadPairs(
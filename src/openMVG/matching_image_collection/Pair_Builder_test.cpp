@@ -56,6 +56,60 @@ TEST(matching_image_collection, contiguousWithOverlap)
   EXPECT_TRUE( pairSet.find(std::make_pair(2,3)) != pairSet.end() );
 }
 
+TEST(matching_image_collection, incrementalPairs)
+{
+  // Views 0,1,2 already matched, views 3,4 are new
+  const Pair_Set matchedPairs = exhaustivePairs(3);
+  const Pair_Set pairSet = incrementalPairs(exhaustivePairs(5), matchedPairs);
+  EXPECT_TRUE( checkPairOrder(pairSet) );
+  EXPECT_EQ( 7, pairSet.size());
+  for (IndexT I = 0; I < 3; ++I)
+  {
+    EXPECT_TRUE( pairSet.find(std::make_pair(I,3)) != pairSet.end() );
+    EXPECT_TRUE( pairSet.find(std::make_pair(I,4)) != pairSet.end() );
+  }
+  EXPECT_TRUE( pairSet.find(std::make_pair(3,4)) != pairSet.end() );
+
+  // No new view: nothing to match
+  EXPECT_EQ( 0, incrementalPairs(matchedPairs, matchedPairs).size());
+  // No matched view: all the pairs are new
+  EXPECT_EQ( 10, incrementalPairs(exhaustivePairs(5), Pair_Set()).size());
+}
+
+TEST(matching_image_collection, shardPairs)
+{
+  const Pair_Set pairs = exhaustivePairs(40);
+  std::map<IndexT, size_t> feature_counts;
+  for (IndexT i = 0; i < 40; ++i)
+    feature_counts[i] = 1000 + (i * 7919) % 5000;
+
+  const size_t shard_count = 4;
+  Pair_Set all_pairs;
+  std::vector<double> shard_costs;
+  for (size_t shard = 0; shard < shard_count; ++shard)
+  {
+    const Pair_Set shard_pairs = shardPairs(pairs, feature_counts, shard, shard_count);
+    // Deterministic
+    EXPECT_TRUE( shard_pairs == shardPairs(pairs, feature_counts, shard, shard_count) );
+    double cost = 0.0;
+    for (Pair_Set::const_iterator iterP = shard_pairs.begin(); iterP != shard_pairs.end(); ++iterP)
+    {
+      // Each pair belongs to a single shard
+      EXPECT_TRUE( all_pairs.insert(*iterP).second );
+      cost += double(feature_counts[iterP->first]) * feature_counts[iterP->second];
+    }
+    shard_costs.push_back(cost);
+  }
+  EXPECT_TRUE( all_pairs == pairs );
+  // Balanced costs
+  const double min_cost = *std::min_element(shard_costs.begin(), shard_costs.end());
+  const double max_cost = *std::max_element(shard_costs.begin(), shard_costs.end());
+  EXPECT_TRUE( max_cost < 1.01 * min_cost );
+
+  EXPECT_EQ( 0, shardPairs(pairs, feature_counts, 4, 4).size());
+  EXPECT_EQ( "matches.f.shard_2_of_4.txt", shardFilename("matches.f.txt", 2, 4));
+}
+
 TEST(matching_image_collection, IO)
 {
   Pair_Set pairSetGT;
@@ -0,0 +1,605 @@
+
+// Copyright (c) 2015 Pierre MOULON.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include "openMVG/types.hpp"
+#include "openMVG/numeric/numeric.h"
+#include "openMVG/features/regions.hpp"
+#include "openMVG/sfm/pipelines/sfm_regions_provider.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace openMVG {
+namespace matching_image_collection {
+
+/// Row major float matrix (one descriptor per row)
+typedef Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> RetrievalDescriptors;
+
+/// Convert (a subset of) the descriptors of some regions to float values.
+/// - Scalar descriptors are converted component wise,
+/// - Binary descriptors are unpacked to one {0,1} value per bit
+///   (the L2 distance between unpacked vectors is the Hamming distance).
+/// If max_count is not 0, at most max_count descriptors are kept,
+///  they are evenly sampled along the region list.
+static bool DescriptorsToFloat
+(
+  const features::Regions & regions,
+  RetrievalDescriptors & descriptors,
+  size_t max_count = 0
+)
+{
+  const size_t count = regions.RegionCount();
+  const size_t kept = (max_count == 0) ? count : std::min(count, max_count);
+  const size_t length = regions.DescriptorLength();
+  const size_t dimension = regions.IsBinary() ? length * 8 : length;
+  descriptors.resize(kept, dimension);
+  if (kept == 0)
+    return true;
+
+  const double step = count / static_cast<double>(kept);
+  for (size_t i = 0; i < kept; ++i)
+  {
+    const size_t idx = static_cast<size_t>(i * step);
+    float * row = descriptors.row(i).data();
+    if (regions.IsBinary())
+    {
+      const unsigned char * desc =
+        reinterpret_cast<const unsigned char*>(regions.DescriptorRawData()) + idx * length;
+      for (size_t k = 0; k < length; ++k)
+        for (int b = 0; b < 8; ++b)
+          row[k * 8 + b] = (desc[k] >> b) & 1;
+    }
+    else if (regions.Type_id() == typeid(unsigned char).name())
+    {
+      const unsigned char * desc =
+        reinterpret_cast<const unsigned char*>(regions.DescriptorRawData()) + idx * length;
+      std::copy(desc, desc + length, row);
+    }
+    else if (regions.Type_id() == typeid(float).name())
+    {
+      const float * desc =
+        reinterpret_cast<const float*>(regions.DescriptorRawData()) + idx * length;
+      std::copy(desc, desc + length, row);
+    }
+    else if (regions.Type_id() == typeid(Float16).name())
+    {
+      const Float16 * desc =
+        reinterpret_cast<const Float16*>(regions.DescriptorRawData()) + idx * length;
+      std::copy(desc, desc + length, row);
+    }
+    else
+    {
+      std::cerr << "Unsupported descriptor type for image retrieval." << std::endl;
+      descriptors.resize(0, dimension);
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+* @brief Hierarchical k-means vocabulary (vocabulary tree).
+*
+* Each node of the tree is split in (at most) `branching` children by k-means,
+*  up to `depth` levels. The leaves are the visual words.
+* A descriptor is quantized by descending the tree, choosing at each level the
+*  closest child center, so quantization costs branching * depth distances.
+*
+* Ref: Scalable Recognition with a Vocabulary Tree.
+*  D. Nister and H. Stewenius. CVPR 2006.
+*/
+class VocabularyTree
+{
+public:
+
+  VocabularyTree(): _branching(0), _depth(0), _dimension(0), _word_count(0) {}
+
+  size_t Dimension() const { return _dimension; }
+  size_t WordCount() const { return _word_count; }
+  bool empty() const { return _word_count == 0; }
+
+  /// Build the tree from training descriptors (one per row)
+  void Train
+  (
+    const RetrievalDescriptors & descriptors,
+    int branching = 10,
+    int depth = 4,
+    int kmeans_iterations = 10,
+    unsigned int seed = 0
+  )
+  {
+    _branching = std::max(2, branching);
+    _depth = std::max(1, depth);
+    _dimension = descriptors.cols();
+    _word_count = 0;
+    _centers.clear();
+    _first_child.clear();
+    _child_count.clear();
+    _word.clear();
+
+    // Root node (its center is never used)
+    AddNode(std::vector<float>(_dimension, 0.f));
+    std::vector<int> indexes(descriptors.rows());
+    for (size_t i = 0; i < indexes.size(); ++i)
+      indexes[i] = static_cast<int>(i);
+
+    std::mt19937 rng(seed);
+    Split(0, descriptors, indexes, 0, kmeans_iterations, rng);
+  }
+
+  /// Return the visual word of a descriptor of Dimension() values
+  int Quantize(const float * descriptor) const
+  {
+    int node = 0;
+    while (_child_count[node] > 0)
+    {
+      int best = _first_child[node];
+      float best_distance = std::numeric_limits<float>::max();
+      for (int c = _first_child[node]; c < _first_child[node] + _child_count[node]; ++c)
+      {
+        const float d = SquaredDistance(descriptor, &_centers[c * _dimension], _dimension);
+        if (d < best_distance)
+        {
+          best_distance = d;
+          best = c;
+        }
+      }
+      node = best;
+    }
+    return _word[node];
+  }
+
+  /// Quantize all the descriptors (one per row)
+  std::vector<int> Quantize(const RetrievalDescriptors & descriptors) const
+  {
+    std::vector<int> words(descriptors.rows());
+    for (int i = 0; i < descriptors.rows(); ++i)
+      words[i] = Quantize(descriptors.row(i).data());
+    return words;
+  }
+
+  /// Save the tree to a binary file
+  bool Save(const std::string & filename) const
+  {
+    std::ofstream stream(filename.c_str(), std::ios::out | std::ios::binary);
+    if (!stream.is_open())
+      return false;
+    const int header[5] = {
+      _branching, _depth, static_cast<int>(_dimension),
+      static_cast<int>(_word_count), static_cast<int>(_word.size())};
+    stream.write(reinterpret_cast<const char*>(header), sizeof(header));
+    stream.write(reinterpret_cast<const char*>(&_centers[0]), _centers.size() * sizeof(float));
+    stream.write(reinterpret_cast<const char*>(&_first_child[0]), _first_child.size() * sizeof(int));
+    stream.write(reinterpret_cast<const char*>(&_child_count[0]), _child_count.size() * sizeof(int));
+    stream.write(reinterpret_cast<const char*>(&_word[0]), _word.size() * sizeof(int));
+    return stream.good();
+  }
+
+  /// Load a tree saved by Save()
+  bool Load(const std::string & filename)
+  {
+    std::ifstream stream(filename.c_str(), std::ios::in | std::ios::binary);
+    if (!stream.is_open())
+      return false;
+    int header[5];
+    stream.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (!stream || header[2] <= 0 || header[4] <= 0)
+      return false;
+    _branching = header[0];
+    _depth = header[1];
+    _dimension = header[2];
+    _word_count = header[3];
+    const size_t node_count = header[4];
+    _centers.resize(node_count * _dimension);
+    _first_child.resize(node_count);
+    _child_count.resize(node_count);
+    _word.resize(node_count);
+    stream.read(reinterpret_cast<char*>(&_centers[0]), _centers.size() * sizeof(float));
+    stream.read(reinterpret_cast<char*>(&_first_child[0]), _first_child.size() * sizeof(int));
+    stream.read(reinterpret_cast<char*>(&_child_count[0]), _child_count.size() * sizeof(int));
+    stream.read(reinterpret_cast<char*>(&_word[0]), _word.size() * sizeof(int));
+    return static_cast<bool>(stream);
+  }
+
+private:
+
+  static inline float SquaredDistance(const float * a, const float * b, size_t size)
+  {
+    float sum = 0.f;
+    for (size_t i = 0; i < size; ++i)
+    {
+      const float d = a[i] - b[i];
+      sum += d * d;
+    }
+    return sum;
+  }
+
+  int AddNode(const std::vector<float> & center)
+  {
+    _centers.insert(_centers.end(), center.begin(), center.end());
+    _first_child.push_back(-1);
+    _child_count.push_back(0);
+    _word.push_back(-1);
+    return static_cast<int>(_word.size()) - 1;
+  }
+
+  // Recursively cluster the descriptors of a node
+  void Split
+  (
+    int node,
+    const RetrievalDescriptors & descriptors,
+    const std::vector<int> & indexes,
+    int level,
+    int kmeans_iterations,
+    std::mt19937 & rng
+  )
+  {
+    if (level == _depth || indexes.size() <= static_cast<size_t>(_branching))
+    {
+      _word[node] = static_cast<int>(_word_count++);
+      return;
+    }
+
+    std::vector<std::vector<float> > centers;
+    std::vector<int> assignment;
+    KMeans(descriptors, indexes, kmeans_iterations, rng, centers, assignment);
+
+    // Create the children first: they must be contiguous in the node list
+    const int first_child = static_cast<int>(_word.size());
+    for (size_t c = 0; c < centers.size(); ++c)
+      AddNode(centers[c]);
+    _first_child[node] = first_child;
+    _child_count[node] = static_cast<int>(centers.size());
+
+    std::vector<std::vector<int> > clusters(centers.size());
+    for (size_t i = 0; i < indexes.size(); ++i)
+      clusters[assignment[i]].push_back(indexes[i]);
+    for (size_t c = 0; c < centers.size(); ++c)
+      Split(first_child + c, descriptors, clusters[c], level + 1, kmeans_iterations, rng);
+  }
+
+  // Lloyd k-means of the descriptor subset (k-means++ seeding)
+  void KMeans
+  (
+    const RetrievalDescriptors & descriptors,
+    const std::vector<int> & indexes,
+    int iterations,
+    std::mt19937 & rng,
+    std::vector<std::vector<float> > & centers,
+    std::vector<int> & assignment
+  ) const
+  {
+    const int n = static_cast<int>(indexes.size());
+    const int k = std::min(_branching, n);
+    const size_t dim = _dimension;
+
+    // k-means++ seeding
+    const float * first =
+      descriptors.row(indexes[std::uniform_int_distribution<int>(0, n - 1)(rng)]).data();
+    centers.assign(1, std::vector<float>(first, first + dim));
+    std::vector<float> min_distance(n, std::numeric_limits<float>::max());
+    while (static_cast<int>(centers.size()) < k)
+    {
+      const float * last = &centers.back()[0];
+      double sum = 0.0;
+      for (int i = 0; i < n; ++i)
+      {
+        min_distance[i] = std::min(min_distance[i],
+          SquaredDistance(descriptors.row(indexes[i]).data(), last, dim));
+        sum += min_distance[i];
+      }
+      int chosen = std::uniform_int_distribution<int>(0, n - 1)(rng);
+      if (sum > 0.0)
+      {
+        double r = std::uniform_real_distribution<double>(0.0, sum)(rng);
+        for (int i = 0; i < n; ++i)
+        {
+          r -= min_distance[i];
+          if (r <= 0.0)
+          {
+            chosen = i;
+            break;
+          }
+        }
+      }
+      const float * seed = descriptors.row(indexes[chosen]).data();
+      centers.push_back(std::vector<float>(seed, seed + dim));
+    }
+
+    // Lloyd iterations
+    assignment.assign(n, 0);
+    for (int iter = 0; iter < iterations; ++iter)
+    {
+      bool changed = false;
+#ifdef OPENMVG_USE_OPENMP
+      #pragma omp parallel for schedule(static) reduction(||:changed) if (n > 10000)
+#endif
+      for (int i = 0; i < n; ++i)
+      {
+        const float * desc = descriptors.row(indexes[i]).data();
+        int best = 0;
+        float best_distance = std::numeric_limits<float>::max();
+        for (int c = 0; c < k; ++c)
+        {
+          const float d = SquaredDistance(desc, &centers[c][0], dim);
+          if (d < best_distance)
+          {
+            best_distance = d;
+            best = c;
+          }
+        }
+        if (assignment[i] != best)
+        {
+          assignment[i] = best;
+          changed = true;
+        }
+      }
+      if (!changed && iter > 0)
+        break;
+
+      // Update the centers (an empty cluster keeps its previous center)
+      std::vector<std::vector<double> > sums(k, std::vector<double>(dim, 0.0));
+      std::vector<int> counts(k, 0);
+      for (int i = 0; i < n; ++i)
+      {
+        const float * desc = descriptors.row(indexes[i]).data();
+        std::vector<double> & sum = sums[assignment[i]];
+        for (size_t d = 0; d < dim; ++d)
+          sum[d] += desc[d];
+        ++counts[assignment[i]];
+      }
+      for (int c = 0; c < k; ++c)
+      {
+        if (counts[c] == 0)
+          continue;
+        for (size_t d = 0; d < dim; ++d)
+          centers[c][d] = static_cast<float>(sums[c][d] / counts[c]);
+      }
+    }
+
+    // Remove the empty clusters
+    std::vector<int> remap(k, -1);
+    std::vector<int> counts(k, 0);
+    for (int i = 0; i < n; ++i)
+      ++counts[assignment[i]];
+    std::vector<std::vector<float> > kept_centers;
+    for (int c = 0; c < k; ++c)
+    {
+      if (counts[c] > 0)
+      {
+        remap[c] = static_cast<int>(kept_centers.size());
+        kept_centers.push_back(centers[c]);
+      }
+    }
+    for (int i = 0; i < n; ++i)
+      assignment[i] = remap[assignment[i]];
+    centers.swap(kept_centers);
+  }
+
+  int _branching, _depth;
+  size_t _dimension, _word_count;
+  // Per node data (children of a node are stored contiguously)
+  std::vector<float> _centers;
+  std::vector<int> _first_child, _child_count;
+  // Word id of the leaves (-1 for the inner nodes)
+  std::vector<int> _word;
+};
+
+/**
+* @brief Inverted file of visual words with TF-IDF weighting.
+*
+* Each image is described by a L2 normalized vector of tf-idf word weights,
+*  the similarity of two images is the dot product of their vectors.
+* Queries only visit the posting lists of the words seen in the query image.
+*/
+class InvertedFile
+{
+public:
+
+  explicit InvertedFile(size_t word_count = 0): _postings(word_count) {}
+
+  /// Add the visual words of an image to the database
+  void Add(IndexT image, const std::vector<int> & words)
+  {
+    std::map<int, float> & histogram = _histograms[image];
+    for (size_t i = 0; i < words.size(); ++i)
+      histogram[words[i]] += 1.f;
+  }
+
+  /// Compute the word weights and fill the posting lists
+  /// (must be called once all the images are added)
+  void Finalize()
+  {
+    // Inverse document frequency
+    std::vector<int> document_count(_postings.size(), 0);
+    for (const auto & image_it : _histograms)
+      for (const auto & word_it : image_it.second)
+        ++document_count[word_it.first];
+    _idf.assign(_postings.size(), 0.f);
+    for (size_t w = 0; w < _postings.size(); ++w)
+    {
+      if (document_count[w] > 0)
+        _idf[w] = std::log(_histograms.size() / static_cast<float>(document_count[w]));
+    }
+
+    // Weighted & normalized vectors
+    for (auto & postings : _postings)
+      postings.clear();
+    for (auto & image_it : _histograms)
+    {
+      std::map<int, float> & histogram = image_it.second;
+      float word_total = 0.f;
+      for (const auto & word_it : histogram)
+        word_total += word_it.second;
+      float norm = 0.f;
+      for (auto & word_it : histogram)
+      {
+        word_it.second = (word_it.second / word_total) * _idf[word_it.first];
+        norm += word_it.second * word_it.second;
+      }
+      norm = std::sqrt(norm);
+      for (auto & word_it : histogram)
+      {
+        if (norm > 0.f)
+          word_it.second /= norm;
+        if (word_it.second > 0.f)
+          _postings[word_it.first].push_back(std::make_pair(image_it.first, word_it.second));
+      }
+    }
+  }
+
+  /// Return the (at most) K images of the database that are the most similar
+  ///  to the given database image, sorted by decreasing score.
+  std::vector<std::pair<float, IndexT> > Query(IndexT image, size_t K) const
+  {
+    std::vector<std::pair<float, IndexT> > result;
+    const auto image_it = _histograms.find(image);
+    if (image_it == _histograms.end())
+      return result;
+
+    std::map<IndexT, float> scores;
+    for (const auto & word_it : image_it->second)
+    {
+      for (const auto & posting : _postings[word_it.first])
+      {
+        if (posting.first != image)
+          scores[posting.first] += word_it.second * posting.second;
+      }
+    }
+    result.reserve(scores.size());
+    for (const auto & score : scores)
+      result.push_back(std::make_pair(score.second, score.first));
+
+    const size_t kept = std::min(K, result.size());
+    std::partial_sort(result.begin(), result.begin() + kept, result.end(),
+      [](const std::pair<float, IndexT> & a, const std::pair<float, IndexT> & b)
+      { return a.first > b.first || (a.first == b.first && a.second < b.second); });
+    result.resize(kept);
+    return result;
+  }
+
+private:
+  // Per image tf-idf weights (sparse vector)
+  std::map<IndexT, std::map<int, float> > _histograms;
+  // Per word list of (image, weight)
+  std::vector<std::vector<std::pair<IndexT, float> > > _postings;
+  std::vector<float> _idf;
+};
+
+/// Train a vocabulary tree on descriptors sampled from all the loaded views
+static bool TrainVocabularyTree
+(
+  const sfm::Regions_Provider & regions_provider,
+  VocabularyTree & tree,
+  int branching = 10,
+  int depth = 4,
+  size_t max_descriptors_per_view = 500
+)
+{
+  std::vector<RetrievalDescriptors> samples;
+  samples.reserve(regions_provider.regions_per_view.size());
+  size_t total = 0, dimension = 0;
+  for (const auto & regions_it : regions_provider.regions_per_view)
+  {
+    RetrievalDescriptors descriptors;
+    if (!DescriptorsToFloat(*regions_it.second, descriptors, max_descriptors_per_view))
+      return false;
+    if (descriptors.rows() == 0)
+      continue;
+    dimension = descriptors.cols();
+    total += descriptors.rows();
+    samples.push_back(std::move(descriptors));
+  }
+  if (total == 0)
+    return false;
+
+  RetrievalDescriptors training(total, dimension);
+  size_t row = 0;
+  for (const auto & descriptors : samples)
+  {
+    training.middleRows(row, descriptors.rows()) = descriptors;
+    row += descriptors.rows();
+  }
+  tree.Train(training, branching, depth);
+  return !tree.empty();
+}
+
+/// Compute the pairs between each view and the K views that share the most
+///  similar visual words (according the given vocabulary tree).
+/// Pairs are expressed with view ids and stored as (min, max).
+static Pair_Set retrievalPairs
+(
+  const sfm::Regions_Provider & regions_provider,
+  const VocabularyTree & tree,
+  size_t K
+)
+{
+  Pair_Set pairs;
+  std::vector<IndexT> view_ids;
+  for (const auto & regions_it : regions_provider.regions_per_view)
+    view_ids.push_back(regions_it.first);
+
+  // Quantize the descriptors of each view
+  std::vector<std::vector<int> > words(view_ids.size());
+  bool bOk = true;
+#ifdef OPENMVG_USE_OPENMP
+  #pragma omp parallel for schedule(dynamic)
+#endif
+  for (int i = 0; i < static_cast<int>(view_ids.size()); ++i)
+  {
+    RetrievalDescriptors descriptors;
+    if (!DescriptorsToFloat(*regions_provider.regions_per_view.at(view_ids[i]), descriptors)
+        || (descriptors.rows() > 0 && descriptors.cols() != static_cast<int>(tree.Dimension())))
+    {
+#ifdef OPENMVG_USE_OPENMP
+      #pragma omp critical
+#endif
+      bOk = false;
+      continue;
+    }
+    words[i] = tree.Quantize(descriptors);
+  }
+  if (!bOk)
+  {
+    std::cerr << "The vocabulary does not fit the regions descriptor." << std::endl;
+    return pairs;
+  }
+
+  InvertedFile inverted_file(tree.WordCount());
+  for (size_t i = 0; i < view_ids.size(); ++i)
+    inverted_file.Add(view_ids[i], words[i]);
+  inverted_file.Finalize();
+
+  std::vector<Pair_Vec> view_pairs(view_ids.size());
+#ifdef OPENMVG_USE_OPENMP
+  #pragma omp parallel for schedule(dynamic)
+#endif
+  for (int i = 0; i < static_cast<int>(view_ids.size()); ++i)
+  {
+    const std::vector<std::pair<float, IndexT> > neighbors =
+      inverted_file.Query(view_ids[i], K);
+    for (size_t k = 0; k < neighbors.size(); ++k)
+    {
+      const IndexT I = view_ids[i], J = neighbors[k].second;
+      view_pairs[i].push_back(std::make_pair(std::min(I, J), std::max(I, J)));
+    }
+  }
+  for (size_t i = 0; i < view_pairs.size(); ++i)
+    pairs.insert(view_pairs[i].begin(), view_pairs[i].end());
+  return pairs;
+}
+
+} // namespace matching_image_collection
+} // namespace openMVG
@@ -0,0 +1,107 @@
+// Copyright (c) 2015 Pierre MOULON.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "openMVG/matching_image_collection/Retrieval_Pair_Builder.hpp"
+#include "testing/testing.h"
+
+#include <cstdio>
+#include <random>
+
+using namespace openMVG;
+using namespace openMVG::matching_image_collection;
+
+// Simulate images of some distinct scenes:
+// - each scene has its own set of 3D points (one descriptor per point),
+// - each image sees a random subset of the points of its scene (with noise).
+static void BuildSyntheticScenes
+(
+  int nb_scenes,
+  int nb_images_per_scene,
+  std::vector<RetrievalDescriptors> & image_descriptors
+)
+{
+  const int dim = 32, nb_points = 300, nb_observations = 150;
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<float> uniform(0.f, 255.f);
+  std::normal_distribution<float> noise(0.f, 4.f);
+  for (int s = 0; s < nb_scenes; ++s)
+  {
+    RetrievalDescriptors points(nb_points, dim);
+    for (int i = 0; i < points.size(); ++i)
+      points.data()[i] = uniform(rng);
+    for (int v = 0; v < nb_images_per_scene; ++v)
+    {
+      std::vector<int> ids(nb_points);
+      for (int i = 0; i < nb_points; ++i) ids[i] = i;
+      std::shuffle(ids.begin(), ids.end(), rng);
+      RetrievalDescriptors descriptors(nb_observations, dim);
+      for (int i = 0; i < nb_observations; ++i)
+        for (int d = 0; d < dim; ++d)
+          descriptors(i, d) = points(ids[i], d) + noise(rng);
+      image_descriptors.push_back(descriptors);
+    }
+  }
+}
+
+TEST(VocabularyTree, retrieval)
+{
+  const int nb_scenes = 4, nb_images_per_scene = 4;
+  std::vector<RetrievalDescriptors> image_descriptors;
+  BuildSyntheticScenes(nb_scenes, nb_images_per_scene, image_descriptors);
+
+  RetrievalDescriptors training(image_descriptors.size() * 150, 32);
+  for (size_t i = 0; i < image_descriptors.size(); ++i)
+    training.middleRows(i * 150, 150) = image_descriptors[i];
+
+  VocabularyTree tree;
+  tree.Train(training, 8, 3);
+  EXPECT_FALSE(tree.empty());
+  EXPECT_EQ(32, tree.Dimension());
+
+  InvertedFile inverted_file(tree.WordCount());
+  for (size_t i = 0; i < image_descriptors.size(); ++i)
+    inverted_file.Add(i, tree.Quantize(image_descriptors[i]));
+  inverted_file.Finalize();
+
+  // The most similar images must come from the same scene
+  for (size_t i = 0; i < image_descriptors.size(); ++i)
+  {
+    const std::vector<std::pair<float, IndexT> > neighbors =
+      inverted_file.Query(i, nb_images_per_scene - 1);
+    EXPECT_EQ(nb_images_per_scene - 1, neighbors.size());
+    for (size_t k = 0; k < neighbors.size(); ++k)
+    {
+      EXPECT_EQ(i / nb_images_per_scene, neighbors[k].second / nb_images_per_scene);
+      EXPECT_TRUE(neighbors[k].second != i);
+    }
+  }
+}
+
+TEST(VocabularyTree, IO)
+{
+  std::vector<RetrievalDescriptors> image_descriptors;
+  BuildSyntheticScenes(2, 2, image_descriptors);
+
+  VocabularyTree tree;
+  tree.Train(image_descriptors[0], 4, 3);
+  const std::string filename = "vocabulary_tree_test.bin";
+  EXPECT_TRUE(tree.Save(filename));
+
+  VocabularyTree loaded_tree;
+  EXPECT_TRUE(loaded_tree.Load(filename));
+  EXPECT_EQ(tree.WordCount(), loaded_tree.WordCount());
+  EXPECT_EQ(tree.Dimension(), loaded_tree.Dimension());
+  for (size_t i = 0; i < image_descriptors.size(); ++i)
+  {
+    EXPECT_TRUE(tree.Quantize(image_descriptors[i]) ==
+      loaded_tree.Quantize(image_descriptors[i]));
+  }
+  std::remove(filename.c_str());
+}
+
+/* ************************************************************************* */
+int main() { TestResult tr; return TestRegistry::runAllTests(tr);}
+/* ************************************************************************* */
@@ -0,0 +1,140 @@
+// Copyright (c) 2015 Pierre MOULON.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include "openMVG/types.hpp"
+#include "openMVG/numeric/numeric.h"
+#include "flann/flann.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <vector>
+
+namespace openMVG {
+namespace matching_image_collection {
+
+/// Position prior of a view (from GPS EXIF tags for example)
+struct ViewPositionPrior
+{
+  ViewPositionPrior(): heading(-1.0) {}
+
+  /// Position in an euclidean metric frame (meters)
+  Vec3 position;
+  /// Camera heading in degrees [0, 360[, -1 if unknown
+  double heading;
+};
+
+typedef std::map<IndexT, ViewPositionPrior> ViewPositionPriors;
+
+/// Convert WGS84 geodetic coordinates (latitude & longitude in degrees,
+///  altitude in meters) to Earth-Centered Earth-Fixed coordinates (meters).
+static Vec3 lla_to_ecef(double latitude, double longitude, double altitude)
+{
+  const double a = 6378137.0;           // WGS84 semi-major axis
+  const double e2 = 6.69437999014e-3;   // WGS84 first eccentricity squared
+  const double lat = latitude * M_PI / 180.0;
+  const double lon = longitude * M_PI / 180.0;
+  const double sin_lat = std::sin(lat), cos_lat = std::cos(lat);
+  const double N = a / std::sqrt(1.0 - e2 * sin_lat * sin_lat);
+  return Vec3(
+    (N + altitude) * cos_lat * std::cos(lon),
+    (N + altitude) * cos_lat * std::sin(lon),
+    (N * (1.0 - e2) + altitude) * sin_lat);
+}
+
+/// Absolute angular difference of two headings (degrees)
+static double headingDifference(double heading_a, double heading_b)
+{
+  const double diff = std::fmod(std::abs(heading_a - heading_b), 360.0);
+  return std::min(diff, 360.0 - diff);
+}
+
+/**
+* @brief Compute the pairs of views that are spatially close.
+*
+* A KD-tree is built over the view positions, each view is paired with:
+* - its K nearest neighbors (K > 0), limited to the radius if radius > 0,
+* - or all the views within the radius (K <= 0 and radius > 0).
+* If max_heading_diff < 180, the pairs of views with known headings that
+*  look in too different directions are discarded.
+* The pairs are expressed with view ids and stored as (min, max).
+*/
+static Pair_Set spatialPairs
+(
+  const ViewPositionPriors & priors,
+  int K,
+  double radius = -1.0,
+  double max_heading_diff = 180.0
+)
+{
+  Pair_Set pairs;
+  if (priors.size() < 2 || (K <= 0 && radius <= 0.0))
+    return pairs;
+
+  // Position relative to the centroid (keep small coordinates for the KD-tree)
+  std::vector<IndexT> view_ids;
+  view_ids.reserve(priors.size());
+  Vec3 centroid = Vec3::Zero();
+  for (const auto & prior_it : priors)
+  {
+    view_ids.push_back(prior_it.first);
+    centroid += prior_it.second.position;
+  }
+  centroid /= static_cast<double>(priors.size());
+
+  std::vector<double> positions;
+  positions.reserve(priors.size() * 3);
+  for (const auto & prior_it : priors)
+  {
+    const Vec3 pos = prior_it.second.position - centroid;
+    positions.insert(positions.end(), pos.data(), pos.data() + 3);
+  }
+
+  typedef flann::L2<double> Metric;
+  const flann::Matrix<double> dataset(&positions[0], priors.size(), 3);
+  flann::Index<Metric> index(dataset, flann::KDTreeSingleIndexParams());
+  index.buildIndex();
+
+  // The query set includes the query view itself
+  std::vector<std::vector<int> > indices;
+  std::vector<std::vector<double> > distances;
+  const flann::SearchParams search_params(flann::FLANN_CHECKS_UNLIMITED);
+  if (K > 0)
+  {
+    const size_t knn = std::min(static_cast<size_t>(K) + 1, priors.size());
+    index.knnSearch(dataset, indices, distances, knn, search_params);
+  }
+  else
+  {
+    // Flann L2 metric uses squared distances
+    index.radiusSearch(dataset, indices, distances,
+      static_cast<float>(radius * radius), search_params);
+  }
+
+  const double squared_radius = radius * radius;
+  for (size_t i = 0; i < indices.size(); ++i)
+  {
+    const IndexT I = view_ids[i];
+    const ViewPositionPrior & prior_I = priors.at(I);
+    for (size_t k = 0; k < indices[i].size(); ++k)
+    {
+      const IndexT J = view_ids[indices[i][k]];
+      if (I == J || (radius > 0.0 && distances[i][k] > squared_radius))
+        continue;
+      const ViewPositionPrior & prior_J = priors.at(J);
+      if (max_heading_diff < 180.0 && prior_I.heading >= 0.0 && prior_J.heading >= 0.0
+          && headingDifference(prior_I.heading, prior_J.heading) > max_heading_diff)
+        continue;
+      pairs.insert(std::make_pair(std::min(I, J), std::max(I, J)));
+    }
+  }
+  return pairs;
+}
+
+} // namespace matching_image_collection
+} // namespace openMVG
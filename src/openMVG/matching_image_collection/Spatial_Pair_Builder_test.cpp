@@ -0,0 +1,67 @@
+// Copyright (c) 2015 Pierre MOULON.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "openMVG/matching_image_collection/Spatial_Pair_Builder.hpp"
+#include "testing/testing.h"
+
+using namespace openMVG;
+using namespace openMVG::matching_image_collection;
+
+// Views regularly spaced along a line (10 meters apart)
+static ViewPositionPriors lineOfViews(size_t N)
+{
+  ViewPositionPriors priors;
+  for (size_t i = 0; i < N; ++i)
+    priors[i].position = Vec3(10.0 * i, 0.0, 0.0);
+  return priors;
+}
+
+TEST(Spatial_Pair_Builder, lla_to_ecef)
+{
+  // Equator & Greenwich meridian
+  EXPECT_NEAR(6378137.0, lla_to_ecef(0.0, 0.0, 0.0)(0), 1e-6);
+  // North pole
+  EXPECT_NEAR(6356752.314, lla_to_ecef(90.0, 0.0, 0.0)(2), 1e-3);
+  // 1 arc second of latitude is about 30 meters
+  const double d = (lla_to_ecef(45.0, 5.0, 200.0) - lla_to_ecef(45.0 + 1.0 / 3600.0, 5.0, 200.0)).norm();
+  EXPECT_NEAR(30.87, d, 0.1);
+}
+
+TEST(Spatial_Pair_Builder, knn)
+{
+  const Pair_Set pairs = spatialPairs(lineOfViews(5), 2);
+  // Each view is paired with its 2 nearest neighbors
+  EXPECT_TRUE(pairs.count(std::make_pair(0,1)) == 1);
+  EXPECT_TRUE(pairs.count(std::make_pair(0,2)) == 1);
+  EXPECT_TRUE(pairs.count(std::make_pair(1,2)) == 1);
+  EXPECT_TRUE(pairs.count(std::make_pair(2,3)) == 1);
+  EXPECT_TRUE(pairs.count(std::make_pair(2,4)) == 1);
+  EXPECT_TRUE(pairs.count(std::make_pair(3,4)) == 1);
+  EXPECT_EQ(6, pairs.size());
+}
+
+TEST(Spatial_Pair_Builder, radius)
+{
+  const Pair_Set pairs = spatialPairs(lineOfViews(5), -1, 15.0);
+  EXPECT_EQ(4, pairs.size());
+  for (IndexT i = 0; i < 4; ++i)
+    EXPECT_TRUE(pairs.count(std::make_pair(i, i + 1)) == 1);
+}
+
+TEST(Spatial_Pair_Builder, heading)
+{
+  ViewPositionPriors priors = lineOfViews(3);
+  priors[0].heading = 350.0;
+  priors[1].heading = 10.0;
+  priors[2].heading = 180.0;
+  const Pair_Set pairs = spatialPairs(priors, 2, -1.0, 45.0);
+  EXPECT_EQ(1, pairs.size());
+  EXPECT_TRUE(pairs.count(std::make_pair(0,1)) == 1);
+}
+
+/* ************************************************************************* */
+int main() { TestResult tr; return TestRegistry::runAllTests(tr);}
+/* ************************************************************************* */
@@ -0,0 +1,151 @@
+
+// Copyright (c) 2015 Pierre MOULON.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include "openMVG/matching_image_collection/Matcher.hpp"
+#include "openMVG/matching_image_collection/GeometricFilter.hpp"
+#include "openMVG/matching/indMatch_utils.hpp"
+#include "openMVG/stl/bounded_queue.hpp"
+
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace openMVG {
+namespace matching_image_collection {
+
+/// Write the received pairwise matches to a stream (in the PairedIndMatchImport format)
+class PairWiseMatches_StreamWriter : public PairWiseMatches_Consumer
+{
+  public:
+  PairWiseMatches_StreamWriter(std::ostream & os)
+    : _os(os), _pair_count(0) {}
+
+  void Consume(const Pair & pair, matching::IndMatches && matches)
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    matching::PairIndMatchToStream(pair, matches, _os);
+    ++_pair_count;
+  }
+
+  size_t pair_count() const
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _pair_count;
+  }
+
+  private:
+  std::ostream & _os;
+  mutable std::mutex _mutex;
+  size_t _pair_count;
+};
+
+/// Geometric filtering of the putative matches as soon as they are computed.
+/// The putative matches received from a Matcher are pushed in a bounded queue,
+///  filtering threads pop them, perform the robust model estimation and send
+///  the geometric matches to the output consumer.
+/// The putative matches are never stored as a whole: the matching threads wait
+///  while the queue is full, so at most queue_depth pairs (+ the pairs being
+///  filtered) of putative matches are in memory.
+template<typename GeometryFunctor>
+class Streaming_Geometric_Filter : public PairWiseMatches_Consumer
+{
+  public:
+  Streaming_Geometric_Filter
+  (
+    const ImageCollectionGeometricFilter & filter,
+    const GeometryFunctor & functor,
+    PairWiseMatches_Consumer & geometric_consumer, // receive the geometric matches
+    const size_t queue_depth,
+    const size_t thread_count,
+    const bool b_guided_matching = false,
+    const double d_distance_ratio = 0.6,
+    PairWiseMatches_Consumer * putative_consumer = NULL // optional: receive the putative matches
+  ):_filter(filter), _functor(functor), _geometric_consumer(geometric_consumer),
+    _putative_consumer(putative_consumer), _b_guided_matching(b_guided_matching),
+    _d_distance_ratio(d_distance_ratio), _min_inlier_count(0), _min_inlier_ratio(0.f),
+    _queue(queue_depth)
+  {
+    const size_t count = (thread_count > 0) ? thread_count : 1;
+    for (size_t i = 0; i < count; ++i)
+      _threads.emplace_back(&Streaming_Geometric_Filter::Filter_queued_pairs, this);
+  }
+
+  ~Streaming_Geometric_Filter()
+  {
+    Finish();
+  }
+
+  /// Discard the pairs with too few geometric inliers
+  /// (absolute count or ratio to the putative matches count)
+  void Set_minimal_inliers(const size_t count, const float ratio)
+  {
+    _min_inlier_count = count;
+    _min_inlier_ratio = ratio;
+  }
+
+  /// Queue the putative matches of a pair (wait if the queue is full).
+  /// If the queue is already closed (Finish was called) the pair is filtered
+  ///  by the calling thread, so that no pair is lost.
+  void Consume(const Pair & pair, matching::IndMatches && putative_matches)
+  {
+    std::pair<Pair, IndMatches> item(pair, std::move(putative_matches));
+    if (!_queue.push(std::move(item)))
+      Filter_pair(item);
+  }
+
+  /// Wait until all the queued pairs are filtered
+  void Finish()
+  {
+    _queue.close();
+    for (size_t i = 0; i < _threads.size(); ++i)
+      _threads[i].join();
+    _threads.clear();
+  }
+
+  private:
+
+  void Filter_queued_pairs()
+  {
+    std::pair<Pair, IndMatches> item;
+    while (_queue.pop(item))
+      Filter_pair(item);
+  }
+
+  void Filter_pair(std::pair<Pair, IndMatches> & item)
+  {
+    const Pair & pair = item.first;
+    IndMatches & putative_matches = item.second;
+    IndMatches geometric_inliers;
+    if (_filter.Robust_model_estimation(_functor, pair, putative_matches, geometric_inliers,
+      _b_guided_matching, _d_distance_ratio)
+      && geometric_inliers.size() >= _min_inlier_count
+      && geometric_inliers.size() >= _min_inlier_ratio * putative_matches.size())
+    {
+      _geometric_consumer.Consume(pair, std::move(geometric_inliers));
+    }
+    if (_putative_consumer)
+      _putative_consumer->Consume(pair, std::move(putative_matches));
+  }
+
+  const ImageCollectionGeometricFilter & _filter;
+  const GeometryFunctor _functor;
+  PairWiseMatches_Consumer & _geometric_consumer;
+  PairWiseMatches_Consumer * _putative_consumer;
+  const bool _b_guided_matching;
+  const double _d_distance_ratio;
+  size_t _min_inlier_count;
+  float _min_inlier_ratio;
+  stl::bounded_queue<std::pair<Pair, IndMatches> > _queue;
+  std::vector<std::thread> _threads;
+};
+
+} // namespace openMVG
+} // namespace matching_image_collection
@@ -0,0 +1,156 @@
+
+// Copyright (c) 2015 Pierre MOULON.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "openMVG/matching_image_collection/Streaming_Geometric_Filter.hpp"
+#include "testing/testing.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+using namespace openMVG;
+using namespace openMVG::matching;
+using namespace openMVG::matching_image_collection;
+
+// Matcher that computes synthetic putative matches for each pair (in parallel)
+class Synthetic_Matcher : public Matcher
+{
+  public:
+  using Matcher::Match;
+
+  void Match
+  (
+    const sfm::SfM_Data & sfm_data,
+    const std::shared_ptr<sfm::Regions_Provider> & regions_provider,
+    const Pair_Set & pairs,
+    PairWiseMatches_Consumer & consumer
+  )const
+  {
+    const std::vector<Pair> vec_pairs(pairs.begin(), pairs.end());
+#ifdef OPENMVG_USE_OPENMP
+    #pragma omp parallel for schedule(dynamic)
+#endif
+    for (int i = 0; i < (int)vec_pairs.size(); ++i)
+    {
+      const Pair & pair = vec_pairs[i];
+      IndMatches matches;
+      for (IndexT k = 0; k < (pair.first + 3 * pair.second) % 40; ++k)
+        matches.emplace_back(k, k + pair.first);
+      if (!matches.empty())
+        consumer.Consume(pair, std::move(matches));
+    }
+  }
+};
+
+// Geometric filter that keeps the even feature indexes (fails with too few of them)
+struct Synthetic_GeometricFilter
+{
+  bool Robust_estimation(
+    const sfm::SfM_Data * sfm_data,
+    const std::shared_ptr<sfm::Regions_Provider> & regions_provider,
+    const Pair pairIndex,
+    const IndMatches & vec_PutativeMatches,
+    IndMatches & geometric_inliers)
+  {
+    geometric_inliers.clear();
+    for (size_t i = 0; i < vec_PutativeMatches.size(); ++i)
+      if (vec_PutativeMatches[i]._i % 2 == 0)
+        geometric_inliers.push_back(vec_PutativeMatches[i]);
+    return geometric_inliers.size() >= 4;
+  }
+
+  bool Geometry_guided_matching(
+    const sfm::SfM_Data * sfm_data,
+    const std::shared_ptr<sfm::Regions_Provider> & regions_provider,
+    const Pair pairIndex,
+    const double dDistanceRatio,
+    IndMatches & matches)
+  {
+    return false;
+  }
+};
+
+TEST(Streaming_Geometric_Filter, SameAsInMemoryFiltering)
+{
+  const sfm::SfM_Data sfm_data;
+  const std::shared_ptr<sfm::Regions_Provider> regions_provider;
+  const Pair_Set pairs = exhaustivePairs(30);
+  const Synthetic_Matcher matcher;
+
+  // Reference: all the putative matches in memory, then geometric filtering
+  PairWiseMatches map_PutativesMatches;
+  matcher.Match(sfm_data, regions_provider, pairs, map_PutativesMatches);
+  ImageCollectionGeometricFilter filter(&sfm_data, regions_provider);
+  filter.Robust_model_estimation(Synthetic_GeometricFilter(), map_PutativesMatches);
+  const PairWiseMatches & map_GeometricMatches = filter.Get_geometric_matches();
+  EXPECT_TRUE(map_GeometricMatches.size() > 0);
+  EXPECT_TRUE(map_GeometricMatches.size() < map_PutativesMatches.size());
+
+  // Streaming: the putative matches go through a small queue
+  std::ostringstream geometric_stream, putative_stream;
+  PairWiseMatches_StreamWriter geometric_writer(geometric_stream), putative_writer(putative_stream);
+  {
+    Streaming_Geometric_Filter<Synthetic_GeometricFilter> streaming_filter(
+      filter, Synthetic_GeometricFilter(), geometric_writer, 4, 3, false, 0.6, &putative_writer);
+    matcher.Match(sfm_data, regions_provider, pairs, streaming_filter);
+    streaming_filter.Finish();
+  }
+  EXPECT_EQ(map_GeometricMatches.size(), geometric_writer.pair_count());
+  EXPECT_EQ(map_PutativesMatches.size(), putative_writer.pair_count());
+
+  // Read back the streamed matches (the pair order is not deterministic)
+  const std::string sFilename = "Streaming_Geometric_Filter_test.txt";
+  PairWiseMatches map_StreamedGeometricMatches, map_StreamedPutativeMatches;
+  {
+    std::ofstream file(sFilename.c_str());
+    file << geometric_stream.str();
+  }
+  EXPECT_TRUE(PairedIndMatchImport(sFilename, map_StreamedGeometricMatches));
+  {
+    std::ofstream file(sFilename.c_str());
+    file << putative_stream.str();
+  }
+  EXPECT_TRUE(PairedIndMatchImport(sFilename, map_StreamedPutativeMatches));
+  std::remove(sFilename.c_str());
+
+  EXPECT_TRUE(map_GeometricMatches == map_StreamedGeometricMatches);
+  EXPECT_TRUE(map_PutativesMatches == map_StreamedPutativeMatches);
+}
+
+TEST(Streaming_Geometric_Filter, MinimalInliers)
+{
+  const sfm::SfM_Data sfm_data;
+  const std::shared_ptr<sfm::Regions_Provider> regions_provider;
+  const Pair_Set pairs = exhaustivePairs(30);
+  const Synthetic_Matcher matcher;
+
+  PairWiseMatches map_PutativesMatches;
+  matcher.Match(sfm_data, regions_provider, pairs, map_PutativesMatches);
+  ImageCollectionGeometricFilter filter(&sfm_data, regions_provider);
+  filter.Robust_model_estimation(Synthetic_GeometricFilter(), map_PutativesMatches);
+  size_t expected_count = 0;
+  for (PairWiseMatches::const_iterator iter = filter.Get_geometric_matches().begin();
+    iter != filter.Get_geometric_matches().end(); ++iter)
+  {
+    if (iter->second.size() >= 10 &&
+        iter->second.size() >= 0.5f * map_PutativesMatches.at(iter->first).size())
+      ++expected_count;
+  }
+
+  PairWiseMatches map_StreamedGeometricMatches;
+  PairWiseMatches_Collector collector(map_StreamedGeometricMatches);
+  Streaming_Geometric_Filter<Synthetic_GeometricFilter> streaming_filter(
+    filter, Synthetic_GeometricFilter(), collector, 2, 2);
+  streaming_filter.Set_minimal_inliers(10, 0.5f);
+  matcher.Match(sfm_data, regions_provider, pairs, streaming_filter);
+  streaming_filter.Finish();
+  EXPECT_EQ(expected_count, map_StreamedGeometricMatches.size());
+}
+
+/* ************************************************************************* */
+int main() { TestResult tr; return TestRegistry::runAllTests(tr);}
+/* ************************************************************************* */
@@ -189,6 +189,23 @@ Mat2X Project(const Mat34 &P, const Mat4X &X) {
   return x;
 }
 
+void ProjectionResiduals(const Mat34 &P, const RMat2X &x, const RMat3X &X,
+  double *residuals) {
+  assert(x.cols() == X.cols());
+  // Plain loop on the contiguous coordinates (vectorized by the compiler),
+  //  then the square root is applied by Eigen on the whole array.
+  const double *u = x.row(0).data(), *v = x.row(1).data();
+  const double *X0 = X.row(0).data(), *X1 = X.row(1).data(), *X2 = X.row(2).data();
+  for (Mat::Index i = 0; i < X.cols(); ++i) {
+    const double w = P(2,0) * X0[i] + P(2,1) * X1[i] + P(2,2) * X2[i] + P(2,3);
+    const double du = u[i] - (P(0,0) * X0[i] + P(0,1) * X1[i] + P(0,2) * X2[i] + P(0,3)) / w;
+    const double dv = v[i] - (P(1,0) * X0[i] + P(1,1) * X1[i] + P(1,2) * X2[i] + P(1,3)) / w;
+    residuals[i] = du * du + dv * dv;
+  }
+  Eigen::Map<Vec> residuals_map(residuals, X.cols());
+  residuals_map = residuals_map.array().sqrt();
+}
+
 void HomogeneousToEuclidean(const Vec4 &H, Vec3 *X) {
   double w = H(3);
   *X << H(0) / w, H(1) / w, H(2) / w;
@@ -61,6 +61,12 @@ Mat2X Project(const Mat34 &P, const Mat3X &X);
 // Return P*[X|1.0] for the X list of point (4D point).
 Mat2X Project(const Mat34 &P, const Mat4X &X);
 
+// Compute the residuals ||x - P*[X|1.0]|| for the X list of point (3D point).
+// Vectorized evaluation on the structure of arrays layout,
+//  residuals must hold X.cols() values.
+void ProjectionResiduals(const Mat34 &P, const RMat2X &x, const RMat3X &X,
+  double *residuals);
+
 // Change homogeneous coordinates to euclidean.
 void HomogeneousToEuclidean(const Vec4 &H, Vec3 *X);
 
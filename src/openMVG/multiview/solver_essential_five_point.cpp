@@ -30,16 +30,25 @@
 #include <iostream>
 namespace openMVG {
 
-Mat FivePointsNullspaceBasis(const Mat2X &x1, const Mat2X &x2) {
-  Eigen::Matrix<double,9, 9> A;
+Mat9_4 FivePointsNullspaceBasis(const Eigen::Ref<const Mat2X> &x1,
+                                const Eigen::Ref<const Mat2X> &x2) {
+  assert(5 <= x1.cols() && x1.cols() <= 9);
+  if (x1.cols() == 5) {
+    Eigen::Matrix<double, 5, 9> A;
+    fundamental::kernel::EncodeEpipolarEquation(x1, x2, &A);
+    // The 5x9 system is exactly determined: its nullspace is 4 dimensional.
+    return NullspaceQR(A);
+  }
+  // 6 to 9 points: least squares nullspace of the over determined system.
+  Eigen::Matrix<double, 9, 9> A;
   A.setZero();  // Make A square until Eigen supports rectangular SVD.
   fundamental::kernel::EncodeEpipolarEquation(x1, x2, &A);
-  Eigen::JacobiSVD<Eigen::Matrix<double,9, 9> > svd(A,Eigen::ComputeFullV);
-  return svd.matrixV().topRightCorner<9,4>();
+  Eigen::JacobiSVD<Eigen::Matrix<double, 9, 9> > svd(A, Eigen::ComputeFullV);
+  return svd.matrixV().topRightCorner<9, 4>();
 }
 
-Vec o1(const Vec &a, const Vec &b) {
-  Vec res = Vec::Zero(20);
+Vec20 o1(const Vec20 &a, const Vec20 &b) {
+  Vec20 res = Vec20::Zero();
 
   res(coef_xx) = a(coef_x) * b(coef_x);
   res(coef_xy) = a(coef_x) * b(coef_y)
@@ -61,8 +70,8 @@ Vec o1(const Vec &a, const Vec &b) {
   return res;
 }
 
-Vec o2(const Vec &a, const Vec &b) {
-  Vec res(20);
+Vec20 o2(const Vec20 &a, const Vec20 &b) {
+  Vec20 res;
 
   res(coef_xxx) = a(coef_xx) * b(coef_x);
   res(coef_xxy) = a(coef_xx) * b(coef_y)
@@ -108,12 +117,12 @@ Vec o2(const Vec &a, const Vec &b) {
   return res;
 }
 
-Mat FivePointsPolynomialConstraints(const Mat &E_basis) {
+Mat10_20 FivePointsPolynomialConstraints(const Mat9_4 &E_basis) {
   // Build the polynomial form of E (equation (8) in Stewenius et al. [1])
-  Vec E[3][3];
+  Vec20 E[3][3];
   for (int i = 0; i < 3; ++i) {
     for (int j = 0; j < 3; ++j) {
-      E[i][j] = Vec::Zero(20);
+      E[i][j] = Vec20::Zero();
       E[i][j](coef_x) = E_basis(3 * i + j, 0);
       E[i][j](coef_y) = E_basis(3 * i + j, 1);
       E[i][j](coef_z) = E_basis(3 * i + j, 2);
@@ -122,7 +131,7 @@ Mat FivePointsPolynomialConstraints(const Mat &E_basis) {
   }
 
   // The constraint matrix.
-  Mat M(10, 20);
+  Mat10_20 M;
   int mrow = 0;
 
   // Determinant constraint det(E) = 0; equation (19) of Nister [2].
@@ -132,7 +141,7 @@ Mat FivePointsPolynomialConstraints(const Mat &E_basis) {
 
   // Cubic singular values constraint.
   // Equation (20).
-  Vec EET[3][3];
+  Vec20 EET[3][3];
   for (int i = 0; i < 3; ++i) {    // Since EET is symmetric, we only compute
     for (int j = 0; j < 3; ++j) {  // its upper triangular part.
       if (i <= j) {
@@ -146,8 +155,8 @@ Mat FivePointsPolynomialConstraints(const Mat &E_basis) {
   }
 
   // Equation (21).
-  Vec (&L)[3][3] = EET;
-  Vec trace  = 0.5 * (EET[0][0] + EET[1][1] + EET[2][2]);
+  Vec20 (&L)[3][3] = EET;
+  const Vec20 trace = 0.5 * (EET[0][0] + EET[1][1] + EET[2][2]);
   for (int i = 0; i < 3; ++i) {
     L[i][i] -= trace;
   }
@@ -155,7 +164,7 @@ Mat FivePointsPolynomialConstraints(const Mat &E_basis) {
   // Equation (23).
   for (int i = 0; i < 3; ++i) {
     for (int j = 0; j < 3; ++j) {
-      Vec LEij = o2(L[i][0], E[0][j])
+      const Vec20 LEij = o2(L[i][0], E[0][j])
                + o2(L[i][1], E[1][j])
                + o2(L[i][2], E[2][j]);
       M.row(mrow++) = LEij;
@@ -165,32 +174,14 @@ Mat FivePointsPolynomialConstraints(const Mat &E_basis) {
   return M;
 }
 
-void FivePointsGaussJordan(Mat *Mp) {
-  Mat &M = *Mp;
-
-  // Gauss Elimination.
-  for (int i = 0; i < 10; ++i) {
-    M.row(i) /= M(i,i);
-    for (int j = i + 1; j < 10; ++j) {
-      M.row(j) = M.row(j) / M(j,i) - M.row(i);
-    }
-  }
-  // Backsubstitution.
-  for (int i = 9; i >= 0; --i) {
-    for (int j = 0; j < i; ++j) {
-      M.row(j) = M.row(j) - M(j,i) * M.row(i);
-    }
-  }
-}
-
-void FivePointsRelativePose(const Mat2X &x1,
-                            const Mat2X &x2,
+void FivePointsRelativePose(const Eigen::Ref<const Mat2X> &x1,
+                            const Eigen::Ref<const Mat2X> &x2,
                             vector<Mat3> *Es) {
   // Step 1: Nullspace Extraction.
-  Mat E_basis = FivePointsNullspaceBasis(x1, x2);
+  const Mat9_4 E_basis = FivePointsNullspaceBasis(x1, x2);
 
   // Step 2: Constraint Expansion.
-  Mat M = FivePointsPolynomialConstraints(E_basis);
+  Mat10_20 M = FivePointsPolynomialConstraints(E_basis);
 
   // Step 3: Gauss-Jordan Elimination.
   FivePointsGaussJordan(&M);
@@ -198,8 +189,9 @@ void FivePointsRelativePose(const Mat2X &x1,
   // For next steps we follow the matlab code given in Stewenius et al [1].
 
   // Build action matrix.
-  Mat B = M.topRightCorner<10,10>();
-  Mat At = Mat::Zero(10,10);
+  typedef Eigen::Matrix<double, 10, 10> Mat10;
+  const Mat10 B = M.topRightCorner<10,10>();
+  Mat10 At = Mat10::Zero();
   At.row(0) = -B.row(0);
   At.row(1) = -B.row(1);
   At.row(2) = -B.row(2);
@@ -212,17 +204,17 @@ void FivePointsRelativePose(const Mat2X &x1,
   At(9,6) = 1;
 
   // Compute solutions from action matrix's eigenvectors.
-  Eigen::EigenSolver<Mat> es(At);
-  typedef Eigen::EigenSolver<Mat>::EigenvectorsType Matc;
-  Matc V = es.eigenvectors();
-  Matc SOLS(4, 10);
+  Eigen::EigenSolver<Mat10> es(At);
+  typedef Eigen::EigenSolver<Mat10>::EigenvectorsType Matc;
+  const Matc V = es.eigenvectors();
+  Eigen::Matrix<Matc::Scalar, 4, 10> SOLS;
   SOLS.row(0) = V.row(6).array() / V.row(9).array();
   SOLS.row(1) = V.row(7).array() / V.row(9).array();
   SOLS.row(2) = V.row(8).array() / V.row(9).array();
   SOLS.row(3).setOnes();
 
   // Get the ten candidate E matrices in vector form.
-  Matc Evec = E_basis * SOLS;
+  Eigen::Matrix<Matc::Scalar, 9, 10> Evec = E_basis.cast<Matc::Scalar>() * SOLS;
 
   // Build essential matrices for the real solutions.
   Es->reserve(10);
@@ -47,29 +47,54 @@
 namespace openMVG {
   using namespace std;
 
+// Compile time sized matrices used by the algorithm (no heap allocation):
+typedef Eigen::Matrix<double, 20, 1> Vec20;     // Polynomial coefficients
+typedef Eigen::Matrix<double, 9, 4> Mat9_4;     // Nullspace basis of E
+typedef Eigen::Matrix<double, 10, 20> Mat10_20; // Polynomial constraints
+
 /** Computes the relative pose of two calibrated cameras from 5 correspondences.
  *
- * \param x1 Points in the first image.  One per column.
+ * \param x1 Points in the first image.  One per column (5 to 9 points).
  * \param x2 Corresponding points in the second image. One per column.
  * \param E  A list of at most 10 candidate essential matrix solutions.
  */
-void FivePointsRelativePose(const Mat2X &x1, const Mat2X &x2,
+void FivePointsRelativePose(const Eigen::Ref<const Mat2X> &x1,
+                            const Eigen::Ref<const Mat2X> &x2,
                             vector<Mat3> *E);
 
 // Compute the nullspace of the linear constraints given by the matches.
-Mat FivePointsNullspaceBasis(const Mat2X &x1, const Mat2X &x2);
+// (5 to 9 matches, the least squares nullspace is used above 5 matches)
+Mat9_4 FivePointsNullspaceBasis(const Eigen::Ref<const Mat2X> &x1,
+                                const Eigen::Ref<const Mat2X> &x2);
 
 // Multiply two polynomials of degree 1.
-Vec o1(const Vec &a, const Vec &b);
+Vec20 o1(const Vec20 &a, const Vec20 &b);
 
 // Multiply a polynomial of degree 2, a, by a polynomial of degree 1, b.
-Vec o2(const Vec &a, const Vec &b);
+Vec20 o2(const Vec20 &a, const Vec20 &b);
 
 // Builds the polynomial constraint matrix M.
-Mat FivePointsPolynomialConstraints(const Mat &E_basis);
+Mat10_20 FivePointsPolynomialConstraints(const Mat9_4 &E_basis);
 
 // Gauss--Jordan elimination for the constraint matrix.
-void FivePointsGaussJordan(Mat *Mp);
+template <typename TMat>
+void FivePointsGaussJordan(TMat *Mp) {
+  TMat &M = *Mp;
+
+  // Gauss Elimination.
+  for (int i = 0; i < 10; ++i) {
+    M.row(i) /= M(i,i);
+    for (int j = i + 1; j < 10; ++j) {
+      M.row(j) = M.row(j) / M(j,i) - M.row(i);
+    }
+  }
+  // Backsubstitution.
+  for (int i = 9; i >= 0; --i) {
+    for (int j = 0; j < i; ++j) {
+      M.row(j) = M.row(j) - M(j,i) * M.row(i);
+    }
+  }
+}
 
 // In the following code, polynomials are expressed as vectors containing
 // their coeficients in the basis of monomials:
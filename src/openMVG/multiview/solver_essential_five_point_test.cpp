@@ -50,7 +50,7 @@ struct TestData {
   Mat2X x1, x2;
 };
 
-TestData SomeTestData() {
+TestData SomeTestData(int nPoints = 5) {
   TestData d;
 
   // --
@@ -59,7 +59,7 @@ TestData SomeTestData() {
   // Second camera as [R=Rx*Ry*Rz|t=random],
   // Compute projection of the 3D points onto image plane.
   // --
-  d.X = Mat3X::Random(3,5);
+  d.X = Mat3X::Random(3,nPoints);
 
   //-- Make point in front to the cameras.
   d.X.row(0).array() -= .5;
@@ -102,6 +102,27 @@ TEST(FivePointsNullspaceBasis, SatisfyEpipolarConstraint) {
   }
 }
 
+TEST(FivePointsNullspaceBasis, OverDetermined) {
+
+  // 6 to 9 matches: the basis is the least squares nullspace
+  for (int nPoints = 6; nPoints <= 9; ++nPoints) {
+    TestData d = SomeTestData(nPoints);
+
+    Mat E_basis = FivePointsNullspaceBasis(d.x1, d.x2);
+
+    // The true essential matrix lies in the span of the basis
+    Vec9 e;
+    for (int i = 0; i < 3; ++i) {
+      for (int j = 0; j < 3; ++j) {
+        e(3 * i + j) = d.E(i, j);
+      }
+    }
+    e.normalize();
+    const Vec4 coefs = E_basis.transpose() * e;
+    EXPECT_NEAR(0, (E_basis * coefs - e).norm(), 1e-6);
+  }
+}
+
 double EvalPolynomial(Vec p, double x, double y, double z) {
   return p(coef_xxx) * x * x * x
        + p(coef_xxy) * x * x * y
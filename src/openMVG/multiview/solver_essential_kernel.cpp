@@ -38,17 +38,26 @@ namespace kernel {
 
 using namespace std;
 
-void EightPointRelativePoseSolver::Solve(const Mat &x1, const Mat &x2, vector<Mat3> *Es) {
+void EightPointRelativePoseSolver::Solve(const Eigen::Ref<const Mat> &x1,
+  const Eigen::Ref<const Mat> &x2, vector<Mat3> *Es) {
   assert(2 == x1.rows());
   assert(8 <= x1.cols());
   assert(x1.rows() == x2.rows());
   assert(x1.cols() == x2.cols());
 
-  MatX9 A(x1.cols(), 9);
-  fundamental::kernel::EncodeEpipolarEquation(x1, x2, &A);
-
   Vec9 e;
-  Nullspace(&A, &e);
+  if (x1.cols() == 8) {
+    // In the minimal solution use fixed sized matrix to let Eigen and the
+    //  compiler doing the maximum of optimization.
+    Eigen::Matrix<double, 8, 9> A;
+    fundamental::kernel::EncodeEpipolarEquation(x1, x2, &A);
+    e = NullspaceQR(A);
+  }
+  else {
+    MatX9 A(x1.cols(), 9);
+    fundamental::kernel::EncodeEpipolarEquation(x1, x2, &A);
+    Nullspace(&A, &e);
+  }
   Mat3 E = Map<RMat3>(e.data());
 
   // Find the closest essential matrix to E in frobenius norm
@@ -64,7 +73,8 @@ void EightPointRelativePoseSolver::Solve(const Mat &x1, const Mat &x2, vector<Ma
   Es->push_back(E);
 }
 
-void FivePointSolver::Solve(const Mat &x1, const Mat &x2, vector<Mat3> *E) {
+void FivePointSolver::Solve(const Eigen::Ref<const Mat> &x1,
+  const Eigen::Ref<const Mat> &x2, vector<Mat3> *E) {
   assert(2 == x1.rows());
   assert(5 <= x1.cols());
   assert(x1.rows() == x2.rows());
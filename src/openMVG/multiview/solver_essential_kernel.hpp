@@ -49,7 +49,8 @@ using namespace std;
 struct EightPointRelativePoseSolver {
   enum { MINIMUM_SAMPLES = 8 };
   enum { MAX_MODELS = 1 };
-  static void Solve(const Mat &x1, const Mat &x2, vector<Mat3> *E);
+  /// The input can be a compile time sized matrix (no copy, nor allocation)
+  static void Solve(const Eigen::Ref<const Mat> &x1, const Eigen::Ref<const Mat> &x2, vector<Mat3> *E);
 };
 
 /**
@@ -60,7 +61,8 @@ struct EightPointRelativePoseSolver {
 struct FivePointSolver {
   enum { MINIMUM_SAMPLES = 5 };
   enum { MAX_MODELS = 10 };
-  static void Solve(const Mat &x1, const Mat &x2, vector<Mat3> *E);
+  /// The input can be a compile time sized matrix (no copy, nor allocation)
+  static void Solve(const Eigen::Ref<const Mat> &x1, const Eigen::Ref<const Mat> &x2, vector<Mat3> *E);
 };
 
 //-- Generic Solver for the 5pt Essential Matrix Estimation.
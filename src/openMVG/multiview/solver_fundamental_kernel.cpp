@@ -34,7 +34,8 @@ namespace fundamental {
 namespace kernel {
 
 using namespace std;
-void SevenPointSolver::Solve(const Mat &x1, const Mat &x2, vector<Mat3> *F) {
+void SevenPointSolver::Solve(const Eigen::Ref<const Mat> &x1,
+  const Eigen::Ref<const Mat> &x2, vector<Mat3> *F) {
   assert(2 == x1.rows());
   assert(7 <= x1.cols());
   assert(x1.rows() == x2.rows());
@@ -43,13 +44,14 @@ void SevenPointSolver::Solve(const Mat &x1, const Mat &x2, vector<Mat3> *F) {
   Vec9 f1, f2;
   if (x1.cols() == 7) {
     // Set up the homogeneous system Af = 0 from the equations x'T*F*x = 0.
-    typedef Eigen::Matrix<double, 9, 9> Mat9;
     // In the minimal solution use fixed sized matrix to let Eigen and the
     //  compiler doing the maximum of optimization.
-    Mat9 A = Mat::Zero(9,9);
+    Eigen::Matrix<double, 7, 9> A;
     EncodeEpipolarEquation(x1, x2, &A);
     // Find the two F matrices in the nullspace of A.
-    Nullspace2(&A, &f1, &f2);
+    const Eigen::Matrix<double, 9, 2> N = NullspaceQR(A);
+    f1 = N.col(0);
+    f2 = N.col(1);
   }
   else  {
     // Set up the homogeneous system Af = 0 from the equations x'T*F*x = 0.
@@ -94,7 +96,8 @@ void SevenPointSolver::Solve(const Mat &x1, const Mat &x2, vector<Mat3> *F) {
   }
 }
 
-void EightPointSolver::Solve(const Mat &x1, const Mat &x2, vector<Mat3> *Fs) {
+void EightPointSolver::Solve(const Eigen::Ref<const Mat> &x1,
+  const Eigen::Ref<const Mat> &x2, vector<Mat3> *Fs) {
   assert(2 == x1.rows());
   assert(8 <= x1.cols());
   assert(x1.rows() == x2.rows());
@@ -102,12 +105,11 @@ void EightPointSolver::Solve(const Mat &x1, const Mat &x2, vector<Mat3> *Fs) {
 
   Vec9 f;
   if (x1.cols() == 8) {
-    typedef Eigen::Matrix<double, 9, 9> Mat9;
     // In the minimal solution use fixed sized matrix to let Eigen and the
     //  compiler doing the maximum of optimization.
-    Mat9 A = Mat::Zero(9,9);
+    Eigen::Matrix<double, 8, 9> A;
     EncodeEpipolarEquation(x1, x2, &A);
-    Nullspace(&A, &f);
+    f = NullspaceQR(A);
   }
   else  {
     MatX9 A(x1.cols(), 9);
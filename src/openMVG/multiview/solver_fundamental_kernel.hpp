@@ -52,13 +52,15 @@ using namespace std;
 struct SevenPointSolver {
   enum { MINIMUM_SAMPLES = 7 };
   enum { MAX_MODELS = 3 };
-  static void Solve(const Mat &x1, const Mat &x2, vector<Mat3> *F);
+  /// The input can be a compile time sized matrix (no copy, nor allocation)
+  static void Solve(const Eigen::Ref<const Mat> &x1, const Eigen::Ref<const Mat> &x2, vector<Mat3> *F);
 };
 
 struct EightPointSolver {
   enum { MINIMUM_SAMPLES = 8 };
   enum { MAX_MODELS = 1 };
-  static void Solve(const Mat &x1, const Mat &x2, vector<Mat3> *Fs);
+  /// The input can be a compile time sized matrix (no copy, nor allocation)
+  static void Solve(const Eigen::Ref<const Mat> &x1, const Eigen::Ref<const Mat> &x2, vector<Mat3> *Fs);
 };
 
 /**
@@ -107,6 +109,22 @@ struct SampsonError {
     return Square(y.dot(F_x)) / (  F_x.head<2>().squaredNorm()
                                 + Ft_y.head<2>().squaredNorm());
   }
+
+  // Vectorized evaluation of the error of all the correspondences
+  //  (structure of arrays layout, errors must hold x1.cols() values).
+  static void Errors(const Mat3 &F, const RMat2X &x1, const RMat2X &x2, double *errors) {
+    const double *u1 = x1.row(0).data(), *v1 = x1.row(1).data();
+    const double *u2 = x2.row(0).data(), *v2 = x2.row(1).data();
+    for (Mat::Index i = 0; i < x1.cols(); ++i) {
+      const double F_x0 = F(0,0) * u1[i] + F(0,1) * v1[i] + F(0,2);
+      const double F_x1 = F(1,0) * u1[i] + F(1,1) * v1[i] + F(1,2);
+      const double F_x2 = F(2,0) * u1[i] + F(2,1) * v1[i] + F(2,2);
+      const double Ft_y0 = F(0,0) * u2[i] + F(1,0) * v2[i] + F(2,0);
+      const double Ft_y1 = F(0,1) * u2[i] + F(1,1) * v2[i] + F(2,1);
+      errors[i] = Square(u2[i] * F_x0 + v2[i] * F_x1 + F_x2)
+        / (F_x0 * F_x0 + F_x1 * F_x1 + Ft_y0 * Ft_y0 + Ft_y1 * Ft_y1);
+    }
+  }
 };
 
 struct SymmetricEpipolarDistanceError {
@@ -120,6 +138,23 @@ struct SymmetricEpipolarDistanceError {
                                 + 1.0 / Ft_y.head<2>().squaredNorm())
       / 4.0;  // The divide by 4 is to make this match the Sampson distance.
   }
+
+  // Vectorized evaluation of the error of all the correspondences
+  //  (structure of arrays layout, errors must hold x1.cols() values).
+  static void Errors(const Mat3 &F, const RMat2X &x1, const RMat2X &x2, double *errors) {
+    const double *u1 = x1.row(0).data(), *v1 = x1.row(1).data();
+    const double *u2 = x2.row(0).data(), *v2 = x2.row(1).data();
+    for (Mat::Index i = 0; i < x1.cols(); ++i) {
+      const double F_x0 = F(0,0) * u1[i] + F(0,1) * v1[i] + F(0,2);
+      const double F_x1 = F(1,0) * u1[i] + F(1,1) * v1[i] + F(1,2);
+      const double F_x2 = F(2,0) * u1[i] + F(2,1) * v1[i] + F(2,2);
+      const double Ft_y0 = F(0,0) * u2[i] + F(1,0) * v2[i] + F(2,0);
+      const double Ft_y1 = F(0,1) * u2[i] + F(1,1) * v2[i] + F(2,1);
+      errors[i] = Square(u2[i] * F_x0 + v2[i] * F_x1 + F_x2)
+        * (1.0 / (F_x0 * F_x0 + F_x1 * F_x1) + 1.0 / (Ft_y0 * Ft_y0 + Ft_y1 * Ft_y1))
+        / 4.0;
+    }
+  }
 };
 
 struct EpipolarDistanceError {
@@ -131,6 +166,20 @@ struct EpipolarDistanceError {
     Vec3 F_x = F * x;
     return Square(F_x.dot(y)) /  F_x.head<2>().squaredNorm();
   }
+
+  // Vectorized evaluation of the error of all the correspondences
+  //  (structure of arrays layout, errors must hold x1.cols() values).
+  static void Errors(const Mat3 &F, const RMat2X &x1, const RMat2X &x2, double *errors) {
+    const double *u1 = x1.row(0).data(), *v1 = x1.row(1).data();
+    const double *u2 = x2.row(0).data(), *v2 = x2.row(1).data();
+    for (Mat::Index i = 0; i < x1.cols(); ++i) {
+      const double F_x0 = F(0,0) * u1[i] + F(0,1) * v1[i] + F(0,2);
+      const double F_x1 = F(1,0) * u1[i] + F(1,1) * v1[i] + F(1,2);
+      const double F_x2 = F(2,0) * u1[i] + F(2,1) * v1[i] + F(2,2);
+      errors[i] = Square(u2[i] * F_x0 + v2[i] * F_x1 + F_x2)
+        / (F_x0 * F_x0 + F_x1 * F_x1);
+    }
+  }
 };
 typedef EpipolarDistanceError SimpleError;
 
@@ -139,6 +139,31 @@ TEST(EightPointTest_Normalized, EasyCase) {
   EXPECT_TRUE(ExpectKernelProperties<Kernel>(x1, x2));
 }
 
+// The vectorized batch errors must match the per correspondence errors
+template <typename ErrorT>
+bool BatchErrorsMatch(const Mat3 & F, const Mat & x1, const Mat & x2) {
+  const RMat2X x1_soa = x1, x2_soa = x2;
+  vector<double> errors(x1.cols());
+  ErrorT::Errors(F, x1_soa, x2_soa, &errors[0]);
+  for (Mat::Index i = 0; i < x1.cols(); ++i) {
+    const double expected = ErrorT::Error(F, x1.col(i), x2.col(i));
+    if (std::abs(errors[i] - expected) > 1e-10 * std::max(1.0, expected))
+      return false;
+  }
+  return true;
+}
+
+TEST(FundamentalErrors, Batch) {
+  Mat3 F;
+  F << 0.1, -2.0,  3.0,
+       2.5,  0.3, -1.0,
+      -4.0,  1.5,  0.7;
+  const Mat x1 = Mat::Random(2, 101) * 500.0, x2 = Mat::Random(2, 101) * 500.0;
+  EXPECT_TRUE(BatchErrorsMatch<fundamental::kernel::SampsonError>(F, x1, x2));
+  EXPECT_TRUE(BatchErrorsMatch<fundamental::kernel::SymmetricEpipolarDistanceError>(F, x1, x2));
+  EXPECT_TRUE(BatchErrorsMatch<fundamental::kernel::EpipolarDistanceError>(F, x1, x2));
+}
+
 /* ************************************************************************* */
 int main() { TestResult tr; return TestRegistry::runAllTests(tr);}
 /* ************************************************************************* */
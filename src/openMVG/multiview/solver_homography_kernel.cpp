@@ -35,8 +35,8 @@ namespace kernel {
 /// Setup the Direct Linear Transform.
 ///  Use template in order to support fixed or dynamic sized matrix.
 /// Allow solve H as homogeneous(x2) = H homogeneous(x1)
-template<typename Matrix >
-void BuildActionMatrix(Matrix & L, const Mat &x, const Mat &y)  {
+template<typename Matrix, typename TMatX>
+void BuildActionMatrix(Matrix & L, const TMatX &x, const TMatX &y)  {
 
   const Mat::Index n = x.cols();
   for (Mat::Index i = 0; i < n; ++i) {
@@ -58,7 +58,8 @@ void BuildActionMatrix(Matrix & L, const Mat &x, const Mat &y)  {
   }
 }
 
-void FourPointSolver::Solve(const Mat &x, const Mat &y, vector<Mat3> *Hs) {
+void FourPointSolver::Solve(const Eigen::Ref<const Mat> &x,
+  const Eigen::Ref<const Mat> &y, vector<Mat3> *Hs) {
   assert(2 == x.rows());
   assert(4 <= x.cols());
   assert(x.rows() == y.rows());
@@ -70,10 +71,10 @@ void FourPointSolver::Solve(const Mat &x, const Mat &y, vector<Mat3> *Hs) {
   if (n == 4)  {
     // In the case of minimal configuration we use fixed sized matrix to let
     //  Eigen and the compiler doing the maximum of optimization.
-    typedef Eigen::Matrix<double, 16, 9> Mat16_9;
-    Mat16_9 L = Mat::Zero(16, 9);
+    typedef Eigen::Matrix<double, 8, 9> Mat8_9;
+    Mat8_9 L = Mat8_9::Zero();
     BuildActionMatrix(L, x, y);
-    Nullspace(&L, &h);
+    h = NullspaceQR(L);
   }
   else {
     MatX9 L = Mat::Zero(n * 2, 9);
@@ -51,17 +51,31 @@ struct FourPointSolver {
    * \param Hs A vector into which the computed homography is stored.
    *
    * The estimated homography should approximately hold the condition y = H x.
+   * The input can be a compile time sized matrix (no copy, nor allocation).
    */
-  static void Solve(const Mat &x, const Mat &y, vector<Mat3> *Hs);
+  static void Solve(const Eigen::Ref<const Mat> &x, const Eigen::Ref<const Mat> &y, vector<Mat3> *Hs);
 };
 
 // Should be distributed as Chi-squared with k = 2.
 struct AsymmetricError {
-  static double Error(const Mat &H, const Vec2 &x1, const Vec2 &x2) {
+  static double Error(const Mat3 &H, const Vec2 &x1, const Vec2 &x2) {
     Vec3 x2h_est = H * EuclideanToHomogeneous(x1);
     Vec2 x2_est = x2h_est.head<2>() / x2h_est[2];
     return (x2 - x2_est).squaredNorm();
   }
+
+  // Vectorized evaluation of the error of all the correspondences
+  //  (structure of arrays layout, errors must hold x1.cols() values).
+  static void Errors(const Mat3 &H, const RMat2X &x1, const RMat2X &x2, double *errors) {
+    const double *u1 = x1.row(0).data(), *v1 = x1.row(1).data();
+    const double *u2 = x2.row(0).data(), *v2 = x2.row(1).data();
+    for (Mat::Index i = 0; i < x1.cols(); ++i) {
+      const double w = H(2,0) * u1[i] + H(2,1) * v1[i] + H(2,2);
+      const double du = u2[i] - (H(0,0) * u1[i] + H(0,1) * v1[i] + H(0,2)) / w;
+      const double dv = v2[i] - (H(1,0) * u1[i] + H(1,1) * v1[i] + H(1,2)) / w;
+      errors[i] = du * du + dv * dv;
+    }
+  }
 };
 
 // Kernel that works on original data point
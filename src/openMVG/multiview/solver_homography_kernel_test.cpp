@@ -107,6 +107,21 @@ TEST(HomographyKernelTest, Fitting_Normalized) {
   }
 }
 
+TEST(HomographyKernelTest, BatchErrors) {
+  Mat3 H;
+  H << 1, -2,  3,
+       4,  5, -6,
+      -7,  8,  1;
+  const Mat x = Mat::Random(2, 101) * 10.0, y = Mat::Random(2, 101) * 10.0;
+  const RMat2X x_soa = x, y_soa = y;
+  vector<double> errors(x.cols());
+  homography::kernel::AsymmetricError::Errors(H, x_soa, y_soa, &errors[0]);
+  for (Mat::Index i = 0; i < x.cols(); ++i) {
+    const double expected = homography::kernel::AsymmetricError::Error(H, x.col(i), y.col(i));
+    EXPECT_NEAR(expected, errors[i], 1e-10 * std::max(1.0, expected));
+  }
+}
+
 /* ************************************************************************* */
 int main() { TestResult tr; return TestRegistry::runAllTests(tr);}
 /* ************************************************************************* */
@@ -35,16 +35,6 @@ namespace kernel {
 
 using namespace std;
 
-void translate(
-  const Mat3X & X,
-  const Vec3 & vecTranslation,
-  Mat3X * XPoints)
-{
-  XPoints->resize(X.rows(), X.cols());
-  for (int i=0; i<X.cols(); ++i)
-    XPoints->col(i) = X.col(i) + vecTranslation;
-}
-
 template <typename TMat, typename TVec>
 double NullspaceRatio(TMat *A, TVec *nullspace) {
   if (A->rows() >= A->cols()) {
@@ -62,13 +52,15 @@ double NullspaceRatio(TMat *A, TVec *nullspace) {
 
 /// Setup the Direct Linear Transform.
 ///  Use template in order to support fixed or dynamic sized matrix.
-template<typename Matrix>
-void BuildActionMatrix(Matrix & A, const Mat &pt2D, const Mat &XPoints)  {
+///  The 3D points are translated by vecTranslation.
+template<typename Matrix, typename TMat>
+void BuildActionMatrix(Matrix & A, const TMat &pt2D, const TMat &pt3d,
+  const Vec3 & vecTranslation)  {
 
   const size_t n = pt2D.cols();
   for (size_t i = 0; i < n; ++i) {
     size_t row_index = i * 2;
-    const Vec3 & X = XPoints.col(i);
+    const Vec3 X = pt3d.col(i) + vecTranslation;
     const Vec2 & x = pt2D.col(i);
     A(row_index,  0) =  X(0);
     A(row_index,  1) =  X(1);
@@ -95,8 +87,8 @@ void BuildActionMatrix(Matrix & A, const Mat &pt2D, const Mat &XPoints)  {
 }
 
 void SixPointResectionSolver::Solve(
-  const Mat &pt2D,
-  const Mat &pt3d,
+  const Eigen::Ref<const Mat> &pt2D,
+  const Eigen::Ref<const Mat> &pt3d,
   vector<Mat34> *Ps,
   bool bcheck)
 {
@@ -112,9 +104,6 @@ void SixPointResectionSolver::Solve(
                        0, 1, 0, vecTranslation(1),
                        0, 0, 1, vecTranslation(2),
                        0, 0, 0, 1;
-  Mat3X XPoints;
-  translate(pt3d, vecTranslation, &XPoints);
-
   const size_t n = pt2D.cols();
 
   typedef Eigen::Matrix<double, 12, 1> Vec12;
@@ -124,13 +113,13 @@ void SixPointResectionSolver::Solve(
     // In the case of minimal configuration we use fixed sized matrix to let
     //  Eigen and the compiler doing the maximum of optimization.
     typedef Eigen::Matrix<double, 12, 12> Mat12;
-    Mat12 A = Mat12::Zero(12, 12);
-    BuildActionMatrix(A, pt2D, XPoints);
+    Mat12 A = Mat12::Zero();
+    BuildActionMatrix(A, pt2D, pt3d, vecTranslation);
     ratio = NullspaceRatio(&A, &p);
   }
   else  {
     Mat A = Mat::Zero(n*2, 12);
-    BuildActionMatrix(A, pt2D, XPoints);
+    BuildActionMatrix(A, pt2D, pt3d, vecTranslation);
     ratio = NullspaceRatio(&A, &p);
   }
   if (bcheck) {
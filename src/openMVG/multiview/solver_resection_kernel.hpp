@@ -49,13 +49,21 @@ struct SixPointResectionSolver {
   enum { MAX_MODELS = 1 };
   // Solve the problem of camera pose.
   // First 3d point will be translated in order to have X0 = (0,0,0,1)
-  static void Solve(const Mat &pt2D, const Mat &pt3D, std::vector<Mat34> *P, bool bcheck = true);
+  // The input can be a compile time sized matrix (no copy, nor allocation)
+  static void Solve(const Eigen::Ref<const Mat> &pt2D, const Eigen::Ref<const Mat> &pt3D,
+    std::vector<Mat34> *P, bool bcheck = true);
 
   // Compute the residual of the projection distance(pt2D, Project(P,pt3D))
   static double Error(const Mat34 & P, const Vec2 & pt2D, const Vec3 & pt3D){
     Vec2 x = Project(P, pt3D);
     return (x-pt2D).norm();
   }
+
+  // Vectorized evaluation of the residuals (structure of arrays layout)
+  static void Errors(const Mat34 & P, const RMat2X & pt2D, const RMat3X & pt3D,
+    double * errors) {
+    ProjectionResiduals(P, pt2D, pt3D, errors);
+  }
 };
 
 //-- Generic Solver for the 6pt Resection algorithm using linear least squares.
@@ -142,6 +150,12 @@ struct EpnpSolver {
   static double Error(const Mat34 & P, const Vec2 & pt2D, const Vec3 & pt3D) {
     return (pt2D - Project(P, pt3D)).norm();
   }
+
+  // Vectorized evaluation of the residuals (structure of arrays layout)
+  static void Errors(const Mat34 & P, const RMat2X & pt2D, const RMat3X & pt3D,
+    double * errors) {
+    ProjectionResiduals(P, pt2D, pt3D, errors);
+  }
 };
 
 class ResectionKernel_K {
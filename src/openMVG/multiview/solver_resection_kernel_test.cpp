@@ -215,6 +215,21 @@ TEST(EuclideanResection, Points6AllRandomInput) {
 
 }
 
+TEST(Resection_Kernel, BatchErrors) {
+  const NViewDataSet d = NRealisticCamerasRing(1, 100, nViewDatasetConfigurator(1, 1, 0, 0, 5, 0));
+  const Mat2X x = d._x[0] + Mat2X::Random(2, 100) * 0.5; // noisy observations
+  const RMat2X x_soa = x;
+  const RMat3X X_soa = d._X;
+  const Mat34 P = d.P(0);
+  std::vector<double> errors(x.cols());
+  resection::kernel::SixPointResectionSolver::Errors(P, x_soa, X_soa, &errors[0]);
+  for (Mat::Index i = 0; i < x.cols(); ++i) {
+    const double expected = resection::kernel::SixPointResectionSolver::Error(
+      P, x.col(i), d._X.col(i));
+    EXPECT_NEAR(expected, errors[i], 1e-10);
+  }
+}
+
 /* ************************************************************************* */
 int main() { TestResult tr; return TestRegistry::runAllTests(tr);}
 /* ************************************************************************* */
@@ -37,6 +37,7 @@
 
 #include <iostream>
 #include "openMVG/numeric/numeric.h"
+#include "openMVG/multiview/projection.hpp"
 
 namespace openMVG {
 namespace euclidean_resection {
@@ -91,6 +92,9 @@ static void solveQuartic( const Vec5 & factors, Vec4 & realRoots)
   realRoots[3] = temp.real();
 }
 
+/// Storage of the P3P solutions: [ C1,R1, C2,R2 ... ]
+typedef Eigen::Matrix<double, 3, 4*4> P3P_Solutions;
+
 /*
  *      Author: Laurent Kneip, adapted to openMVG by Pierre Moulon
  * Description: Compute the absolute pose of a camera using three 3D-to-2D correspondences
@@ -107,10 +111,8 @@ static void solveQuartic( const Vec5 & factors, Vec4 & realRoots)
  *      Output: bool: true if correct execution
  *                    false if world points aligned
  */
-
-static bool compute_P3P_Poses( const Mat3 & featureVectors, const Mat3 & worldPoints, Mat & solutions )
+static bool compute_P3P_Poses( const Mat3 & featureVectors, const Mat3 & worldPoints, P3P_Solutions & solutions )
 {
-  solutions = Mat(3, 4*4);
 
   // Extraction of world points
 
@@ -288,7 +290,9 @@ struct P3PSolver {
   enum { MINIMUM_SAMPLES = 3 };
   enum { MAX_MODELS = 4};
   // Solve the problem of camera pose.
-  static void Solve(const Mat &pt2D, const Mat &pt3D, std::vector<Mat34> *models)
+  // The input can be a compile time sized matrix (no copy, nor allocation)
+  static void Solve(const Eigen::Ref<const Mat> &pt2D, const Eigen::Ref<const Mat> &pt3D,
+    std::vector<Mat34> *models)
   {
     Mat3 R;
     Vec3 t;
@@ -296,7 +300,7 @@ struct P3PSolver {
     assert(2 == pt2D.rows());
     assert(3 == pt3D.rows());
     assert(pt2D.cols() == pt3D.cols());
-    Mat solutions = Mat(3, 4*4);
+    P3P_Solutions solutions;
     Mat3 pt2D_3x3;
     pt2D_3x3.block<2,3>(0,0) = pt2D;
     pt2D_3x3.row(2).fill(1);
@@ -319,6 +323,12 @@ struct P3PSolver {
   static double Error(const Mat34 & P, const Vec2 & pt2D, const Vec3 & pt3D) {
     return (pt2D - Project(P, pt3D)).norm();
   }
+
+  // Vectorized evaluation of the residuals (structure of arrays layout)
+  static void Errors(const Mat34 & P, const RMat2X & pt2D, const RMat3X & pt3D,
+    double * errors) {
+    ProjectionResiduals(P, pt2D, pt3D, errors);
+  }
 };
 
 class P3P_ResectionKernel_K {
@@ -339,9 +349,10 @@ class P3P_ResectionKernel_K {
   }
 
   void Fit(const std::vector<size_t> &samples, std::vector<Model> *models) const {
-    const Mat3 pt2D_3x3 ( ExtractColumns(x_camera_, samples) );
-    const Mat3 pt3D_3x3 ( ExtractColumns(X_, samples) );
-    Mat solutions(3, 4*4);
+    Mat3 pt2D_3x3, pt3D_3x3;
+    ExtractColumns(x_camera_, samples, &pt2D_3x3);
+    ExtractColumns(X_, samples, &pt3D_3x3);
+    P3P_Solutions solutions;
     if (compute_P3P_Poses( pt2D_3x3, pt3D_3x3, solutions))
     {
       Mat34 P;
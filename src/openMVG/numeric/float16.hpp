@@ -0,0 +1,134 @@
+// Copyright (c) 2015 Pierre MOULON.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef OPENMVG_NUMERIC_FLOAT16_HPP
+#define OPENMVG_NUMERIC_FLOAT16_HPP
+
+#include "openMVG/numeric/accumulator_trait.hpp"
+
+#include <Eigen/Core>
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+
+#ifdef __F16C__
+#include <immintrin.h>
+#endif
+
+namespace openMVG {
+
+/**
+ * IEEE 754 half precision floating point value (storage type).
+ * The arithmetic is done in single precision: a Float16 is converted to float
+ *  when used in an expression, and a float is rounded to the nearest Float16
+ *  (ties to even) when assigned.
+ * The F16C instructions are used for the conversions if they are enabled.
+ */
+struct Float16
+{
+  uint16_t bits;
+
+  Float16() {}
+  Float16(const float value) : bits(From_float(value)) {}
+
+  operator float() const { return To_float(bits); }
+
+  static float To_float(const uint16_t h)
+  {
+#ifdef __F16C__
+    return _cvtsh_ss(h);
+#else
+    // Shift the exponent and mantissa to the single precision position and rebias
+    // the exponent (Inf/NaN keep the maximal exponent, subnormals are renormalized)
+    const uint32_t shifted_exp = 0x7c00u << 13;
+    uint32_t o = (h & 0x7fffu) << 13;
+    const uint32_t exp = shifted_exp & o;
+    o += (127 - 15) << 23;
+    if (exp == shifted_exp)
+      o += (128 - 16) << 23;
+    else if (exp == 0)
+    {
+      o += 1 << 23;
+      o = As_uint(As_float(o) - As_float(113u << 23));
+    }
+    o |= uint32_t(h & 0x8000u) << 16;
+    return As_float(o);
+#endif
+  }
+
+  static uint16_t From_float(const float value)
+  {
+#ifdef __F16C__
+    return _cvtss_sh(value, 0);
+#else
+    const uint32_t f32_infinity = 255u << 23;
+    const uint32_t f16_max = (127u + 16) << 23;
+    const uint32_t denorm_magic = ((127u - 15) + (23 - 10) + 1) << 23;
+    uint32_t f = As_uint(value);
+    const uint32_t sign = f & 0x80000000u;
+    f ^= sign;
+    uint16_t o;
+    if (f >= f16_max) // overflow: Inf, NaN stays NaN
+      o = (f > f32_infinity) ? 0x7e00 : 0x7c00;
+    else if (f < (113u << 23)) // subnormal or zero: the float addition does the rounding
+      o = static_cast<uint16_t>(As_uint(As_float(f) + As_float(denorm_magic)) - denorm_magic);
+    else
+    {
+      // Rebias the exponent and round the mantissa to nearest even
+      const uint32_t mant_odd = (f >> 13) & 1;
+      f += (uint32_t(15 - 127) << 23) + 0xfff;
+      f += mant_odd;
+      o = static_cast<uint16_t>(f >> 13);
+    }
+    return static_cast<uint16_t>(o | (sign >> 16));
+#endif
+  }
+
+  template<class Archive>
+  void serialize(Archive & ar)
+  {
+    ar(bits);
+  }
+
+private:
+
+  static uint32_t As_uint(const float f) { uint32_t u; std::memcpy(&u, &f, sizeof(u)); return u; }
+  static float As_float(const uint32_t u) { float f; std::memcpy(&f, &u, sizeof(f)); return f; }
+};
+
+template<>
+struct Accumulator<Float16> { typedef float Type; };
+
+inline std::ostream& operator<<(std::ostream& os, const Float16 & value)
+{
+  return os << static_cast<float>(value);
+}
+
+inline std::istream& operator>>(std::istream& is, Float16 & value)
+{
+  float f;
+  if (is >> f)
+    value = Float16(f);
+  return is;
+}
+
+} // namespace openMVG
+
+namespace Eigen {
+
+/// Float16 can be stored in Eigen matrices (i.e. mapped descriptor arrays)
+template<>
+struct NumTraits<openMVG::Float16> : NumTraits<float>
+{
+  typedef openMVG::Float16 Real;
+  typedef openMVG::Float16 NonInteger;
+  typedef openMVG::Float16 Nested;
+};
+
+} // namespace Eigen
+
+#endif // OPENMVG_NUMERIC_FLOAT16_HPP
@@ -110,6 +110,10 @@ namespace openMVG {
   typedef Eigen::Matrix<double, 3, Eigen::Dynamic> Mat3X;
   typedef Eigen::Matrix<double, 4, Eigen::Dynamic> Mat4X;
 
+  //-- Point lists stored as structure of arrays (each coordinate is contiguous)
+  typedef Eigen::Matrix<double, 2, Eigen::Dynamic, Eigen::RowMajor> RMat2X;
+  typedef Eigen::Matrix<double, 3, Eigen::Dynamic, Eigen::RowMajor> RMat3X;
+
   typedef Eigen::Matrix<double, Eigen::Dynamic, 9> MatX9;
 
   //-- Sparse Matrix (Column major, and row major)
@@ -235,6 +239,21 @@ namespace openMVG {
     return Nullspace2(&A_extended, x1, x2);
   }
 
+  /// Compute the nullspace of a full row rank matrix A with less rows than
+  /// columns (i.e. the linear system of a minimal solver), from the Householder
+  /// QR decomposition of A^T: the last (cols - rows) columns of Q are an
+  /// orthonormal basis of the nullspace. A must be a compile time sized matrix:
+  /// there is no heap allocation and it is much faster than the SVD.
+  template <typename TMat>
+  inline Eigen::Matrix<double, TMat::ColsAtCompileTime,
+    TMat::ColsAtCompileTime - TMat::RowsAtCompileTime>
+  NullspaceQR(const TMat &A) {
+    enum { Rows = TMat::RowsAtCompileTime, Cols = TMat::ColsAtCompileTime };
+    const Eigen::HouseholderQR<Eigen::Matrix<double, Cols, Rows> > qr(A.transpose());
+    const Eigen::Matrix<double, Cols, Cols> Q = qr.householderQ();
+    return Q.template rightCols<Cols - Rows>();
+  }
+
   // Make a rotation matrix such that center becomes the direction of the
   // positive z-axis, and y is oriented close to up by default.
   Mat3 LookAt(const Vec3 &center, const Vec3 & up = Vec3::UnitY());
@@ -326,6 +345,16 @@ namespace openMVG {
     return compressed;
   }
 
+  /// Extract the columns in an already sized matrix (i.e. a compile time
+  ///  sized matrix, to avoid any heap allocation).
+  template <typename TMat, typename TCols, typename TMatOut>
+  void ExtractColumns(const TMat &A, const TCols &columns, TMatOut *compressed) {
+    assert(compressed->cols() == static_cast<typename TMatOut::Index>(columns.size()));
+    for (size_t i = 0; i < static_cast<size_t>(columns.size()); ++i) {
+      compressed->col(i) = A.col(columns[i]);
+    }
+  }
+
   void MeanAndVarianceAlongRows(const Mat &A,
     Vec *mean_pointer,
     Vec *variance_pointer);
@@ -14,6 +14,8 @@ using namespace openMVG::matching;
 #include "openMVG/features/regions.hpp"
 #include "openMVG/cameras/Camera_Intrinsics.hpp"
 
+#include <algorithm>
+#include <cmath>
 #include <vector>
 
 namespace openMVG{
@@ -389,6 +391,296 @@ void GuidedMatching_Fundamental_Fast(
   }
 }
 
+/// Uniform grid over a set of 2D points:
+///  Allow to retrieve the points that are close to a position (disc query)
+///  or close to a line (band query) without an exhaustive search.
+/// Points indexes are stored contiguously per cell (compressed row storage).
+class PointGrid2D
+{
+public:
+
+  /// Build the grid over the points bounding box.
+  /// The cell size is chosen to have a few points per cell and to be
+  ///  at least as large as the given minimal size (search radius).
+  PointGrid2D(const std::vector<Vec2> & points, double min_cell_size)
+  {
+    _origin.setZero();
+    _cell_size = 1.0;
+    _cols = _rows = 0;
+    if (points.empty())
+      return;
+
+    Vec2 min_pt = points[0], max_pt = points[0];
+    for (size_t i = 1; i < points.size(); ++i)
+    {
+      min_pt = min_pt.cwiseMin(points[i]);
+      max_pt = max_pt.cwiseMax(points[i]);
+    }
+    const Vec2 extent = (max_pt - min_pt).cwiseMax(Vec2(1.0, 1.0));
+
+    // Target an average of 4 points per cell
+    const double points_per_cell = 4.0;
+    _cell_size = std::max(min_cell_size,
+      std::sqrt(extent(0) * extent(1) * points_per_cell / points.size()));
+    _origin = min_pt;
+    _cols = static_cast<int>(extent(0) / _cell_size) + 1;
+    _rows = static_cast<int>(extent(1) / _cell_size) + 1;
+
+    // Counting sort of the points per cell
+    std::vector<int> point_cells(points.size());
+    _cell_start.assign(_cols * _rows + 1, 0);
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+      point_cells[i] = cellIndex(points[i]);
+      ++_cell_start[point_cells[i] + 1];
+    }
+    for (size_t c = 1; c < _cell_start.size(); ++c)
+      _cell_start[c] += _cell_start[c-1];
+    _indexes.resize(points.size());
+    std::vector<IndexT> fill(_cell_start.begin(), _cell_start.end() - 1);
+    for (size_t i = 0; i < points.size(); ++i)
+      _indexes[fill[point_cells[i]]++] = static_cast<IndexT>(i);
+  }
+
+  /// Append to candidates the points of the cells that intersect
+  ///  the square bounding the disc (center, radius)
+  void queryDisc(const Vec2 & center, double radius, std::vector<IndexT> & candidates) const
+  {
+    if (_indexes.empty())
+      return;
+    const int x_min = std::max(0, cellCoord(center(0) - radius, _origin(0)));
+    const int x_max = std::min(_cols - 1, cellCoord(center(0) + radius, _origin(0)));
+    const int y_min = std::max(0, cellCoord(center(1) - radius, _origin(1)));
+    const int y_max = std::min(_rows - 1, cellCoord(center(1) + radius, _origin(1)));
+    for (int y = y_min; y <= y_max; ++y)
+      appendCells(y * _cols + x_min, y * _cols + x_max, candidates);
+  }
+
+  /// Append to candidates the points of the cells that intersect
+  ///  the band of half width around the line (a*x + b*y + c = 0)
+  void queryBand(const Vec3 & line, double half_width, std::vector<IndexT> & candidates) const
+  {
+    const double norm = line.head<2>().norm();
+    if (_indexes.empty() || norm <= 0.0)
+      return;
+    const Vec3 l = line / norm;
+    const double a = l(0), b = l(1), c = l(2);
+
+    if (std::abs(b) >= std::abs(a))
+    {
+      // Walk along the columns: y = (-c - a*x +/- half_width) / b
+      for (int x = 0; x < _cols; ++x)
+      {
+        const double x0 = _origin(0) + x * _cell_size;
+        const double x1 = x0 + _cell_size;
+        const double y_a = (-c - a * x0) / b, y_b = (-c - a * x1) / b;
+        const double offset = half_width / std::abs(b);
+        const int y_min = std::max(0, cellCoord(std::min(y_a, y_b) - offset, _origin(1)));
+        const int y_max = std::min(_rows - 1, cellCoord(std::max(y_a, y_b) + offset, _origin(1)));
+        for (int y = y_min; y <= y_max; ++y)
+          appendCells(y * _cols + x, y * _cols + x, candidates);
+      }
+    }
+    else
+    {
+      // Walk along the rows: x = (-c - b*y +/- half_width) / a
+      for (int y = 0; y < _rows; ++y)
+      {
+        const double y0 = _origin(1) + y * _cell_size;
+        const double y1 = y0 + _cell_size;
+        const double x_a = (-c - b * y0) / a, x_b = (-c - b * y1) / a;
+        const double offset = half_width / std::abs(a);
+        const int x_min = std::max(0, cellCoord(std::min(x_a, x_b) - offset, _origin(0)));
+        const int x_max = std::min(_cols - 1, cellCoord(std::max(x_a, x_b) + offset, _origin(0)));
+        if (x_min <= x_max)
+          appendCells(y * _cols + x_min, y * _cols + x_max, candidates);
+      }
+    }
+  }
+
+private:
+
+  int cellCoord(double v, double origin) const
+  {
+    // clamp before the cast in order to avoid integer overflow
+    const double cell = std::floor((v - origin) / _cell_size);
+    return static_cast<int>(std::max(-1.0, std::min(cell, static_cast<double>(std::max(_cols, _rows)))));
+  }
+
+  int cellIndex(const Vec2 & pt) const
+  {
+    const int x = std::min(_cols - 1, std::max(0, cellCoord(pt(0), _origin(0))));
+    const int y = std::min(_rows - 1, std::max(0, cellCoord(pt(1), _origin(1))));
+    return y * _cols + x;
+  }
+
+  // Append the points of the consecutive cells [first, last]
+  void appendCells(int first, int last, std::vector<IndexT> & candidates) const
+  {
+    if (first > last)
+      return;
+    candidates.insert(candidates.end(),
+      _indexes.begin() + _cell_start[first],
+      _indexes.begin() + _cell_start[last + 1]);
+  }
+
+  Vec2 _origin;
+  double _cell_size;
+  int _cols, _rows;
+  std::vector<IndexT> _cell_start; // first point index of each cell
+  std::vector<IndexT> _indexes;    // point indexes sorted by cell
+};
+
+/// Keep the candidates that satisfy the geometric error and update the
+///  distance ratio with their descriptor distances (computed in a single batch)
+template<
+  typename ModelArg,  // The used model type
+  typename ErrorArg   // The metric to compute distance to the model
+  >
+void UpdateGuidedCandidates(
+  const ModelArg & mod,
+  const features::Regions & lRegions,
+  const std::vector<Vec2> & lRegionsPos,
+  const features::Regions & rRegions,
+  const std::vector<Vec2> & rRegionsPos,
+  const size_t i,
+  const double errorTh,
+  std::vector<IndexT> & candidates,
+  std::vector<double> & distances,
+  distanceRatio<double> & dR)
+{
+  // Keep only the candidates that are close enough to the model
+  size_t count = 0;
+  for (size_t k = 0; k < candidates.size(); ++k)
+  {
+    const IndexT j = candidates[k];
+    if (ErrorArg::Error(mod, lRegionsPos[i], rRegionsPos[j]) < errorTh)
+      candidates[count++] = j;
+  }
+  if (count == 0)
+    return;
+  // Compute the descriptor distances of all the candidates at once
+  distances.resize(count);
+  lRegions.SquaredDescriptorDistances(i, &rRegions, &candidates[0], count, &distances[0]);
+  for (size_t k = 0; k < count; ++k)
+    dR.update(candidates[k], distances[k]);
+}
+
+/// Guided Matching (features + descriptors with distance ratio):
+///  Right features are indexed in a 2D grid. For each left feature, only the
+///  right features that are close to the transferred position (H * x_left) are tested.
+///   Keep the best corresponding points for the given model under the
+///   user specified distance ratio.
+/// ErrorArg must be the squared transfer distance in the right image
+///  (i.e homography::kernel::AsymmetricError).
+template<
+  typename ErrorArg> // The metric to compute distance to the model
+void GuidedMatching_Homography_Grid(
+  const Mat3 & H,       // The homography (left to right)
+  const cameras::IntrinsicBase * camL, // Optional camera (in order to undistord on the fly feature positions, can be NULL)
+  const features::Regions & lRegions,  // regions (point features & corresponding descriptors)
+  const cameras::IntrinsicBase * camR, // Optional camera (in order to undistord on the fly feature positions, can be NULL)
+  const features::Regions & rRegions,  // regions (point features & corresponding descriptors)
+  double errorTh,       // Maximal authorized error threshold (consider it's a square threshold)
+  double distRatio,     // Maximal authorized distance ratio
+  IndMatches & vec_corresponding_index) // Ouput corresponding index
+{
+  // Build region positions arrays (in order to un-distord on-demand point position once)
+  std::vector<Vec2>
+    lRegionsPos(lRegions.RegionCount()),
+    rRegionsPos(rRegions.RegionCount());
+  for (size_t i = 0; i < lRegions.RegionCount(); ++i) {
+    lRegionsPos[i] = camL ? camL->get_ud_pixel(lRegions.GetRegionPosition(i)) : lRegions.GetRegionPosition(i);
+  }
+  for (size_t i = 0; i < rRegions.RegionCount(); ++i) {
+    rRegionsPos[i] = camR ? camR->get_ud_pixel(rRegions.GetRegionPosition(i)) : rRegions.GetRegionPosition(i);
+  }
+
+  const double radius = sqrt(errorTh);
+  const PointGrid2D grid(rRegionsPos, 2.0 * radius);
+
+  std::vector<IndexT> candidates;
+  std::vector<double> distances;
+  for (size_t i = 0; i < lRegions.RegionCount(); ++i) {
+
+    const Vec3 x_transfer = H * lRegionsPos[i].homogeneous();
+    if (x_transfer(2) == 0.0)
+      continue;
+
+    candidates.clear();
+    grid.queryDisc(x_transfer.head<2>() / x_transfer(2), radius, candidates);
+
+    distanceRatio<double> dR;
+    UpdateGuidedCandidates<Mat3, ErrorArg>(
+      H, lRegions, lRegionsPos, rRegions, rRegionsPos, i, errorTh,
+      candidates, distances, dR);
+    // Add correspondence only iff the distance ratio is valid
+    if (dR.isValid(distRatio))  {
+      // save the best corresponding index
+      vec_corresponding_index.push_back(IndMatch(i,dR.idx));
+    }
+  }
+
+  // Remove duplicates (when multiple points at same position exist)
+  IndMatch::getDeduplicated(vec_corresponding_index);
+}
+
+/// Guided Matching (features + descriptors with distance ratio):
+///  Right features are indexed in a 2D grid. For each left feature, only the
+///  right features of the cells crossed by the epipolar band are tested.
+///   Keep the best corresponding points for the given model under the
+///   user specified distance ratio.
+/// ErrorArg must be the squared point to epipolar line distance in the right image
+///  (i.e fundamental::kernel::EpipolarDistanceError).
+template<
+  typename ErrorArg> // The metric to compute distance to the model
+void GuidedMatching_Fundamental_Grid(
+  const Mat3 & F,       // The fundamental matrix
+  const cameras::IntrinsicBase * camL, // Optional camera (in order to undistord on the fly feature positions, can be NULL)
+  const features::Regions & lRegions,  // regions (point features & corresponding descriptors)
+  const cameras::IntrinsicBase * camR, // Optional camera (in order to undistord on the fly feature positions, can be NULL)
+  const features::Regions & rRegions,  // regions (point features & corresponding descriptors)
+  double errorTh,       // Maximal authorized error threshold (consider it's a square threshold)
+  double distRatio,     // Maximal authorized distance ratio
+  IndMatches & vec_corresponding_index) // Ouput corresponding index
+{
+  // Build region positions arrays (in order to un-distord on-demand point position once)
+  std::vector<Vec2>
+    lRegionsPos(lRegions.RegionCount()),
+    rRegionsPos(rRegions.RegionCount());
+  for (size_t i = 0; i < lRegions.RegionCount(); ++i) {
+    lRegionsPos[i] = camL ? camL->get_ud_pixel(lRegions.GetRegionPosition(i)) : lRegions.GetRegionPosition(i);
+  }
+  for (size_t i = 0; i < rRegions.RegionCount(); ++i) {
+    rRegionsPos[i] = camR ? camR->get_ud_pixel(rRegions.GetRegionPosition(i)) : rRegions.GetRegionPosition(i);
+  }
+
+  const double half_width = sqrt(errorTh);
+  const PointGrid2D grid(rRegionsPos, 2.0 * half_width);
+
+  std::vector<IndexT> candidates;
+  std::vector<double> distances;
+  for (size_t i = 0; i < lRegions.RegionCount(); ++i) {
+
+    // Epipolar line of the left point in the right image
+    candidates.clear();
+    grid.queryBand(F * lRegionsPos[i].homogeneous(), half_width, candidates);
+
+    distanceRatio<double> dR;
+    UpdateGuidedCandidates<Mat3, ErrorArg>(
+      F, lRegions, lRegionsPos, rRegions, rRegionsPos, i, errorTh,
+      candidates, distances, dR);
+    // Add correspondence only iff the distance ratio is valid
+    if (dR.isValid(distRatio))  {
+      // save the best corresponding index
+      vec_corresponding_index.push_back(IndMatch(i,dR.idx));
+    }
+  }
+
+  // Remove duplicates (when multiple points at same position exist)
+  IndMatch::getDeduplicated(vec_corresponding_index);
+}
+
 } // namespace geometry_aware
 } // namespace openMVG
 #endif // OPENMVG_ROBUST_ESTIMATION_GUIDED_MATCHING_H_
@@ -0,0 +1,145 @@
+// Copyright (c) 2015 Pierre MOULON.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "openMVG/robust_estimation/guided_matching.hpp"
+#include "openMVG/features/regions_factory.hpp"
+#include "openMVG/multiview/solver_homography_kernel.hpp"
+#include "openMVG/multiview/solver_fundamental_kernel.hpp"
+
+#include "testing/testing.h"
+
+#include <algorithm>
+
+using namespace openMVG;
+using namespace openMVG::features;
+using namespace openMVG::geometry_aware;
+
+// Create random regions in a (1000 x 800) image
+// and regions with perturbed positions & descriptors in another image
+template <typename TransferFunctor>
+void CreateRegions
+(
+  const TransferFunctor & transfer,
+  AKAZE_Float_Regions & lRegions,
+  AKAZE_Float_Regions & rRegions
+)
+{
+  std::srand(0);
+  for (int i = 0; i < 500; ++i)
+  {
+    const Vec2 x = (Vec2::Random() + Vec2::Ones()).cwiseProduct(Vec2(500, 400));
+    const Vec2 y = transfer(x) + Vec2::Random() * 0.5;
+    lRegions.Features().push_back(SIOPointFeature(x(0), x(1)));
+    rRegions.Features().push_back(SIOPointFeature(y(0), y(1)));
+
+    AKAZE_Float_Regions::DescriptorT desc, desc_noisy;
+    for (int k = 0; k < AKAZE_Float_Regions::DescriptorT::static_size; ++k)
+    {
+      desc[k] = std::rand() / static_cast<float>(RAND_MAX);
+      desc_noisy[k] = desc[k] + 0.01f * std::rand() / static_cast<float>(RAND_MAX);
+    }
+    lRegions.Descriptors().push_back(desc);
+    rRegions.Descriptors().push_back(desc_noisy);
+  }
+}
+
+struct HomographyTransfer
+{
+  Mat3 H;
+  Vec2 operator()(const Vec2 & x) const
+  {
+    const Vec3 y = H * Vec3(x(0), x(1), 1.0);
+    return y.head<2>() / y(2);
+  }
+};
+
+// The right point is a translation of the left point along the epipolar line
+struct FundamentalTransfer
+{
+  Vec2 operator()(const Vec2 & x) const
+  {
+    return x + Vec2(20.0 + x(0) * 0.1, 0.0);
+  }
+};
+
+bool SameMatches(IndMatches matches_a, IndMatches matches_b)
+{
+  std::sort(matches_a.begin(), matches_a.end());
+  std::sort(matches_b.begin(), matches_b.end());
+  return matches_a == matches_b;
+}
+
+//-----------------
+// Test summary:
+//-----------------
+// - Check that the grid based homography guided matching finds the same
+//    correspondences as the exhaustive guided matching
+//-----------------
+TEST(GuidedMatching, Homography_Grid)
+{
+  HomographyTransfer transfer;
+  transfer.H << 1.1, 0.05, 20,
+                -0.02, 0.95, -15,
+                1e-5, 2e-5, 1;
+
+  AKAZE_Float_Regions lRegions, rRegions;
+  CreateRegions(transfer, lRegions, rRegions);
+
+  // Use a large threshold to have several candidates per point
+  //  (the distance ratio requires at least two candidates)
+  const double errorTh = Square(40.0);
+  IndMatches exhaustive_matches, grid_matches;
+  GuidedMatching<Mat3, homography::kernel::AsymmetricError>(
+    transfer.H, NULL, lRegions, NULL, rRegions, errorTh, Square(0.8), exhaustive_matches);
+  GuidedMatching_Homography_Grid<homography::kernel::AsymmetricError>(
+    transfer.H, NULL, lRegions, NULL, rRegions, errorTh, Square(0.8), grid_matches);
+
+  EXPECT_TRUE(exhaustive_matches.size() > 400);
+  EXPECT_TRUE(SameMatches(exhaustive_matches, grid_matches));
+}
+
+//-----------------
+// Test summary:
+//-----------------
+// - Check that the grid based fundamental guided matching finds the same
+//    correspondences as the exhaustive guided matching
+//-----------------
+TEST(GuidedMatching, Fundamental_Grid)
+{
+  // Pure translation along X: epipolar lines are the image rows
+  Mat3 F;
+  F << 0, 0, 0,
+       0, 0, -1,
+       0, 1, 0;
+
+  AKAZE_Float_Regions lRegions, rRegions;
+  CreateRegions(FundamentalTransfer(), lRegions, rRegions);
+
+  const double errorTh = Square(2.0);
+  IndMatches exhaustive_matches, grid_matches;
+  GuidedMatching<Mat3, fundamental::kernel::EpipolarDistanceError>(
+    F, NULL, lRegions, NULL, rRegions, errorTh, Square(0.8), exhaustive_matches);
+  GuidedMatching_Fundamental_Grid<fundamental::kernel::EpipolarDistanceError>(
+    F, NULL, lRegions, NULL, rRegions, errorTh, Square(0.8), grid_matches);
+
+  EXPECT_TRUE(exhaustive_matches.size() > 400);
+  EXPECT_TRUE(SameMatches(exhaustive_matches, grid_matches));
+
+  // Same test with a rotated epipolar geometry (non axis aligned lines)
+  const Mat3 R = Eigen::AngleAxisd(0.3, Vec3::UnitZ()).toRotationMatrix();
+  const Mat3 F_rotated = R.transpose() * F * R;
+  exhaustive_matches.clear();
+  grid_matches.clear();
+  GuidedMatching<Mat3, fundamental::kernel::EpipolarDistanceError>(
+    F_rotated, NULL, lRegions, NULL, rRegions, errorTh, Square(0.8), exhaustive_matches);
+  GuidedMatching_Fundamental_Grid<fundamental::kernel::EpipolarDistanceError>(
+    F_rotated, NULL, lRegions, NULL, rRegions, errorTh, Square(0.8), grid_matches);
+  EXPECT_TRUE(SameMatches(exhaustive_matches, grid_matches));
+}
+
+/* ************************************************************************* */
+int main() { TestResult tr; return TestRegistry::runAllTests(tr);}
+/* ************************************************************************* */
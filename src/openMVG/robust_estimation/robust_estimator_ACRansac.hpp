@@ -156,6 +156,9 @@ std::pair<double, double> ACRANSAC(const Kernel &kernel,
   std::vector<ErrorIndex> vec_residuals(nData); // [residual,index]
   std::vector<double> vec_residuals_(nData);
   std::vector<size_t> vec_sample(sizeSample); // Sample indices
+  // Up to max_models solutions (the buffer is reused across the iterations)
+  std::vector<typename Kernel::Model> vec_models;
+  vec_models.reserve(Kernel::MAX_MODELS);
 
   // Possible sampling indices [0,..,nData] (will change in the optimization phase)
   std::vector<size_t> vec_index(nData);
@@ -179,7 +182,7 @@ std::pair<double, double> ACRANSAC(const Kernel &kernel,
   for (size_t iter=0; iter < nIter; ++iter) {
     UniformSample(sizeSample, vec_index, &vec_sample); // Get random sample
 
-    std::vector<typename Kernel::Model> vec_models; // Up to max_models solutions
+    vec_models.clear();
     kernel.Fit(vec_sample, &vec_models);
 
     // Evaluate models
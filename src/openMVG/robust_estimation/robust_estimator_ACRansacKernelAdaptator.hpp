@@ -26,10 +26,95 @@
 // Mainly it add correct data normalization and define the function required
 //  by the generic ACRANSAC routine.
 //
+// The correspondences used for the residual evaluation are stored as
+//  structure of arrays (RMat2X, RMat3X): the error functors providing a
+//  static Errors(model, x1, x2, double * errors) function are evaluated on all
+//  the correspondences at once (vectorized), the others one by one (Error).
+//
+
+#include <type_traits>
+#include <vector>
 
 namespace openMVG {
 namespace robust{
 
+/// Run the solver on the sampled columns of x1 and x2.
+/// Minimal samples are copied in compile time sized matrices: the minimal
+///  solvers (taking Eigen::Ref inputs) then run without any heap allocation.
+template <typename Solver, int Dim1, int Dim2, typename TMat1, typename TMat2, typename Model>
+void SolveOnSamples
+(
+  const TMat1 & x1, const TMat2 & x2,
+  const std::vector<size_t> & samples,
+  std::vector<Model> * models
+)
+{
+  if (samples.size() == static_cast<size_t>(Solver::MINIMUM_SAMPLES))
+  {
+    Eigen::Matrix<double, Dim1, Solver::MINIMUM_SAMPLES> x1_sample;
+    Eigen::Matrix<double, Dim2, Solver::MINIMUM_SAMPLES> x2_sample;
+    ExtractColumns(x1, samples, &x1_sample);
+    ExtractColumns(x2, samples, &x2_sample);
+    Solver::Solve(x1_sample, x2_sample, models);
+  }
+  else
+  {
+    Mat x1_sample(Dim1, samples.size()), x2_sample(Dim2, samples.size());
+    ExtractColumns(x1, samples, &x1_sample);
+    ExtractColumns(x2, samples, &x2_sample);
+    Solver::Solve(x1_sample, x2_sample, models);
+  }
+}
+
+/// Tell at compile time if the error functor provides the vectorized
+///  residual evaluation: static void Errors(model, x1, x2, double * errors).
+template <typename ErrorT>
+struct HasBatchErrors
+{
+  template <typename U> static char test(decltype(&U::Errors));
+  template <typename U> static long test(...);
+  enum { value = sizeof(test<ErrorT>(nullptr)) == sizeof(char) };
+};
+
+/// Compute the residuals of all the correspondences with the vectorized
+///  ErrorT::Errors (structure of arrays layout).
+template <typename ErrorT, typename Model, typename TMat1, typename TMat2>
+void ComputeErrors
+(
+  const Model & model, const TMat1 & x1, const TMat2 & x2,
+  std::vector<double> & vec_errors, std::true_type
+)
+{
+  vec_errors.resize(x1.cols());
+  ErrorT::Errors(model, x1, x2, &vec_errors[0]);
+}
+
+/// Compute the residuals of all the correspondences one by one (ErrorT::Error).
+template <typename ErrorT, typename Model, typename TMat1, typename TMat2>
+void ComputeErrors
+(
+  const Model & model, const TMat1 & x1, const TMat2 & x2,
+  std::vector<double> & vec_errors, std::false_type
+)
+{
+  vec_errors.resize(x1.cols());
+  for (size_t sample = 0; sample < static_cast<size_t>(x1.cols()); ++sample)
+    vec_errors[sample] = ErrorT::Error(model, x1.col(sample), x2.col(sample));
+}
+
+/// Compute the residuals of all the correspondences, the evaluation method is
+///  selected at compile time according to the error functor.
+template <typename ErrorT, typename Model, typename TMat1, typename TMat2>
+void ComputeErrors
+(
+  const Model & model, const TMat1 & x1, const TMat2 & x2,
+  std::vector<double> & vec_errors
+)
+{
+  ComputeErrors<ErrorT>(model, x1, x2, vec_errors,
+    std::integral_constant<bool, HasBatchErrors<ErrorT>::value>());
+}
+
 /// Two view Kernel adapter for the A contrario model estimator
 /// Handle data normalization and compute the corresponding logalpha 0
 ///  that depends of the error model (point to line, or point to point)
@@ -49,15 +134,17 @@ public:
   ACKernelAdaptor(
     const Mat &x1, int w1, int h1,
     const Mat &x2, int w2, int h2, bool bPointToLine = true)
-    : x1_(x1.rows(), x1.cols()), x2_(x2.rows(), x2.cols()),
-    N1_(3,3), N2_(3,3), logalpha0_(0.0), bPointToLine_(bPointToLine)
+    : N1_(3,3), N2_(3,3), logalpha0_(0.0), bPointToLine_(bPointToLine)
   {
-    assert(2 == x1_.rows());
-    assert(x1_.rows() == x2_.rows());
-    assert(x1_.cols() == x2_.cols());
+    assert(2 == x1.rows());
+    assert(x1.rows() == x2.rows());
+    assert(x1.cols() == x2.cols());
 
-    NormalizePoints(x1, &x1_, &N1_, w1, h1);
-    NormalizePoints(x2, &x2_, &N2_, w2, h2);
+    Mat x1_normalized, x2_normalized;
+    NormalizePoints(x1, &x1_normalized, &N1_, w1, h1);
+    NormalizePoints(x2, &x2_normalized, &N2_, w2, h2);
+    x1_ = x1_normalized;
+    x2_ = x2_normalized;
 
     // LogAlpha0 is used to make error data scale invariant
     if(bPointToLine)  {
@@ -76,9 +163,7 @@ public:
   enum { MAX_MODELS = Solver::MAX_MODELS };
 
   void Fit(const std::vector<size_t> &samples, std::vector<Model> *models) const {
-    const Mat x1 = ExtractColumns(x1_, samples);
-    const Mat x2 = ExtractColumns(x2_, samples);
-    Solver::Solve(x1, x2, models);
+    SolveOnSamples<Solver, 2, 2>(x1_, x2_, samples, models);
   }
 
   double Error(size_t sample, const Model &model) const {
@@ -87,9 +172,7 @@ public:
 
   void Errors(const Model & model, std::vector<double> & vec_errors) const
   {
-    vec_errors.resize(x1_.cols());
-    for (size_t sample = 0; sample < x1_.cols(); ++sample)
-      vec_errors[sample] = ErrorT::Error(model, x1_.col(sample), x2_.col(sample));
+    ComputeErrors<ErrorT>(model, x1_, x2_, vec_errors);
   }
 
   size_t NumSamples() const {
@@ -110,7 +193,7 @@ public:
   double unormalizeError(double val) const {return sqrt(val) / N2_(0,0);}
 
 private:
-  Mat x1_, x2_;       // Normalized input data
+  RMat2X x1_, x2_;    // Normalized input data
   Mat3 N1_, N2_;      // Matrix used to normalize data
   double logalpha0_; // Alpha0 is used to make the error adaptive to the image size
   bool bPointToLine_;// Store if error model is pointToLine or point to point
@@ -135,23 +218,22 @@ public:
   typedef ErrorArg ErrorT;
 
   ACKernelAdaptorResection(const Mat &x2d, int w, int h, const Mat &x3D)
-    : x2d_(x2d.rows(), x2d.cols()), x3D_(x3D),
-    N1_(3,3), logalpha0_(log10(M_PI))
+    : x3D_(x3D), N1_(3,3), logalpha0_(log10(M_PI))
   {
-    assert(2 == x2d_.rows());
-    assert(3 == x3D_.rows());
-    assert(x2d_.cols() == x3D_.cols());
+    assert(2 == x2d.rows());
+    assert(3 == x3D.rows());
+    assert(x2d.cols() == x3D.cols());
 
-    NormalizePoints(x2d, &x2d_, &N1_, w, h);
+    Mat x2d_normalized;
+    NormalizePoints(x2d, &x2d_normalized, &N1_, w, h);
+    x2d_ = x2d_normalized;
   }
 
   enum { MINIMUM_SAMPLES = Solver::MINIMUM_SAMPLES };
   enum { MAX_MODELS = Solver::MAX_MODELS };
 
   void Fit(const std::vector<size_t> &samples, std::vector<Model> *models) const {
-    const Mat x1 = ExtractColumns(x2d_, samples);
-    const Mat x2 = ExtractColumns(x3D_, samples);
-    Solver::Solve(x1, x2, models);
+    SolveOnSamples<Solver, 2, 3>(x2d_, x3D_, samples, models);
   }
 
   double Error(int sample, const Model &model) const {
@@ -160,9 +242,7 @@ public:
 
   void Errors(const Model & model, std::vector<double> & vec_errors) const
   {
-    vec_errors.resize(x2d_.cols());
-    for (size_t sample = 0; sample < x2d_.cols(); ++sample)
-      vec_errors[sample] = ErrorT::Error(model, x2d_.col(sample), x3D_.col(sample));
+    ComputeErrors<ErrorT>(model, x2d_, x3D_, vec_errors);
   }
 
   size_t NumSamples() const { return x2d_.cols(); }
@@ -179,8 +259,8 @@ public:
   double unormalizeError(double val) const {return sqrt(val) / N1_(0,0);}
 
 private:
-  Mat x2d_;
-  const Mat & x3D_;
+  RMat2X x2d_;
+  RMat3X x3D_;
   Mat3 N1_;      // Matrix used to normalize data
   double logalpha0_; // Alpha0 is used to make the error adaptive to the image size
 };
@@ -199,25 +279,25 @@ public:
   typedef ErrorArg ErrorT;
 
   ACKernelAdaptorResection_K(const Mat &x2d, const Mat &x3D, const Mat3 & K)
-    : x2d_(x2d.rows(), x2d.cols()), x3D_(x3D),
+    : x3D_(x3D),
     N1_(K.inverse()),
     logalpha0_(log10(M_PI)), K_(K)
   {
-    assert(2 == x2d_.rows());
-    assert(3 == x3D_.rows());
-    assert(x2d_.cols() == x3D_.cols());
+    assert(2 == x2d.rows());
+    assert(3 == x3D.rows());
+    assert(x2d.cols() == x3D.cols());
 
     // Normalize points by inverse(K)
-    ApplyTransformationToPoints(x2d, N1_, &x2d_);
+    Mat x2d_normalized;
+    ApplyTransformationToPoints(x2d, N1_, &x2d_normalized);
+    x2d_ = x2d_normalized;
   }
 
   enum { MINIMUM_SAMPLES = Solver::MINIMUM_SAMPLES };
   enum { MAX_MODELS = Solver::MAX_MODELS };
 
   void Fit(const std::vector<size_t> &samples, std::vector<Model> *models) const {
-    const Mat x1 = ExtractColumns(x2d_, samples);
-    const Mat x2 = ExtractColumns(x3D_, samples);
-    Solver::Solve(x1, x2, models);
+    SolveOnSamples<Solver, 2, 3>(x2d_, x3D_, samples, models);
   }
 
   double Error(size_t sample, const Model &model) const {
@@ -226,9 +306,7 @@ public:
 
   void Errors(const Model & model, std::vector<double> & vec_errors) const
   {
-    vec_errors.resize(x2d_.cols());
-    for (size_t sample = 0; sample < x2d_.cols(); ++sample)
-      vec_errors[sample] = ErrorT::Error(model, x2d_.col(sample), x3D_.col(sample));
+    ComputeErrors<ErrorT>(model, x2d_, x3D_, vec_errors);
   }
 
   size_t NumSamples() const { return x2d_.cols(); }
@@ -245,8 +323,8 @@ public:
   double unormalizeError(double val) const {return sqrt(val) / N1_(0,0);}
 
 private:
-  Mat x2d_;
-  const Mat & x3D_;
+  RMat2X x2d_;
+  RMat3X x3D_;
   Mat3 N1_;      // Matrix used to normalize data
   double logalpha0_; // Alpha0 is used to make the error adaptive to the image size
   Mat3 K_;            // Intrinsic camera parameter
@@ -276,8 +354,8 @@ public:
     assert(x1_.rows() == x2_.rows());
     assert(x1_.cols() == x2_.cols());
 
-    ApplyTransformationToPoints(x1_, K1_.inverse(), &x1k_);
-    ApplyTransformationToPoints(x2_, K2_.inverse(), &x2k_);
+    ApplyTransformationToPoints(x1, K1_.inverse(), &x1k_);
+    ApplyTransformationToPoints(x2, K2_.inverse(), &x2k_);
 
     //Point to line probability (line is the epipolar line)
     double D = sqrt(w2*(double)w2 + h2*(double)h2); // diameter
@@ -289,9 +367,7 @@ public:
   enum { MAX_MODELS = Solver::MAX_MODELS };
 
   void Fit(const std::vector<size_t> &samples, std::vector<Model> *models) const {
-    const Mat x1 = ExtractColumns(x1k_, samples);
-    const Mat x2 = ExtractColumns(x2k_, samples);
-    Solver::Solve(x1, x2, models);
+    SolveOnSamples<Solver, 2, 2>(x1k_, x2k_, samples, models);
   }
 
   double Error(size_t sample, const Model &model) const {
@@ -304,9 +380,7 @@ public:
   {
     Mat3 F;
     FundamentalFromEssential(model, K1_, K2_, &F);
-    vec_errors.resize(x1_.cols());
-    for (size_t sample = 0; sample < x1_.cols(); ++sample)
-      vec_errors[sample] = ErrorT::Error(F, this->x1_.col(sample), this->x2_.col(sample));
+    ComputeErrors<ErrorT>(F, x1_, x2_, vec_errors);
   }
 
   size_t NumSamples() const { return x1_.cols(); }
@@ -318,7 +392,8 @@ public:
   double unormalizeError(double val) const { return val; }
 
 private:
-  Mat x1_, x2_, x1k_, x2k_; // image point and camera plane point.
+  RMat2X x1_, x2_; // image point
+  Mat x1k_, x2k_;   // camera plane point
   Mat3 N1_, N2_;      // Matrix used to normalize data
   double logalpha0_; // Alpha0 is used to make the error adaptive to the image size
   Mat3 K1_, K2_;      // Intrinsic camera parameter
@@ -352,9 +427,7 @@ public:
   enum { MAX_MODELS = Solver::MAX_MODELS };
 
   void Fit(const std::vector<size_t> &samples, std::vector<Model> *models) const {
-    const Mat x1 = ExtractColumns(x1_, samples);
-    const Mat x2 = ExtractColumns(x2_, samples);
-    Solver::Solve(x1, x2, models);
+    SolveOnSamples<Solver, 3, 3>(x1_, x2_, samples, models);
   }
 
   double Error(size_t sample, const Model &model) const {
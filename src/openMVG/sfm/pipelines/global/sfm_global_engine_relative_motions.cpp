@@ -32,7 +32,8 @@ GlobalSfMReconstructionEngine_RelativeMotions::GlobalSfMReconstructionEngine_Rel
   const SfM_Data & sfm_data,
   const std::string & soutDirectory,
   const std::string & sloggingFile)
-  : ReconstructionEngine(sfm_data, soutDirectory), _sLoggingFile(sloggingFile), _normalized_features_provider(NULL) {
+  : ReconstructionEngine(sfm_data, soutDirectory), _sLoggingFile(sloggingFile),
+  _relative_pose_cache(NULL), _normalized_features_provider(NULL) {
 
   if (!_sLoggingFile.empty())
   {
@@ -96,6 +97,11 @@ void GlobalSfMReconstructionEngine_RelativeMotions::SetMatchesProvider(Matches_P
   _matches_provider = provider;
 }
 
+void GlobalSfMReconstructionEngine_RelativeMotions::SetRelativePoseCache(RelativePose_Cache * cache)
+{
+  _relative_pose_cache = cache;
+}
+
 void GlobalSfMReconstructionEngine_RelativeMotions::SetRotationAveragingMethod
 (
   ERotationAveragingMethod eRotationAveragingMethod
@@ -549,62 +555,18 @@ void GlobalSfMReconstructionEngine_RelativeMotions::Compute_Relative_Rotations
       const std::pair<size_t, size_t> imageSize_I(1., 1.), imageSize_J(1.,1.);
       const Mat3 K  = Mat3::Identity();
 
-      if (!robustRelativePose(K, K, x1, x2, relativePose_info, imageSize_I, imageSize_J, 256))
+      const bool bRelativePose = _relative_pose_cache ?
+        _relative_pose_cache->robustRelativePose(pairIterator,
+          K, K, x1, x2, relativePose_info, imageSize_I, imageSize_J, 256) :
+        robustRelativePose(K, K, x1, x2, relativePose_info, imageSize_I, imageSize_J, 256);
+      if (!bRelativePose)
       {
         continue;
       }
-      bool bRefine_using_BA = true;
-      if (bRefine_using_BA)
-      {
-        // Refine the defined scene
-        SfM_Data tiny_scene;
-        tiny_scene.views.insert(*_sfm_data.GetViews().find(view_I->id_view));
-        tiny_scene.views.insert(*_sfm_data.GetViews().find(view_J->id_view));
-        tiny_scene.intrinsics.insert(*_sfm_data.GetIntrinsics().find(view_I->id_intrinsic));
-        tiny_scene.intrinsics.insert(*_sfm_data.GetIntrinsics().find(view_J->id_intrinsic));
-
-        // Init poses
-        const Pose3 & Pose_I = tiny_scene.poses[view_I->id_pose] = Pose3(Mat3::Identity(), Vec3::Zero());
-        const Pose3 & Pose_J = tiny_scene.poses[view_J->id_pose] = relativePose_info.relativePose;
-
-        // Init structure
-        const Mat34 P1 = cam_I->get_projective_equivalent(Pose_I);
-        const Mat34 P2 = cam_J->get_projective_equivalent(Pose_J);
-        Landmarks & landmarks = tiny_scene.structure;
-        for (size_t k = 0; k < x1.cols(); ++k) {
-          const Vec2 x1_ = _features_provider->feats_per_view[I][matches[k]._i].coords().cast<double>();
-          const Vec2 x2_ = _features_provider->feats_per_view[J][matches[k]._j].coords().cast<double>();
-          Vec3 X;
-          TriangulateDLT(P1, x1_, P2, x2_, &X);
-          Observations obs;
-          obs[view_I->id_view] = Observation(x1_, matches[k]._i);
-          obs[view_J->id_view] = Observation(x2_, matches[k]._j);
-          landmarks[k].obs = obs;
-          landmarks[k].X = X;
-        }
-        // - refine only Structure and Rotations & translations (keep intrinsic constant)
-        Bundle_Adjustment_Ceres::BA_options options(false, false);
-        options._linear_solver_type = ceres::DENSE_SCHUR;
-        Bundle_Adjustment_Ceres bundle_adjustment_obj(options);
-        if (bundle_adjustment_obj.Adjust(tiny_scene, true, true, false))
-        {
-          // --> to debug: save relative pair geometry on disk
-          // std::ostringstream os;
-          // os << relative_pose_pair.first << "_" << relative_pose_pair.second << ".ply";
-          // Save(tiny_scene, os.str(), ESfM_Data(STRUCTURE | EXTRINSICS));
-          //
-          const Mat3 R1 = tiny_scene.poses[view_I->id_pose].rotation();
-          const Mat3 R2 = tiny_scene.poses[view_J->id_pose].rotation();
-          const Vec3 t1 = tiny_scene.poses[view_I->id_pose].translation();
-          const Vec3 t2 = tiny_scene.poses[view_J->id_pose].translation();
-          // Compute relative motion and save it
-          Mat3 Rrel;
-          Vec3 trel;
-          RelativeCameraMotion(R1, t1, R2, t2, &Rrel, &trel);
-          // Update found relative pose
-          relativePose_info.relativePose = Pose3(Rrel, -Rrel.transpose() * trel);
-        }
-      }
+      // Refine the relative pose (Sampson error over the inliers, the features are normalized)
+      refineRelativePose(x1, x2, relativePose_info.vec_inliers,
+        relativePose_info.relativePose, relativePose_info.found_residual_precision);
+
 #ifdef OPENMVG_USE_OPENMP
       #pragma omp critical
 #endif
@@ -9,6 +9,7 @@
 #define OPENMVG_SFM_GLOBAL_ENGINE_RELATIVE_MOTIONS_HPP
 
 #include "openMVG/sfm/pipelines/sfm_engine.hpp"
+#include "openMVG/sfm/pipelines/sfm_relative_pose_cache.hpp"
 
 #include "openMVG/sfm/pipelines/global/GlobalSfM_rotation_averaging.hpp"
 #include "openMVG/sfm/pipelines/global/GlobalSfM_translation_averaging.hpp"
@@ -32,6 +33,8 @@ public:
 
   void SetFeaturesProvider(Features_Provider * provider);
   void SetMatchesProvider(Matches_Provider * provider);
+  /// Use (and fill) a relative pose cache for the relative rotation estimation
+  void SetRelativePoseCache(RelativePose_Cache * cache);
 
   void SetRotationAveragingMethod(ERotationAveragingMethod eRotationAveragingMethod);
   void SetTranslationAveragingMethod(ETranslationAveragingMethod _eTranslationAveragingMethod);
@@ -84,6 +87,7 @@ private:
   //-- Data provider
   Features_Provider  * _features_provider;
   Matches_Provider  * _matches_provider;
+  RelativePose_Cache * _relative_pose_cache;
 
   std::shared_ptr<Features_Provider> _normalized_features_provider;
 };
@@ -41,7 +41,8 @@ SequentialSfMReconstructionEngine::SequentialSfMReconstructionEngine(
   : ReconstructionEngine(sfm_data, soutDirectory),
     _sLoggingFile(sloggingFile),
     _initialpair(Pair(0,0)),
-    _camType(EINTRINSIC(PINHOLE_CAMERA_RADIAL3))
+    _camType(EINTRINSIC(PINHOLE_CAMERA_RADIAL3)),
+    _relative_pose_cache(NULL)
 {
   if (!_sLoggingFile.empty())
   {
@@ -83,6 +84,11 @@ void SequentialSfMReconstructionEngine::SetMatchesProvider(Matches_Provider * pr
   _matches_provider = provider;
 }
 
+void SequentialSfMReconstructionEngine::SetRelativePoseCache(RelativePose_Cache * cache)
+{
+  _relative_pose_cache = cache;
+}
+
 bool SequentialSfMReconstructionEngine::Process() {
 
   //-------------------
@@ -419,11 +425,14 @@ bool SequentialSfMReconstructionEngine::AutomaticInitialPairChoice(Pair & initia
         RelativePose_Info relativePose_info;
         relativePose_info.initial_residual_tolerance = Square(4.0);
 
-        if (robustRelativePose(
-          cam_I->K(), cam_J->K(),
-          xI, xJ, relativePose_info,
-          std::make_pair(cam_I->w(), cam_I->h()), std::make_pair(cam_J->w(), cam_J->h()),
-          256) && relativePose_info.vec_inliers.size() > iMin_inliers_count)
+        const std::pair<size_t, size_t>
+          imageSize_I(cam_I->w(), cam_I->h()), imageSize_J(cam_J->w(), cam_J->h());
+        const bool bRelativePose = _relative_pose_cache ?
+          _relative_pose_cache->robustRelativePose(Pair(I, J),
+            cam_I->K(), cam_J->K(), xI, xJ, relativePose_info, imageSize_I, imageSize_J, 256) :
+          robustRelativePose(cam_I->K(), cam_J->K(),
+            xI, xJ, relativePose_info, imageSize_I, imageSize_J, 256);
+        if (bRelativePose && relativePose_info.vec_inliers.size() > iMin_inliers_count)
         {
           // Triangulate inliers & compute angle between bearing vectors
           std::vector<float> vec_angles;
@@ -543,10 +552,24 @@ bool SequentialSfMReconstructionEngine::MakeInitialPair3D(const Pair & current_p
   // Bound min precision at 1 pix.
   relativePose_info.found_residual_precision = std::max(relativePose_info.found_residual_precision, 1.0);
 
-  bool bRefine_using_BA = true;
-  if (bRefine_using_BA)
+  // Refine the relative pose (Sampson error over the inliers, in normalized coordinates)
+  //  before the bundle adjustment: the structure is triangulated from a better pose
+  {
+    Mat xI_n(2, xI.cols()), xJ_n(2, xJ.cols());
+    for (Mat::Index k = 0; k < xI.cols(); ++k)
+    {
+      xI_n.col(k) = cam_I->ima2cam(xI.col(k));
+      xJ_n.col(k) = cam_J->ima2cam(xJ.col(k));
+    }
+    const double huber_threshold = std::sqrt(
+      cam_I->imagePlane_toCameraPlaneError(relativePose_info.found_residual_precision) *
+      cam_J->imagePlane_toCameraPlaneError(relativePose_info.found_residual_precision));
+    refineRelativePose(xI_n, xJ_n, relativePose_info.vec_inliers,
+      relativePose_info.relativePose, huber_threshold);
+  }
+
   {
-    // Refine the defined scene
+    // Build the initial scene from the refined relative pose, then adjust it
     SfM_Data tiny_scene;
     tiny_scene.views.insert(*_sfm_data.GetViews().find(view_I->id_view));
     tiny_scene.views.insert(*_sfm_data.GetViews().find(view_J->id_view));
@@ -562,10 +585,11 @@ bool SequentialSfMReconstructionEngine::MakeInitialPair3D(const Pair & current_p
     const Mat34 P2 = cam_J->get_projective_equivalent(Pose_J);
     Landmarks & landmarks = tiny_scene.structure;
 
+    cptIndex = 0;
     for (openMVG::tracks::STLMAPTracks::const_iterator
       iterT = map_tracksCommon.begin();
       iterT != map_tracksCommon.end();
-      ++iterT)
+      ++iterT, ++cptIndex)
     {
       // Get corresponding points
       tracks::submapTrack::const_iterator iter = iterT->second.begin();
@@ -575,8 +599,9 @@ bool SequentialSfMReconstructionEngine::MakeInitialPair3D(const Pair & current_p
       const Vec2 x1_ = _features_provider->feats_per_view[I][i].coords().cast<double>();
       const Vec2 x2_ = _features_provider->feats_per_view[J][j].coords().cast<double>();
 
+      // Triangulate the undistorted points
       Vec3 X;
-      TriangulateDLT(P1, x1_, P2, x2_, &X);
+      TriangulateDLT(P1, xI.col(cptIndex), P2, xJ.col(cptIndex), &X);
       Observations obs;
       obs[view_I->id_view] = Observation(x1_, i);
       obs[view_J->id_view] = Observation(x2_, j);
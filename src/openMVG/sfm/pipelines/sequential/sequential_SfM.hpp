@@ -10,6 +10,7 @@
 #include "openMVG/sfm/pipelines/sfm_engine.hpp"
 #include "openMVG/sfm/pipelines/sfm_features_provider.hpp"
 #include "openMVG/sfm/pipelines/sfm_matches_provider.hpp"
+#include "openMVG/sfm/pipelines/sfm_relative_pose_cache.hpp"
 #include "openMVG/tracks/tracks.hpp"
 
 #include "third_party/htmlDoc/htmlDoc.hpp"
@@ -32,6 +33,8 @@ public:
 
   void SetFeaturesProvider(Features_Provider * provider);
   void SetMatchesProvider(Matches_Provider * provider);
+  /// Use (and fill) a relative pose cache for the automatic initial pair choice
+  void SetRelativePoseCache(RelativePose_Cache * cache);
 
   virtual bool Process();
 
@@ -98,6 +101,7 @@ private:
   //-- Data provider
   Features_Provider  * _features_provider;
   Matches_Provider  * _matches_provider;
+  RelativePose_Cache * _relative_pose_cache;
 
   // Temporary data
   openMVG::tracks::STLMAPTracks _map_tracks; // putative landmark tracks (visibility per 3D point)
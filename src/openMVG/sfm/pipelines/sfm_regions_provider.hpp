@@ -15,6 +15,7 @@
 #include "third_party/progress/progress.hpp"
 
 #include <memory>
+#include <set>
 
 namespace openMVG {
 namespace sfm {
@@ -27,12 +28,15 @@ struct Regions_Provider
   Hash_Map<IndexT, std::unique_ptr<features::Regions> > regions_per_view;
 
   // Load Regions related to a provided SfM_Data View container
+  // (if view_ids is not NULL, only the regions of these views are loaded:
+  //  an empty set loads no regions)
   virtual bool load(
     const SfM_Data & sfm_data,
     const std::string & feat_directory,
-    std::unique_ptr<features::Regions>& region_type)
+    std::unique_ptr<features::Regions>& region_type,
+    const std::set<IndexT> * view_ids = NULL)
   {
-    C_Progress_display my_progress_bar( sfm_data.GetViews().size(),
+    C_Progress_display my_progress_bar( view_ids ? view_ids->size() : sfm_data.GetViews().size(),
       std::cout, "\n- Regions Loading -\n");
     // Read for each view the corresponding regions and store them
     bool bContinue = true;
@@ -42,6 +46,8 @@ struct Regions_Provider
     for (Views::const_iterator iter = sfm_data.GetViews().begin();
       iter != sfm_data.GetViews().end() && bContinue; ++iter)
     {
+      if (view_ids && view_ids->count(iter->second.get()->id_view) == 0)
+        continue;
 #ifdef OPENMVG_USE_OPENMP
     #pragma omp single nowait
 #endif
@@ -0,0 +1,215 @@
+
+// Copyright (c) 2015 Pierre MOULON.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "openMVG/sfm/pipelines/sfm_relative_pose_cache.hpp"
+
+#include <cereal/archives/portable_binary.hpp>
+#include <cereal/types/map.hpp>
+#include <cereal/types/utility.hpp>
+#include <cereal/types/vector.hpp>
+
+#include <fstream>
+#include <iostream>
+
+namespace openMVG {
+namespace sfm {
+
+namespace {
+
+// Version of the cache file layout
+const uint32_t CACHE_VERSION = 1;
+
+// Accumulate a memory block in a FNV-1a hash
+void HashBytes(uint64_t & hash, const void * data, size_t size)
+{
+  const unsigned char * bytes = static_cast<const unsigned char *>(data);
+  for (size_t i = 0; i < size; ++i)
+  {
+    hash ^= bytes[i];
+    hash *= 1099511628211ull;
+  }
+}
+
+template <typename T>
+void HashValue(uint64_t & hash, const T & value)
+{
+  HashBytes(hash, &value, sizeof(T));
+}
+
+void HashMatrix(uint64_t & hash, const Mat & mat)
+{
+  HashValue(hash, static_cast<uint64_t>(mat.rows()));
+  HashValue(hash, static_cast<uint64_t>(mat.cols()));
+  HashBytes(hash, mat.data(), sizeof(double) * mat.size());
+}
+
+} // namespace
+
+template <class Archive>
+void RelativePose_Cache::Entry::serialize(Archive & ar)
+{
+  ar(bValid,
+     cereal::binary_data(relativePose_info.essential_matrix.data(), sizeof(double) * 9),
+     relativePose_info.relativePose,
+     relativePose_info.vec_inliers,
+     relativePose_info.initial_residual_tolerance,
+     relativePose_info.found_residual_precision,
+     last_session);
+}
+
+RelativePose_Cache::RelativePose_Cache()
+  : _session(0), _hit_count(0), _miss_count(0)
+{
+}
+
+bool RelativePose_Cache::Load(const std::string & filename)
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  _entries.clear();
+  _session = 0;
+
+  std::ifstream stream(filename.c_str(), std::ios::binary | std::ios::in);
+  if (!stream.is_open())
+    return true; // No cache yet
+
+  bool bOk = true;
+  try
+  {
+    cereal::PortableBinaryInputArchive archive(stream);
+    uint32_t version = 0;
+    archive(version);
+    if (version == CACHE_VERSION)
+      archive(_session, _entries);
+    else
+      bOk = false;
+  }
+  catch (const cereal::Exception & e)
+  {
+    std::cerr << e.what() << std::endl;
+    bOk = false;
+  }
+  if (!bOk)
+  {
+    std::cerr << "Invalid relative pose cache: " << filename << std::endl;
+    _entries.clear();
+    _session = 0;
+    return false;
+  }
+  ++_session;
+  return true;
+}
+
+bool RelativePose_Cache::Save(const std::string & filename) const
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+
+  Entries entries;
+  for (const auto & entry : _entries)
+  {
+    if (_session - entry.second.last_session < MAX_UNUSED_SESSIONS)
+      entries.insert(entries.end(), entry);
+  }
+
+  std::ofstream stream(filename.c_str(), std::ios::binary | std::ios::out);
+  if (!stream.is_open())
+    return false;
+  try
+  {
+    cereal::PortableBinaryOutputArchive archive(stream);
+    archive(CACHE_VERSION, _session, entries);
+  }
+  catch (const cereal::Exception & e)
+  {
+    std::cerr << e.what() << std::endl;
+    return false;
+  }
+  return stream.good();
+}
+
+bool RelativePose_Cache::robustRelativePose
+(
+  const Pair & pair,
+  const Mat3 & K1, const Mat3 & K2,
+  const Mat & x1, const Mat & x2,
+  RelativePose_Info & relativePose_info,
+  const std::pair<size_t, size_t> & size_ima1,
+  const std::pair<size_t, size_t> & size_ima2,
+  const size_t max_iteration_count
+)
+{
+  const std::pair<Pair, uint64_t> key(pair,
+    Hash(K1, K2, x1, x2, relativePose_info.initial_residual_tolerance,
+      size_ima1, size_ima2, max_iteration_count));
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    const Entries::iterator it = _entries.find(key);
+    if (it != _entries.end())
+    {
+      ++_hit_count;
+      it->second.last_session = _session;
+      relativePose_info = it->second.relativePose_info;
+      return it->second.bValid;
+    }
+  }
+
+  // Not in the cache: run the estimation (outside of the lock)
+  Entry entry;
+  entry.bValid = sfm::robustRelativePose(K1, K2, x1, x2, relativePose_info,
+    size_ima1, size_ima2, max_iteration_count);
+  entry.relativePose_info = relativePose_info;
+
+  std::lock_guard<std::mutex> lock(_mutex);
+  ++_miss_count;
+  entry.last_session = _session;
+  _entries[key] = entry;
+  return entry.bValid;
+}
+
+uint64_t RelativePose_Cache::Hash
+(
+  const Mat3 & K1, const Mat3 & K2,
+  const Mat & x1, const Mat & x2,
+  const double initial_residual_tolerance,
+  const std::pair<size_t, size_t> & size_ima1,
+  const std::pair<size_t, size_t> & size_ima2,
+  const size_t max_iteration_count
+)
+{
+  uint64_t hash = 14695981039346656037ull; // FNV-1a offset basis
+  HashBytes(hash, K1.data(), sizeof(double) * 9);
+  HashBytes(hash, K2.data(), sizeof(double) * 9);
+  HashMatrix(hash, x1);
+  HashMatrix(hash, x2);
+  HashValue(hash, initial_residual_tolerance);
+  HashValue(hash, static_cast<uint64_t>(size_ima1.first));
+  HashValue(hash, static_cast<uint64_t>(size_ima1.second));
+  HashValue(hash, static_cast<uint64_t>(size_ima2.first));
+  HashValue(hash, static_cast<uint64_t>(size_ima2.second));
+  HashValue(hash, static_cast<uint64_t>(max_iteration_count));
+  return hash;
+}
+
+size_t RelativePose_Cache::size() const
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _entries.size();
+}
+
+size_t RelativePose_Cache::hit_count() const
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _hit_count;
+}
+
+size_t RelativePose_Cache::miss_count() const
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _miss_count;
+}
+
+} // namespace sfm
+} // namespace openMVG
@@ -0,0 +1,107 @@
+
+// Copyright (c) 2015 Pierre MOULON.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef OPENMVG_SFM_RELATIVE_POSE_CACHE_HPP
+#define OPENMVG_SFM_RELATIVE_POSE_CACHE_HPP
+
+#include "openMVG/types.hpp"
+#include "openMVG/sfm/pipelines/sfm_robust_model_estimation.hpp"
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+
+namespace openMVG {
+namespace sfm {
+
+/**
+* @brief On-disk cache of the robust relative pose estimations.
+*
+* The robustRelativePose results (relative pose, inliers and a contrario
+*  thresholds) are stored per view pair, along with a hash of the estimation
+*  inputs (point correspondences, intrinsics, image sizes and thresholds).
+* A cached result is used only if the hash is the same: a change of the
+*  matches, of the features or of the intrinsics invalidates it.
+* The entries unused during the last MAX_UNUSED_SESSIONS sessions (a session
+*  is a Load/Save cycle) are discarded when the cache is saved.
+* The cache can be shared by the global and the sequential pipelines and used
+*  concurrently from several threads.
+*/
+class RelativePose_Cache
+{
+public:
+
+  enum { MAX_UNUSED_SESSIONS = 4 };
+
+  RelativePose_Cache();
+
+  /// Load the cache (a missing file is an empty cache)
+  bool Load(const std::string & filename);
+
+  /// Save the cache (entries unused during the last sessions are discarded)
+  bool Save(const std::string & filename) const;
+
+  /**
+  * @brief Same as robustRelativePose(), but the estimation runs only if the
+  *  cache does not contain its result for the same inputs.
+  *
+  * @param[in] pair view indexes of the estimation (the cache key)
+  * (other parameters: see robustRelativePose())
+  */
+  bool robustRelativePose
+  (
+    const Pair & pair,
+    const Mat3 & K1, const Mat3 & K2,
+    const Mat & x1, const Mat & x2,
+    RelativePose_Info & relativePose_info,
+    const std::pair<size_t, size_t> & size_ima1,
+    const std::pair<size_t, size_t> & size_ima2,
+    const size_t max_iteration_count = 4096
+  );
+
+  /// Hash of the robustRelativePose inputs
+  static uint64_t Hash
+  (
+    const Mat3 & K1, const Mat3 & K2,
+    const Mat & x1, const Mat & x2,
+    const double initial_residual_tolerance,
+    const std::pair<size_t, size_t> & size_ima1,
+    const std::pair<size_t, size_t> & size_ima2,
+    const size_t max_iteration_count
+  );
+
+  size_t size() const;
+  size_t hit_count() const;
+  size_t miss_count() const;
+
+private:
+
+  struct Entry
+  {
+    bool bValid; // robustRelativePose result
+    RelativePose_Info relativePose_info;
+    uint32_t last_session; // last session that used this entry
+
+    template <class Archive>
+    void serialize(Archive & ar);
+  };
+
+  // Cache key: (pair, hash of the estimation inputs)
+  typedef std::map<std::pair<Pair, uint64_t>, Entry> Entries;
+
+  Entries _entries;
+  uint32_t _session;
+  size_t _hit_count, _miss_count;
+  mutable std::mutex _mutex;
+};
+
+} // namespace sfm
+} // namespace openMVG
+
+#endif // OPENMVG_SFM_RELATIVE_POSE_CACHE_HPP
@@ -0,0 +1,66 @@
+
+// Copyright (c) 2015 Pierre MOULON.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "openMVG/sfm/pipelines/sfm_relative_pose_cache.hpp"
+#include "openMVG/multiview/test_data_sets.hpp"
+#include "testing/testing.h"
+
+#include <cstdio>
+
+using namespace openMVG;
+using namespace openMVG::sfm;
+
+TEST(RelativePose_Cache, HitMissSaveLoad)
+{
+  const nViewDatasetConfigurator config(1000, 1000, 500, 500, 5, 0);
+  const NViewDataSet d = NRealisticCamerasRing(2, 100, config);
+  const Mat3 K = d._K[0];
+  Mat x1 = d._x[0], x2 = d._x[1];
+  const std::pair<size_t, size_t> size_ima(1000, 1000);
+  const std::string filename = "relative_pose_cache_test.bin";
+
+  RelativePose_Info info_miss, info_hit;
+  {
+    RelativePose_Cache cache;
+    EXPECT_TRUE(cache.Load(filename + ".missing")); // no file: empty cache
+    EXPECT_TRUE(cache.robustRelativePose(Pair(0,1), K, K, x1, x2, info_miss, size_ima, size_ima));
+    EXPECT_EQ(0, cache.hit_count());
+    EXPECT_EQ(1, cache.miss_count());
+
+    EXPECT_TRUE(cache.robustRelativePose(Pair(0,1), K, K, x1, x2, info_hit, size_ima, size_ima));
+    EXPECT_EQ(1, cache.hit_count());
+    EXPECT_EQ(1, cache.miss_count());
+    EXPECT_TRUE(info_miss.vec_inliers == info_hit.vec_inliers);
+    EXPECT_MATRIX_NEAR(info_miss.essential_matrix, info_hit.essential_matrix, 1e-12);
+    EXPECT_TRUE(cache.Save(filename));
+  }
+  {
+    RelativePose_Cache cache;
+    EXPECT_TRUE(cache.Load(filename));
+    EXPECT_EQ(1, cache.size());
+
+    RelativePose_Info info_loaded;
+    EXPECT_TRUE(cache.robustRelativePose(Pair(0,1), K, K, x1, x2, info_loaded, size_ima, size_ima));
+    EXPECT_EQ(1, cache.hit_count());
+    EXPECT_TRUE(info_miss.vec_inliers == info_loaded.vec_inliers);
+    EXPECT_MATRIX_NEAR(info_miss.essential_matrix, info_loaded.essential_matrix, 1e-12);
+    EXPECT_MATRIX_NEAR(info_miss.relativePose.rotation(), info_loaded.relativePose.rotation(), 1e-12);
+    EXPECT_MATRIX_NEAR(info_miss.relativePose.center(), info_loaded.relativePose.center(), 1e-12);
+
+    // Modified correspondences invalidate the cached result
+    x1(0,0) += 1.0;
+    RelativePose_Info info_modified;
+    EXPECT_TRUE(cache.robustRelativePose(Pair(0,1), K, K, x1, x2, info_modified, size_ima, size_ima));
+    EXPECT_EQ(1, cache.hit_count());
+    EXPECT_EQ(1, cache.miss_count());
+  }
+  std::remove(filename.c_str());
+}
+
+/* ************************************************************************* */
+int main() { TestResult tr; return TestRegistry::runAllTests(tr);}
+/* ************************************************************************* */
@@ -119,6 +119,177 @@ bool robustRelativePose(
   return true;
 }
 
+namespace {
+
+typedef Eigen::Matrix<double, 5, 5> Mat5;
+typedef Eigen::Matrix<double, 5, 1> Vec5;
+
+// Orthonormal basis of the plane orthogonal to the unit vector t
+void TangentBasis(const Vec3 & t, Vec3 * b1, Vec3 * b2)
+{
+  Vec3 axis = Vec3::Zero();
+  int min_index;
+  t.cwiseAbs().minCoeff(&min_index);
+  axis(min_index) = 1.0;
+  *b1 = t.cross(axis).normalized();
+  *b2 = t.cross(*b1);
+}
+
+// Compute the robust Sampson cost of E = [t]x R over the inliers and
+// (optionally) the normal equations for the pose update:
+//  R' = exp([w]x) R, t' = normalize(t + a.b1 + b.b2), with (w, a, b) in R^5
+double SampsonNormalEquations
+(
+  const Mat & x1, const Mat & x2,
+  const std::vector<size_t> & vec_inliers,
+  const Mat3 & R, const Vec3 & t,
+  const Vec3 & b1, const Vec3 & b2,
+  const double huber_threshold,
+  Mat5 * JtJ,
+  Vec5 * Jtr
+)
+{
+  const Mat3 t_x = CrossProductMatrix(t);
+  const Mat3 E = t_x * R;
+  Mat3 dE[5];
+  if (JtJ)
+  {
+    for (int k = 0; k < 3; ++k)
+      dE[k] = t_x * CrossProductMatrix(Vec3::Unit(k)) * R;
+    dE[3] = CrossProductMatrix(b1) * R;
+    dE[4] = CrossProductMatrix(b2) * R;
+    JtJ->setZero();
+    Jtr->setZero();
+  }
+  const double huber_threshold_2 = Square(huber_threshold);
+
+  double cost = 0.0;
+  for (const size_t index : vec_inliers)
+  {
+    const Vec3 p1(x1(0, index), x1(1, index), 1.0);
+    const Vec3 p2(x2(0, index), x2(1, index), 1.0);
+    const Vec3 Ep1 = E * p1;
+    const Vec3 Etp2 = E.transpose() * p2;
+    const double numerator = p2.dot(Ep1);
+    const double denominator =
+      Ep1.head<2>().squaredNorm() + Etp2.head<2>().squaredNorm();
+    if (denominator <= std::numeric_limits<double>::epsilon())
+      continue;
+    const double sqrt_denominator = std::sqrt(denominator);
+    const double residual = numerator / sqrt_denominator;
+    const double residual_2 = Square(residual);
+
+    // Huber loss (and its Iteratively Reweighted Least Squares weight)
+    double weight = 1.0;
+    if (residual_2 <= huber_threshold_2)
+    {
+      cost += residual_2;
+    }
+    else
+    {
+      const double abs_residual = std::abs(residual);
+      cost += 2.0 * huber_threshold * abs_residual - huber_threshold_2;
+      weight = huber_threshold / abs_residual;
+    }
+
+    if (JtJ)
+    {
+      Vec5 J;
+      for (int k = 0; k < 5; ++k)
+      {
+        const Vec3 dEp1 = dE[k] * p1;
+        const Vec3 dEtp2 = dE[k].transpose() * p2;
+        const double d_numerator = p2.dot(dEp1);
+        const double d_denominator = 2.0 *
+          (Ep1.head<2>().dot(dEp1.head<2>()) + Etp2.head<2>().dot(dEtp2.head<2>()));
+        J(k) = d_numerator / sqrt_denominator
+          - 0.5 * numerator * d_denominator / (denominator * sqrt_denominator);
+      }
+      JtJ->noalias() += weight * J * J.transpose();
+      Jtr->noalias() += (weight * residual) * J;
+    }
+  }
+  return cost;
+}
+
+} // namespace
+
+bool refineRelativePose
+(
+  const Mat & x1, const Mat & x2,
+  const std::vector<size_t> & vec_inliers,
+  geometry::Pose3 & relative_pose,
+  const double huber_threshold,
+  const size_t max_iteration_count
+)
+{
+  if (vec_inliers.size() < 5)
+    return false;
+
+  Mat3 R = relative_pose.rotation();
+  Vec3 t = relative_pose.translation();
+  const double t_norm = t.norm();
+  if (t_norm <= std::numeric_limits<double>::epsilon())
+    return false;
+  t /= t_norm;
+
+  Vec3 b1, b2;
+  TangentBasis(t, &b1, &b2);
+  Mat5 JtJ;
+  Vec5 Jtr;
+  double cost = SampsonNormalEquations(x1, x2, vec_inliers, R, t, b1, b2,
+    huber_threshold, &JtJ, &Jtr);
+  const double initial_cost = cost;
+
+  // Levenberg-Marquardt iterations
+  double lambda = 1e-3;
+  for (size_t iter = 0; iter < max_iteration_count; ++iter)
+  {
+    bool step_accepted = false, converged = false;
+    while (!step_accepted && lambda < 1e10)
+    {
+      Mat5 A = JtJ;
+      A.diagonal() += lambda * (JtJ.diagonal() + Vec5::Constant(1e-12));
+      const Vec5 delta = A.ldlt().solve(-Jtr);
+
+      const Vec3 w = delta.head<3>();
+      const double angle = w.norm();
+      const Mat3 R_update = (angle > 0.0) ?
+        Mat3(Eigen::AngleAxisd(angle, w / angle)) : Mat3(Mat3::Identity());
+      const Mat3 R_new = R_update * R;
+      const Vec3 t_new = (t + delta(3) * b1 + delta(4) * b2).normalized();
+
+      const double new_cost = SampsonNormalEquations(x1, x2, vec_inliers,
+        R_new, t_new, b1, b2, huber_threshold, NULL, NULL);
+      if (new_cost < cost)
+      {
+        converged = (cost - new_cost) < 1e-10 * cost || delta.norm() < 1e-12;
+        R = R_new;
+        t = t_new;
+        cost = new_cost;
+        lambda = std::max(lambda / 10.0, 1e-10);
+        step_accepted = true;
+      }
+      else
+      {
+        lambda *= 10.0;
+      }
+    }
+    if (!step_accepted || converged)
+      break;
+    TangentBasis(t, &b1, &b2);
+    SampsonNormalEquations(x1, x2, vec_inliers, R, t, b1, b2,
+      huber_threshold, &JtJ, &Jtr);
+  }
+
+  if (!(cost < initial_cost))
+    return false;
+
+  // Store [R|C], with the input translation norm
+  relative_pose = geometry::Pose3(R, -R.transpose() * (t * t_norm));
+  return true;
+}
+
 } // namespace sfm
 } // namespace openMVG
 
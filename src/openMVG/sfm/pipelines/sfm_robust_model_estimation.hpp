@@ -10,6 +10,7 @@
 
 #include "openMVG/numeric/numeric.h"
 #include "openMVG/geometry/pose3.hpp"
+#include <limits>
 #include <vector>
 
 namespace openMVG {
@@ -73,6 +74,32 @@ bool robustRelativePose
   const size_t max_iteration_count = 4096
 );
 
+/**
+ * @brief Refine a relative pose [R|C] (the first camera is [Id|0]) by
+ *  minimizing the Sampson error of the point correspondences.
+ *  The Sampson error is the first order approximation of the reprojection
+ *  error, so the 3D points are eliminated from the problem and the
+ *  Levenberg-Marquardt iterations only solve a 5x5 system
+ *  (3 for the rotation, 2 for the translation direction).
+ *  The translation norm is kept.
+ *
+ * @param[in] x1 camera 1 normalized image points (K^-1 x)
+ * @param[in] x2 camera 2 normalized image points (K^-1 x)
+ * @param[in] vec_inliers indices of the correspondences to use
+ * @param[in,out] relative_pose pose of the second camera
+ * @param[in] huber_threshold Huber loss threshold (normalized unit)
+ * @param[in] max_iteration_count maximal number of LM iterations
+ * @return true if the Sampson error was decreased
+ */
+bool refineRelativePose
+(
+  const Mat & x1, const Mat & x2,
+  const std::vector<size_t> & vec_inliers,
+  geometry::Pose3 & relative_pose,
+  const double huber_threshold = std::numeric_limits<double>::infinity(),
+  const size_t max_iteration_count = 20
+);
+
 } // namespace sfm
 } // namespace openMVG
 
@@ -0,0 +1,66 @@
+
+// Copyright (c) 2015 Pierre MOULON.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "openMVG/sfm/pipelines/sfm_robust_model_estimation.hpp"
+#include "openMVG/multiview/essential.hpp"
+#include "openMVG/multiview/test_data_sets.hpp"
+#include "testing/testing.h"
+
+#include <random>
+
+using namespace openMVG;
+using namespace openMVG::geometry;
+using namespace openMVG::sfm;
+
+// Refine a perturbed relative pose and check that the ground truth is recovered
+TEST(RelativePose, refineRelativePose)
+{
+  const int nbPoints = 100;
+  const NViewDataSet d = NRealisticCamerasRing(2, nbPoints,
+    nViewDatasetConfigurator(1, 1, 0, 0, 5, 0)); // K = Id: normalized points
+
+  Mat3 R_gt;
+  Vec3 t_gt;
+  RelativeCameraMotion(d._R[0], d._t[0], d._R[1], d._t[1], &R_gt, &t_gt);
+
+  const Mat x1 = d._x[0], x2 = d._x[1];
+  std::vector<size_t> vec_inliers(nbPoints);
+  for (size_t i = 0; i < vec_inliers.size(); ++i)
+    vec_inliers[i] = i;
+
+  // Perturbed initial pose (same translation norm)
+  const Mat3 R_init = RotationAroundX(D2R(2.0)) * RotationAroundY(D2R(-1.5)) * R_gt;
+  const Vec3 t_init = (t_gt + Vec3(0.1, -0.05, 0.02) * t_gt.norm()).normalized() * t_gt.norm();
+  Pose3 relative_pose(R_init, -R_init.transpose() * t_init);
+
+  EXPECT_TRUE(refineRelativePose(x1, x2, vec_inliers, relative_pose));
+  EXPECT_MATRIX_NEAR(R_gt, relative_pose.rotation(), 1e-6);
+  EXPECT_MATRIX_NEAR(t_gt, relative_pose.translation(), 1e-6);
+
+  // Refinement with noisy points & outliers:
+  //  the Huber loss must limit the influence of the outliers
+  std::mt19937 rng(0);
+  std::normal_distribution<double> noise(0.0, 1e-3);
+  Mat x2_noisy = x2;
+  for (int i = 0; i < nbPoints; ++i)
+    x2_noisy.col(i) += Vec2(noise(rng), noise(rng));
+  for (int i = 0; i < 5; ++i)
+    x2_noisy.col(i * 10) += Vec2(0.1, -0.05);
+
+  Pose3 pose_l2(R_init, -R_init.transpose() * t_init);
+  Pose3 pose_huber = pose_l2;
+  EXPECT_TRUE(refineRelativePose(x1, x2_noisy, vec_inliers, pose_l2));
+  EXPECT_TRUE(refineRelativePose(x1, x2_noisy, vec_inliers, pose_huber, 2e-3));
+  const double error_l2 = (R_gt - pose_l2.rotation()).norm();
+  const double error_huber = (R_gt - pose_huber.rotation()).norm();
+  EXPECT_TRUE(error_huber < error_l2);
+  EXPECT_TRUE(error_huber < (R_gt - R_init).norm());
+}
+
+/* ************************************************************************* */
+int main() { TestResult tr; return TestRegistry::runAllTests(tr);}
+/* ************************************************************************* */
@@ -24,15 +24,6 @@ using namespace openMVG::features;
 using namespace openMVG::geometry;
 
 
-/// Camera pair epipole (Projection of camera center 2 in the image plane 1)
-static Vec3 epipole_from_P(const Mat34& P1, const Pose3& P2)
-{
-  const Vec3 c = P2.center();
-  Vec4 center;
-  center << c(0), c(1), c(2), 1.0;
-  return P1*center;
-}
-
 /// Export point feature based vector to a matrix [(x,y)'T, (x,y)'T]
 /// Use the camera intrinsics in order to get undistorted pixel coordinates
 template<typename MatT >
@@ -121,19 +112,14 @@ void SfM_Data_Structure_Estimation_From_Known_Poses::match(
           vec_corresponding_indexes
         );
     #else
-      const Vec3 epipole2  = epipole_from_P(P_R, poseL);
-
-      const features::Regions * regions = regions_provider->regions_per_view.at(it->first).get();
-      geometry_aware::GuidedMatching_Fundamental_Fast
+      geometry_aware::GuidedMatching_Fundamental_Grid
         <openMVG::fundamental::kernel::EpipolarDistanceError>
         (
           F_lr,
-          epipole2,
           iterIntrinsicL->second.get(),
           *regions_provider->regions_per_view.at(it->first),
           iterIntrinsicR->second.get(),
           *regions_provider->regions_per_view.at(it->second),
-          iterIntrinsicR->second->w(), iterIntrinsicR->second->h(),
           Square(thresholdF), Square(0.8),
           vec_corresponding_indexes
         );
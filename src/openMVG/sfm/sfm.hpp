@@ -34,6 +34,7 @@
 #include "openMVG/sfm/pipelines/sfm_matches_provider.hpp"
 
 #include "openMVG/sfm/pipelines/sfm_robust_model_estimation.hpp"
+#include "openMVG/sfm/pipelines/sfm_relative_pose_cache.hpp"
 
 #include "openMVG/sfm/pipelines/sequential/sequential_SfM.hpp"
 
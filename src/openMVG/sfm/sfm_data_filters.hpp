@@ -10,6 +10,7 @@
 
 #include "openMVG/stl/stl.hpp"
 #include <iterator>
+#include <stdexcept>
 
 namespace openMVG {
 namespace sfm {
@@ -51,8 +52,87 @@ static Pair_Set Pair_filter
   return kept_pairs;
 }
 
-// Remove tracks that have a small angle (tracks with tiny angle leads to instable 3D points)
-// Return the number of removed tracks
+/// Pose & intrinsic of a view, gathered once for all the observations
+struct Filter_ViewData
+{
+  Filter_ViewData(): intrinsic(NULL) {}
+
+  geometry::Pose3 pose;
+  Mat3 Rt; // camera to world rotation (used to orient the bearing vectors)
+  const cameras::IntrinsicBase * intrinsic;
+};
+
+typedef Hash_Map<IndexT, Filter_ViewData> Filter_ViewDatas;
+
+/// Gather the view data (indexed by view id) of the views that have
+///  a valid pose & intrinsic
+static Filter_ViewDatas Get_Filter_ViewData
+(
+  const SfM_Data & sfm_data
+)
+{
+  Filter_ViewDatas view_data;
+  for (Views::const_iterator it = sfm_data.GetViews().begin();
+    it != sfm_data.GetViews().end(); ++it)
+  {
+    const View * view = it->second.get();
+    if (!sfm_data.IsPoseAndIntrinsicDefined(view))
+      continue;
+    Filter_ViewData & data = view_data[it->first];
+    data.pose = sfm_data.GetPoseOrDie(view);
+    data.Rt = data.pose.rotation().transpose();
+    data.intrinsic = sfm_data.GetIntrinsics().at(view->id_intrinsic).get();
+  }
+  return view_data;
+}
+
+/// Return the view data of an observation (NULL if the view is not valid)
+static inline const Filter_ViewData * Get_Filter_ViewData
+(
+  const Filter_ViewDatas & view_data,
+  IndexT view_id
+)
+{
+  const Filter_ViewDatas::const_iterator it = view_data.find(view_id);
+  return (it != view_data.end()) ? &it->second : NULL;
+}
+
+/// List the landmarks in a random access container (for parallel processing)
+static std::vector<Landmarks::iterator> Get_Landmark_Iterators
+(
+  Landmarks & landmarks
+)
+{
+  std::vector<Landmarks::iterator> iterators;
+  iterators.reserve(landmarks.size());
+  for (Landmarks::iterator it = landmarks.begin(); it != landmarks.end(); ++it)
+    iterators.push_back(it);
+  return iterators;
+}
+
+/// Erase the flagged landmarks (once all the tracks have been processed)
+static void Erase_Flagged_Landmarks
+(
+  Landmarks & landmarks,
+  const std::vector<Landmarks::iterator> & iterators,
+  const std::vector<unsigned char> & flags
+)
+{
+  // Collect the ids first: erasing can invalidate the other iterators
+  std::vector<IndexT> to_remove;
+  for (size_t i = 0; i < iterators.size(); ++i)
+  {
+    if (flags[i])
+      to_remove.push_back(iterators[i]->first);
+  }
+  for (size_t i = 0; i < to_remove.size(); ++i)
+    landmarks.erase(to_remove[i]);
+}
+
+// Remove observations with a large reprojection error
+//  and the tracks that become too short
+// Return the number of removed observations
+// Throw std::out_of_range if a view without pose or intrinsic is observed
 static IndexT RemoveOutliers_PixelResidualError
 (
   SfM_Data & sfm_data,
@@ -60,19 +140,31 @@ static IndexT RemoveOutliers_PixelResidualError
   const unsigned int minTrackLength = 2
 )
 {
+  const Filter_ViewDatas view_data = Get_Filter_ViewData(sfm_data);
+  const std::vector<Landmarks::iterator> tracks = Get_Landmark_Iterators(sfm_data.structure);
+  std::vector<unsigned char> remove_track(tracks.size(), 0);
+  const double squared_threshold = dThresholdPixel * dThresholdPixel;
+
   IndexT outlier_count = 0;
-  Landmarks::iterator iterTracks = sfm_data.structure.begin();
-  while (iterTracks != sfm_data.structure.end())
+  bool bInvalidView = false; // an exception cannot leave the parallel loop
+#ifdef OPENMVG_USE_OPENMP
+  #pragma omp parallel for schedule(dynamic, 256) reduction(+:outlier_count) reduction(||:bInvalidView)
+#endif
+  for (int i = 0; i < static_cast<int>(tracks.size()); ++i)
   {
-    Observations & obs = iterTracks->second.obs;
+    Landmark & landmark = tracks[i]->second;
+    Observations & obs = landmark.obs;
     Observations::iterator itObs = obs.begin();
     while (itObs != obs.end())
     {
-      const View * view = sfm_data.views.at(itObs->first).get();
-      const geometry::Pose3 pose = sfm_data.GetPoseOrDie(view);
-      const cameras::IntrinsicBase * intrinsic = sfm_data.intrinsics.at(view->id_intrinsic).get();
-      const Vec2 residual = intrinsic->residual(pose, iterTracks->second.X, itObs->second.x);
-      if (residual.norm() > dThresholdPixel)
+      const Filter_ViewData * data = Get_Filter_ViewData(view_data, itObs->first);
+      if (!data)
+      {
+        bInvalidView = true;
+        ++itObs;
+      }
+      else if (data->intrinsic->residual(data->pose, landmark.X, itObs->second.x).squaredNorm()
+            > squared_threshold)
       {
         ++outlier_count;
         itObs = obs.erase(itObs);
@@ -80,57 +172,89 @@ static IndexT RemoveOutliers_PixelResidualError
       else
         ++itObs;
     }
-    if (obs.empty() || obs.size() < minTrackLength)
-      iterTracks = sfm_data.structure.erase(iterTracks);
-    else
-      ++iterTracks;
+    remove_track[i] = (obs.empty() || obs.size() < minTrackLength);
   }
+  if (bInvalidView)
+    throw std::out_of_range("RemoveOutliers_PixelResidualError: observation of a view without pose or intrinsic");
+  Erase_Flagged_Landmarks(sfm_data.structure, tracks, remove_track);
   return outlier_count;
 }
 
 // Remove tracks that have a small angle (tracks with tiny angle leads to instable 3D points)
 // Return the number of removed tracks
+// Throw std::out_of_range if a view without pose or intrinsic is observed
 static IndexT RemoveOutliers_AngleError
 (
   SfM_Data & sfm_data,
   const double dMinAcceptedAngle
 )
 {
+  const Filter_ViewDatas view_data = Get_Filter_ViewData(sfm_data);
+  const std::vector<Landmarks::iterator> tracks = Get_Landmark_Iterators(sfm_data.structure);
+  std::vector<unsigned char> remove_track(tracks.size(), 0);
+  const double min_angle = D2R(dMinAcceptedAngle);
+  const double cos_min_angle = cos(min_angle);
+
   IndexT removedTrack_count = 0;
-  Landmarks::iterator iterTracks = sfm_data.structure.begin();
-  while (iterTracks != sfm_data.structure.end())
+  bool bInvalidView = false; // an exception cannot leave the parallel loop
+#ifdef OPENMVG_USE_OPENMP
+  #pragma omp parallel for schedule(dynamic, 256) reduction(+:removedTrack_count) reduction(||:bInvalidView)
+#endif
+  for (int i = 0; i < static_cast<int>(tracks.size()); ++i)
   {
-    Observations & obs = iterTracks->second.obs;
-    double max_angle = 0.0;
-    for (Observations::const_iterator itObs1 = obs.begin();
-      itObs1 != obs.end(); ++itObs1)
+    const Observations & obs = tracks[i]->second.obs;
+
+    // Bearing vectors of the observations (world frame)
+    std::vector<Vec3> bearings;
+    bearings.reserve(obs.size());
+    Vec3 mean_bearing = Vec3::Zero();
+    for (Observations::const_iterator itObs = obs.begin(); itObs != obs.end(); ++itObs)
     {
-      const View * view1 = sfm_data.views.at(itObs1->first).get();
-      const geometry::Pose3 pose1 = sfm_data.GetPoseOrDie(view1);
-      const cameras::IntrinsicBase * intrinsic1 = sfm_data.intrinsics.at(view1->id_intrinsic).get();
+      const Filter_ViewData * data = Get_Filter_ViewData(view_data, itObs->first);
+      if (!data)
+      {
+        bInvalidView = true;
+        continue;
+      }
+      bearings.push_back((data->Rt * (*data->intrinsic)(itObs->second.x)).normalized());
+      mean_bearing += bearings.back();
+    }
 
-      Observations::const_iterator itObs2 = itObs1;
-      ++itObs2;
-      for (; itObs2 != obs.end(); ++itObs2)
+    // Bounding cone of the bearing vectors (axis: mean bearing, half angle theta):
+    //  theta <= max pairwise angle <= 2 theta
+    // The exact O(k^2) test is only required in the undecided range.
+    bool bKeep = false;
+    if (bearings.size() >= 2 && mean_bearing.norm() > 1e-8)
+    {
+      mean_bearing.normalize();
+      double min_cos_theta = 1.0;
+      for (size_t k = 0; k < bearings.size(); ++k)
+        min_cos_theta = std::min(min_cos_theta, mean_bearing.dot(bearings[k]));
+      const double theta = acos(clamp(min_cos_theta, -1.0, 1.0));
+      if (theta >= min_angle)
+        bKeep = true;
+      else if (2.0 * theta >= min_angle)
       {
-        const View * view2 = sfm_data.views.at(itObs2->first).get();
-        const geometry::Pose3 pose2 = sfm_data.GetPoseOrDie(view2);
-        const cameras::IntrinsicBase * intrinsic2 = sfm_data.intrinsics.at(view2->id_intrinsic).get();
-
-        const double angle = AngleBetweenRay(
-          pose1, intrinsic1, pose2, intrinsic2,
-          itObs1->second.x, itObs2->second.x);
-        max_angle = std::max(angle, max_angle);
+        for (size_t k = 0; k < bearings.size() && !bKeep; ++k)
+          for (size_t l = k + 1; l < bearings.size() && !bKeep; ++l)
+            bKeep = bearings[k].dot(bearings[l]) <= cos_min_angle;
       }
     }
-    if (max_angle < dMinAcceptedAngle)
+    else if (bearings.size() >= 2)
+    {
+      // Opposite rays
+      bKeep = true;
+    }
+
+    if (!bKeep)
     {
-      iterTracks = sfm_data.structure.erase(iterTracks);
+      remove_track[i] = 1;
       ++removedTrack_count;
     }
-    else
-      ++iterTracks;
   }
+  if (bInvalidView)
+    throw std::out_of_range("RemoveOutliers_AngleError: observation of a view without pose or intrinsic");
+  Erase_Flagged_Landmarks(sfm_data.structure, tracks, remove_track);
   return removedTrack_count;
 }
 
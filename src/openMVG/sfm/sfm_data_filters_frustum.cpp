@@ -10,6 +10,7 @@
 #include "openMVG/types.hpp"
 #include "openMVG/geometry/half_space_intersection.hpp"
 
+#include <algorithm>
 #include <fstream>
 
 namespace openMVG {
@@ -19,6 +20,21 @@ using namespace openMVG::cameras;
 using namespace openMVG::geometry;
 using namespace openMVG::geometry::halfPlane;
 
+// Functor to sort bounding boxes indexes by their minimal coordinate along an axis
+struct SortBoxMin
+{
+  SortBoxMin(const std::vector<Eigen::AlignedBox<double, 3> > & boxes, const int axis)
+    : _boxes(boxes), _axis(axis) {}
+
+  bool operator()(const size_t a, const size_t b) const
+  {
+    return _boxes[a].min()(_axis) < _boxes[b].min()(_axis);
+  }
+
+  const std::vector<Eigen::AlignedBox<double, 3> > & _boxes;
+  const int _axis;
+};
+
 // Constructor
 Frustum_Filter::Frustum_Filter(const SfM_Data & sfm_data,
   const double zNear, const double zFar)
@@ -68,40 +84,76 @@ void Frustum_Filter::initFrustum(const SfM_Data & sfm_data)
 Pair_Set Frustum_Filter::getFrustumIntersectionPairs() const
 {
   Pair_Set pairs;
-  // List active view Id
+
+  // List active view Id and the bounding box of their frustum
+  typedef Eigen::AlignedBox<double, 3> BoxT;
   std::vector<IndexT> viewIds;
-  viewIds.reserve(z_near_z_far_perView.size());
-  std::transform(z_near_z_far_perView.begin(), z_near_z_far_perView.end(),
-    std::back_inserter(viewIds), stl::RetrieveKey());
+  std::vector<BoxT> boxes;
+  viewIds.reserve(frustum_perView.size());
+  boxes.reserve(frustum_perView.size());
+  for (FrustumsT::const_iterator it = frustum_perView.begin();
+    it != frustum_perView.end(); ++it)
+  {
+    viewIds.push_back(it->first);
+    boxes.push_back(it->second.bounds());
+  }
+
+  // Broad phase (sweep and prune):
+  //  Sort the bounding boxes along the axis where the frustums are the most spread
+  //  and only test the frustum pairs whose bounding boxes overlap.
+  int sweep_axis = 0;
+  {
+    BoxT centers;
+    for (size_t i = 0; i < boxes.size(); ++i)
+    {
+      if (boxes[i].min().allFinite() && boxes[i].max().allFinite())
+        centers.extend(boxes[i].center());
+    }
+    if (!centers.isEmpty())
+      centers.sizes().maxCoeff(&sweep_axis);
+  }
+  std::vector<size_t> order(viewIds.size());
+  for (size_t i = 0; i < order.size(); ++i)
+    order[i] = i;
+  std::sort(order.begin(), order.end(), SortBoxMin(boxes, sweep_axis));
 
   C_Progress_display my_progress_bar(
-    viewIds.size() * (viewIds.size()-1)/2,
+    viewIds.size(),
     std::cout, "\nCompute frustum intersection\n");
 
-  // Exhaustive comparison (use the fact that the intersect function is symmetric)
+  // Narrow phase (use the fact that the intersect function is symmetric)
 #ifdef OPENMVG_USE_OPENMP
-  #pragma omp parallel for
+  #pragma omp parallel for schedule(dynamic)
 #endif
-  for (int i = 0; i < (int)viewIds.size(); ++i)
+  for (int i = 0; i < (int)order.size(); ++i)
   {
-    for (size_t j = i+1; j < viewIds.size(); ++j)
+    const size_t id_i = order[i];
+    const BoxT & box_i = boxes[id_i];
+    const Frustum & frustum_i = frustum_perView.at(viewIds[id_i]);
+    Pair_Vec local_pairs;
+    for (size_t j = i+1; j < order.size(); ++j)
     {
-      if (frustum_perView.at(viewIds[i]).intersect(frustum_perView.at(viewIds[j])))
+      const size_t id_j = order[j];
+      const BoxT & box_j = boxes[id_j];
+      // Next boxes cannot overlap the current one along the sweep axis
+      if (box_j.min()(sweep_axis) > box_i.max()(sweep_axis))
+        break;
+      if (box_i.intersection(box_j).isEmpty())
+        continue;
+      if (frustum_i.intersect(frustum_perView.at(viewIds[id_j])))
       {
-#ifdef OPENMVG_USE_OPENMP
-        #pragma omp critical
-#endif
-        {
-          pairs.insert(std::make_pair(viewIds[i], viewIds[j]));
-        }
+        local_pairs.push_back(
+          std::make_pair(std::min(viewIds[id_i], viewIds[id_j]),
+                         std::max(viewIds[id_i], viewIds[id_j])));
       }
-      // Progress bar update
+    }
 #ifdef OPENMVG_USE_OPENMP
-      #pragma omp critical
+    #pragma omp critical
 #endif
-      {
-        ++my_progress_bar;
-      }
+    {
+      pairs.insert(local_pairs.begin(), local_pairs.end());
+      // Progress bar update
+      ++my_progress_bar;
     }
   }
   return pairs;
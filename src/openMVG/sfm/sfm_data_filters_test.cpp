@@ -0,0 +1,194 @@
+
+// Copyright (c) 2015 Pierre MOULON.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "openMVG/sfm/sfm_data.hpp"
+#include "openMVG/sfm/sfm_data_filters.hpp"
+#include "openMVG/cameras/cameras.hpp"
+#include "testing/testing.h"
+
+#include <random>
+#include <stdexcept>
+
+using namespace openMVG;
+using namespace openMVG::cameras;
+using namespace openMVG::geometry;
+using namespace openMVG::sfm;
+
+// Cameras along the X axis looking at points at various depths
+// (the far points are seen with tiny angles), some observations are outliers
+// The view ids can be sparse (view_ids[i] is the id of the i-th view)
+static SfM_Data SyntheticScene(const std::vector<IndexT> & view_ids = {0, 1, 2, 3, 4})
+{
+  SfM_Data sfm_data;
+  const int nb_views = static_cast<int>(view_ids.size());
+  for (int i = 0; i < nb_views; ++i)
+  {
+    sfm_data.views[view_ids[i]] = std::make_shared<View>("", view_ids[i], 0, i, 1000, 1000);
+    sfm_data.poses[i] = Pose3(Mat3::Identity(), Vec3(i * 0.2, 0.0, 0.0));
+  }
+  sfm_data.intrinsics[0] = std::make_shared<Pinhole_Intrinsic>(1000, 1000, 1000.0, 500.0, 500.0);
+
+  std::mt19937 rng(0);
+  std::uniform_real_distribution<double> xy(-1.0, 1.0), depth(0.0, 3.0), unit(0.0, 1.0);
+  for (IndexT j = 0; j < 500; ++j)
+  {
+    Landmark & landmark = sfm_data.structure[j * 3]; // sparse landmark ids
+    // depth from 1 to 1000 units (log scale)
+    const double z = std::pow(10.0, depth(rng));
+    landmark.X = Vec3(xy(rng) * z, xy(rng) * z, z);
+    for (int i = 0; i < nb_views; ++i)
+    {
+      if (unit(rng) < 0.3)
+        continue;
+      Vec2 x = sfm_data.intrinsics[0]->project(sfm_data.poses[i], landmark.X);
+      if (unit(rng) < 0.1)
+        x += Vec2(xy(rng), xy(rng)) * 20.0;
+      landmark.obs[view_ids[i]] = Observation(x, j);
+    }
+  }
+  return sfm_data;
+}
+
+// Reference (brute force) implementations
+static IndexT Reference_PixelResidual(SfM_Data & sfm_data, double threshold, unsigned int min_length)
+{
+  IndexT count = 0;
+  Landmarks::iterator it = sfm_data.structure.begin();
+  while (it != sfm_data.structure.end())
+  {
+    Observations & obs = it->second.obs;
+    Observations::iterator itObs = obs.begin();
+    while (itObs != obs.end())
+    {
+      const View * view = sfm_data.views.at(itObs->first).get();
+      const Vec2 residual = sfm_data.intrinsics.at(view->id_intrinsic)->residual(
+        sfm_data.GetPoseOrDie(view), it->second.X, itObs->second.x);
+      if (residual.norm() > threshold)
+      {
+        ++count;
+        itObs = obs.erase(itObs);
+      }
+      else
+        ++itObs;
+    }
+    if (obs.size() < min_length)
+      it = sfm_data.structure.erase(it);
+    else
+      ++it;
+  }
+  return count;
+}
+
+static IndexT Reference_Angle(SfM_Data & sfm_data, double min_angle)
+{
+  IndexT count = 0;
+  Landmarks::iterator it = sfm_data.structure.begin();
+  while (it != sfm_data.structure.end())
+  {
+    const Observations & obs = it->second.obs;
+    double max_angle = 0.0;
+    for (Observations::const_iterator itObs1 = obs.begin(); itObs1 != obs.end(); ++itObs1)
+    {
+      const View * view1 = sfm_data.views.at(itObs1->first).get();
+      Observations::const_iterator itObs2 = itObs1;
+      for (++itObs2; itObs2 != obs.end(); ++itObs2)
+      {
+        const View * view2 = sfm_data.views.at(itObs2->first).get();
+        max_angle = std::max(max_angle, AngleBetweenRay(
+          sfm_data.GetPoseOrDie(view1), sfm_data.intrinsics.at(view1->id_intrinsic).get(),
+          sfm_data.GetPoseOrDie(view2), sfm_data.intrinsics.at(view2->id_intrinsic).get(),
+          itObs1->second.x, itObs2->second.x));
+      }
+    }
+    if (max_angle < min_angle)
+    {
+      ++count;
+      it = sfm_data.structure.erase(it);
+    }
+    else
+      ++it;
+  }
+  return count;
+}
+
+static bool SameStructure(const SfM_Data & a, const SfM_Data & b)
+{
+  if (a.structure.size() != b.structure.size())
+    return false;
+  for (Landmarks::const_iterator it = a.structure.begin(); it != a.structure.end(); ++it)
+  {
+    if (b.structure.count(it->first) == 0 ||
+        b.structure.at(it->first).obs.size() != it->second.obs.size())
+      return false;
+  }
+  return true;
+}
+
+TEST(SfM_Data_Filters, PixelResidualError)
+{
+  SfM_Data sfm_data = SyntheticScene(), reference = SyntheticScene();
+  const IndexT count = RemoveOutliers_PixelResidualError(sfm_data, 4.0, 2);
+  EXPECT_EQ(Reference_PixelResidual(reference, 4.0, 2), count);
+  EXPECT_TRUE(count > 0);
+  EXPECT_TRUE(SameStructure(sfm_data, reference));
+}
+
+TEST(SfM_Data_Filters, AngleError)
+{
+  SfM_Data sfm_data = SyntheticScene(), reference = SyntheticScene();
+  const IndexT count = RemoveOutliers_AngleError(sfm_data, 2.0);
+  EXPECT_EQ(Reference_Angle(reference, 2.0), count);
+  EXPECT_TRUE(count > 0);
+  EXPECT_TRUE(SameStructure(sfm_data, reference));
+}
+
+TEST(SfM_Data_Filters, SparseViewIds)
+{
+  // Large and non contiguous view ids (no dense view id indexing)
+  const std::vector<IndexT> view_ids = {7, 100000000, 2000000000, UndefinedIndexT - 1, UndefinedIndexT};
+  {
+    SfM_Data sfm_data = SyntheticScene(view_ids), reference = SyntheticScene(view_ids);
+    const IndexT count = RemoveOutliers_PixelResidualError(sfm_data, 4.0, 2);
+    EXPECT_EQ(Reference_PixelResidual(reference, 4.0, 2), count);
+    EXPECT_TRUE(count > 0);
+    EXPECT_TRUE(SameStructure(sfm_data, reference));
+  }
+  {
+    SfM_Data sfm_data = SyntheticScene(view_ids), reference = SyntheticScene(view_ids);
+    const IndexT count = RemoveOutliers_AngleError(sfm_data, 2.0);
+    EXPECT_EQ(Reference_Angle(reference, 2.0), count);
+    EXPECT_TRUE(count > 0);
+    EXPECT_TRUE(SameStructure(sfm_data, reference));
+  }
+}
+
+TEST(SfM_Data_Filters, ObservationOfAViewWithoutPose)
+{
+  // As the reference implementations, the filters fail on such observations
+  {
+    SfM_Data sfm_data = SyntheticScene();
+    sfm_data.poses.erase(2);
+    bool bThrow = false;
+    try { RemoveOutliers_PixelResidualError(sfm_data, 4.0, 2); }
+    catch (const std::out_of_range &) { bThrow = true; }
+    EXPECT_TRUE(bThrow);
+  }
+  {
+    SfM_Data sfm_data = SyntheticScene();
+    const size_t landmark_count = sfm_data.structure.size();
+    sfm_data.poses.erase(2);
+    bool bThrow = false;
+    try { RemoveOutliers_AngleError(sfm_data, 2.0); }
+    catch (const std::out_of_range &) { bThrow = true; }
+    EXPECT_TRUE(bThrow);
+    EXPECT_EQ(landmark_count, sfm_data.structure.size());
+  }
+}
+
+/* ************************************************************************* */
+int main() { TestResult tr; return TestRegistry::runAllTests(tr);}
+/* ************************************************************************* */
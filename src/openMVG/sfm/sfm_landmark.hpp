@@ -8,6 +8,7 @@
 #define OPENMVG_SFM_LANDMARK_HPP
 
 #include "openMVG/numeric/numeric.h"
+#include "openMVG/stl/flat_map.hpp"
 #include <cereal/cereal.hpp> // Serialization
 
 namespace openMVG {
@@ -42,7 +43,9 @@ struct Observation
   }
 };
 /// Observations are indexed by their View_id
-typedef Hash_Map<IndexT, Observation> Observations;
+/// (stored in a vector sorted by View_id: a landmark has only a few observations)
+typedef stl::flat_map<IndexT, Observation,
+  Eigen::aligned_allocator<std::pair<IndexT, Observation> > > Observations;
 
 /// Define a landmark (a 3D point, with it's 2d observations)
 struct Landmark
@@ -0,0 +1,92 @@
+
+// Copyright (c) 2015 Pierre MOULON.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef OPENMVG_STL_BOUNDED_QUEUE_HPP
+#define OPENMVG_STL_BOUNDED_QUEUE_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+namespace stl
+{
+
+/**
+* @brief Thread safe FIFO queue with a maximal size (producer/consumer).
+*
+* push() blocks while the queue is full and pop() blocks while it is empty,
+*  so the memory used by the elements in transit is bounded by the capacity.
+* Once close() is called, push() is refused and pop() returns false when the
+*  remaining elements have been consumed.
+*/
+template <typename T>
+class bounded_queue
+{
+public:
+
+  explicit bounded_queue(std::size_t capacity)
+    : capacity_(capacity > 0 ? capacity : 1), closed_(false)
+  {}
+
+  /// Add an element (wait while the queue is full)
+  /// Return false if the queue is closed
+  bool push(T && value)
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_full_.wait(lock, [this]{ return closed_ || queue_.size() < capacity_; });
+    if (closed_)
+      return false;
+    queue_.push_back(std::move(value));
+    not_empty_.notify_one();
+    return true;
+  }
+
+  /// Remove the oldest element (wait while the queue is empty)
+  /// Return false if the queue is closed and empty
+  bool pop(T & value)
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_empty_.wait(lock, [this]{ return closed_ || !queue_.empty(); });
+    if (queue_.empty())
+      return false;
+    value = std::move(queue_.front());
+    queue_.pop_front();
+    not_full_.notify_one();
+    return true;
+  }
+
+  /// No more element will be pushed: wake up all the waiting threads
+  void close()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+    not_empty_.notify_all();
+    not_full_.notify_all();
+  }
+
+  std::size_t size() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.size();
+  }
+
+  std::size_t capacity() const { return capacity_; }
+
+private:
+
+  const std::size_t capacity_;
+  bool closed_;
+  std::deque<T> queue_;
+  mutable std::mutex mutex_;
+  std::condition_variable not_empty_, not_full_;
+};
+
+} // namespace stl
+
+#endif // OPENMVG_STL_BOUNDED_QUEUE_HPP
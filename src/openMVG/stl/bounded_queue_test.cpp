@@ -0,0 +1,75 @@
+
+// Copyright (c) 2015 Pierre MOULON.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "openMVG/stl/bounded_queue.hpp"
+#include "testing/testing.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace stl;
+
+TEST(bounded_queue, FIFO)
+{
+  bounded_queue<int> queue(3);
+  EXPECT_TRUE(queue.push(1));
+  EXPECT_TRUE(queue.push(2));
+  EXPECT_EQ(2, queue.size());
+  int value = 0;
+  EXPECT_TRUE(queue.pop(value));
+  EXPECT_EQ(1, value);
+  queue.close();
+  EXPECT_FALSE(queue.push(3));
+  // The remaining elements are still delivered after close()
+  EXPECT_TRUE(queue.pop(value));
+  EXPECT_EQ(2, value);
+  EXPECT_FALSE(queue.pop(value));
+}
+
+TEST(bounded_queue, ProducersConsumers)
+{
+  const int producer_count = 4, consumer_count = 3, item_count = 10000;
+  bounded_queue<int> queue(8);
+  std::atomic<long long> sum(0);
+  std::atomic<int> max_size(0);
+
+  std::vector<std::thread> consumers;
+  for (int i = 0; i < consumer_count; ++i)
+  {
+    consumers.emplace_back([&]{
+      int value;
+      while (queue.pop(value))
+        sum += value;
+    });
+  }
+  std::vector<std::thread> producers;
+  for (int i = 0; i < producer_count; ++i)
+  {
+    producers.emplace_back([&]{
+      for (int k = 1; k <= item_count; ++k)
+      {
+        queue.push(int(k));
+        const int size = static_cast<int>(queue.size());
+        int current = max_size;
+        while (size > current && !max_size.compare_exchange_weak(current, size)) {}
+      }
+    });
+  }
+  for (size_t i = 0; i < producers.size(); ++i)
+    producers[i].join();
+  queue.close();
+  for (size_t i = 0; i < consumers.size(); ++i)
+    consumers[i].join();
+
+  EXPECT_EQ(producer_count * (long long)item_count * (item_count + 1) / 2, sum);
+  EXPECT_TRUE(max_size <= 8);
+}
+
+/* ************************************************************************* */
+int main() { TestResult tr; return TestRegistry::runAllTests(tr);}
+/* ************************************************************************* */
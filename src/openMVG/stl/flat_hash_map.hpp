@@ -0,0 +1,264 @@
+
+// Copyright (c) 2015 Pierre MOULON.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef OPENMVG_STL_FLAT_HASH_MAP_HPP
+#define OPENMVG_STL_FLAT_HASH_MAP_HPP
+
+#include <cereal/cereal.hpp> // Serialization
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace stl
+{
+
+/**
+* @brief Open addressing hash map with densely stored elements.
+*
+* The (key, value) pairs are stored contiguously in a vector (iteration is a
+*  linear scan), and an open addressing table (linear probing) of 32 bits
+*  indexes maps the keys to their position in this vector.
+* Erase moves the last element in the erased slot, so the usual
+*  `it = map.erase(it)` loop visits every element once.
+* Differences with std::map:
+* - iteration order is the insertion order (modified by erase),
+* - insertion & erase invalidate the iterators and references,
+* - value_type is std::pair<Key, T> (the key must not be modified).
+*/
+template <
+  typename Key,
+  typename T,
+  typename Hash = std::hash<Key>,
+  typename Allocator = std::allocator<std::pair<Key, T> > >
+class flat_hash_map
+{
+public:
+  typedef Key key_type;
+  typedef T mapped_type;
+  typedef std::pair<Key, T> value_type;
+  typedef std::vector<value_type, Allocator> container_type;
+  typedef typename container_type::size_type size_type;
+  typedef typename container_type::iterator iterator;
+  typedef typename container_type::const_iterator const_iterator;
+
+  iterator begin() { return _data.begin(); }
+  iterator end() { return _data.end(); }
+  const_iterator begin() const { return _data.begin(); }
+  const_iterator end() const { return _data.end(); }
+
+  size_type size() const { return _data.size(); }
+  bool empty() const { return _data.empty(); }
+  void clear() { _data.clear(); _slots.clear(); }
+  void swap(flat_hash_map & other) { _data.swap(other._data); _slots.swap(other._slots); }
+
+  void reserve(size_type n)
+  {
+    _data.reserve(n);
+    if (n > MaxSize(_slots.size()))
+      Rehash(n);
+  }
+
+  iterator find(const Key & key)
+  {
+    const size_t slot = FindSlot(key);
+    return (slot == NPOS || _slots[slot] == EMPTY) ? _data.end() : _data.begin() + _slots[slot];
+  }
+  const_iterator find(const Key & key) const
+  {
+    const size_t slot = FindSlot(key);
+    return (slot == NPOS || _slots[slot] == EMPTY) ? _data.end() : _data.begin() + _slots[slot];
+  }
+
+  size_type count(const Key & key) const { return find(key) != end() ? 1 : 0; }
+
+  T & at(const Key & key)
+  {
+    const iterator it = find(key);
+    if (it == _data.end())
+      throw std::out_of_range("flat_hash_map::at");
+    return it->second;
+  }
+  const T & at(const Key & key) const
+  {
+    const const_iterator it = find(key);
+    if (it == _data.end())
+      throw std::out_of_range("flat_hash_map::at");
+    return it->second;
+  }
+
+  T & operator[](const Key & key)
+  {
+    const size_t slot = InsertSlot(key);
+    if (_slots[slot] == EMPTY)
+    {
+      _slots[slot] = static_cast<uint32_t>(_data.size());
+      _data.emplace_back(std::piecewise_construct,
+        std::forward_as_tuple(key), std::forward_as_tuple());
+    }
+    return _data[_slots[slot]].second;
+  }
+
+  std::pair<iterator, bool> insert(const value_type & value)
+  {
+    return emplace(value.first, value.second);
+  }
+
+  template <typename K, typename V>
+  std::pair<iterator, bool> emplace(K && key, V && value)
+  {
+    const size_t slot = InsertSlot(key);
+    if (_slots[slot] != EMPTY)
+      return std::make_pair(_data.begin() + _slots[slot], false);
+    _slots[slot] = static_cast<uint32_t>(_data.size());
+    _data.emplace_back(std::forward<K>(key), std::forward<V>(value));
+    return std::make_pair(_data.end() - 1, true);
+  }
+
+  template <typename K, typename V>
+  iterator emplace_hint(const_iterator, K && key, V && value)
+  {
+    return emplace(std::forward<K>(key), std::forward<V>(value)).first;
+  }
+
+  /// Erase an element, return the iterator to the next element to visit
+  iterator erase(const_iterator pos)
+  {
+    const size_t index = pos - _data.begin();
+    EraseSlot(FindSlot(pos->first));
+    const size_t last = _data.size() - 1;
+    if (index != last)
+    {
+      // Move the last element in the released position
+      _slots[FindSlot(_data[last].first)] = static_cast<uint32_t>(index);
+      _data[index] = std::move(_data[last]);
+    }
+    _data.pop_back();
+    return _data.begin() + index;
+  }
+  iterator erase(iterator pos) { return erase(const_iterator(pos)); }
+
+  size_type erase(const Key & key)
+  {
+    const const_iterator it = find(key);
+    if (it == _data.end())
+      return 0;
+    erase(it);
+    return 1;
+  }
+
+private:
+
+  static const uint32_t EMPTY = std::numeric_limits<uint32_t>::max();
+  static const size_t NPOS = std::numeric_limits<size_t>::max();
+
+  // Maximal number of elements for a given table size (load factor 1/2)
+  static size_type MaxSize(size_t slot_count) { return slot_count / 2; }
+
+  size_t Home(const Key & key) const
+  {
+    // Fibonacci hashing: spread the (often sequential) integer keys
+    const uint64_t h = static_cast<uint64_t>(Hash()(key)) * 11400714819323198485ull;
+    return static_cast<size_t>(h >> 32) & (_slots.size() - 1);
+  }
+
+  // Return the slot of the key, or the empty slot that ends its probe sequence
+  size_t FindSlot(const Key & key) const
+  {
+    if (_slots.empty())
+      return NPOS;
+    const size_t mask = _slots.size() - 1;
+    size_t slot = Home(key);
+    while (_slots[slot] != EMPTY && !(_data[_slots[slot]].first == key))
+      slot = (slot + 1) & mask;
+    return slot;
+  }
+
+  size_t InsertSlot(const Key & key)
+  {
+    if (_data.size() + 1 > MaxSize(_slots.size()))
+      Rehash(_data.size() + 1);
+    return FindSlot(key);
+  }
+
+  void Rehash(size_type n)
+  {
+    size_t slot_count = 16;
+    while (MaxSize(slot_count) < n)
+      slot_count *= 2;
+    _slots.assign(slot_count, EMPTY);
+    for (size_t i = 0; i < _data.size(); ++i)
+      _slots[FindSlot(_data[i].first)] = static_cast<uint32_t>(i);
+  }
+
+  // Backward shift deletion (keep the probe sequences without tombstones)
+  void EraseSlot(size_t slot)
+  {
+    const size_t mask = _slots.size() - 1;
+    size_t hole = slot, next = slot;
+    while (true)
+    {
+      next = (next + 1) & mask;
+      if (_slots[next] == EMPTY)
+        break;
+      const size_t home = Home(_data[_slots[next]].first);
+      // Move the element if its home is not in the (hole, next] cyclic range
+      const bool in_range = (hole <= next) ?
+        (hole < home && home <= next) :
+        (hole < home || home <= next);
+      if (!in_range)
+      {
+        _slots[hole] = _slots[next];
+        hole = next;
+      }
+    }
+    _slots[hole] = EMPTY;
+  }
+
+  container_type _data;
+  std::vector<uint32_t> _slots;
+};
+
+template <typename Key, typename T, typename Hash, typename Allocator>
+const uint32_t flat_hash_map<Key, T, Hash, Allocator>::EMPTY;
+
+template <typename Key, typename T, typename Hash, typename Allocator>
+const size_t flat_hash_map<Key, T, Hash, Allocator>::NPOS;
+
+/// Serialization (same layout as the cereal std::map serialization)
+template <class Archive, typename Key, typename T, typename Hash, typename Allocator>
+void save(Archive & ar, const flat_hash_map<Key, T, Hash, Allocator> & map)
+{
+  ar(cereal::make_size_tag(static_cast<cereal::size_type>(map.size())));
+  for (const auto & it : map)
+    ar(cereal::make_map_item(it.first, it.second));
+}
+
+template <class Archive, typename Key, typename T, typename Hash, typename Allocator>
+void load(Archive & ar, flat_hash_map<Key, T, Hash, Allocator> & map)
+{
+  cereal::size_type size;
+  ar(cereal::make_size_tag(size));
+  map.clear();
+  map.reserve(size);
+  for (size_t i = 0; i < size; ++i)
+  {
+    Key key;
+    T value;
+    ar(cereal::make_map_item(key, value));
+    map.emplace(std::move(key), std::move(value));
+  }
+}
+
+} // namespace stl
+
+#endif // OPENMVG_STL_FLAT_HASH_MAP_HPP
@@ -0,0 +1,184 @@
+
+// Copyright (c) 2015 Pierre MOULON.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef OPENMVG_STL_FLAT_MAP_HPP
+#define OPENMVG_STL_FLAT_MAP_HPP
+
+#include <cereal/cereal.hpp> // Serialization
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace stl
+{
+
+/**
+* @brief Associative container stored as a vector of (key, value) sorted by key.
+*
+* Drop-in replacement of std::map for small maps (i.e. the observations of a
+*  landmark): the elements are contiguous in memory, so iteration does not
+*  chase pointers and the memory overhead is the one of a std::vector.
+* Iteration order is the key order (like std::map).
+* Differences with std::map:
+* - insertion is linear in the size of the container,
+* - insertion & erase invalidate the iterators and references,
+* - value_type is std::pair<Key, T> (the key must not be modified).
+*/
+template <
+  typename Key,
+  typename T,
+  typename Allocator = std::allocator<std::pair<Key, T> > >
+class flat_map
+{
+public:
+  typedef Key key_type;
+  typedef T mapped_type;
+  typedef std::pair<Key, T> value_type;
+  typedef std::vector<value_type, Allocator> container_type;
+  typedef typename container_type::size_type size_type;
+  typedef typename container_type::iterator iterator;
+  typedef typename container_type::const_iterator const_iterator;
+
+  iterator begin() { return _data.begin(); }
+  iterator end() { return _data.end(); }
+  const_iterator begin() const { return _data.begin(); }
+  const_iterator end() const { return _data.end(); }
+
+  size_type size() const { return _data.size(); }
+  bool empty() const { return _data.empty(); }
+  void clear() { _data.clear(); }
+  void reserve(size_type n) { _data.reserve(n); }
+  void swap(flat_map & other) { _data.swap(other._data); }
+
+  iterator lower_bound(const Key & key)
+  {
+    return std::lower_bound(_data.begin(), _data.end(), key, KeyLess());
+  }
+  const_iterator lower_bound(const Key & key) const
+  {
+    return std::lower_bound(_data.begin(), _data.end(), key, KeyLess());
+  }
+
+  iterator find(const Key & key)
+  {
+    const iterator it = lower_bound(key);
+    return (it != _data.end() && !(key < it->first)) ? it : _data.end();
+  }
+  const_iterator find(const Key & key) const
+  {
+    const const_iterator it = lower_bound(key);
+    return (it != _data.end() && !(key < it->first)) ? it : _data.end();
+  }
+
+  size_type count(const Key & key) const { return find(key) != end() ? 1 : 0; }
+
+  T & at(const Key & key)
+  {
+    const iterator it = find(key);
+    if (it == _data.end())
+      throw std::out_of_range("flat_map::at");
+    return it->second;
+  }
+  const T & at(const Key & key) const
+  {
+    const const_iterator it = find(key);
+    if (it == _data.end())
+      throw std::out_of_range("flat_map::at");
+    return it->second;
+  }
+
+  T & operator[](const Key & key)
+  {
+    iterator it = lower_bound(key);
+    if (it == _data.end() || key < it->first)
+      it = _data.insert(it, value_type(key, T()));
+    return it->second;
+  }
+
+  std::pair<iterator, bool> insert(const value_type & value)
+  {
+    return emplace(value.first, value.second);
+  }
+
+  template <typename K, typename V>
+  std::pair<iterator, bool> emplace(K && key, V && value)
+  {
+    iterator it = lower_bound(key);
+    if (it != _data.end() && !(key < it->first))
+      return std::make_pair(it, false);
+    it = _data.insert(it, value_type(std::forward<K>(key), std::forward<V>(value)));
+    return std::make_pair(it, true);
+  }
+
+  /// Insertion in key order is constant time when the hint is end()
+  template <typename K, typename V>
+  iterator emplace_hint(const_iterator hint, K && key, V && value)
+  {
+    if (hint == _data.end() && (_data.empty() || _data.back().first < key))
+    {
+      _data.emplace_back(std::forward<K>(key), std::forward<V>(value));
+      return _data.end() - 1;
+    }
+    return emplace(std::forward<K>(key), std::forward<V>(value)).first;
+  }
+
+  iterator erase(const_iterator pos) { return _data.erase(pos); }
+  iterator erase(iterator pos) { return _data.erase(pos); }
+  iterator erase(const_iterator first, const_iterator last) { return _data.erase(first, last); }
+  size_type erase(const Key & key)
+  {
+    const iterator it = find(key);
+    if (it == _data.end())
+      return 0;
+    _data.erase(it);
+    return 1;
+  }
+
+  bool operator==(const flat_map & other) const { return _data == other._data; }
+  bool operator!=(const flat_map & other) const { return _data != other._data; }
+
+private:
+
+  struct KeyLess
+  {
+    bool operator()(const value_type & value, const Key & key) const { return value.first < key; }
+  };
+
+  container_type _data;
+};
+
+/// Serialization (same layout as the cereal std::map serialization)
+template <class Archive, typename Key, typename T, typename Allocator>
+void save(Archive & ar, const flat_map<Key, T, Allocator> & map)
+{
+  ar(cereal::make_size_tag(static_cast<cereal::size_type>(map.size())));
+  for (const auto & it : map)
+    ar(cereal::make_map_item(it.first, it.second));
+}
+
+template <class Archive, typename Key, typename T, typename Allocator>
+void load(Archive & ar, flat_map<Key, T, Allocator> & map)
+{
+  cereal::size_type size;
+  ar(cereal::make_size_tag(size));
+  map.clear();
+  map.reserve(size);
+  for (size_t i = 0; i < size; ++i)
+  {
+    Key key;
+    T value;
+    ar(cereal::make_map_item(key, value));
+    map.emplace_hint(map.end(), std::move(key), std::move(value));
+  }
+}
+
+} // namespace stl
+
+#endif // OPENMVG_STL_FLAT_MAP_HPP
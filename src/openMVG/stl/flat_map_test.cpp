@@ -0,0 +1,121 @@
+
+// Copyright (c) 2015 Pierre MOULON.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "openMVG/stl/flat_map.hpp"
+#include "openMVG/stl/flat_hash_map.hpp"
+#include "testing/testing.h"
+
+#include <map>
+#include <memory>
+#include <random>
+
+using namespace stl;
+
+// Apply the same random insertions & removals to a std::map and to a map
+// implementation and check that they contain the same elements.
+template <typename MapT>
+bool sameAsStdMap(MapT & map, unsigned int seed)
+{
+  std::map<int, int> reference;
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<int> key(0, 500), op(0, 3);
+  for (int i = 0; i < 20000; ++i)
+  {
+    const int k = key(rng);
+    switch (op(rng))
+    {
+      case 0: map[k] = i; reference[k] = i; break;
+      case 1: map.insert(std::make_pair(k, i)); reference.insert(std::make_pair(k, i)); break;
+      case 2:
+        if (map.erase(k) != reference.erase(k))
+          return false;
+      break;
+      case 3:
+        if (map.count(k) != reference.count(k)
+            || (map.count(k) && map.at(k) != reference.at(k)))
+          return false;
+      break;
+    }
+  }
+  // Remove the odd values with an iterator loop
+  typename MapT::iterator it = map.begin();
+  while (it != map.end())
+  {
+    if (it->second % 2)
+      it = map.erase(it);
+    else
+      ++it;
+  }
+  for (std::map<int, int>::iterator itR = reference.begin(); itR != reference.end();)
+  {
+    if (itR->second % 2)
+      itR = reference.erase(itR);
+    else
+      ++itR;
+  }
+  if (map.size() != reference.size())
+    return false;
+  for (const auto & itR : reference)
+  {
+    if (map.find(itR.first) == map.end() || map.at(itR.first) != itR.second)
+      return false;
+  }
+  return true;
+}
+
+TEST(flat_map, std_map_equivalence)
+{
+  flat_map<int, int> map;
+  EXPECT_TRUE(sameAsStdMap(map, 0));
+  // Iteration in key order
+  int previous = -1;
+  for (const auto & it : map)
+  {
+    EXPECT_TRUE(previous < it.first);
+    previous = it.first;
+  }
+}
+
+TEST(flat_map, emplace_hint)
+{
+  flat_map<int, int> map;
+  map.emplace_hint(map.end(), 1, 1);
+  map.emplace_hint(map.end(), 5, 5);
+  map.emplace_hint(map.end(), 3, 3); // out of order hint
+  EXPECT_EQ(3, map.size());
+  EXPECT_EQ(1, map.begin()->first);
+  EXPECT_EQ(3, (map.begin() + 1)->first);
+  EXPECT_EQ(5, (map.begin() + 2)->first);
+}
+
+TEST(flat_hash_map, std_map_equivalence)
+{
+  flat_hash_map<int, int> map;
+  EXPECT_TRUE(sameAsStdMap(map, 0));
+  map.clear();
+  EXPECT_TRUE(sameAsStdMap(map, 1));
+}
+
+TEST(flat_hash_map, move_only_value)
+{
+  flat_hash_map<unsigned int, std::unique_ptr<int> > map;
+  for (unsigned int i = 0; i < 1000; ++i)
+    map[i * 7919u].reset(new int(i));
+  EXPECT_EQ(1000, map.size());
+  for (unsigned int i = 0; i < 1000; i += 2)
+    map.erase(i * 7919u);
+  EXPECT_EQ(500, map.size());
+  for (unsigned int i = 1; i < 1000; i += 2)
+  {
+    EXPECT_EQ(1, map.count(i * 7919u));
+    EXPECT_EQ(i, *map.at(i * 7919u));
+  }
+}
+
+/* ************************************************************************* */
+int main() { TestResult tr; return TestRegistry::runAllTests(tr);}
+/* ************************************************************************* */
@@ -19,6 +19,10 @@
 #include <unordered_map>
 #endif
 
+#if defined OPENMVG_USE_FLAT_HASH_MAP
+#include "openMVG/stl/flat_hash_map.hpp"
+#endif
+
 namespace openMVG{
 
 typedef uint32_t IndexT;
@@ -28,7 +32,9 @@ typedef std::pair<IndexT,IndexT> Pair;
 typedef std::set<Pair> Pair_Set;
 typedef std::vector<Pair> Pair_Vec;
 
+#if !defined OPENMVG_USE_FLAT_HASH_MAP && !defined OPENMVG_STD_UNORDERED_MAP
 #define OPENMVG_NO_UNORDERED_MAP 1
+#endif
 
 #if defined OPENMVG_NO_UNORDERED_MAP
 template<typename K, typename V>
@@ -41,6 +47,24 @@ template<typename Key, typename Value>
 struct Hash_Map : std::unordered_map<Key, Value> {};
 #endif
 
+/// Open addressing map (contiguous storage, insertion ordered iteration)
+#if defined OPENMVG_USE_FLAT_HASH_MAP
+/// Eigen aligned allocator that supports move only types (C++11 construct)
+template<typename T>
+struct Hash_Map_Allocator : Eigen::aligned_allocator<T>
+{
+  template<typename U> struct rebind { typedef Hash_Map_Allocator<U> other; };
+  Hash_Map_Allocator() {}
+  template<typename U> Hash_Map_Allocator(const Hash_Map_Allocator<U> &) {}
+  template<typename U, typename... Args>
+  void construct(U * p, Args&&... args) { ::new((void*)p) U(std::forward<Args>(args)...); }
+};
+
+template<typename K, typename V>
+struct Hash_Map : stl::flat_hash_map<K, V, std::hash<K>,
+ Hash_Map_Allocator<std::pair<K,V> > > {};
+#endif
+
 } // namespace openMVG
 
 #endif  // OPENMVG_TYPES_H_
@@ -0,0 +1,142 @@
+
+// Copyright (c) 2015 Pierre MOULON.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Micro-benchmark of the minimal solvers used in the A Contrario RANSAC loops.
+// Each solver is run on random minimal samples through its ACKernelAdaptor
+// (as done by ACRANSAC) and the number of solves per second is reported.
+// The residual evaluation of all the correspondences (ACKernelAdaptor::Errors)
+// is reported in million residuals per second.
+
+#include "openMVG/multiview/solver_essential_kernel.hpp"
+#include "openMVG/multiview/solver_fundamental_kernel.hpp"
+#include "openMVG/multiview/solver_homography_kernel.hpp"
+#include "openMVG/multiview/solver_resection_kernel.hpp"
+#include "openMVG/multiview/solver_resection_p3p.hpp"
+#include "openMVG/multiview/test_data_sets.hpp"
+#include "openMVG/robust_estimation/rand_sampling.hpp"
+#include "openMVG/robust_estimation/robust_estimator_ACRansacKernelAdaptator.hpp"
+#include "openMVG/system/timer.hpp"
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+using namespace openMVG;
+using namespace openMVG::robust;
+
+// Fit the kernel on random samples and report the solves per second
+template <typename Kernel>
+void RunBenchmark(const std::string & name, const Kernel & kernel, size_t solve_count)
+{
+  std::vector<size_t> vec_sample(Kernel::MINIMUM_SAMPLES);
+  std::vector<typename Kernel::Model> vec_models;
+  vec_models.reserve(Kernel::MAX_MODELS);
+
+  std::srand(0);
+  size_t model_count = 0;
+  system::Timer timer;
+  for (size_t i = 0; i < solve_count; ++i)
+  {
+    UniformSample(Kernel::MINIMUM_SAMPLES, kernel.NumSamples(), &vec_sample);
+    vec_models.clear();
+    kernel.Fit(vec_sample, &vec_models);
+    model_count += vec_models.size();
+  }
+  const double elapsed = timer.elapsed();
+  std::cout << std::setw(28) << std::left << name
+    << std::setw(12) << std::right << static_cast<size_t>(solve_count / elapsed)
+    << " solves/s (" << model_count / static_cast<double>(solve_count)
+    << " models per solve)" << std::endl;
+}
+
+// Evaluate the residuals of all the correspondences for a model of the kernel
+template <typename Kernel>
+void RunErrorsBenchmark(const std::string & name, const Kernel & kernel, size_t repeat_count)
+{
+  std::vector<size_t> vec_sample(Kernel::MINIMUM_SAMPLES);
+  std::vector<typename Kernel::Model> vec_models;
+  std::srand(0);
+  while (vec_models.empty())
+  {
+    UniformSample(Kernel::MINIMUM_SAMPLES, kernel.NumSamples(), &vec_sample);
+    kernel.Fit(vec_sample, &vec_models);
+  }
+
+  std::vector<double> vec_errors;
+  double checksum = 0.0;
+  system::Timer timer;
+  for (size_t i = 0; i < repeat_count; ++i)
+  {
+    kernel.Errors(vec_models[0], vec_errors);
+    checksum += vec_errors[i % vec_errors.size()];
+  }
+  const double elapsed = timer.elapsed();
+  std::cout << std::setw(28) << std::left << name
+    << std::setw(12) << std::right
+    << repeat_count * kernel.NumSamples() / elapsed / 1e6
+    << " Mresiduals/s (checksum " << checksum << ")" << std::endl;
+}
+
+int main(int argc, char ** argv)
+{
+  const size_t solve_count = (argc > 1) ? std::atol(argv[1]) : 100000;
+  const size_t repeat_count = (argc > 2) ? std::atol(argv[2]) : 10000;
+
+  const int nbPoints = 1000;
+  const nViewDatasetConfigurator config(1000, 1000, 500, 500, 5, 0);
+  const NViewDataSet d = NRealisticCamerasRing(2, nbPoints, config);
+  const Mat x1 = d._x[0], x2 = d._x[1];
+  const Mat X = d._X;
+  const Mat3 K = d._K[0];
+
+  std::cout << "Solves per second of the minimal solvers ("
+    << solve_count << " random samples):" << std::endl;
+
+  typedef ACKernelAdaptorEssential<
+    essential::kernel::FivePointSolver, fundamental::kernel::EpipolarDistanceError,
+    UnnormalizerT, Mat3> KernelEssential5;
+  typedef ACKernelAdaptor<
+    fundamental::kernel::SevenPointSolver, fundamental::kernel::SimpleError,
+    UnnormalizerT, Mat3> KernelFundamental7;
+  typedef ACKernelAdaptor<
+    fundamental::kernel::EightPointSolver, fundamental::kernel::SimpleError,
+    UnnormalizerT, Mat3> KernelFundamental8;
+  typedef ACKernelAdaptor<
+    homography::kernel::FourPointSolver, homography::kernel::AsymmetricError,
+    UnnormalizerI, Mat3> KernelHomography4;
+  typedef ACKernelAdaptorResection<
+    resection::kernel::SixPointResectionSolver, resection::kernel::SixPointResectionSolver,
+    UnnormalizerResection, Mat34> KernelResection6;
+  typedef ACKernelAdaptorResection_K<
+    euclidean_resection::P3PSolver, euclidean_resection::P3PSolver,
+    UnnormalizerResection, Mat34> KernelResectionP3P;
+
+  const KernelEssential5 kernelEssential5(x1, 1000, 1000, x2, 1000, 1000, K, K);
+  const KernelFundamental7 kernelFundamental7(x1, 1000, 1000, x2, 1000, 1000, true);
+  const KernelFundamental8 kernelFundamental8(x1, 1000, 1000, x2, 1000, 1000, true);
+  const KernelHomography4 kernelHomography4(x1, 1000, 1000, x2, 1000, 1000, false);
+  const KernelResection6 kernelResection6(x1, 1000, 1000, X);
+  const KernelResectionP3P kernelResectionP3P(x1, X, K);
+
+  RunBenchmark("Essential 5 points", kernelEssential5, solve_count);
+  RunBenchmark("Fundamental 7 points", kernelFundamental7, solve_count);
+  RunBenchmark("Fundamental 8 points", kernelFundamental8, solve_count);
+  RunBenchmark("Homography 4 points", kernelHomography4, solve_count);
+  RunBenchmark("Resection 6 points (DLT)", kernelResection6, solve_count);
+  RunBenchmark("Resection P3P", kernelResectionP3P, solve_count);
+
+  std::cout << "\nResidual evaluation of " << nbPoints << " correspondences ("
+    << repeat_count << " times):" << std::endl;
+
+  RunErrorsBenchmark("Essential (epipolar)", kernelEssential5, repeat_count);
+  RunErrorsBenchmark("Fundamental (epipolar)", kernelFundamental8, repeat_count);
+  RunErrorsBenchmark("Homography (transfer)", kernelHomography4, repeat_count);
+  RunErrorsBenchmark("Resection (reprojection)", kernelResection6, repeat_count);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,161 @@
+
+// Copyright (c) 2015 Pierre MOULON.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Benchmark of the containers used to store the SfM_Data structure:
+// - node based std::map (the default Hash_Map),
+// - sorted vector (stl::flat_map, used for the landmark observations),
+// - open addressing hash map (stl::flat_hash_map, OPENMVG_USE_FLAT_HASH_MAP).
+// The synthetic scene has `landmarks * observations per landmark` observations
+// (10M by default) and the timed operations mimic the SfM_Data usages:
+// building the tracks, scanning the observations (BA setup, exports),
+// looking up observations of a view and filtering outliers.
+
+#include "openMVG/types.hpp"
+#include "openMVG/numeric/numeric.h"
+#include "openMVG/stl/flat_map.hpp"
+#include "openMVG/stl/flat_hash_map.hpp"
+#include "openMVG/system/timer.hpp"
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+
+using namespace openMVG;
+
+struct Observation
+{
+  Observation():id_feat(UndefinedIndexT) {}
+  Observation(const Vec2 & p, IndexT idFeat): x(p), id_feat(idFeat) {}
+  Vec2 x;
+  IndexT id_feat;
+};
+
+typedef Eigen::aligned_allocator<std::pair<const IndexT, Observation> > NodeObsAllocator;
+typedef Eigen::aligned_allocator<std::pair<IndexT, Observation> > FlatObsAllocator;
+
+typedef std::map<IndexT, Observation, std::less<IndexT>, NodeObsAllocator> Map_Observations;
+typedef stl::flat_map<IndexT, Observation, FlatObsAllocator> Flat_Observations;
+
+template <typename ObservationsT>
+struct Landmark
+{
+  ObservationsT obs;
+  Vec3 X;
+};
+
+template <typename ObservationsT>
+struct Map_Landmarks : std::map<IndexT, Landmark<ObservationsT>, std::less<IndexT>,
+  Eigen::aligned_allocator<std::pair<const IndexT, Landmark<ObservationsT> > > > {};
+
+template <typename ObservationsT>
+struct Flat_Landmarks : stl::flat_hash_map<IndexT, Landmark<ObservationsT>, std::hash<IndexT>,
+  Eigen::aligned_allocator<std::pair<IndexT, Landmark<ObservationsT> > > > {};
+
+template <typename LandmarksT>
+void RunBenchmark
+(
+  const std::string & name,
+  size_t landmark_count,
+  size_t obs_per_landmark,
+  IndexT view_count
+)
+{
+  typedef typename LandmarksT::mapped_type LandmarkT;
+  system::Timer timer;
+  double t_build, t_scan, t_lookup, t_filter;
+
+  LandmarksT landmarks;
+  {
+    std::mt19937 rng(0);
+    std::uniform_int_distribution<IndexT> view(0, view_count - 1);
+    timer.reset();
+    for (size_t i = 0; i < landmark_count; ++i)
+    {
+      LandmarkT & landmark = landmarks[static_cast<IndexT>(i)];
+      landmark.X = Vec3(i, i, i);
+      for (size_t k = 0; k < obs_per_landmark; ++k)
+        landmark.obs[view(rng)] = Observation(Vec2(k, i), static_cast<IndexT>(i));
+    }
+    t_build = timer.elapsedMs();
+  }
+
+  // Scan all the observations (BA problem setup, residual computation)
+  double sum = 0.0;
+  size_t obs_count = 0;
+  timer.reset();
+  for (const auto & landmark_it : landmarks)
+  {
+    for (const auto & obs_it : landmark_it.second.obs)
+    {
+      sum += obs_it.second.x(0) + landmark_it.second.X(2);
+      ++obs_count;
+    }
+  }
+  t_scan = timer.elapsedMs();
+
+  // Look up the observations of some views in every landmark
+  size_t found = 0;
+  timer.reset();
+  for (IndexT v = 0; v < 8; ++v)
+    for (const auto & landmark_it : landmarks)
+      found += landmark_it.second.obs.count(v * (view_count / 8));
+  t_lookup = timer.elapsedMs();
+
+  // Remove the observations of 1 view out of 7 and the too short tracks
+  timer.reset();
+  typename LandmarksT::iterator iterTracks = landmarks.begin();
+  while (iterTracks != landmarks.end())
+  {
+    auto & obs = iterTracks->second.obs;
+    auto itObs = obs.begin();
+    while (itObs != obs.end())
+    {
+      if (itObs->first % 7 == 0)
+        itObs = obs.erase(itObs);
+      else
+        ++itObs;
+    }
+    if (obs.size() < 2)
+      iterTracks = landmarks.erase(iterTracks);
+    else
+      ++iterTracks;
+  }
+  t_filter = timer.elapsedMs();
+
+  std::cout << std::setw(40) << std::left << name
+    << " build: " << std::setw(8) << t_build
+    << " scan: " << std::setw(8) << t_scan
+    << " lookup: " << std::setw(8) << t_lookup
+    << " filter: " << std::setw(8) << t_filter
+    << " (ms) [" << obs_count << " observations, " << found << " found, "
+    << landmarks.size() << " kept, checksum " << sum << "]" << std::endl;
+}
+
+int main(int argc, char ** argv)
+{
+  // Usage: [observation count] [observations per landmark] [view count]
+  const size_t obs_total = (argc > 1) ? std::atol(argv[1]) : 10000000;
+  const size_t obs_per_landmark = (argc > 2) ? std::atol(argv[2]) : 4;
+  const IndexT view_count = (argc > 3) ? std::atol(argv[3]) : 2000;
+  const size_t landmark_count = obs_total / obs_per_landmark;
+
+  std::cout << "Synthetic scene: " << landmark_count << " landmarks, "
+    << obs_per_landmark << " observations per landmark, "
+    << view_count << " views" << std::endl;
+
+  RunBenchmark<Map_Landmarks<Map_Observations> >(
+    "std::map landmarks, std::map obs", landmark_count, obs_per_landmark, view_count);
+  RunBenchmark<Map_Landmarks<Flat_Observations> >(
+    "std::map landmarks, flat_map obs", landmark_count, obs_per_landmark, view_count);
+  RunBenchmark<Flat_Landmarks<Flat_Observations> >(
+    "flat_hash_map landmarks, flat_map obs", landmark_count, obs_per_landmark, view_count);
+
+  return EXIT_SUCCESS;
+}
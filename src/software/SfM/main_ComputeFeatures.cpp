@@ -21,6 +21,7 @@
 
 #include <cstdlib>
 #include <fstream>
+#include <map>
 
 using namespace openMVG;
 using namespace openMVG::image;
@@ -44,6 +45,38 @@ features::EDESCRIBER_PRESET stringToEnum(const std::string & sPreset)
   return preset;
 }
 
+features::EFEATURE_SELECTION stringToFeatureSelection(const std::string & sSelection)
+{
+  features::EFEATURE_SELECTION selection;
+  if (sSelection == "RESPONSE")
+    selection = features::FEATURE_SELECTION_RESPONSE;
+  else
+  if (sSelection == "GRID")
+    selection = features::FEATURE_SELECTION_GRID;
+  else
+  if (sSelection == "ANMS")
+    selection = features::FEATURE_SELECTION_ANMS;
+  else
+    selection = features::EFEATURE_SELECTION(-1);
+  return selection;
+}
+
+features::EDESCRIPTOR_STORAGE stringToDescriptorStorage(const std::string & sStorage)
+{
+  features::EDESCRIPTOR_STORAGE storage;
+  if (sStorage == "FULL")
+    storage = features::DESCRIPTOR_STORAGE_FULL;
+  else
+  if (sStorage == "FLOAT16")
+    storage = features::DESCRIPTOR_STORAGE_FLOAT16;
+  else
+  if (sStorage == "PCA64")
+    storage = features::DESCRIPTOR_STORAGE_PCA64;
+  else
+    storage = features::EDESCRIPTOR_STORAGE(-1);
+  return storage;
+}
+
 /// - Compute view image description (feature & descriptor extraction)
 /// - Export computed data
 int main(int argc, char **argv)
@@ -56,6 +89,14 @@ int main(int argc, char **argv)
   std::string sImage_Describer_Method = "SIFT";
   bool bForce = false;
   std::string sFeaturePreset = "";
+  int iMaxFeatures = 0;
+  std::string sFeatureSelection = "RESPONSE";
+  int iTileSize = 0;
+  int iTileOverlap = 256;
+  bool bNativeScaleSpace = false;
+  std::string sCacheDir = "";
+  int iCacheSize = 4096;
+  std::string sDescriptorStorage = "FULL";
 
   // required
   cmd.add( make_option('i', sSfM_Data_Filename, "input_file") );
@@ -65,6 +106,14 @@ int main(int argc, char **argv)
   cmd.add( make_option('u', bUpRight, "upright") );
   cmd.add( make_option('f', bForce, "force") );
   cmd.add( make_option('p', sFeaturePreset, "describerPreset") );
+  cmd.add( make_option('n', iMaxFeatures, "maxFeatures") );
+  cmd.add( make_option('s', sFeatureSelection, "featureSelection") );
+  cmd.add( make_option('t', iTileSize, "tileSize") );
+  cmd.add( make_option('w', iTileOverlap, "tileOverlap") );
+  cmd.add( make_option('x', bNativeScaleSpace, "nativeScaleSpace") );
+  cmd.add( make_option('c', sCacheDir, "cacheDir") );
+  cmd.add( make_option('z', iCacheSize, "cacheSize") );
+  cmd.add( make_option('d', sDescriptorStorage, "descriptorStorage") );
 
   try {
       if (argc == 1) throw std::string("Invalid command line parameter.");
@@ -86,6 +135,29 @@ int main(int argc, char **argv)
       << "   NORMAL (default),\n"
       << "   HIGH,\n"
       << "   ULTRA: !!Can take long time!!\n"
+      << "[-n|--maxFeatures] maximal number of regions per image\n"
+      << "  (the dropped keypoints are not described, 0: no limit (default))\n"
+      << "[-s|--featureSelection]\n"
+      << "  (how the kept regions are chosen when --maxFeatures is used):\n"
+      << "   RESPONSE (default): strongest responses,\n"
+      << "   GRID: strongest responses per cell of a regular grid,\n"
+      << "   ANMS: adaptive non-maximal suppression (uniform coverage)\n"
+      << "[-t|--tileSize] size of the tiles used to describe the images larger than a tile\n"
+      << "  (bounded memory for very large images, 0: no tiling (default))\n"
+      << "  Note: --maxFeatures applies per tile.\n"
+      << "[-w|--tileOverlap] size of the tile neighborhood in pixels (default 256)\n"
+      << "[-x|--nativeScaleSpace] SIFT: build the scale space with the parallel\n"
+      << "  and vectorized openMVG code (same regions as VLFeat) 0 or 1\n"
+      << "[-c|--cacheDir path] directory of a cache of the decoded images and of the\n"
+      << "  scale space base levels, shared by the runs (other describers or presets\n"
+      << "  skip the image decoding and the initial smoothing), empty: no cache (default)\n"
+      << "[-z|--cacheSize] maximal size of the cache directory in MB (default 4096)\n"
+      << "[-d|--descriptorStorage]\n"
+      << "  (how the descriptors are stored in the .desc files and loaded for matching):\n"
+      << "   FULL (default): as computed by the describer,\n"
+      << "   FLOAT16: half precision floats (AKAZE_FLOAT, twice smaller),\n"
+      << "   PCA64: 64 PCA components on 8 bits (SIFT and AKAZE_FLOAT, 2 or 4 times smaller),\n"
+      << "    the projection is learned from the first images and saved in descriptor_pca.bin\n"
       << std::endl;
 
       std::cerr << s << std::endl;
@@ -99,6 +171,14 @@ int main(int argc, char **argv)
             << "--describerMethod " << sImage_Describer_Method << std::endl
             << "--upright " << bUpRight << std::endl
             << "--describerPreset " << (sFeaturePreset.empty() ? "NORMAL" : sFeaturePreset) << std::endl
+            << "--maxFeatures " << iMaxFeatures << std::endl
+            << "--featureSelection " << sFeatureSelection << std::endl
+            << "--tileSize " << iTileSize << std::endl
+            << "--tileOverlap " << iTileOverlap << std::endl
+            << "--nativeScaleSpace " << bNativeScaleSpace << std::endl
+            << "--cacheDir " << sCacheDir << std::endl
+            << "--cacheSize " << iCacheSize << std::endl
+            << "--descriptorStorage " << sDescriptorStorage << std::endl
             << "--force " << bForce << std::endl;
 
 
@@ -107,6 +187,28 @@ int main(int argc, char **argv)
     return EXIT_FAILURE;
   }
 
+  const features::EFEATURE_SELECTION eFeatureSelection = stringToFeatureSelection(sFeatureSelection);
+  if (iMaxFeatures < 0 || eFeatureSelection == features::EFEATURE_SELECTION(-1))  {
+    std::cerr << "\nInvalid feature budget configuration" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  if (iTileSize < 0 || iTileOverlap < 0)  {
+    std::cerr << "\nInvalid tiling configuration" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  if (iCacheSize < 0)  {
+    std::cerr << "\nInvalid cache size" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  EDESCRIPTOR_STORAGE eDescriptorStorage = stringToDescriptorStorage(sDescriptorStorage);
+  if (eDescriptorStorage == EDESCRIPTOR_STORAGE(-1))  {
+    std::cerr << "\nInvalid descriptor storage" << std::endl;
+    return EXIT_FAILURE;
+  }
+
   // Create output dir
   if (!stlplus::folder_exists(sOutDir))
   {
@@ -135,7 +237,8 @@ int main(int argc, char **argv)
   std::unique_ptr<Image_describer> image_describer;
 
   const std::string sImage_describer = stlplus::create_filespec(sOutDir, "image_describer", "json");
-  if (!bForce && stlplus::is_file(sImage_describer))
+  const bool bReuse_describer = !bForce && stlplus::is_file(sImage_describer);
+  if (bReuse_describer)
   {
     // Dynamically load the image_describer from the file (will restore old used settings)
     std::ifstream stream(sImage_describer.c_str());
@@ -146,6 +249,15 @@ int main(int argc, char **argv)
     {
       cereal::JSONInputArchive archive(stream);
       archive(cereal::make_nvp("image_describer", image_describer));
+      // The descriptor storage is the one of the saved regions type
+      std::unique_ptr<Regions> regionsType;
+      archive(cereal::make_nvp("regions_type", regionsType));
+      if (dynamic_cast<AKAZE_Float16_Regions*>(regionsType.get()))
+        eDescriptorStorage = DESCRIPTOR_STORAGE_FLOAT16;
+      else if (dynamic_cast<PCA64_Regions*>(regionsType.get()))
+        eDescriptorStorage = DESCRIPTOR_STORAGE_PCA64;
+      else
+        eDescriptorStorage = DESCRIPTOR_STORAGE_FULL;
     }
     catch (const cereal::Exception & e)
     {
@@ -189,6 +301,17 @@ int main(int argc, char **argv)
       }
     }
 
+    // The saved region type is the one of the stored descriptors
+    std::unique_ptr<Regions> regionsType;
+    image_describer->Allocate(regionsType);
+    regionsType = Compressed_Regions_Type(*regionsType, eDescriptorStorage);
+    if (!regionsType)
+    {
+      std::cerr << "The descriptor storage " << sDescriptorStorage
+        << " is not available for the describer " << sImage_Describer_Method << "." << std::endl;
+      return EXIT_FAILURE;
+    }
+
     // Export the used Image_describer and region type for:
     // - dynamic future regions computation and/or loading
     {
@@ -198,19 +321,124 @@ int main(int argc, char **argv)
 
       cereal::JSONOutputArchive archive(stream);
       archive(cereal::make_nvp("image_describer", image_describer));
-      std::unique_ptr<Regions> regionsType;
-      image_describer->Allocate(regionsType);
       archive(cereal::make_nvp("regions_type", regionsType));
     }
   }
 
+  // The feature budget and the SIFT scale space implementation are runtime settings
+  //  (they are not saved in image_describer.json)
+  image_describer->Set_feature_budget(iMaxFeatures, eFeatureSelection);
+  SIFT_Image_describer * sift_describer = dynamic_cast<SIFT_Image_describer*>(image_describer.get());
+  if (sift_describer)
+    sift_describer->Set_native_scale_space(bNativeScaleSpace);
+
+  // Cache of the decoded images and of the scale space base levels.
+  // Each image is described once per run: only the on-disk tier is useful here.
+  std::shared_ptr<Image_Pyramid_Cache> pyramid_cache;
+  if (!sCacheDir.empty())
+  {
+    if (!stlplus::folder_exists(sCacheDir) && !stlplus::folder_create(sCacheDir))
+    {
+      std::cerr << "Cannot create the cache directory" << std::endl;
+      return EXIT_FAILURE;
+    }
+    pyramid_cache = std::make_shared<Image_Pyramid_Cache>(
+      0, sCacheDir, size_t(iCacheSize) << 20);
+  }
+
+  // Describe an image (if it is larger than a tile, it is read and described tile per tile)
+  Image<unsigned char> imageGray;
+  auto describe_image = [&](const std::string & sView_filename, std::unique_ptr<Regions> & regions) -> bool
+  {
+    ImageHeader imgHeader;
+    if (iTileSize > 0 && ReadImageHeader(sView_filename.c_str(), &imgHeader) &&
+        std::max(imgHeader.width, imgHeader.height) > iTileSize)
+    {
+      // Tiled computation: the image is read band per band
+      // (the tiles are not cached)
+      image_describer->Set_pyramid_cache(std::shared_ptr<Image_Pyramid_Cache>());
+      ImageBandReader band_reader;
+      return band_reader.Open(sView_filename.c_str()) &&
+        Describe_Tiled(*image_describer, band_reader.Width(), band_reader.Height(),
+          [&](int y, int rows, Image<unsigned char> & band)
+          { return band_reader.ReadBand(y, rows, &band); },
+          regions, NULL, iTileSize, iTileOverlap);
+    }
+    // The decoded image is cached with the hash of the image file
+    const std::string sImage_key = pyramid_cache ?
+      Image_Pyramid_Cache::Hash_File(sView_filename) + "_gray" : "";
+    if (!pyramid_cache || !pyramid_cache->Get(sImage_key, imageGray))
+    {
+      if (!ReadImage(sView_filename.c_str(), &imageGray))
+        return false;
+      if (pyramid_cache)
+        pyramid_cache->Put(sImage_key, imageGray);
+    }
+    image_describer->Set_pyramid_cache(pyramid_cache);
+    image_describer->Describe(imageGray, regions);
+    return true;
+  };
+
+  // PCA projection of the descriptors (PCA64 storage):
+  // - the one of the previous runs,
+  // - else it is learned from the regions of some images
+  //   (these regions are kept for the extraction below)
+  Descriptor_PCA descriptor_pca;
+  std::map<IndexT, std::unique_ptr<Regions> > sample_regions;
+  if (eDescriptorStorage == DESCRIPTOR_STORAGE_PCA64)
+  {
+    const std::string sPCA_file = stlplus::create_filespec(sOutDir, "descriptor_pca", "bin");
+    if (bReuse_describer && !descriptor_pca.Load(sPCA_file))
+    {
+      std::cerr << "Cannot read the PCA projection of the stored descriptors: " << sPCA_file << std::endl
+        << "Use --force to compute again all the regions." << std::endl;
+      return EXIT_FAILURE;
+    }
+    if (!descriptor_pca.Is_learned())
+    {
+      const size_t max_sample_views = 16, max_samples_per_view = 4000;
+      const size_t step = std::max(size_t(1), sfm_data.GetViews().size() / max_sample_views);
+      std::vector<Eigen::MatrixXf> samples;
+      Eigen::MatrixXf::Index sample_count = 0;
+      Views::const_iterator iterViews = sfm_data.views.begin();
+      for (size_t i = 0; iterViews != sfm_data.views.end(); ++iterViews, ++i)
+      {
+        if (i % step != 0)
+          continue;
+        const std::string sView_filename = stlplus::create_filespec(sfm_data.s_root_path,
+          iterViews->second->s_Img_path);
+        std::unique_ptr<Regions> regions;
+        Eigen::MatrixXf descriptors;
+        if (!describe_image(sView_filename, regions) ||
+            !Descriptors_To_Matrix(*regions, descriptors) || descriptors.rows() == 0)
+          continue;
+        // Evenly spaced descriptors of the image
+        const Eigen::MatrixXf::Index kept =
+          std::min(descriptors.rows(), Eigen::MatrixXf::Index(max_samples_per_view));
+        samples.push_back(Eigen::MatrixXf(kept, descriptors.cols()));
+        for (Eigen::MatrixXf::Index k = 0; k < kept; ++k)
+          samples.back().row(k) = descriptors.row(k * descriptors.rows() / kept);
+        sample_count += kept;
+        sample_regions[iterViews->second->id_view] = std::move(regions);
+      }
+      Eigen::MatrixXf descriptors(sample_count, samples.empty() ? 0 : samples[0].cols());
+      for (size_t i = 0, row = 0; i < samples.size(); row += samples[i].rows(), ++i)
+        descriptors.middleRows(row, samples[i].rows()) = samples[i];
+      if (!descriptor_pca.Learn(descriptors) || !descriptor_pca.Save(sPCA_file))
+      {
+        std::cerr << "Cannot learn the PCA projection of the descriptors." << std::endl;
+        return EXIT_FAILURE;
+      }
+      std::cout << "PCA projection learned from " << sample_count << " descriptors" << std::endl;
+    }
+  }
+
   // Feature extraction routines
   // For each View of the SfM_Data container:
   // - if regions file exist continue,
   // - if no file, compute features
   {
     system::Timer timer;
-    Image<unsigned char> imageGray;
     C_Progress_display my_progress_bar( sfm_data.GetViews().size(),
       std::cout, "\n- EXTRACT FEATURES -\n" );
     for(Views::const_iterator iterViews = sfm_data.views.begin();
@@ -228,16 +456,30 @@ int main(int argc, char **argv)
       //If features or descriptors file are missing, compute them
       if (bForce || !stlplus::file_exists(sFeat) || !stlplus::file_exists(sDesc))
       {
-        if (!ReadImage(sView_filename.c_str(), &imageGray))
+        std::unique_ptr<Regions> regions;
+        std::map<IndexT, std::unique_ptr<Regions> >::iterator sample = sample_regions.find(view->id_view);
+        if (sample != sample_regions.end())
+          regions = std::move(sample->second);
+        else if (!describe_image(sView_filename, regions))
           continue;
 
-        // Compute features and descriptors and export them to files
-        std::unique_ptr<Regions> regions;
-        image_describer->Describe(imageGray, regions);
+        // Store the descriptors as requested
+        if (eDescriptorStorage != DESCRIPTOR_STORAGE_FULL)
+          regions = Compress_Regions(*regions, eDescriptorStorage, &descriptor_pca);
+
+        // Export the computed features and descriptors to files
         image_describer->Save(regions.get(), sFeat, sDesc);
       }
     }
     std::cout << "Task done in (s): " << timer.elapsed() << std::endl;
+    if (sift_describer)
+      std::cout << "SIFT stages (" << sift_describer->Get_timings() << ")" << std::endl;
+    if (pyramid_cache)
+    {
+      const Image_Pyramid_Cache::Statistics stats = pyramid_cache->Get_statistics();
+      std::cout << "Pyramid cache: " << stats.disk_hits << " hits, "
+        << stats.misses << " misses, " << stats.evictions << " evictions" << std::endl;
+    }
   }
   return EXIT_SUCCESS;
 }
@@ -18,6 +18,11 @@
 #include "openMVG/matching_image_collection/F_ACRobust.hpp"
 #include "openMVG/matching_image_collection/E_ACRobust.hpp"
 #include "openMVG/matching_image_collection/H_ACRobust.hpp"
+#include "openMVG/matching_image_collection/Retrieval_Pair_Builder.hpp"
+#include "openMVG/matching_image_collection/Spatial_Pair_Builder.hpp"
+#include "openMVG/matching_image_collection/Streaming_Geometric_Filter.hpp"
+#include "openMVG/exif/exif_IO_EasyExif.hpp"
+#include "openMVG/features/descriptor.hpp"
 #include "openMVG/matching/pairwiseAdjacencyDisplay.hpp"
 #include "openMVG/matching/indMatch_utils.hpp"
 #include "openMVG/system/timer.hpp"
@@ -27,8 +32,10 @@
 #include "third_party/cmdLine/cmdLine.h"
 #include "third_party/stlplus3/filesystemSimplified/file_system.hpp"
 
+#include <cstdio>
 #include <cstdlib>
 #include <fstream>
+#include <thread>
 
 using namespace openMVG;
 using namespace openMVG::cameras;
@@ -49,9 +56,109 @@ enum EPairMode
 {
   PAIR_EXHAUSTIVE = 0,
   PAIR_CONTIGUOUS = 1,
-  PAIR_FROM_FILE  = 2
+  PAIR_FROM_FILE  = 2,
+  PAIR_RETRIEVAL  = 3,
+  PAIR_SPATIAL    = 4
 };
 
+/// Read the GPS position & heading of the views from their EXIF data
+/// Return the number of views that have a GPS position
+static size_t ReadViewPositionPriors
+(
+  const SfM_Data & sfm_data,
+  ViewPositionPriors & priors
+)
+{
+  using namespace openMVG::exif;
+  for (Views::const_iterator iter = sfm_data.GetViews().begin();
+    iter != sfm_data.GetViews().end(); ++iter)
+  {
+    const View * v = iter->second.get();
+    const std::string sImageFilename = stlplus::create_filespec(sfm_data.s_root_path, v->s_Img_path);
+    std::unique_ptr<Exif_IO> exifReader(new Exif_IO_EasyExif());
+    double latitude, longitude, altitude = 0.0;
+    if (!exifReader->open(sImageFilename)
+        || !exifReader->GPSLatitude(&latitude)
+        || !exifReader->GPSLongitude(&longitude))
+      continue;
+    exifReader->GPSAltitude(&altitude);
+
+    ViewPositionPrior & prior = priors[v->id_view];
+    prior.position = lla_to_ecef(latitude, longitude, altitude);
+    double heading;
+    if (exifReader->GPSImgDirection(&heading))
+      prior.heading = heading;
+  }
+  return priors.size();
+}
+
+/// Read the feature count of the views from their descriptor files (without loading them)
+static std::map<IndexT, size_t> ReadViewFeatureCounts
+(
+  const SfM_Data & sfm_data,
+  const std::string & sMatchesDirectory
+)
+{
+  std::map<IndexT, size_t> feature_counts;
+  for (Views::const_iterator iter = sfm_data.GetViews().begin();
+    iter != sfm_data.GetViews().end(); ++iter)
+  {
+    const std::string basename = stlplus::basename_part(iter->second->s_Img_path);
+    const std::string descFile = stlplus::create_filespec(sMatchesDirectory, basename, ".desc");
+    size_t count = 0;
+    if (features::countDescsInBinFile(descFile, count))
+      feature_counts[iter->second->id_view] = count;
+  }
+  return feature_counts;
+}
+
+/// Views used by a set of pairs
+static std::set<IndexT> PairsViews(const Pair_Set & pairs)
+{
+  std::set<IndexT> view_ids;
+  for (Pair_Set::const_iterator iter = pairs.begin(); iter != pairs.end(); ++iter)
+  {
+    view_ids.insert(iter->first);
+    view_ids.insert(iter->second);
+  }
+  return view_ids;
+}
+
+/// Putative matching of the pairs with on-the-fly geometric filtering:
+/// the putative matches go through a bounded queue to the filtering threads
+/// and the geometric matches are written to the stream as soon as computed
+template <typename GeometryFunctor>
+static size_t StreamingMatchAndFilter
+(
+  const Matcher & matcher,
+  const SfM_Data & sfm_data,
+  const std::shared_ptr<Regions_Provider> & regions_provider,
+  const Pair_Set & pairs,
+  const GeometryFunctor & functor,
+  const bool bGuided_matching,
+  const double dDistanceRatio,
+  const size_t minInlierCount,
+  const float minInlierRatio,
+  const size_t queueDepth,
+  std::ostream & geometricStream,
+  std::ostream * putativeStream // optional
+)
+{
+  ImageCollectionGeometricFilter filter(&sfm_data, regions_provider);
+  PairWiseMatches_StreamWriter geometricWriter(geometricStream);
+  std::unique_ptr<PairWiseMatches_StreamWriter> putativeWriter(
+    putativeStream ? new PairWiseMatches_StreamWriter(*putativeStream) : NULL);
+  const size_t threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+  Streaming_Geometric_Filter<GeometryFunctor> streamingFilter(
+    filter, functor, geometricWriter, queueDepth, threadCount,
+    bGuided_matching, dDistanceRatio, putativeWriter.get());
+  streamingFilter.Set_minimal_inliers(minInlierCount, minInlierRatio);
+  matcher.Match(sfm_data, regions_provider, pairs, streamingFilter);
+  streamingFilter.Finish();
+  return geometricWriter.pair_count();
+}
+
 /// Compute corresponding features between a series of views:
 /// - Load view images description (regions: features & descriptors)
 /// - Compute putative local feature matches (descriptors matching)
@@ -70,8 +177,17 @@ int main(int argc, char **argv)
   bool bUpRight = false;
   std::string sNearestMatchingMethod = "AUTO";
   bool bForce = false;
+  bool bIncremental = false;
   bool bGuided_matching = false;
   int imax_iteration = 2048;
+  int iRetrievalTopK = -1;
+  std::string sVocabularyTree = "";
+  int iGPSNeighbors = -1;
+  double dGPSRadius = -1.0;
+  double dGPSMaxHeadingDiff = 180.0;
+  int iStreamingQueueDepth = 0;
+  bool bExportPutative = true;
+  std::string sShard = "";
 
   //required
   cmd.add( make_option('i', sSfM_Data_Filename, "input_file") );
@@ -83,8 +199,17 @@ int main(int argc, char **argv)
   cmd.add( make_option('l', sPredefinedPairList, "pair_list") );
   cmd.add( make_option('n', sNearestMatchingMethod, "nearest_matching_method") );
   cmd.add( make_option('f', bForce, "force") );
+  cmd.add( make_option('u', bIncremental, "incremental") );
   cmd.add( make_option('m', bGuided_matching, "guided_matching") );
   cmd.add( make_option('I', imax_iteration, "max_iteration") );
+  cmd.add( make_option('k', iRetrievalTopK, "retrieval_top_k") );
+  cmd.add( make_option('V', sVocabularyTree, "vocabulary_tree") );
+  cmd.add( make_option('G', iGPSNeighbors, "gps_neighbors") );
+  cmd.add( make_option('R', dGPSRadius, "gps_radius") );
+  cmd.add( make_option('H', dGPSMaxHeadingDiff, "gps_max_heading_diff") );
+  cmd.add( make_option('s', iStreamingQueueDepth, "streaming_queue_depth") );
+  cmd.add( make_option('x', bExportPutative, "export_putative") );
+  cmd.add( make_option('S', sShard, "shard") );
 
   try {
       if (argc == 1) throw std::string("Invalid command line parameter.");
@@ -95,6 +220,9 @@ int main(int argc, char **argv)
       << "[-o|--out_dir path] output path where computed are stored\n"
       << "\n[Optional]\n"
       << "[-f|--force] Force to recompute data]\n"
+      << "[-u|--incremental] Match only the new views\n"
+      << "  (views not found in the existing putative matches)\n"
+      << "   with all the views and append the results to the existing match files.\n"
       << "[-r|--ratio] Distance ratio to discard non meaningful matches\n"
       << "   0.8: (default).\n"
       << "[-g|--geometric_model]\n"
@@ -108,6 +236,20 @@ int main(int argc, char **argv)
       << "   2: will match 0 with (1,2), 1 with (2,3), ...\n"
       << "   3: will match 0 with (1,2,3), 1 with (2,3,4), ...\n"
       << "[-l]--pair_list] file\n"
+      << "[-k|--retrieval_top_k] K\n"
+      << "  (image retrieval pair preselection)\n"
+      << "   match each view with the K most similar views (vocabulary tree & tf-idf scoring).\n"
+      << "[-V|--vocabulary_tree] file\n"
+      << "  vocabulary tree used by --retrieval_top_k:\n"
+      << "   loaded if the file exists, else trained on the scene regions and saved.\n"
+      << "[-G|--gps_neighbors] K\n"
+      << "  (GPS EXIF pair preselection)\n"
+      << "   match each view with its K nearest views.\n"
+      << "[-R|--gps_radius] meters\n"
+      << "   match the views that are closer than this distance\n"
+      << "   (with --gps_neighbors: limit the neighbors distance).\n"
+      << "[-H|--gps_max_heading_diff] degrees\n"
+      << "   discard the pairs whose EXIF image directions differ more than this angle.\n"
       << "[-n|--nearest_matching_method]\n"
       << "  AUTO: auto choice from regions type,\n"
       << "  For Scalar based regions descriptor:\n"
@@ -120,7 +262,17 @@ int main(int argc, char **argv)
       << "  For Binary based descriptor:\n"
       << "    BRUTEFORCEHAMMING: BruteForce Hamming matching.\n"
       << "[-m|--guided_matching]\n"
-      << "  use the found model to improve the pairwise correspondences."
+      << "  use the found model to improve the pairwise correspondences.\n"
+      << "[-s|--streaming_queue_depth] N\n"
+      << "  (bounded memory matching)\n"
+      << "   the putative matches of each pair are geometrically filtered as soon as computed,\n"
+      << "   at most N pairs of putative matches wait for the filtering (0: disabled (default)).\n"
+      << "[-x|--export_putative] 0 or 1\n"
+      << "   with --streaming_queue_depth: save the putative matches (default: 1).\n"
+      << "[-S|--shard] i/N\n"
+      << "  (multi-node matching)\n"
+      << "   match only the i-th of N balanced parts of the pairs (1 <= i <= N),\n"
+      << "   the matches are saved in per shard files (see openMVG_main_MergeMatches)."
       << std::endl;
 
       std::cerr << s << std::endl;
@@ -133,12 +285,21 @@ int main(int argc, char **argv)
             << "--out_dir " << sMatchesDirectory << "\n"
             << "Optional parameters:" << "\n"
             << "--force " << bForce << "\n"
+            << "--incremental " << bIncremental << "\n"
             << "--ratio " << fDistRatio << "\n"
             << "--geometric_model " << sGeometricModel << "\n"
             << "--video_mode_matching " << iMatchingVideoMode << "\n"
             << "--pair_list " << sPredefinedPairList << "\n"
+            << "--retrieval_top_k " << iRetrievalTopK << "\n"
+            << "--vocabulary_tree " << sVocabularyTree << "\n"
+            << "--gps_neighbors " << iGPSNeighbors << "\n"
+            << "--gps_radius " << dGPSRadius << "\n"
+            << "--gps_max_heading_diff " << dGPSMaxHeadingDiff << "\n"
             << "--nearest_matching_method " << sNearestMatchingMethod << "\n"
-            << "--guided_matching " << bGuided_matching << std::endl;
+            << "--guided_matching " << bGuided_matching << "\n"
+            << "--streaming_queue_depth " << iStreamingQueueDepth << "\n"
+            << "--export_putative " << bExportPutative << "\n"
+            << "--shard " << sShard << std::endl;
 
   EPairMode ePairmode = (iMatchingVideoMode == -1 ) ? PAIR_EXHAUSTIVE : PAIR_CONTIGUOUS;
 
@@ -150,6 +311,43 @@ int main(int argc, char **argv)
     }
   }
 
+  if (iRetrievalTopK > 0) {
+    if (ePairmode != PAIR_EXHAUSTIVE) {
+      std::cerr << "\nIncompatible options: --retrieval_top_k and --videoModeMatching or --pairList" << std::endl;
+      return EXIT_FAILURE;
+    }
+    ePairmode = PAIR_RETRIEVAL;
+  }
+
+  if (iGPSNeighbors > 0 || dGPSRadius > 0.0) {
+    if (ePairmode != PAIR_EXHAUSTIVE) {
+      std::cerr << "\nIncompatible options: GPS pair selection and another pair mode" << std::endl;
+      return EXIT_FAILURE;
+    }
+    ePairmode = PAIR_SPATIAL;
+  }
+
+  const bool bStreaming = (iStreamingQueueDepth > 0);
+  if (bStreaming && bIncremental) {
+    std::cerr << "\nIncompatible options: --streaming_queue_depth and --incremental" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Shard i of N (1 <= i <= N)
+  unsigned int iShard = 0, iShardCount = 0;
+  const bool bSharding = !sShard.empty();
+  if (bSharding) {
+    if (std::sscanf(sShard.c_str(), "%u/%u", &iShard, &iShardCount) != 2
+        || iShard < 1 || iShard > iShardCount) {
+      std::cerr << "\nInvalid shard: " << sShard << " (expected i/N with 1 <= i <= N)" << std::endl;
+      return EXIT_FAILURE;
+    }
+    if (bIncremental || ePairmode == PAIR_RETRIEVAL) {
+      std::cerr << "\nIncompatible options: --shard and --incremental or --retrieval_top_k" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
   if (sMatchesDirectory.empty() || !stlplus::is_folder(sMatchesDirectory))  {
     std::cerr << "\nIt is an invalid output directory" << std::endl;
     return EXIT_FAILURE;
@@ -214,13 +412,17 @@ int main(int argc, char **argv)
   //---------------------------------------
 
   // Load the corresponding view regions
+  //  (in sharding mode, only the regions of the views of the shard pairs are loaded
+  //   once the pairs are known)
   std::shared_ptr<Regions_Provider> regions_provider = std::make_shared<Regions_Provider>();
-  if (!regions_provider->load(sfm_data, sMatchesDirectory, regions_type)) {
+  if (!bSharding && !regions_provider->load(sfm_data, sMatchesDirectory, regions_type)) {
     std::cerr << std::endl << "Invalid regions." << std::endl;
     return EXIT_FAILURE;
   }
 
   PairWiseMatches map_PutativesMatches;
+  // Putative matches computed by this run (only the new pairs in incremental mode)
+  PairWiseMatches map_NewPutativesMatches;
 
   // Build some alias from SfM_Data Views data:
   // - List views as a vector of filenames & image sizes
@@ -242,12 +444,28 @@ int main(int argc, char **argv)
 
   std::cout << std::endl << " - PUTATIVE MATCHES - " << std::endl;
   // If the matches already exists, reload them
-  if (!bForce && stlplus::file_exists(sMatchesDirectory + "/matches.putative.txt"))
+  // In sharding mode each shard has its own match files
+  const std::string sPutativeMatchesFilename = sMatchesDirectory + "/" +
+    (bSharding ? shardFilename("matches.putative.txt", iShard, iShardCount) : "matches.putative.txt");
+  const std::string sGeometricMatchesFilespec = sMatchesDirectory + "/" +
+    (bSharding ? shardFilename(sGeometricMatchesFilename, iShard, iShardCount) : sGeometricMatchesFilename);
+  // The streaming mode always recomputes the matches
+  const bool bPreviousPutatives = !bStreaming && !bForce
+    && stlplus::file_exists(sPutativeMatchesFilename);
+  if (bPreviousPutatives)
   {
-    PairedIndMatchImport(sMatchesDirectory + "/matches.putative.txt", map_PutativesMatches);
+    PairedIndMatchImport(sPutativeMatchesFilename, map_PutativesMatches);
     std::cout << "\t PREVIOUS RESULTS LOADED" << std::endl;
+    if (bSharding) {
+      const std::set<IndexT> shardViews = PairsViews(getPairs(map_PutativesMatches));
+      if (!regions_provider->load(sfm_data, sMatchesDirectory, regions_type, &shardViews)) {
+        std::cerr << std::endl << "Invalid regions." << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
   }
-  else // Compute the putative matches
+  // Compute the putative matches (of the new views only in incremental mode)
+  if (!bPreviousPutatives || bIncremental)
   {
     std::cout << "Use: ";
     switch (ePairmode)
@@ -255,6 +473,8 @@ int main(int argc, char **argv)
       case PAIR_EXHAUSTIVE: std::cout << "exhaustive pairwise matching" << std::endl; break;
       case PAIR_CONTIGUOUS: std::cout << "sequence pairwise matching" << std::endl; break;
       case PAIR_FROM_FILE:  std::cout << "user defined pairwise matching" << std::endl; break;
+      case PAIR_RETRIEVAL:  std::cout << "image retrieval pairwise matching" << std::endl; break;
+      case PAIR_SPATIAL:    std::cout << "GPS neighborhood pairwise matching" << std::endl; break;
     }
 
     // Allocate the right Matcher according the Matching requested method
@@ -323,25 +543,143 @@ int main(int argc, char **argv)
               return EXIT_FAILURE;
           };
           break;
+        case PAIR_RETRIEVAL:
+        {
+          VocabularyTree tree;
+          if (!sVocabularyTree.empty() && stlplus::file_exists(sVocabularyTree))
+          {
+            if (!tree.Load(sVocabularyTree))
+            {
+              std::cerr << "Invalid vocabulary tree file: " << sVocabularyTree << std::endl;
+              return EXIT_FAILURE;
+            }
+          }
+          else
+          {
+            std::cout << "Training the vocabulary tree" << std::endl;
+            if (!TrainVocabularyTree(*regions_provider.get(), tree))
+            {
+              std::cerr << "Cannot train the vocabulary tree" << std::endl;
+              return EXIT_FAILURE;
+            }
+            if (!sVocabularyTree.empty() && !tree.Save(sVocabularyTree))
+              std::cerr << "Cannot save the vocabulary tree: " << sVocabularyTree << std::endl;
+          }
+          pairs = retrievalPairs(*regions_provider.get(), tree, iRetrievalTopK);
+          if (pairs.empty())
+          {
+            std::cerr << "No pair found by image retrieval" << std::endl;
+            return EXIT_FAILURE;
+          }
+          std::cout << "Image retrieval selected " << pairs.size() << " pairs" << std::endl;
+        }
+        break;
+        case PAIR_SPATIAL:
+        {
+          ViewPositionPriors priors;
+          const size_t count = ReadViewPositionPriors(sfm_data, priors);
+          std::cout << count << " of " << sfm_data.GetViews().size()
+            << " views have a GPS position" << std::endl;
+          pairs = spatialPairs(priors, iGPSNeighbors, dGPSRadius, dGPSMaxHeadingDiff);
+          if (pairs.empty())
+          {
+            std::cerr << "No pair found from the GPS positions" << std::endl;
+            return EXIT_FAILURE;
+          }
+          std::cout << "GPS neighborhood selected " << pairs.size() << " pairs" << std::endl;
+        }
+        break;
+      }
+      if (bSharding)
+      {
+        // Keep the pairs of the shard and load the regions of their views
+        const size_t pairCount = pairs.size();
+        pairs = shardPairs(pairs, ReadViewFeatureCounts(sfm_data, sMatchesDirectory),
+          iShard - 1, iShardCount);
+        std::cout << "Shard " << iShard << "/" << iShardCount << ": "
+          << pairs.size() << " of " << pairCount << " pairs" << std::endl;
+        const std::set<IndexT> shardViews = PairsViews(pairs);
+        if (!regions_provider->load(sfm_data, sMatchesDirectory, regions_type, &shardViews))
+        {
+          std::cerr << std::endl << "Invalid regions." << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+      if (bPreviousPutatives)
+      {
+        // Skip the pairs of the views that are already matched
+        const size_t pairCount = pairs.size();
+        pairs = incrementalPairs(pairs, getPairs(map_PutativesMatches));
+        std::cout << "Incremental matching: " << pairs.size() << " of "
+          << pairCount << " pairs link a new view" << std::endl;
+      }
+      if (bStreaming)
+      {
+        // Photometric matching & geometric filtering of each pair:
+        //  the putative matches are never stored as a whole
+        std::cout << std::endl << " - Streaming geometric filtering - " << std::endl;
+        std::ofstream geometricFile(sGeometricMatchesFilespec.c_str());
+        std::ofstream putativeFile;
+        if (bExportPutative)
+          putativeFile.open(sPutativeMatchesFilename.c_str());
+        if (!geometricFile.is_open() || (bExportPutative && !putativeFile.is_open()))
+        {
+          std::cerr << "Cannot open the output match files" << std::endl;
+          return EXIT_FAILURE;
+        }
+        std::ostream * putativeStream = bExportPutative ? &putativeFile : NULL;
+        size_t geometricPairCount = 0;
+        switch (eGeometricModelToCompute)
+        {
+          case HOMOGRAPHY_MATRIX:
+          {
+            const bool bGeometric_only_guided_matching = true;
+            geometricPairCount = StreamingMatchAndFilter(*collectionMatcher, sfm_data, regions_provider,
+              pairs, GeometricFilter_HMatrix_AC(4.0, imax_iteration), bGuided_matching,
+              bGeometric_only_guided_matching ? -1.0 : 0.6, 0, 0.f,
+              iStreamingQueueDepth, geometricFile, putativeStream);
+          }
+          break;
+          case FUNDAMENTAL_MATRIX:
+            geometricPairCount = StreamingMatchAndFilter(*collectionMatcher, sfm_data, regions_provider,
+              pairs, GeometricFilter_FMatrix_AC(4.0, imax_iteration), bGuided_matching, 0.6, 0, 0.f,
+              iStreamingQueueDepth, geometricFile, putativeStream);
+          break;
+          case ESSENTIAL_MATRIX:
+            // Remove pairs with poor overlap (same check as the in memory filtering)
+            geometricPairCount = StreamingMatchAndFilter(*collectionMatcher, sfm_data, regions_provider,
+              pairs, GeometricFilter_EMatrix_AC(4.0, imax_iteration), bGuided_matching, 0.6, 50, .3f,
+              iStreamingQueueDepth, geometricFile, putativeStream);
+          break;
+        }
+        std::cout << geometricPairCount << " pairs have geometric matches" << std::endl;
+      }
+      else
+      {
+        // Photometric matching of putative pairs
+        collectionMatcher->Match(sfm_data, regions_provider, pairs, map_NewPutativesMatches);
+        //---------------------------------------
+        //-- Export putative matches (appended to the previous ones in incremental mode)
+        //---------------------------------------
+        std::ofstream file (sPutativeMatchesFilename.c_str(),
+          bPreviousPutatives ? std::ios::app : std::ios::out);
+        if (file.is_open())
+          PairedIndMatchToStream(map_NewPutativesMatches, file);
+        file.close();
+        map_PutativesMatches.insert(map_NewPutativesMatches.begin(), map_NewPutativesMatches.end());
       }
-      // Photometric matching of putative pairs
-      collectionMatcher->Match(sfm_data, regions_provider, pairs, map_PutativesMatches);
-      //---------------------------------------
-      //-- Export putative matches
-      //---------------------------------------
-      std::ofstream file (std::string(sMatchesDirectory + "/matches.putative.txt").c_str());
-      if (file.is_open())
-        PairedIndMatchToStream(map_PutativesMatches, file);
-      file.close();
     }
     std::cout << "Task (Regions Matching) done in (s): " << timer.elapsed() << std::endl;
   }
-  //-- export putative matches Adjacency matrix
-  PairWiseMatchingToAdjacencyMatrixSVG(vec_fileNames.size(),
-    map_PutativesMatches,
-    stlplus::create_filespec(sMatchesDirectory, "PutativeAdjacencyMatrix", "svg"));
-  //-- export view pair graph once putative graph matches have been computed
+  // (the putative matches are not kept in memory in streaming mode,
+  //  a shard does not export partial views of the match graph)
+  if (!bStreaming && !bSharding)
   {
+    //-- export putative matches Adjacency matrix
+    PairWiseMatchingToAdjacencyMatrixSVG(vec_fileNames.size(),
+      map_PutativesMatches,
+      stlplus::create_filespec(sMatchesDirectory, "PutativeAdjacencyMatrix", "svg"));
+    //-- export view pair graph once putative graph matches have been computed
     std::set<IndexT> set_ViewIds;
     std::transform(sfm_data.GetViews().begin(), sfm_data.GetViews().end(),
       std::inserter(set_ViewIds, set_ViewIds.begin()), stl::RetrieveKey());
@@ -365,64 +703,86 @@ int main(int argc, char **argv)
     system::Timer timer;
     std::cout << std::endl << " - Geometric filtering - " << std::endl;
 
+    // In incremental mode only the new putative pairs are filtered
+    //  (if the previous pairs have already been filtered)
+    const bool bIncrementalFilter = bIncremental && bPreviousPutatives
+      && stlplus::file_exists(sGeometricMatchesFilespec);
+    const PairWiseMatches & map_PairsToFilter =
+      bIncrementalFilter ? map_NewPutativesMatches : map_PutativesMatches;
+
     PairWiseMatches map_GeometricMatches;
-    switch (eGeometricModelToCompute)
+    if (bStreaming)
     {
-      case HOMOGRAPHY_MATRIX:
-      {
-        const bool bGeometric_only_guided_matching = true;
-        filter_ptr->Robust_model_estimation(GeometricFilter_HMatrix_AC(4.0, imax_iteration),
-          map_PutativesMatches, bGuided_matching,
-          bGeometric_only_guided_matching ? -1.0 : 0.6);
-        map_GeometricMatches = filter_ptr->Get_geometric_matches();
-      }
-      break;
-      case FUNDAMENTAL_MATRIX:
-      {
-        filter_ptr->Robust_model_estimation(GeometricFilter_FMatrix_AC(4.0, imax_iteration),
-          map_PutativesMatches, bGuided_matching);
-        map_GeometricMatches = filter_ptr->Get_geometric_matches();
-      }
-      break;
-      case ESSENTIAL_MATRIX:
+      // Already filtered and saved during the matching: reload them for the exports
+      PairedIndMatchImport(sGeometricMatchesFilespec, map_GeometricMatches);
+    }
+    else
+    {
+      switch (eGeometricModelToCompute)
       {
-        filter_ptr->Robust_model_estimation(GeometricFilter_EMatrix_AC(4.0, imax_iteration),
-          map_PutativesMatches, bGuided_matching);
-        map_GeometricMatches = filter_ptr->Get_geometric_matches();
-
-        //-- Perform an additional check to remove pairs with poor overlap
-        std::vector<PairWiseMatches::key_type> vec_toRemove;
-        for (PairWiseMatches::const_iterator iterMap = map_GeometricMatches.begin();
-          iterMap != map_GeometricMatches.end(); ++iterMap)
+        case HOMOGRAPHY_MATRIX:
         {
-          const size_t putativePhotometricCount = map_PutativesMatches.find(iterMap->first)->second.size();
-          const size_t putativeGeometricCount = iterMap->second.size();
-          const float ratio = putativeGeometricCount / (float)putativePhotometricCount;
-          if (putativeGeometricCount < 50 || ratio < .3f)  {
-            // the pair will be removed
-            vec_toRemove.push_back(iterMap->first);
-          }
+          const bool bGeometric_only_guided_matching = true;
+          filter_ptr->Robust_model_estimation(GeometricFilter_HMatrix_AC(4.0, imax_iteration),
+            map_PairsToFilter, bGuided_matching,
+            bGeometric_only_guided_matching ? -1.0 : 0.6);
+          map_GeometricMatches = filter_ptr->Get_geometric_matches();
+        }
+        break;
+        case FUNDAMENTAL_MATRIX:
+        {
+          filter_ptr->Robust_model_estimation(GeometricFilter_FMatrix_AC(4.0, imax_iteration),
+            map_PairsToFilter, bGuided_matching);
+          map_GeometricMatches = filter_ptr->Get_geometric_matches();
         }
-        //-- remove discarded pairs
-        for (std::vector<PairWiseMatches::key_type>::const_iterator
-          iter =  vec_toRemove.begin(); iter != vec_toRemove.end(); ++iter)
+        break;
+        case ESSENTIAL_MATRIX:
         {
-          map_GeometricMatches.erase(*iter);
+          filter_ptr->Robust_model_estimation(GeometricFilter_EMatrix_AC(4.0, imax_iteration),
+            map_PairsToFilter, bGuided_matching);
+          map_GeometricMatches = filter_ptr->Get_geometric_matches();
+
+          //-- Perform an additional check to remove pairs with poor overlap
+          std::vector<PairWiseMatches::key_type> vec_toRemove;
+          for (PairWiseMatches::const_iterator iterMap = map_GeometricMatches.begin();
+            iterMap != map_GeometricMatches.end(); ++iterMap)
+          {
+            const size_t putativePhotometricCount = map_PutativesMatches.find(iterMap->first)->second.size();
+            const size_t putativeGeometricCount = iterMap->second.size();
+            const float ratio = putativeGeometricCount / (float)putativePhotometricCount;
+            if (putativeGeometricCount < 50 || ratio < .3f)  {
+              // the pair will be removed
+              vec_toRemove.push_back(iterMap->first);
+            }
+          }
+          //-- remove discarded pairs
+          for (std::vector<PairWiseMatches::key_type>::const_iterator
+            iter =  vec_toRemove.begin(); iter != vec_toRemove.end(); ++iter)
+          {
+            map_GeometricMatches.erase(*iter);
+          }
         }
+        break;
       }
-      break;
-    }
 
-    //---------------------------------------
-    //-- Export geometric filtered matches
-    //---------------------------------------
-    std::ofstream file (string(sMatchesDirectory + "/" + sGeometricMatchesFilename).c_str());
-    if (file.is_open())
-      PairedIndMatchToStream(map_GeometricMatches, file);
-    file.close();
+      //---------------------------------------
+      //-- Export geometric filtered matches
+      //---------------------------------------
+      std::ofstream file (sGeometricMatchesFilespec.c_str(),
+        bIncrementalFilter ? std::ios::app : std::ios::out);
+      if (file.is_open())
+        PairedIndMatchToStream(map_GeometricMatches, file);
+      file.close();
+      // Reload all the geometric matches (previous & new ones) for the exports
+      if (bIncrementalFilter)
+        PairedIndMatchImport(sGeometricMatchesFilespec, map_GeometricMatches);
+    }
 
     std::cout << "Task done in (s): " << timer.elapsed() << std::endl;
 
+    if (bSharding)
+      return EXIT_SUCCESS;
+
     //-- export Adjacency matrix
     std::cout << "\n Export Adjacency Matrix of the pairwise's geometric matches"
       << std::endl;
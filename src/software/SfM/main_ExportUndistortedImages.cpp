@@ -56,30 +56,53 @@ int main(int argc, char *argv[]) {
 
   bool bOk = true;
   {
+    // Precompute the undistortion maps once per intrinsic
+    //  (shared by all the views that use this intrinsic)
+    UndistortionMaps undistortion_maps;
+    for (Intrinsics::const_iterator iterIntrinsic = sfm_data.GetIntrinsics().begin();
+      iterIntrinsic != sfm_data.GetIntrinsics().end(); ++iterIntrinsic)
+    {
+      const IntrinsicBase * cam = iterIntrinsic->second.get();
+      if (cam->have_disto())
+        undistortion_maps[iterIntrinsic->first].Build(cam, cam->w(), cam->h());
+    }
+
     // Export views as undistorted images (those with valid Intrinsics)
-    Image<RGBColor> image, image_ud;
-    C_Progress_display my_progress_bar( sfm_data.GetViews().size() );
+    std::vector<const View*> views;
     for(Views::const_iterator iter = sfm_data.GetViews().begin();
-      iter != sfm_data.GetViews().end(); ++iter, ++my_progress_bar)
+      iter != sfm_data.GetViews().end(); ++iter)
     {
       const View * view = iter->second.get();
-      bool bIntrinsicDefined = view->id_intrinsic != UndefinedIndexT &&
-        sfm_data.GetIntrinsics().find(view->id_intrinsic) != sfm_data.GetIntrinsics().end();
+      if (view->id_intrinsic != UndefinedIndexT &&
+        sfm_data.GetIntrinsics().find(view->id_intrinsic) != sfm_data.GetIntrinsics().end())
+        views.push_back(view);
+    }
 
-      Intrinsics::const_iterator iterIntrinsic = sfm_data.GetIntrinsics().find(view->id_intrinsic);
+    C_Progress_display my_progress_bar( views.size() );
+#ifdef OPENMVG_USE_OPENMP
+    #pragma omp parallel for schedule(dynamic)
+#endif
+    for (int i = 0; i < static_cast<int>(views.size()); ++i)
+    {
+      const View * view = views[i];
+      const IntrinsicBase * cam = sfm_data.GetIntrinsics().at(view->id_intrinsic).get();
 
       const std::string srcImage = stlplus::create_filespec(sfm_data.s_root_path, view->s_Img_path);
       const std::string dstImage = stlplus::create_filespec(
         sOutDir, stlplus::filename_part(srcImage));
 
-      const IntrinsicBase * cam = iterIntrinsic->second.get();
+      bool bExport = true;
       if (cam->have_disto())
       {
         // undistort the image and save it
+        Image<RGBColor> image, image_ud;
         if (ReadImage( srcImage.c_str(), &image))
         {
-          UndistortImage(image, cam, image_ud, BLACK);
-          bOk &= WriteImage(dstImage.c_str(), image_ud);
+          // Use the shared undistortion map if it fits the image size
+          //  or compute the undistortion for this image only.
+          if (!UndistortImage(image, undistortion_maps.at(view->id_intrinsic), image_ud, BLACK))
+            UndistortImage(image, cam, image_ud, BLACK);
+          bExport = WriteImage(dstImage.c_str(), image_ud);
         }
       }
       else // (no distortion)
@@ -87,6 +110,13 @@ int main(int argc, char *argv[]) {
         // copy the image since there is no distortion
         stlplus::file_copy(srcImage, dstImage);
       }
+#ifdef OPENMVG_USE_OPENMP
+      #pragma omp critical
+#endif
+      {
+        bOk &= bExport;
+        ++my_progress_bar;
+      }
     }
   }
 
@@ -41,6 +41,7 @@ int main(int argc, char **argv)
   int iRotationAveragingMethod = int (ROTATION_AVERAGING_L2);
   int iTranslationAveragingMethod = int (TRANSLATION_AVERAGING_SOFTL1);
   bool bRefineIntrinsics = true;
+  std::string sRelativePoseCache = "";
 
   cmd.add( make_option('i', sSfM_Data_Filename, "input_file") );
   cmd.add( make_option('m', sMatchesDir, "matchdir") );
@@ -48,6 +49,7 @@ int main(int argc, char **argv)
   cmd.add( make_option('r', iRotationAveragingMethod, "rotationAveraging") );
   cmd.add( make_option('t', iTranslationAveragingMethod, "translationAveraging") );
   cmd.add( make_option('f', bRefineIntrinsics, "refineIntrinsics") );
+  cmd.add( make_option('p', sRelativePoseCache, "relative_pose_cache") );
 
   try {
     if (argc == 1) throw std::string("Invalid parameter.");
@@ -68,6 +70,8 @@ int main(int argc, char **argv)
     << "[-f|--refineIntrinsics]\n"
     << "\t 0-> intrinsic parameters are kept as constant\n"
     << "\t 1-> refine intrinsic parameters (default). \n"
+    << "[-p|--relative_pose_cache] file used to cache the relative pose estimations\n"
+    << "\t (default: matchdir/relative_pose_cache.bin, remove it to recompute everything)\n"
     << std::endl;
 
     std::cerr << s << std::endl;
@@ -142,6 +146,13 @@ int main(int argc, char **argv)
   sfmEngine.SetFeaturesProvider(feats_provider.get());
   sfmEngine.SetMatchesProvider(matches_provider.get());
 
+  // Reuse the relative poses estimated by the previous runs (on the same inputs)
+  if (sRelativePoseCache.empty())
+    sRelativePoseCache = stlplus::create_filespec(sMatchesDir, "relative_pose_cache.bin");
+  RelativePose_Cache relative_pose_cache;
+  relative_pose_cache.Load(sRelativePoseCache);
+  sfmEngine.SetRelativePoseCache(&relative_pose_cache);
+
   // Configure reconstruction parameters
   sfmEngine.Set_bFixedIntrinsics(!bRefineIntrinsics);
 
@@ -151,7 +162,14 @@ int main(int argc, char **argv)
   sfmEngine.SetTranslationAveragingMethod(
     ETranslationAveragingMethod(iTranslationAveragingMethod));
 
-  if (sfmEngine.Process())
+  const bool bProcess = sfmEngine.Process();
+
+  std::cout << "Relative pose cache: " << relative_pose_cache.hit_count() << " reused, "
+    << relative_pose_cache.miss_count() << " computed" << std::endl;
+  if (!relative_pose_cache.Save(sRelativePoseCache))
+    std::cerr << "Cannot save the relative pose cache: " << sRelativePoseCache << std::endl;
+
+  if (bProcess)
   {
     std::cout << std::endl << " Total Ac-Global-Sfm took (s): " << timer.elapsed() << std::endl;
 
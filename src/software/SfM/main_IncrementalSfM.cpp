@@ -68,6 +68,7 @@ int main(int argc, char **argv)
   std::string sOutDir = "";
   std::pair<std::string,std::string> initialPairString("","");
   bool bRefineIntrinsics = true;
+  std::string sRelativePoseCache = "";
   int i_User_camera_model = PINHOLE_CAMERA_RADIAL3;
 
   cmd.add( make_option('i', sSfM_Data_Filename, "input_file") );
@@ -77,6 +78,7 @@ int main(int argc, char **argv)
   cmd.add( make_option('b', initialPairString.second, "initialPairB") );
   cmd.add( make_option('c', i_User_camera_model, "camera_model") );
   cmd.add( make_option('f', bRefineIntrinsics, "refineIntrinsics") );
+  cmd.add( make_option('p', sRelativePoseCache, "relative_pose_cache") );
 
   try {
     if (argc == 1) throw std::string("Invalid parameter.");
@@ -95,6 +97,8 @@ int main(int argc, char **argv)
     << "[-f|--refineIntrinsics] \n"
     << "\t 0-> intrinsic parameters are kept as constant\n"
     << "\t 1-> refine intrinsic parameters (default). \n"
+    << "[-p|--relative_pose_cache] file used to cache the relative pose estimations\n"
+    << "\t (default: matchdir/relative_pose_cache.bin, remove it to recompute everything)\n"
     << std::endl;
 
     std::cerr << s << std::endl;
@@ -157,6 +161,13 @@ int main(int argc, char **argv)
   sfmEngine.SetFeaturesProvider(feats_provider.get());
   sfmEngine.SetMatchesProvider(matches_provider.get());
 
+  // Reuse the relative poses estimated by the previous runs (on the same inputs)
+  if (sRelativePoseCache.empty())
+    sRelativePoseCache = stlplus::create_filespec(sMatchesDir, "relative_pose_cache.bin");
+  RelativePose_Cache relative_pose_cache;
+  relative_pose_cache.Load(sRelativePoseCache);
+  sfmEngine.SetRelativePoseCache(&relative_pose_cache);
+
   // Configure reconstruction parameters
   sfmEngine.Set_bFixedIntrinsics(!bRefineIntrinsics);
   sfmEngine.SetUnknownCameraType(EINTRINSIC(i_User_camera_model));
@@ -174,7 +185,14 @@ int main(int argc, char **argv)
     sfmEngine.setInitialPair(initialPairIndex);
   }
 
-  if (sfmEngine.Process())
+  const bool bProcess = sfmEngine.Process();
+
+  std::cout << "Relative pose cache: " << relative_pose_cache.hit_count() << " reused, "
+    << relative_pose_cache.miss_count() << " computed" << std::endl;
+  if (!relative_pose_cache.Save(sRelativePoseCache))
+    std::cerr << "Cannot save the relative pose cache: " << sRelativePoseCache << std::endl;
+
+  if (bProcess)
   {
     std::cout << std::endl << " Total Ac-Sfm took (s): " << timer.elapsed() << std::endl;
 
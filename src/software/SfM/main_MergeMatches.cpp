@@ -0,0 +1,135 @@
+
+// Copyright (c) 2015 Pierre MOULON.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "openMVG/matching/indMatch_utils.hpp"
+#include "openMVG/matching_image_collection/Pair_Builder.hpp"
+
+#include "third_party/cmdLine/cmdLine.h"
+#include "third_party/stlplus3/filesystemSimplified/file_system.hpp"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+using namespace openMVG;
+using namespace openMVG::matching;
+
+/// Merge the shard files of a match file into the final match file
+/// Return false if a shard is missing or if a pair is found in several shards
+static bool MergeShards
+(
+  const std::string & sMatchesDirectory,
+  const std::string & sFilename,
+  const unsigned int iShardCount
+)
+{
+  std::ofstream file(stlplus::create_filespec(sMatchesDirectory, sFilename).c_str());
+  if (!file.is_open())
+  {
+    std::cerr << "Cannot write the file: " << sFilename << std::endl;
+    return false;
+  }
+  // The shards are read one by one: only a shard is in memory at a time
+  Pair_Set merged_pairs;
+  for (unsigned int iShard = 1; iShard <= iShardCount; ++iShard)
+  {
+    const std::string sShardFile =
+      stlplus::create_filespec(sMatchesDirectory, shardFilename(sFilename, iShard, iShardCount));
+    PairWiseMatches map_Matches;
+    if (!stlplus::file_exists(sShardFile) || !PairedIndMatchImport(sShardFile, map_Matches))
+    {
+      std::cerr << "Missing shard: " << sShardFile << std::endl;
+      return false;
+    }
+    for (PairWiseMatches::const_iterator iter = map_Matches.begin();
+      iter != map_Matches.end(); ++iter)
+    {
+      if (!merged_pairs.insert(iter->first).second)
+      {
+        std::cerr << "The pair (" << iter->first.first << "," << iter->first.second
+          << ") is found in several shards" << std::endl;
+        return false;
+      }
+    }
+    PairedIndMatchToStream(map_Matches, file);
+  }
+  std::cout << sFilename << ": " << merged_pairs.size() << " pairs" << std::endl;
+  return file.good();
+}
+
+/// Merge the match files computed by openMVG_main_ComputeMatches --shard i/N
+int main(int argc, char **argv)
+{
+  CmdLine cmd;
+
+  std::string sMatchesDirectory = "";
+  std::string sGeometricModel = "f";
+  int iShardCount = 0;
+
+  //required
+  cmd.add( make_option('o', sMatchesDirectory, "out_dir") );
+  cmd.add( make_option('n', iShardCount, "shard_count") );
+  // Options
+  cmd.add( make_option('g', sGeometricModel, "geometric_model") );
+
+  try {
+      if (argc == 1) throw std::string("Invalid command line parameter.");
+      cmd.process(argc, argv);
+  } catch(const std::string& s) {
+      std::cerr << "Usage: " << argv[0] << '\n'
+      << "[-o|--out_dir path] directory of the match shards (the merged matches are stored there)\n"
+      << "[-n|--shard_count] N: number of shards\n"
+      << "\n[Optional]\n"
+      << "[-g|--geometric_model] geometric model used to compute the shards\n"
+      << "   f: (default) fundamental matrix,\n"
+      << "   e: essential matrix,\n"
+      << "   h: homography matrix."
+      << std::endl;
+
+      std::cerr << s << std::endl;
+      return EXIT_FAILURE;
+  }
+
+  std::cout << " You called : " << "\n"
+            << argv[0] << "\n"
+            << "--out_dir " << sMatchesDirectory << "\n"
+            << "--shard_count " << iShardCount << "\n"
+            << "--geometric_model " << sGeometricModel << std::endl;
+
+  if (sMatchesDirectory.empty() || !stlplus::is_folder(sMatchesDirectory))  {
+    std::cerr << "\nIt is an invalid output directory" << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (iShardCount < 1)  {
+    std::cerr << "\nInvalid shard count" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::string sGeometricMatchesFilename = "";
+  switch(sGeometricModel[0])
+  {
+    case 'f': case 'F': sGeometricMatchesFilename = "matches.f.txt"; break;
+    case 'e': case 'E': sGeometricMatchesFilename = "matches.e.txt"; break;
+    case 'h': case 'H': sGeometricMatchesFilename = "matches.h.txt"; break;
+    default:
+      std::cerr << "Unknown geometric model" << std::endl;
+      return EXIT_FAILURE;
+  }
+
+  // The putative matches are optional (not saved with --export_putative 0)
+  const std::string sPutativeMatchesFilename = "matches.putative.txt";
+  if (stlplus::file_exists(stlplus::create_filespec(sMatchesDirectory,
+        shardFilename(sPutativeMatchesFilename, 1, iShardCount))))
+  {
+    if (!MergeShards(sMatchesDirectory, sPutativeMatchesFilename, iShardCount))
+      return EXIT_FAILURE;
+  }
+  if (!MergeShards(sMatchesDirectory, sGeometricMatchesFilename, iShardCount))
+    return EXIT_FAILURE;
+
+  return EXIT_SUCCESS;
+}
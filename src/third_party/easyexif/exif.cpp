@@ -513,6 +513,19 @@ int EXIFInfo::parseFromEXIFSegment(const unsigned char *buf, unsigned len) {
               this->GeoLocation.Altitude = -this->GeoLocation.Altitude;
           }
           break;
+
+        case 16:
+          // GPS image direction reference (true or magnetic north)
+          this->GeoLocation.ImgDirectionRef = *(buf + offs + 8);
+          break;
+
+        case 17:
+          // GPS image direction
+          if (format == 5) {
+            this->GeoLocation.ImgDirection =
+              parseEXIFRational(buf + data + tiff_header_start, alignIntel);
+          }
+          break;
       }
       offs += 12;
     }
@@ -556,6 +569,8 @@ void EXIFInfo::clear() {
   GeoLocation.Longitude   = 0;
   GeoLocation.Altitude    = 0;
   GeoLocation.AltitudeRef = 0;
+  GeoLocation.ImgDirection    = -1;
+  GeoLocation.ImgDirectionRef = 0;
   GeoLocation.LatComponents.degrees   = 0;
   GeoLocation.LatComponents.minutes   = 0;
   GeoLocation.LatComponents.seconds   = 0;
@@ -124,6 +124,9 @@ class EXIFInfo {
     double Longitude;                 // Image longitude expressed as decimal
     double Altitude;                  // Altitude in meters, relative to sea level
     char AltitudeRef;                 // 0 = above sea level, -1 = below sea level
+    double ImgDirection;              // Direction of the image in degrees [0, 360[
+                                      // (-1 if not available)
+    char ImgDirectionRef;             // 'T' = true north, 'M' = magnetic north
     struct Coord_t {
       double degrees;
       double minutes;